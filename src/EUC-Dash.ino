@@ -39,33 +39,60 @@
 #include "hardware/Kingsong.h"
 #include "hardware/dashboard.h"
 #include "hardware/wheelctl.h"
+#include "hardware/alarmctl.h"
+#include "hardware/configstore.h"
+#include "hardware/bootctl.h"
+#include "hardware/mqttctl.h"
+#include "hardware/webserver.h"
+#include "hardware/metrics.h"
+#include "hardware/console.h"
+#include "hardware/arena.h"
 
 TTGOClass *ttgo = TTGOClass::getWatch();
 
 void setup()
 {
+    int boot_phase;
+
     Serial.begin(115200);
     Serial.printf("starting t-watch V1, version: " __FIRMWARE__ " core: %d\r\n", xPortGetCoreID() );
     Serial.printf("Configure watchdog to 30s: %d\r\n", esp_task_wdt_init( 30, true ) );
 
+    /*
+     * hot buffers get their memory from the arenas, reserve them while the heap
+     * is still in one piece
+     */
+    arena_setup();
+
+    boot_phase = bootctl_phase_begin( "ttgo begin" );
     ttgo->begin();
     ttgo->lvgl_begin();
+    bootctl_phase_end( boot_phase );
 
-    SPIFFS.begin();
-    motor_setup();
+    boot_phase = bootctl_phase_begin( "spiffs mount" );
+    bool spiffs_mounted = SPIFFS.begin();
+    bootctl_phase_end( boot_phase );
 
+    boot_phase = bootctl_phase_begin( "config read" );
+    configstore_setup();
+    motor_setup();
     dashboard_setup();
+    bootctl_phase_end( boot_phase );
 
-    // force to store all new heap allocations in psram to get more internal ram
+    // force to store all new heap allocations in psram to get more internal ram,
+    // this only steers library and lvgl allocations, our hot buffers are in the arenas
     heap_caps_malloc_extmem_enable( 1 );
     
+    boot_phase = bootctl_phase_begin( "display" );
     display_setup();
 
     splash_screen_stage_one();
     splash_screen_stage_update( "init serial", 10 );
+    bootctl_phase_end( boot_phase );
 
     splash_screen_stage_update( "init spiff", 20 );
-    if ( !SPIFFS.begin() ) {
+    if ( !spiffs_mounted ) {
+        boot_phase = bootctl_phase_begin( "spiffs format" );
         splash_screen_stage_update( "format spiff", 30 );
         SPIFFS.format();
         splash_screen_stage_update( "format spiff done", 40 );
@@ -76,10 +103,15 @@ void setup()
             delay(3000);
             ESP.restart();
         }
+        bootctl_phase_end( boot_phase );
     }
 
     splash_screen_stage_update( "init powermgm", 50 );
+    boot_phase = bootctl_phase_begin( "powermgm" );
     powermgm_setup();
+    metrics_setup();
+    console_setup();
+    bootctl_phase_end( boot_phase );
     
     splash_screen_stage_update( "init wifi", 60 );
     if ( wifictl_get_autoon() && ( pmu_is_charging() || pmu_is_vbus_plug() || ( pmu_get_battery_voltage() > 3400) ) )
@@ -90,19 +122,26 @@ void setup()
     heap_caps_malloc_extmem_enable( 16*1024 );
 
     wheelctl_setup();
-
-    //blectl_setup();
-    splash_screen_stage_update( "init BLE", 80 );
+    alarmctl_setup();
+    mqttctl_setup();
+    webserver_setup();
+
+    /*
+     * the ble stack bring up does not depend on the gui, let it run on core 0
+     * while we build the tiles here
+     */
+    splash_screen_stage_update( "init BLE and gui", 80 );
+    bootctl_add_job( "ble stack", blectl_scan_init, 0, 0 );
+    bootctl_add_job( "gui", gui_setup, 0, xPortGetCoreID() );
+    bootctl_run();
     blectl_scan_setup();
 
-    splash_screen_stage_update( "init gui", 90 );
-    gui_setup();
-
     splash_screen_stage_finish();
 
     display_set_brightness( display_get_brightness() );
 
-    delay(500);
+    bootctl_mark( BOOTCTL_MARK_SETUP_DONE );
+    bootctl_print();
 
     Serial.printf("Total heap: %d\r\n", ESP.getHeapSize());
     Serial.printf("Free heap: %d\r\n", ESP.getFreeHeap());
@@ -111,6 +150,7 @@ void setup()
 
     disableCore0WDT();
     callback_print();
+    arena_print();
 }
 
 void loop() {
@@ -0,0 +1,66 @@
+/****************************************************************************
+ *   Copyright  2020  Jesper Ortlund
+ ****************************************************************************/
+/*
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+#include "config.h"
+#include <TTGO.h>
+
+#include "bandstyle.h"
+
+void bandstyle_init( bandstyle_t *bandstyle, lv_style_t *base, int prop, lv_color_t normal, lv_color_t warn, lv_color_t crit, lv_color_t regen ) {
+    lv_color_t colour[ BANDSTYLE_NUM ] = { normal, warn, crit, regen };
+
+    bandstyle->base = base;
+    for ( int band = 0 ; band < BANDSTYLE_NUM ; band++ ) {
+        /*
+         * lv_style_copy allocates a new property map, free the old one on a rebuild
+         */
+        if ( bandstyle->initialized )
+            lv_style_reset( &bandstyle->band[ band ] );
+        lv_style_copy( &bandstyle->band[ band ], base );
+        switch( prop ) {
+            case BANDSTYLE_TEXT:        lv_style_set_text_color( &bandstyle->band[ band ], LV_STATE_DEFAULT, colour[ band ] );
+                                        break;
+            case BANDSTYLE_IMAGE:       lv_style_set_image_recolor( &bandstyle->band[ band ], LV_STATE_DEFAULT, colour[ band ] );
+                                        lv_style_set_image_recolor_opa( &bandstyle->band[ band ], LV_STATE_DEFAULT, LV_OPA_COVER );
+                                        break;
+            default:                    lv_style_set_line_color( &bandstyle->band[ band ], LV_STATE_DEFAULT, colour[ band ] );
+                                        break;
+        }
+    }
+    bandstyle->initialized = true;
+}
+
+void bandstyle_attach( bandstyle_slot_t *slot, lv_obj_t *obj, uint8_t part, bandstyle_t *bandstyle ) {
+    slot->obj = obj;
+    slot->part = part;
+    slot->bandstyle = bandstyle;
+    slot->band = BANDSTYLE_NONE;
+    lv_obj_add_style( obj, part, bandstyle->base );
+}
+
+void bandstyle_set( bandstyle_slot_t *slot, int band ) {
+    if ( slot->obj == NULL || band == slot->band || band < 0 || band >= BANDSTYLE_NUM )
+        return;
+
+    if ( slot->band == BANDSTYLE_NONE )
+        lv_obj_remove_style( slot->obj, slot->part, slot->bandstyle->base );
+    else
+        lv_obj_remove_style( slot->obj, slot->part, &slot->bandstyle->band[ slot->band ] );
+    lv_obj_add_style( slot->obj, slot->part, &slot->bandstyle->band[ band ] );
+    slot->band = band;
+}
@@ -0,0 +1,89 @@
+/****************************************************************************
+ *   Copyright  2020  Jesper Ortlund
+ ****************************************************************************/
+/*
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+#ifndef _BANDSTYLE_H
+    #define _BANDSTYLE_H
+
+    #include <TTGO.h>
+
+    /**
+     * @brief colour bands a gauge can be in
+     */
+    enum {
+        BANDSTYLE_NORMAL = 0,
+        BANDSTYLE_WARN,
+        BANDSTYLE_CRIT,
+        BANDSTYLE_REGEN,
+        BANDSTYLE_NUM
+    };
+
+    #define BANDSTYLE_NONE              -1          /** @brief the base style is attached, no band selected yet */
+
+    #define BANDSTYLE_LINE              0           /** @brief bands change the line colour, for arcs */
+    #define BANDSTYLE_TEXT              1           /** @brief bands change the text colour, for labels */
+    #define BANDSTYLE_IMAGE             2           /** @brief bands recolour images, for digitsprite readouts */
+
+    /**
+     * @brief one precomputed style per colour band, built once from a base style
+     */
+    typedef struct {
+        lv_style_t *base = NULL;                    /** @brief base style, attached until the first band is set */
+        lv_style_t band[ BANDSTYLE_NUM ];           /** @brief copies of base with the band colour set */
+        bool initialized = false;
+    } bandstyle_t;
+
+    /**
+     * @brief an object part that swaps between the styles of a bandstyle_t
+     */
+    typedef struct {
+        lv_obj_t *obj = NULL;
+        uint8_t part = 0;
+        bandstyle_t *bandstyle = NULL;
+        int band = BANDSTYLE_NONE;                  /** @brief current band */
+    } bandstyle_slot_t;
+
+    /**
+     * @brief build the band styles, call again to rebuild them after a reload
+     *
+     * @param   bandstyle   pointer to the bandstyle_t to fill
+     * @param   base        base style, has to stay valid as long as the bandstyle is used
+     * @param   prop        BANDSTYLE_LINE, BANDSTYLE_TEXT or BANDSTYLE_IMAGE
+     * @param   normal      colour for BANDSTYLE_NORMAL
+     * @param   warn        colour for BANDSTYLE_WARN
+     * @param   crit        colour for BANDSTYLE_CRIT
+     * @param   regen       colour for BANDSTYLE_REGEN
+     */
+    void bandstyle_init( bandstyle_t *bandstyle, lv_style_t *base, int prop, lv_color_t normal, lv_color_t warn, lv_color_t crit, lv_color_t regen );
+    /**
+     * @brief add the base style to an object part and remember it for bandstyle_set()
+     *
+     * @param   slot        pointer to the slot to fill
+     * @param   obj         pointer to the lv_obj
+     * @param   part        object part, like LV_ARC_PART_INDIC
+     * @param   bandstyle   pointer to an initialized bandstyle_t
+     */
+    void bandstyle_attach( bandstyle_slot_t *slot, lv_obj_t *obj, uint8_t part, bandstyle_t *bandstyle );
+    /**
+     * @brief swap the style of an object part to the given band, does nothing if the band is unchanged
+     *
+     * @param   slot        pointer to an attached slot
+     * @param   band        BANDSTYLE_NORMAL, BANDSTYLE_WARN, BANDSTYLE_CRIT or BANDSTYLE_REGEN
+     */
+    void bandstyle_set( bandstyle_slot_t *slot, int band );
+
+#endif // _BANDSTYLE_H
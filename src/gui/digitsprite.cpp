@@ -0,0 +1,345 @@
+/****************************************************************************
+ *   Copyright  2020  Jesper Ortlund
+ ****************************************************************************/
+/*
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+#include "config.h"
+#include <TTGO.h>
+
+#include "digitsprite.h"
+
+#include "hardware/alloc.h"
+#include "hardware/arena.h"
+
+#define DIGITSPRITE_GLYPH_NUM       ( sizeof( DIGITSPRITE_CHARS ) - 1 )
+
+/**
+ * @brief the glyphs of a font pre-rendered in one colour over black
+ */
+typedef struct {
+    lv_color_t color;
+    uint8_t readouts;                               /** @brief readouts showing this set, only unused sets are rendered over */
+    lv_img_dsc_t glyph[ DIGITSPRITE_GLYPH_NUM ];
+} digitsprite_colorset_t;
+
+typedef struct {
+    const lv_font_t *font;
+    lv_coord_t cell_w;
+    lv_coord_t cell_h;
+    lv_coord_t ink_y;                               /** @brief first row any glyph draws to */
+    lv_coord_t ink_h;                               /** @brief rows between the first and last row any glyph draws to */
+    uint8_t colorsets;
+    digitsprite_colorset_t colorset[ DIGITSPRITE_MAX_COLORS ];
+} digitsprite_font_t;
+
+typedef struct {
+    digitsprite_font_t *sprite_font;
+    digitsprite_colorset_t *colorset;
+    uint8_t cells;
+    uint8_t len;
+    char text[ DIGITSPRITE_MAX_CELLS ];
+    lv_obj_t *cell[ DIGITSPRITE_MAX_CELLS ];
+} digitsprite_ext_t;
+
+static digitsprite_font_t digitsprite_font[ DIGITSPRITE_MAX_FONTS ];
+static int digitsprite_font_num = 0;
+static lv_signal_cb_t digitsprite_ancestor_signal = NULL;
+
+static lv_res_t digitsprite_signal( lv_obj_t *digitsprite, lv_signal_t sign, void *param );
+static void digitsprite_update_color( lv_obj_t *digitsprite );
+static void digitsprite_set_cell( digitsprite_ext_t *ext, int cell );
+static digitsprite_font_t *digitsprite_get_font( const lv_font_t *font );
+static digitsprite_colorset_t *digitsprite_get_colorset( digitsprite_font_t *sprite_font, lv_color_t color );
+static void digitsprite_render_glyph( digitsprite_font_t *sprite_font, uint32_t letter, lv_color_t color, lv_img_dsc_t *glyph );
+
+lv_obj_t *digitsprite_create( lv_obj_t *parent, const lv_font_t *font, uint8_t cells ) {
+    digitsprite_font_t *sprite_font = digitsprite_get_font( font );
+
+    if ( sprite_font == NULL )
+        return( NULL );
+
+    if ( cells > DIGITSPRITE_MAX_CELLS )
+        cells = DIGITSPRITE_MAX_CELLS;
+
+    lv_obj_t *digitsprite = lv_obj_create( parent, NULL );
+    lv_obj_reset_style_list( digitsprite, LV_OBJ_PART_MAIN );
+    lv_obj_set_click( digitsprite, false );
+    lv_obj_set_size( digitsprite, 0, sprite_font->cell_h );
+
+    digitsprite_ext_t *ext = (digitsprite_ext_t *)lv_obj_allocate_ext_attr( digitsprite, sizeof( digitsprite_ext_t ) );
+    if ( ext == NULL ) {
+        log_e("digitsprite ext alloc failed");
+        lv_obj_del( digitsprite );
+        return( NULL );
+    }
+    memset( ext, 0, sizeof( digitsprite_ext_t ) );
+    ext->sprite_font = sprite_font;
+    ext->cells = cells;
+
+    /*
+     * the cells are opaque and already in colour, keep them from inheriting the
+     * image recolor of the readout. that leaves lvgl a straight copy per cell
+     */
+    for ( int cell = 0 ; cell < cells ; cell++ ) {
+        ext->cell[ cell ] = lv_img_create( digitsprite, NULL );
+        lv_obj_reset_style_list( ext->cell[ cell ], LV_IMG_PART_MAIN );
+        lv_obj_set_style_local_image_recolor_opa( ext->cell[ cell ], LV_IMG_PART_MAIN, LV_STATE_DEFAULT, LV_OPA_TRANSP );
+        lv_obj_set_pos( ext->cell[ cell ], cell * sprite_font->cell_w, sprite_font->ink_y );
+        lv_obj_set_hidden( ext->cell[ cell ], true );
+    }
+
+    if ( digitsprite_ancestor_signal == NULL )
+        digitsprite_ancestor_signal = lv_obj_get_signal_cb( digitsprite );
+    lv_obj_set_signal_cb( digitsprite, digitsprite_signal );
+    return( digitsprite );
+}
+
+void digitsprite_set_text( lv_obj_t *digitsprite, const char *text ) {
+    digitsprite_ext_t *ext = (digitsprite_ext_t *)lv_obj_get_ext_attr( digitsprite );
+    uint8_t len = 0;
+
+    if ( ext == NULL || text == NULL )
+        return;
+
+    if ( ext->colorset == NULL )
+        digitsprite_update_color( digitsprite );
+
+    for ( int cell = 0 ; cell < ext->cells ; cell++ ) {
+        char c = text[ len ];
+
+        if ( c != '\0' )
+            len++;
+        if ( c == ext->text[ cell ] )
+            continue;
+        ext->text[ cell ] = c;
+        digitsprite_set_cell( ext, cell );
+    }
+
+    /*
+     * resize only when the number of digits changes, so the caller can keep aligning the readout
+     */
+    if ( len != ext->len ) {
+        ext->len = len;
+        lv_obj_set_width( digitsprite, len * ext->sprite_font->cell_w );
+    }
+}
+
+/**
+ * @brief follow the image recolor of the readout, a bandstyle_set() lands here as style change
+ */
+static lv_res_t digitsprite_signal( lv_obj_t *digitsprite, lv_signal_t sign, void *param ) {
+    lv_res_t res = digitsprite_ancestor_signal( digitsprite, sign, param );
+
+    if ( res != LV_RES_OK )
+        return( res );
+
+    if ( sign == LV_SIGNAL_STYLE_CHG ) {
+        digitsprite_update_color( digitsprite );
+    }
+    else if ( sign == LV_SIGNAL_CLEANUP ) {
+        digitsprite_ext_t *ext = (digitsprite_ext_t *)lv_obj_get_ext_attr( digitsprite );
+        if ( ext && ext->colorset ) {
+            ext->colorset->readouts--;
+            ext->colorset = NULL;
+        }
+    }
+    return( res );
+}
+
+static void digitsprite_update_color( lv_obj_t *digitsprite ) {
+    digitsprite_ext_t *ext = (digitsprite_ext_t *)lv_obj_get_ext_attr( digitsprite );
+
+    if ( ext == NULL || ext->sprite_font == NULL )
+        return;
+
+    lv_color_t color = lv_obj_get_style_image_recolor( digitsprite, LV_OBJ_PART_MAIN );
+    if ( ext->colorset && ext->colorset->color.full == color.full )
+        return;
+
+    digitsprite_colorset_t *colorset = digitsprite_get_colorset( ext->sprite_font, color );
+    if ( colorset == NULL )
+        return;
+
+    if ( ext->colorset )
+        ext->colorset->readouts--;
+    colorset->readouts++;
+    ext->colorset = colorset;
+
+    for ( int cell = 0 ; cell < ext->cells ; cell++ ) {
+        digitsprite_set_cell( ext, cell );
+    }
+}
+
+static void digitsprite_set_cell( digitsprite_ext_t *ext, int cell ) {
+    char c = ext->text[ cell ];
+    const char *glyph = c ? strchr( DIGITSPRITE_CHARS, c ) : NULL;
+
+    if ( glyph == NULL || ext->colorset == NULL ) {
+        lv_obj_set_hidden( ext->cell[ cell ], true );
+    }
+    else {
+        lv_img_set_src( ext->cell[ cell ], &ext->colorset->glyph[ glyph - DIGITSPRITE_CHARS ] );
+        lv_obj_set_hidden( ext->cell[ cell ], false );
+    }
+}
+
+static digitsprite_font_t *digitsprite_get_font( const lv_font_t *font ) {
+    for ( int i = 0 ; i < digitsprite_font_num ; i++ ) {
+        if ( digitsprite_font[ i ].font == font )
+            return( &digitsprite_font[ i ] );
+    }
+
+    if ( digitsprite_font_num >= DIGITSPRITE_MAX_FONTS ) {
+        log_e("no space for another sprite font");
+        return( NULL );
+    }
+
+    digitsprite_font_t *sprite_font = &digitsprite_font[ digitsprite_font_num ];
+    lv_coord_t ink_top = LV_COORD_MAX;
+    lv_coord_t ink_bottom = 0;
+
+    sprite_font->font = font;
+    sprite_font->cell_w = 0;
+    sprite_font->cell_h = lv_font_get_line_height( font );
+    sprite_font->colorsets = 0;
+
+    /*
+     * cells get the width of the widest glyph, but only the rows glyphs draw to are
+     * stored, the rest of the line height stays empty
+     */
+    for ( int i = 0 ; i < DIGITSPRITE_GLYPH_NUM ; i++ ) {
+        lv_font_glyph_dsc_t dsc;
+        if ( !lv_font_get_glyph_dsc( font, &dsc, DIGITSPRITE_CHARS[ i ], 0 ) )
+            continue;
+        if ( dsc.adv_w > sprite_font->cell_w )
+            sprite_font->cell_w = dsc.adv_w;
+        if ( dsc.box_h == 0 )
+            continue;
+        lv_coord_t y_ofs = ( font->line_height - font->base_line ) - dsc.box_h - dsc.ofs_y;
+        ink_top = LV_MATH_MIN( ink_top, y_ofs );
+        ink_bottom = LV_MATH_MAX( ink_bottom, y_ofs + dsc.box_h );
+    }
+    ink_top = LV_MATH_MAX( ink_top, 0 );
+    ink_bottom = LV_MATH_MIN( ink_bottom, sprite_font->cell_h );
+    sprite_font->ink_y = ink_top < ink_bottom ? ink_top : 0;
+    sprite_font->ink_h = ink_top < ink_bottom ? ink_bottom - ink_top : 1;
+
+    digitsprite_font_num++;
+    return( sprite_font );
+}
+
+/**
+ * @brief get the glyphs of a font in a colour, rendered on first use. sets no readout shows
+ * any more are rendered over before new memory is taken
+ */
+static digitsprite_colorset_t *digitsprite_get_colorset( digitsprite_font_t *sprite_font, lv_color_t color ) {
+    digitsprite_colorset_t *colorset = NULL;
+
+    for ( int i = 0 ; i < sprite_font->colorsets ; i++ ) {
+        if ( sprite_font->colorset[ i ].color.full == color.full )
+            return( &sprite_font->colorset[ i ] );
+    }
+
+    if ( sprite_font->colorsets < DIGITSPRITE_MAX_COLORS ) {
+        colorset = &sprite_font->colorset[ sprite_font->colorsets ];
+        size_t size = DIGITSPRITE_GLYPH_NUM * sprite_font->cell_w * sprite_font->ink_h * sizeof( lv_color_t );
+        uint8_t *data = (uint8_t *)arena_alloc( ARENA_BULK, size, "digitsprite" );
+        if ( data == NULL ) {
+            data = (uint8_t *)MALLOC( size );
+        }
+        if ( data == NULL ) {
+            log_e("sprite alloc failed");
+            return( NULL );
+        }
+        for ( int i = 0 ; i < DIGITSPRITE_GLYPH_NUM ; i++ ) {
+            colorset->glyph[ i ].data = &data[ i * size / DIGITSPRITE_GLYPH_NUM ];
+        }
+        colorset->readouts = 0;
+        sprite_font->colorsets++;
+    }
+    else {
+        for ( int i = 0 ; i < sprite_font->colorsets && colorset == NULL ; i++ ) {
+            if ( sprite_font->colorset[ i ].readouts == 0 )
+                colorset = &sprite_font->colorset[ i ];
+        }
+        if ( colorset == NULL ) {
+            log_w("all %d sprite colours in use", DIGITSPRITE_MAX_COLORS );
+            return( NULL );
+        }
+    }
+
+    uint64_t start = esp_timer_get_time();
+    colorset->color = color;
+    for ( int i = 0 ; i < DIGITSPRITE_GLYPH_NUM ; i++ ) {
+        digitsprite_render_glyph( sprite_font, DIGITSPRITE_CHARS[ i ], color, &colorset->glyph[ i ] );
+    }
+    log_i("sprite font %dx%d (%d rows stored), %d bytes per colour, rendered in %lluus", sprite_font->cell_w, sprite_font->cell_h, sprite_font->ink_h,
+                                                                                       DIGITSPRITE_GLYPH_NUM * colorset->glyph[ 0 ].data_size,
+                                                                                       esp_timer_get_time() - start );
+    return( colorset );
+}
+
+static void digitsprite_render_glyph( digitsprite_font_t *sprite_font, uint32_t letter, lv_color_t color, lv_img_dsc_t *glyph ) {
+    const lv_font_t *font = sprite_font->font;
+    uint32_t pixels = sprite_font->cell_w * sprite_font->ink_h;
+    lv_color_t *data = (lv_color_t *)glyph->data;
+    lv_font_glyph_dsc_t dsc;
+
+    for ( uint32_t px = 0 ; px < pixels ; px++ ) {
+        data[ px ] = LV_COLOR_BLACK;
+    }
+
+    glyph->header.always_zero = 0;
+    glyph->header.cf = LV_IMG_CF_TRUE_COLOR;
+    glyph->header.w = sprite_font->cell_w;
+    glyph->header.h = sprite_font->ink_h;
+    glyph->data_size = pixels * sizeof( lv_color_t );
+
+    if ( !lv_font_get_glyph_dsc( font, &dsc, letter, 0 ) )
+        return;
+
+    const uint8_t *bitmap = lv_font_get_glyph_bitmap( font, letter );
+    if ( bitmap == NULL )
+        return;
+
+    if ( dsc.bpp != 1 && dsc.bpp != 2 && dsc.bpp != 4 && dsc.bpp != 8 ) {
+        log_e("unsupported glyph bpp %d", dsc.bpp );
+        return;
+    }
+
+    /*
+     * same placement as lv_draw_letter, centered in the cell. glyph bitmaps are packed
+     * msb first without padding at the end of a row. the coverage blends the colour
+     * over black, what the dash tiles have behind the readouts
+     */
+    lv_coord_t x_ofs = ( sprite_font->cell_w - dsc.adv_w ) / 2 + dsc.ofs_x;
+    lv_coord_t y_ofs = ( font->line_height - font->base_line ) - dsc.box_h - dsc.ofs_y - sprite_font->ink_y;
+    uint8_t mask = ( 1 << dsc.bpp ) - 1;
+
+    for ( int y = 0 ; y < dsc.box_h ; y++ ) {
+        for ( int x = 0 ; x < dsc.box_w ; x++ ) {
+            lv_coord_t px_x = x_ofs + x;
+            lv_coord_t px_y = y_ofs + y;
+            if ( px_x < 0 || px_x >= sprite_font->cell_w || px_y < 0 || px_y >= sprite_font->ink_h )
+                continue;
+
+            uint32_t bit = ( y * dsc.box_w + x ) * dsc.bpp;
+            uint8_t value = ( bitmap[ bit >> 3 ] >> ( 8 - dsc.bpp - ( bit & 7 ) ) ) & mask;
+            if ( value )
+                data[ px_y * sprite_font->cell_w + px_x ] = lv_color_mix( color, LV_COLOR_BLACK, ( value * 255 ) / mask );
+        }
+    }
+}
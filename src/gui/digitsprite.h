@@ -0,0 +1,53 @@
+/****************************************************************************
+ *   Copyright  2020  Jesper Ortlund
+ ****************************************************************************/
+/*
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+#ifndef _DIGITSPRITE_H
+    #define _DIGITSPRITE_H
+
+    #include <TTGO.h>
+
+    #define DIGITSPRITE_CHARS           "0123456789.-"  /** @brief characters pre-rasterized per font */
+    #define DIGITSPRITE_MAX_FONTS       4               /** @brief max number of cached sprite fonts */
+    #define DIGITSPRITE_MAX_CELLS       6               /** @brief max number of digit cells per readout */
+    #define DIGITSPRITE_MAX_COLORS      3               /** @brief max number of colours kept rendered per font, normal, warn and crit */
+
+    /**
+     * @brief create a numeric readout that draws pre-rasterized glyphs instead of going through the font engine
+     *
+     * The glyphs are rendered into opaque RGB565 cells over black in PSRAM, once per font and colour,
+     * so a redraw is a straight copy. The colour is the image_recolor style property of the returned
+     * object, for example a BANDSTYLE_IMAGE bandstyle, a new colour is rendered on its first use.
+     * All cells have the width of the widest glyph. Meant for black backgrounds, a wallpaper does
+     * not show through the cells.
+     *
+     * @param   parent      pointer to the parent lv_obj
+     * @param   font        font to rasterize, DIGITSPRITE_CHARS are taken from it
+     * @param   cells       number of digit cells, max DIGITSPRITE_MAX_CELLS
+     *
+     * @return  pointer to the readout lv_obj or NULL if failed
+     */
+    lv_obj_t *digitsprite_create( lv_obj_t *parent, const lv_font_t *font, uint8_t cells );
+    /**
+     * @brief set the readout text, only cells with a changed character are redrawn
+     *
+     * @param   digitsprite pointer to a readout from digitsprite_create()
+     * @param   text        text to show, characters not in DIGITSPRITE_CHARS show as blank cells
+     */
+    void digitsprite_set_text( lv_obj_t *digitsprite, const char *text );
+
+#endif // _DIGITSPRITE_H
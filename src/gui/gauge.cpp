@@ -0,0 +1,79 @@
+/****************************************************************************
+ *   Copyright  2020  Jesper Ortlund
+ ****************************************************************************/
+/*
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+#include "gauge.h"
+
+static uint16_t gauge_wrap( int32_t angle );
+
+void gauge_init( gauge_geometry_t *gauge, int arcstart, int arcstop, float minvalue, float maxvalue, bool reverse ) {
+    gauge->start = ( ( arcstart % 360 ) + 360 ) % 360;
+    gauge->span = ( ( ( arcstop - arcstart ) % 360 ) + 360 ) % 360;
+    gauge->reverse = reverse;
+    gauge->min = 0;
+    gauge->max = 0;
+    gauge->scale = 0;
+    gauge_set_range( gauge, minvalue, maxvalue );
+}
+
+void gauge_set_range( gauge_geometry_t *gauge, float minvalue, float maxvalue ) {
+    int32_t min = GAUGE_VALUE( minvalue );
+    int32_t max = GAUGE_VALUE( maxvalue );
+
+    if ( min == gauge->min && max == gauge->max && gauge->scale )
+        return;
+
+    gauge->min = min;
+    gauge->max = max;
+    /*
+     * an empty range leaves scale at 0, every value maps to the arc start
+     */
+    if ( max > min )
+        gauge->scale = ( (int32_t)gauge->span << GAUGE_SCALE_SHIFT ) / ( max - min );
+    else
+        gauge->scale = 0;
+}
+
+uint16_t gauge_value2angle( const gauge_geometry_t *gauge, int32_t value ) {
+    if ( value < gauge->min )
+        value = gauge->min;
+    else if ( value > gauge->max )
+        value = gauge->max;
+
+    /*
+     * round to the nearest degree, the truncated scale would never reach the arc end
+     */
+    int32_t offset = ( ( value - gauge->min ) * gauge->scale + ( 1 << ( GAUGE_SCALE_SHIFT - 1 ) ) ) >> GAUGE_SCALE_SHIFT;
+    if ( gauge->reverse )
+        offset = gauge->span - offset;
+
+    return( gauge_wrap( gauge->start + offset ) );
+}
+
+void gauge_marker_angles( const gauge_geometry_t *gauge, int32_t value, uint16_t *start, uint16_t *end ) {
+    *start = gauge_value2angle( gauge, value );
+    *end = gauge_wrap( *start + GAUGE_MARKER_WIDTH );
+}
+
+/*
+ * start + offset and angle + marker width both stay below 720
+ */
+static uint16_t gauge_wrap( int32_t angle ) {
+    if ( angle >= 360 )
+        angle -= 360;
+    return( angle );
+}
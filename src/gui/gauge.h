@@ -0,0 +1,82 @@
+/****************************************************************************
+ *   Copyright  2020  Jesper Ortlund
+ ****************************************************************************/
+/*
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+#ifndef _GAUGE_H
+    #define _GAUGE_H
+
+    /*
+     * no arduino or lvgl in here, the geometry builds and runs on the host
+     */
+    #include <stdint.h>
+
+    #define GAUGE_VALUE_FRAC            16          /** @brief gauge values are kept in 1/16 units */
+    #define GAUGE_SCALE_SHIFT           16          /** @brief degrees per value unit are kept in 16.16 fixed point */
+    #define GAUGE_MARKER_WIDTH          3           /** @brief width of max/min marker bars in degrees */
+    #define GAUGE_VALUE( x )            ( (int32_t)( ( x ) * GAUGE_VALUE_FRAC ) )   /** @brief convert a value to 1/GAUGE_VALUE_FRAC units */
+
+    /**
+     * @brief precomputed geometry of an arc gauge
+     */
+    typedef struct {
+        int16_t start;                              /** @brief arc start angle, 0..359 */
+        int16_t span;                               /** @brief arc length in degrees, wraps over 0 if start + span >= 360 */
+        int32_t min;                                /** @brief min value in 1/GAUGE_VALUE_FRAC units */
+        int32_t max;                                /** @brief max value in 1/GAUGE_VALUE_FRAC units */
+        int32_t scale;                              /** @brief degrees per value unit, 16.16 fixed point */
+        bool reverse;                               /** @brief min value at the arc stop angle */
+    } gauge_geometry_t;
+
+    /**
+     * @brief setup the geometry of an arc gauge
+     *
+     * @param   gauge       pointer to the gauge_geometry_t to fill
+     * @param   arcstart    arc start angle, like lv_arc_set_bg_angles
+     * @param   arcstop     arc stop angle, may be smaller than arcstart when the arc wraps over 0
+     * @param   minvalue    value at the start of the arc
+     * @param   maxvalue    value at the end of the arc
+     * @param   reverse     true if the arc grows from arcstop towards arcstart
+     */
+    void gauge_init( gauge_geometry_t *gauge, int arcstart, int arcstop, float minvalue, float maxvalue, bool reverse );
+    /**
+     * @brief change the value range of a gauge, only recomputes the scale if the range changed
+     *
+     * @param   gauge       pointer to an initialized gauge_geometry_t
+     * @param   minvalue    value at the start of the arc
+     * @param   maxvalue    value at the end of the arc
+     */
+    void gauge_set_range( gauge_geometry_t *gauge, float minvalue, float maxvalue );
+    /**
+     * @brief map a value to an angle on the gauge, values outside the range are clamped to the arc ends
+     *
+     * @param   gauge       pointer to an initialized gauge_geometry_t
+     * @param   value       value to map in 1/GAUGE_VALUE_FRAC units, see GAUGE_VALUE()
+     *
+     * @return  angle 0..359
+     */
+    uint16_t gauge_value2angle( const gauge_geometry_t *gauge, int32_t value );
+    /**
+     * @brief get the angles of a marker bar at a value on the gauge, for lv_arc_set_angles
+     *
+     * @param   gauge       pointer to an initialized gauge_geometry_t
+     * @param   value       value to mark in 1/GAUGE_VALUE_FRAC units, see GAUGE_VALUE()
+     * @param   start       pointer to the marker start angle
+     * @param   end         pointer to the marker end angle, GAUGE_MARKER_WIDTH behind start
+     */
+    void gauge_marker_angles( const gauge_geometry_t *gauge, int32_t value, uint16_t *start, uint16_t *end );
+
+#endif // _GAUGE_H
@@ -0,0 +1,93 @@
+/****************************************************************************
+ *   Copyright  2020  Jesper Ortlund
+ ****************************************************************************/
+/*
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+#include "gaugeanim.h"
+
+static float gaugeanim_clamp( float value, float min, float max );
+
+void gaugeanim_init( gaugeanim_t *anim, float min, float max, float max_rate ) {
+    anim->min = min;
+    anim->max = max;
+    anim->max_rate = max_rate;
+    anim->last = min;
+    anim->last_time = 0;
+    anim->slope = 0;
+    anim->shown = min;
+    anim->shown_time = 0;
+    anim->samples = 0;
+}
+
+void gaugeanim_add_sample( gaugeanim_t *anim, float value, int64_t time ) {
+    if ( anim->samples && time == anim->last_time )
+        return;
+
+    int64_t elapsed = time - anim->last_time;
+    if ( anim->samples && elapsed > 0 && elapsed <= GAUGEANIM_STALE_US ) {
+        float max_slope = anim->max_rate / 1000000.0f;
+        anim->slope = gaugeanim_clamp( ( value - anim->last ) / elapsed, -max_slope, max_slope );
+    }
+    else {
+        anim->slope = 0;
+    }
+
+    anim->last = value;
+    anim->last_time = time;
+    if ( anim->samples < 2 )
+        anim->samples++;
+}
+
+float gaugeanim_get_target( gaugeanim_t *anim, int64_t now ) {
+    int64_t elapsed = now - anim->last_time;
+
+    /*
+     * no slope yet or the wheel went quiet, hold the last sample instead of running away
+     */
+    if ( anim->samples < 2 || elapsed <= 0 || elapsed > GAUGEANIM_STALE_US )
+        return( gaugeanim_clamp( anim->last, anim->min, anim->max ) );
+
+    if ( elapsed > GAUGEANIM_HORIZON_US )
+        elapsed = GAUGEANIM_HORIZON_US;
+
+    return( gaugeanim_clamp( anim->last + anim->slope * elapsed, anim->min, anim->max ) );
+}
+
+float gaugeanim_get_value( gaugeanim_t *anim, int64_t now ) {
+    float target = gaugeanim_get_target( anim, now );
+    int64_t elapsed = now - anim->shown_time;
+
+    /*
+     * first frame or a long pause, e.g. the tile was hidden, start at the target
+     */
+    if ( anim->shown_time == 0 || elapsed <= 0 || elapsed > GAUGEANIM_STALE_US ) {
+        anim->shown = target;
+    }
+    else {
+        anim->shown += ( target - anim->shown ) * elapsed / ( elapsed + GAUGEANIM_TAU_US );
+    }
+    anim->shown_time = now;
+
+    return( anim->shown );
+}
+
+static float gaugeanim_clamp( float value, float min, float max ) {
+    if ( value < min )
+        return( min );
+    if ( value > max )
+        return( max );
+    return( value );
+}
@@ -0,0 +1,85 @@
+/****************************************************************************
+ *   Copyright  2020  Jesper Ortlund
+ ****************************************************************************/
+/*
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+#ifndef _GAUGEANIM_H
+    #define _GAUGEANIM_H
+
+    /*
+     * no arduino or lvgl in here, tools/animerr.py builds this file on the host and replays traces through it
+     */
+    #include <stdint.h>
+
+    #define GAUGEANIM_FRAME_MS          33          /** @brief animation task period, about what the spi display keeps up with for small areas */
+    #define GAUGEANIM_HORIZON_US        150000      /** @brief extrapolate at most this far past the last sample, covers ble jitter */
+    #define GAUGEANIM_STALE_US          1000000     /** @brief samples further apart than this don't give a usable slope */
+    #define GAUGEANIM_TAU_US            50000       /** @brief time constant the shown value follows the target with */
+
+    /**
+     * @brief animation state of one gauge value
+     */
+    typedef struct {
+        float min;                                  /** @brief lowest value ever shown */
+        float max;                                  /** @brief highest value ever shown */
+        float max_rate;                             /** @brief max slope in units per second, caps extrapolation of noisy samples */
+        float last;                                 /** @brief newest sample */
+        int64_t last_time;                          /** @brief newest sample time in us */
+        float slope;                                /** @brief units per us between the two newest samples */
+        float shown;                                /** @brief value returned by the last gaugeanim_get_value */
+        int64_t shown_time;                         /** @brief time of the last gaugeanim_get_value in us */
+        uint32_t samples;                           /** @brief samples taken, saturates at 2 */
+    } gaugeanim_t;
+
+    /**
+     * @brief setup the animation state of a gauge value
+     *
+     * @param   anim        pointer to the gaugeanim_t to setup
+     * @param   min         lowest value to show
+     * @param   max         highest value to show
+     * @param   max_rate    max plausible change in units per second
+     */
+    void gaugeanim_init( gaugeanim_t *anim, float min, float max, float max_rate );
+    /**
+     * @brief add a timestamped sample, a sample with the time of the newest one is ignored
+     * so the caller can hand in the current wheel data on every frame
+     *
+     * @param   anim        pointer to an initialized gaugeanim_t
+     * @param   value       sample value
+     * @param   time        sample time in us, when the frame was decoded
+     */
+    void gaugeanim_add_sample( gaugeanim_t *anim, float value, int64_t time );
+    /**
+     * @brief get the value to show at a given time, the newest sample extrapolated by up to
+     * GAUGEANIM_HORIZON_US and smoothed over GAUGEANIM_TAU_US so corrections don't jump
+     *
+     * @param   anim        pointer to an initialized gaugeanim_t
+     * @param   now         current time in us
+     *
+     * @return  value to show
+     */
+    float gaugeanim_get_value( gaugeanim_t *anim, int64_t now );
+    /**
+     * @brief get the value to show without smoothing, the newest sample when nothing was sampled yet
+     *
+     * @param   anim        pointer to an initialized gaugeanim_t
+     * @param   now         current time in us
+     *
+     * @return  extrapolated value, clamped to min..max
+     */
+    float gaugeanim_get_target( gaugeanim_t *anim, int64_t now );
+
+#endif // _GAUGEANIM_H
@@ -48,11 +48,16 @@
 
 #include "hardware/powermgm.h"
 #include "hardware/display.h"
+#include "hardware/bma.h"
+#include "hardware/metrics.h"
+#include "hardware/alarmctl.h"
 
 lv_obj_t *img_bin;
 
 bool gui_powermgm_event_cb( EventBits_t event, void *arg );
 bool gui_powermgm_loop_event_cb( EventBits_t event, void *arg );
+bool gui_bma_event_cb( EventBits_t event, void *arg );
+bool gui_alarmctl_event_cb( EventBits_t event, void *arg );
 
 void gui_setup( void )
 {
@@ -90,6 +95,46 @@ void gui_setup( void )
 
     powermgm_register_cb( POWERMGM_STANDBY | POWERMGM_WAKEUP | POWERMGM_SILENCE_WAKEUP, gui_powermgm_event_cb, "gui" );
     powermgm_register_loop_cb( POWERMGM_WAKEUP | POWERMGM_SILENCE_WAKEUP, gui_powermgm_loop_event_cb, "gui loop" );
+    bma_register_cb( BMACTL_SHAKE, gui_bma_event_cb, "gui shake" );
+    alarmctl_register_cb( ALARMCTL_ON, gui_alarmctl_event_cb, "gui alarm" );
+}
+
+bool gui_alarmctl_event_cb( EventBits_t event, void *arg ) {
+    alarm_rule_t *rule = (alarm_rule_t*)arg;
+
+    switch ( event ) {
+        case ALARMCTL_ON:               if ( !( rule->actions & ALARM_RULE_JUMP ) )
+                                            break;
+                                        /*
+                                         * leave the rider on the dash tile they picked, only bring back one of them
+                                         */
+                                        if ( mainbar_get_current_tile() != fulldash_get_tile() && mainbar_get_current_tile() != simpledash_get_tile() ) {
+                                            mainbar_jump_to_maintile( LV_ANIM_OFF );
+                                        }
+                                        lv_disp_trig_activity( NULL );
+                                        break;
+    }
+    return( true );
+}
+
+bool gui_bma_event_cb( EventBits_t event, void *arg ) {
+    switch ( event ) {
+        case BMACTL_SHAKE:              if ( !powermgm_get_event( POWERMGM_WAKEUP ) )
+                                            break;
+                                        /*
+                                         * a shake flips between the two dash tiles while riding
+                                         */
+                                        if ( mainbar_get_current_tile() == fulldash_get_tile() ) {
+                                            mainbar_jump_to_tilenumber( simpledash_get_tile(), LV_ANIM_OFF );
+                                            lv_disp_trig_activity( NULL );
+                                        }
+                                        else if ( mainbar_get_current_tile() == simpledash_get_tile() ) {
+                                            mainbar_jump_to_tilenumber( fulldash_get_tile(), LV_ANIM_OFF );
+                                            lv_disp_trig_activity( NULL );
+                                        }
+                                        break;
+    }
+    return( true );
 }
 
 bool gui_powermgm_event_cb( EventBits_t event, void *arg ) {
@@ -167,7 +212,9 @@ void gui_set_background_image ( uint32_t background_image ) {
 bool gui_powermgm_loop_event_cb( EventBits_t event, void *arg ) {
     switch ( event ) {
         case POWERMGM_WAKEUP:           if ( lv_disp_get_inactive_time( NULL ) < display_get_timeout() * 1000 || display_get_timeout() == DISPLAY_MAX_TIMEOUT ) {
+                                            int64_t start = esp_timer_get_time();
                                             lv_task_handler();
+                                            metrics_sample_since( METRICS_RENDER_US, start );
                                             if(LV_EVENT_VALUE_CHANGED) {
                                                // mainbar_tilevent_action();
                                             }
@@ -177,7 +224,9 @@ bool gui_powermgm_loop_event_cb( EventBits_t event, void *arg ) {
                                         }
                                         break;
         case POWERMGM_SILENCE_WAKEUP:   if ( lv_disp_get_inactive_time( NULL ) < display_get_timeout() * 1000 ) {
+                                            int64_t start = esp_timer_get_time();
                                             lv_task_handler();
+                                            metrics_sample_since( METRICS_RENDER_US, start );
                                         }
                                         else {
                                             powermgm_set_event( POWERMGM_STANDBY_REQUEST );
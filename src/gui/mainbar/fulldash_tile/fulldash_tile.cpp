@@ -20,22 +20,32 @@
 #include "config.h"
 #include <Arduino.h>
 #include "gui/mainbar/mainbar.h"
+#include "gui/bandstyle.h"
+#include "gui/gauge.h"
+#include "gui/digitsprite.h"
+#include "gui/gaugeanim.h"
 #include "fulldash_tile.h"
 #include "hardware/pmu.h"
 #include "hardware/blectl.h"
 #include "hardware/Kingsong.h"
 #include "hardware/dashboard.h"
 #include "hardware/wheelctl.h"
+#include "hardware/alarmctl.h"
 #include "hardware/motor.h"
+#include "hardware/callback.h"
 
 //task declarations
 lv_task_t *dash_task = nullptr;
 lv_task_t *time_task = nullptr;
+lv_task_t *anim_task = nullptr;
+static uint32_t dash_refresh = 250;
 
 // Function declarations
 static void lv_dash_task(lv_task_t *dash_task);
 static void lv_time_task(lv_task_t *time_task);
+static void lv_anim_task(lv_task_t *anim_task);
 static void overlay_event_cb(lv_obj_t * obj, lv_event_t event);
+static void lv_marker_update(gauge_geometry_t *gauge, lv_obj_t *marker, float value);
 
 void updateTime();
 void stop_time_task();
@@ -111,6 +121,36 @@ static lv_style_t alert_style;
 static lv_obj_t *overlay_bar = NULL;
 static lv_obj_t *overlay_line = NULL;
 static lv_style_t overlay_style;
+static lv_style_t overlay_connected_style;
+static bool overlay_connected = false;
+
+//Gauge geometry for the max/min marker bars
+static gauge_geometry_t speed_gauge;
+static gauge_geometry_t batt_gauge;
+static gauge_geometry_t current_gauge;
+static gauge_geometry_t temp_gauge;
+
+//Speed arc values are in 1/SPEED_ARC_STEPS km/h so the animation moves smoothly
+#define SPEED_ARC_STEPS 10
+static gaugeanim_t speed_anim;
+
+//Colour band styles, built once and swapped only when a gauge changes band
+static bandstyle_t speed_indic_band;
+static bandstyle_t speed_label_band;
+static bandstyle_t batt_indic_band;
+static bandstyle_t batt_label_band;
+static bandstyle_t current_indic_band;
+static bandstyle_t current_label_band;
+static bandstyle_t temp_indic_band;
+static bandstyle_t temp_label_band;
+static bandstyle_slot_t speed_indic_slot;
+static bandstyle_slot_t speed_label_slot;
+static bandstyle_slot_t batt_indic_slot;
+static bandstyle_slot_t batt_label_slot;
+static bandstyle_slot_t current_indic_slot;
+static bandstyle_slot_t current_label_slot;
+static bandstyle_slot_t temp_indic_slot;
+static bandstyle_slot_t temp_label_slot;
 
 //End LV objects and styles
 
@@ -163,8 +203,10 @@ void lv_define_styles_1(void)
     lv_style_set_line_color(&speed_main_style, LV_STATE_DEFAULT, speed_bg_clr);
 
     lv_style_init(&speed_label_style);
-    lv_style_set_text_color(&speed_label_style, LV_STATE_DEFAULT, speed_bg_clr);
-    lv_style_set_text_font(&speed_label_style, LV_STATE_DEFAULT, &DIN1451_m_cond_120);
+    lv_style_set_image_recolor(&speed_label_style, LV_STATE_DEFAULT, speed_bg_clr);
+    lv_style_set_image_recolor_opa(&speed_label_style, LV_STATE_DEFAULT, LV_OPA_COVER);
+    bandstyle_init(&speed_indic_band, &speed_indic_style, BANDSTYLE_LINE, speed_fg_clr, LV_COLOR_YELLOW, LV_COLOR_RED, speed_fg_clr);
+    bandstyle_init(&speed_label_band, &speed_label_style, BANDSTYLE_IMAGE, speed_fg_clr, LV_COLOR_YELLOW, LV_COLOR_RED, speed_fg_clr);
 
     // Battery Arc and label
     lv_style_copy(&batt_indic_style, &arc_style);
@@ -172,7 +214,8 @@ void lv_define_styles_1(void)
     lv_style_set_line_color(&batt_main_style, LV_STATE_DEFAULT, batt_bg_clr);
 
     lv_style_init(&batt_label_style);
-    lv_style_set_text_font(&batt_label_style, LV_STATE_DEFAULT, &DIN1451_m_cond_66);
+    bandstyle_init(&batt_indic_band, &batt_indic_style, BANDSTYLE_LINE, batt_fg_clr, LV_COLOR_YELLOW, LV_COLOR_RED, batt_fg_clr);
+    bandstyle_init(&batt_label_band, &batt_label_style, BANDSTYLE_IMAGE, batt_fg_clr, LV_COLOR_YELLOW, LV_COLOR_RED, batt_fg_clr);
 
     // Current Arc and label
     lv_style_copy(&current_indic_style, &arc_style);
@@ -181,6 +224,8 @@ void lv_define_styles_1(void)
 
     lv_style_init(&current_label_style);
     lv_style_set_text_font(&current_label_style, LV_STATE_DEFAULT, &DIN1451_m_cond_44);
+    bandstyle_init(&current_indic_band, &current_indic_style, BANDSTYLE_LINE, current_fg_clr, LV_COLOR_YELLOW, LV_COLOR_RED, speed_fg_clr);
+    bandstyle_init(&current_label_band, &current_label_style, BANDSTYLE_TEXT, current_fg_clr, LV_COLOR_YELLOW, LV_COLOR_RED, speed_fg_clr);
 
     // Temperature Arc
     lv_style_copy(&temp_indic_style, &arc_style);
@@ -189,6 +234,8 @@ void lv_define_styles_1(void)
 
     lv_style_init(&temp_label_style);
     lv_style_set_text_font(&temp_label_style, LV_STATE_DEFAULT, &DIN1451_m_cond_44);
+    bandstyle_init(&temp_indic_band, &temp_indic_style, BANDSTYLE_LINE, temp_fg_clr, LV_COLOR_YELLOW, LV_COLOR_RED, temp_fg_clr);
+    bandstyle_init(&temp_label_band, &temp_label_style, BANDSTYLE_TEXT, temp_fg_clr, LV_COLOR_YELLOW, LV_COLOR_RED, temp_fg_clr);
 
     //Bar background -- transparent
     lv_style_copy(&bar_main_style, &arc_style);
@@ -224,6 +271,9 @@ void lv_define_styles_1(void)
     lv_style_set_line_width(&overlay_style, LV_STATE_DEFAULT, 20);
     lv_style_set_line_opa(&overlay_style, LV_STATE_DEFAULT, LV_OPA_20);
     lv_style_set_bg_opa(&overlay_style, LV_STATE_DEFAULT, LV_OPA_20);
+    lv_style_copy(&overlay_connected_style, &overlay_style);
+    lv_style_set_line_opa(&overlay_connected_style, LV_STATE_DEFAULT, LV_OPA_TRANSP);
+    lv_style_set_bg_opa(&overlay_connected_style, LV_STATE_DEFAULT, LV_OPA_TRANSP);
 
 } //End Define LVGL default object styles
 
@@ -238,13 +288,15 @@ void lv_speed_arc_1(void)
 
     speed_arc = lv_arc_create(fulldash_cont, NULL);
     lv_obj_reset_style_list(speed_arc, LV_OBJ_PART_MAIN);
-    lv_obj_add_style(speed_arc, LV_ARC_PART_INDIC, &speed_indic_style);
+    bandstyle_attach(&speed_indic_slot, speed_arc, LV_ARC_PART_INDIC, &speed_indic_band);
     lv_obj_add_style(speed_arc, LV_OBJ_PART_MAIN, &speed_main_style);
     lv_arc_set_bg_angles(speed_arc, speed_arc_start, speed_arc_end);
-    lv_arc_set_range(speed_arc, 0, tiltback_speed + 5);
-    lv_arc_set_value(speed_arc, current_speed);
+    lv_arc_set_range(speed_arc, 0, (tiltback_speed + 5) * SPEED_ARC_STEPS);
+    lv_arc_set_value(speed_arc, current_speed * SPEED_ARC_STEPS);
     lv_obj_set_size(speed_arc, out_arc_x, out_arc_y);
     lv_obj_align(speed_arc, NULL, LV_ALIGN_CENTER, 0, 0);
+    gauge_init(&speed_gauge, speed_arc_start, speed_arc_end, 0, tiltback_speed + 5, false);
+    gaugeanim_init(&speed_anim, 0, 100, 40);
 
     //Max bar
     speed_max_bar = lv_arc_create(fulldash_cont, NULL);
@@ -267,10 +319,9 @@ void lv_speed_arc_1(void)
     lv_obj_align(speed_avg_bar, NULL, LV_ALIGN_CENTER, 0, 0);
 
     //Label
-    speed_label = lv_label_create(fulldash_cont, NULL);
-    lv_obj_reset_style_list(speed_label, LV_OBJ_PART_MAIN);
+    speed_label = digitsprite_create(fulldash_cont, &DIN1451_m_cond_120, 3);
 
-    lv_obj_add_style(speed_label, LV_LABEL_PART_MAIN, &speed_label_style);
+    bandstyle_attach(&speed_label_slot, speed_label, LV_OBJ_PART_MAIN, &speed_label_band);
     char speedstring[4];
     if (current_speed > 10)
     {
@@ -280,8 +331,7 @@ void lv_speed_arc_1(void)
     {
         dtostrf(current_speed, 1, 0, speedstring);
     }
-    lv_label_set_text(speed_label, speedstring);
-    lv_label_set_align(speed_label, LV_LABEL_ALIGN_CENTER);
+    digitsprite_set_text(speed_label, speedstring);
     lv_obj_align(speed_label, speed_arc, LV_ALIGN_CENTER, 0, -5);
     mainbar_add_slide_element(speed_label);
 }
@@ -293,7 +343,7 @@ void lv_batt_arc_1(void)
     //Arc
     batt_arc = lv_arc_create(fulldash_cont, NULL);
     lv_obj_reset_style_list(batt_arc, LV_OBJ_PART_MAIN);
-    lv_obj_add_style(batt_arc, LV_ARC_PART_INDIC, &batt_indic_style);
+    bandstyle_attach(&batt_indic_slot, batt_arc, LV_ARC_PART_INDIC, &batt_indic_band);
     lv_obj_add_style(batt_arc, LV_OBJ_PART_MAIN, &batt_main_style);
     lv_arc_set_type(batt_arc, LV_ARC_TYPE_REVERSE);
     lv_arc_set_bg_angles(batt_arc, batt_arc_start, batt_arc_end);
@@ -301,6 +351,7 @@ void lv_batt_arc_1(void)
     lv_arc_set_range(batt_arc, 0, 100);
     lv_obj_set_size(batt_arc, out_arc_x, out_arc_y);
     lv_obj_align(batt_arc, NULL, LV_ALIGN_CENTER, 0, 0);
+    gauge_init(&batt_gauge, batt_arc_start, batt_arc_end, 0, 100, rev_batt_arc);
 
     //max bar
     batt_max_bar = lv_arc_create(fulldash_cont, NULL);
@@ -324,13 +375,11 @@ void lv_batt_arc_1(void)
 
     //Label
 
-    batt_label = lv_label_create(fulldash_cont, NULL);
-    lv_obj_reset_style_list(batt_label, LV_OBJ_PART_MAIN);
-    lv_obj_add_style(batt_label, LV_OBJ_PART_MAIN, &batt_label_style);
+    batt_label = digitsprite_create(fulldash_cont, &DIN1451_m_cond_66, 3);
+    bandstyle_attach(&batt_label_slot, batt_label, LV_OBJ_PART_MAIN, &batt_label_band);
     char battstring[4];
     dtostrf(wheelctl_get_data(WHEELCTL_BATTPCT), 2, 0, battstring);
-    lv_label_set_text(batt_label, battstring);
-    lv_label_set_align(batt_label, LV_LABEL_ALIGN_CENTER);
+    digitsprite_set_text(batt_label, battstring);
     lv_obj_align(batt_label, batt_arc, LV_ALIGN_CENTER, 0, 75);
 }
 
@@ -343,13 +392,14 @@ void lv_current_arc_1(void)
     //Arc
     current_arc = lv_arc_create(fulldash_cont, NULL);
     lv_obj_reset_style_list(current_arc, LV_OBJ_PART_MAIN);
-    lv_obj_add_style(current_arc, LV_ARC_PART_INDIC, &current_indic_style);
+    bandstyle_attach(&current_indic_slot, current_arc, LV_ARC_PART_INDIC, &current_indic_band);
     lv_obj_add_style(current_arc, LV_OBJ_PART_MAIN, &current_main_style);
     lv_arc_set_bg_angles(current_arc, current_arc_start, current_arc_end);
     lv_arc_set_angles(current_arc, current_arc_start, current_arc_end);
     lv_arc_set_range(current_arc, 0, maxcurrent);
     lv_obj_set_size(current_arc, in_arc_x, in_arc_y);
     lv_obj_align(current_arc, NULL, LV_ALIGN_CENTER, 0, 0);
+    gauge_init(&current_gauge, current_arc_start, current_arc_end, 0, maxcurrent, rev_current_arc);
 
     //Max bar
     current_max_bar = lv_arc_create(fulldash_cont, NULL);
@@ -374,7 +424,7 @@ void lv_current_arc_1(void)
     //Label
     current_label = lv_label_create(fulldash_cont, NULL);
     lv_obj_reset_style_list(current_label, LV_OBJ_PART_MAIN);
-    lv_obj_add_style(current_label, LV_OBJ_PART_MAIN, &current_label_style);
+    bandstyle_attach(&current_label_slot, current_label, LV_OBJ_PART_MAIN, &current_label_band);
     char currentstring[4];
     dtostrf(current_current, 2, 0, currentstring);
     lv_label_set_text(current_label, currentstring);
@@ -390,7 +440,7 @@ void lv_temp_arc_1(void)
     //Arc
     temp_arc = lv_arc_create(fulldash_cont, NULL);
     lv_obj_reset_style_list(temp_arc, LV_OBJ_PART_MAIN);
-    lv_obj_add_style(temp_arc, LV_ARC_PART_INDIC, &temp_indic_style);
+    bandstyle_attach(&temp_indic_slot, temp_arc, LV_ARC_PART_INDIC, &temp_indic_band);
     lv_obj_add_style(temp_arc, LV_OBJ_PART_MAIN, &temp_main_style);
     lv_arc_set_type(temp_arc, LV_ARC_TYPE_REVERSE);
     lv_arc_set_bg_angles(temp_arc, temp_arc_start, temp_arc_end);
@@ -399,6 +449,7 @@ void lv_temp_arc_1(void)
     lv_arc_set_value(temp_arc, ((crit_temp + 10) - current_temp));
     lv_obj_set_size(temp_arc, in_arc_x, in_arc_y);
     lv_obj_align(temp_arc, NULL, LV_ALIGN_CENTER, 0, 0);
+    gauge_init(&temp_gauge, temp_arc_start, temp_arc_end, 0, (crit_temp + 10), true);
     mainbar_add_slide_element(temp_arc);
 
     //Max bar
@@ -415,7 +466,7 @@ void lv_temp_arc_1(void)
     //Label
     temp_label = lv_label_create(fulldash_cont, NULL);
     lv_obj_reset_style_list(temp_label, LV_OBJ_PART_MAIN);
-    lv_obj_add_style(temp_label, LV_OBJ_PART_MAIN, &temp_label_style);
+    bandstyle_attach(&temp_label_slot, temp_label, LV_OBJ_PART_MAIN, &temp_label_band);
     char tempstring[4];
     dtostrf(current_temp, 2, 0, tempstring);
     lv_label_set_text(temp_label, tempstring);
@@ -474,6 +525,7 @@ void lv_overlay(void)
     lv_obj_reset_style_list(overlay_bar, LV_OBJ_PART_MAIN);
     lv_obj_set_size(overlay_bar, lv_disp_get_hor_res(NULL), lv_disp_get_ver_res(NULL));
     lv_obj_add_style(overlay_bar, LV_OBJ_PART_MAIN, &overlay_style);
+    overlay_connected = false;
     lv_obj_align(overlay_bar, NULL, LV_ALIGN_CENTER, 0, 0);
     mainbar_add_slide_element(overlay_bar);
     lv_obj_set_event_cb( overlay_bar, overlay_event_cb );
@@ -488,6 +540,14 @@ void lv_overlay(void)
 
 } //End Create Dashboard objects
 
+static void lv_marker_update(gauge_geometry_t *gauge, lv_obj_t *marker, float value)
+{
+    uint16_t start, end;
+
+    gauge_marker_angles(gauge, GAUGE_VALUE(value), &start, &end);
+    lv_arc_set_angles(marker, start, end);
+}
+
 static void overlay_event_cb(lv_obj_t * obj, lv_event_t event) {
     switch( event ) {
         case( LV_EVENT_LONG_PRESSED ):  Serial.println("long press on overlay");
@@ -495,37 +555,6 @@ static void overlay_event_cb(lv_obj_t * obj, lv_event_t event) {
     }
 }
 
-int value2angle(int arcstart, int arcstop, float minvalue, float maxvalue, float arcvalue, bool reverse)
-{
-    int rAngle;
-    int arcdegrees;
-    if (arcstop < arcstart)
-    {
-        arcdegrees = (arcstop + 360) - arcstart;
-    }
-    else
-    {
-        arcdegrees = arcstop - arcstart;
-    }
-    if (reverse)
-    {
-        rAngle = arcstop - (arcvalue * arcdegrees / (maxvalue - minvalue));
-    }
-    else
-    {
-        rAngle = arcstart + (arcvalue * arcdegrees / (maxvalue - minvalue));
-    }
-    if (rAngle >= 360)
-    {
-        rAngle = rAngle - 360;
-    }
-    else if (rAngle < 0)
-    {
-        rAngle = rAngle + 360;
-    }
-    return rAngle;
-}
-
 /***************************************************************
    Dashboard GUI Update Functions, called via the task handler
    runs every 250ms
@@ -534,48 +563,33 @@ int value2angle(int arcstart, int arcstop, float minvalue, float maxvalue, float
 static void lv_speed_update(void)
 {
     float tiltback_speed = wheelctl_get_data(WHEELCTL_TILTBACK);
-    float current_speed = wheelctl_get_data(WHEELCTL_SPEED);
-    float warn_speed = wheelctl_get_data(WHEELCTL_ALARM3);
-    float top_speed = wheelctl_get_data(WHEELCTL_TOPSPEED);
-    if (top_speed < tiltback_speed + 5) top_speed = tiltback_speed + 5;
 
-    if (current_speed >= tiltback_speed)
-    {
-        lv_style_set_line_color(&speed_indic_style, LV_STATE_DEFAULT, LV_COLOR_RED);
-        lv_style_set_text_color(&speed_label_style, LV_STATE_DEFAULT, LV_COLOR_RED);
-    }
-    else if (current_speed >= warn_speed)
-    {
-        lv_style_set_line_color(&speed_indic_style, LV_STATE_DEFAULT, LV_COLOR_YELLOW);
-        lv_style_set_text_color(&speed_label_style, LV_STATE_DEFAULT, LV_COLOR_YELLOW);
-    }
-    else
-    {
-        lv_style_set_line_color(&speed_indic_style, LV_STATE_DEFAULT, speed_fg_clr);
-        lv_style_set_text_color(&speed_label_style, LV_STATE_DEFAULT, speed_fg_clr);
-    }
+    lv_arc_set_range(speed_arc, 0, (tiltback_speed + 5) * SPEED_ARC_STEPS);
 
-    lv_obj_add_style(speed_arc, LV_ARC_PART_INDIC, &speed_indic_style);
-    lv_arc_set_range(speed_arc, 0, (tiltback_speed + 5));
-    lv_arc_set_value(speed_arc, current_speed);
+    gauge_set_range(&speed_gauge, 0, (tiltback_speed + 5));
+    lv_marker_update(&speed_gauge, speed_max_bar, wheelctl_get_data(WHEELCTL_TOPSPEED));
+    lv_marker_update(&speed_gauge, speed_avg_bar, wheelctl_get_min_data(WHEELCTL_SPEED));
+}
 
-    int ang_max = value2angle(speed_arc_start, speed_arc_end, 0, (tiltback_speed + 5), wheelctl_get_data(WHEELCTL_TOPSPEED), false);
-    int ang_max2 = ang_max + 3;
-    if (ang_max2 >= 360)
-    {
-        ang_max2 = ang_max2 - 360;
-    }
-    lv_arc_set_angles(speed_max_bar, ang_max, ang_max2);
+/*
+ * runs every animation frame, arc and label only invalidate what changed,
+ * so frames between two wheel samples cost a few arc degrees or one digit
+ */
+static void lv_speed_anim_update(void)
+{
+    float sample;
+    int64_t sample_time;
 
-    int ang_avg = value2angle(speed_arc_start, speed_arc_end, 0, (tiltback_speed + 5), wheelctl_get_min_data(WHEELCTL_SPEED), false);
-    int ang_avg2 = ang_avg + 3;
-    if (ang_avg2 >= 360)
-    {
-        ang_avg2 = ang_avg2 - 360;
-    }
-    lv_arc_set_angles(speed_avg_bar, ang_avg, ang_avg2);
+    wheelctl_get_sample(WHEELCTL_SPEED, &sample, &sample_time);
+    gaugeanim_add_sample(&speed_anim, sample, sample_time);
+    float current_speed = gaugeanim_get_value(&speed_anim, esp_timer_get_time());
+
+    int band = alarmctl_get_band(WHEELCTL_SPEED);
+    bandstyle_set(&speed_indic_slot, band);
+    bandstyle_set(&speed_label_slot, band);
+
+    lv_arc_set_value(speed_arc, current_speed * SPEED_ARC_STEPS);
 
-    lv_obj_add_style(speed_label, LV_LABEL_PART_MAIN, &speed_label_style);
     float converted_speed = current_speed;
     if (dashboard_get_config(DASHBOARD_IMPDIST))
     {
@@ -590,8 +604,7 @@ static void lv_speed_update(void)
     {
         dtostrf(converted_speed, 1, 0, speedstring);
     }
-    lv_label_set_text(speed_label, speedstring);
-    lv_label_set_align(speed_label, LV_LABEL_ALIGN_CENTER);
+    digitsprite_set_text(speed_label, speedstring);
     lv_obj_align(speed_label, fulldash_cont, LV_ALIGN_CENTER, 0, -3);
 }
 
@@ -599,44 +612,17 @@ void lv_batt_update(void)
 {
     float current_battpct = wheelctl_get_data(WHEELCTL_BATTPCT);
 
-    if (current_battpct < 10)
-    {
-        lv_style_set_line_color(&batt_indic_style, LV_STATE_DEFAULT, LV_COLOR_RED);
-        lv_style_set_text_color(&batt_label_style, LV_STATE_DEFAULT, LV_COLOR_RED);
-    }
-    else if (current_battpct < wheelctl_get_constant(WHEELCTL_CONST_BATTWARN))
-    {
-        lv_style_set_line_color(&batt_indic_style, LV_STATE_DEFAULT, LV_COLOR_YELLOW);
-        lv_style_set_text_color(&batt_label_style, LV_STATE_DEFAULT, LV_COLOR_YELLOW);
-    }
-    else
-    {
-        lv_style_set_line_color(&batt_indic_style, LV_STATE_DEFAULT, batt_fg_clr);
-        lv_style_set_text_color(&batt_label_style, LV_STATE_DEFAULT, batt_fg_clr);
-    }
-    lv_obj_add_style(batt_arc, LV_ARC_PART_INDIC, &batt_indic_style);
+    int band = alarmctl_get_band(WHEELCTL_BATTPCT);
+    bandstyle_set(&batt_indic_slot, band);
+    bandstyle_set(&batt_label_slot, band);
 
     // draw batt arc
 
     lv_arc_set_value(batt_arc, (100 - current_battpct));
 
-    int ang_max = value2angle(batt_arc_start, batt_arc_end, 0, 100, wheelctl_get_max_data(WHEELCTL_BATTPCT), rev_batt_arc);
-    int ang_max2 = ang_max + 3;
-    if (ang_max2 >= 360)
-    {
-        ang_max2 = ang_max2 - 360;
-    }
-    lv_arc_set_angles(batt_max_bar, ang_max, ang_max2);
-
-    int ang_min = value2angle(batt_arc_start, batt_arc_end, 0, 100, wheelctl_get_min_data(WHEELCTL_BATTPCT), rev_batt_arc);
-    int ang_min2 = ang_min + 3;
-    if (ang_min2 >= 360)
-    {
-        ang_min2 = ang_min2 - 360;
-    }
-    lv_arc_set_angles(batt_min_bar, ang_min, ang_min2);
+    lv_marker_update(&batt_gauge, batt_max_bar, wheelctl_get_max_data(WHEELCTL_BATTPCT));
+    lv_marker_update(&batt_gauge, batt_min_bar, wheelctl_get_min_data(WHEELCTL_BATTPCT));
 
-    lv_obj_add_style(batt_label, LV_OBJ_PART_MAIN, &batt_label_style);
     char battstring[4];
     if (current_battpct > 10)
     {
@@ -646,8 +632,7 @@ void lv_batt_update(void)
     {
         dtostrf(current_battpct, 1, 0, battstring);
     }
-    lv_label_set_text(batt_label, battstring);
-    lv_label_set_align(batt_label, LV_LABEL_ALIGN_CENTER);
+    digitsprite_set_text(batt_label, battstring);
     lv_obj_align(batt_label, fulldash_cont, LV_ALIGN_CENTER, 0, 75);
 }
 
@@ -658,48 +643,20 @@ void lv_current_update(void)
     float current_current = wheelctl_get_data(WHEELCTL_CURRENT);
     float amps = current_current;
     
-    if (current_current > (maxcurrent * 0.75))
+    int band = alarmctl_get_band(WHEELCTL_CURRENT);
+    if (current_current < 0)
     {
-        lv_style_set_line_color(&current_indic_style, LV_STATE_DEFAULT, LV_COLOR_RED);
-        lv_style_set_text_color(&current_label_style, LV_STATE_DEFAULT, LV_COLOR_RED);
-    }
-    else if (current_current > (maxcurrent * 0.5))
-    {
-        lv_style_set_line_color(&current_indic_style, LV_STATE_DEFAULT, LV_COLOR_YELLOW);
-        lv_style_set_text_color(&current_label_style, LV_STATE_DEFAULT, LV_COLOR_YELLOW);
-    }
-    else if (current_current < 0)
-    {
-        lv_style_set_line_color(&current_indic_style, LV_STATE_DEFAULT, speed_fg_clr);
-        lv_style_set_text_color(&current_label_style, LV_STATE_DEFAULT, speed_fg_clr);
         amps = (current_current * -1);
     }
-    else
-    {
-        lv_style_set_line_color(&current_indic_style, LV_STATE_DEFAULT, current_fg_clr);
-        lv_style_set_text_color(&current_label_style, LV_STATE_DEFAULT, current_fg_clr);
-    }
-    lv_obj_add_style(current_arc, LV_ARC_PART_INDIC, &current_indic_style);
+    bandstyle_set(&current_indic_slot, band);
+    bandstyle_set(&current_label_slot, band);
 
     lv_arc_set_value(current_arc, amps);
 
-    int ang_max = value2angle(current_arc_start, current_arc_end, 0, maxcurrent, wheelctl_get_max_data(WHEELCTL_CURRENT), rev_current_arc);
-    int ang_max2 = ang_max + 3;
-    if (ang_max2 >= 360)
-    {
-        ang_max2 = ang_max2 - 360;
-    }
-    lv_arc_set_angles(current_max_bar, ang_max, ang_max2);
+    gauge_set_range(&current_gauge, 0, maxcurrent);
+    lv_marker_update(&current_gauge, current_max_bar, wheelctl_get_max_data(WHEELCTL_CURRENT));
+    lv_marker_update(&current_gauge, current_regen_bar, -wheelctl_get_min_data(WHEELCTL_CURRENT));
 
-    int ang_regen = value2angle(current_arc_start, current_arc_end, 0, maxcurrent, wheelctl_get_min_data(WHEELCTL_CURRENT), rev_current_arc);
-    int ang_regen2 = ang_regen + 3;
-    if (ang_regen2 >= 360)
-    {
-        ang_regen2 = ang_regen2 - 360;
-    }
-    lv_arc_set_angles(current_regen_bar, ang_regen, ang_regen2);
-
-    lv_obj_add_style(current_label, LV_OBJ_PART_MAIN, &current_label_style);
     char currentstring[4];
     dtostrf(current_current, 2, 0, currentstring);
     lv_label_set_text(current_label, currentstring);
@@ -712,33 +669,14 @@ void lv_temp_update(void)
     byte crit_temp = wheelctl_get_constant(WHEELCTL_CONST_CRITTEMP);
     float current_temp = wheelctl_get_data(WHEELCTL_TEMP);
     // Set warning and alert colour
-    if (current_temp > crit_temp)
-    {
-        lv_style_set_line_color(&temp_indic_style, LV_STATE_DEFAULT, LV_COLOR_RED);
-        lv_style_set_text_color(&temp_label_style, LV_STATE_DEFAULT, LV_COLOR_RED);
-    }
-    else if (current_temp > wheelctl_get_constant(WHEELCTL_CONST_WARNTEMP))
-    {
-        lv_style_set_line_color(&temp_indic_style, LV_STATE_DEFAULT, LV_COLOR_YELLOW);
-        lv_style_set_text_color(&temp_label_style, LV_STATE_DEFAULT, LV_COLOR_YELLOW);
-    }
-    else
-    {
-        lv_style_set_line_color(&temp_indic_style, LV_STATE_DEFAULT, temp_fg_clr);
-        lv_style_set_text_color(&temp_label_style, LV_STATE_DEFAULT, temp_fg_clr);
-    }
-    lv_obj_add_style(temp_arc, LV_ARC_PART_INDIC, &temp_indic_style);
+    int band = alarmctl_get_band(WHEELCTL_TEMP);
+    bandstyle_set(&temp_indic_slot, band);
+    bandstyle_set(&temp_label_slot, band);
     lv_arc_set_value(temp_arc, ((crit_temp + 10) - current_temp));
 
-    int ang_max = value2angle(temp_arc_start, temp_arc_end, 0, (crit_temp + 10), wheelctl_get_max_data(WHEELCTL_TEMP), true);
-    int ang_max2 = ang_max + 3;
-    if (ang_max2 >= 360)
-    {
-        ang_max2 = ang_max2 - 360;
-    }
-    lv_arc_set_angles(temp_max_bar, ang_max, ang_max2);
+    gauge_set_range(&temp_gauge, 0, (crit_temp + 10));
+    lv_marker_update(&temp_gauge, temp_max_bar, wheelctl_get_max_data(WHEELCTL_TEMP));
 
-    lv_obj_add_style(temp_label, LV_OBJ_PART_MAIN, &temp_label_style);
     char tempstring[4];
     float converted_temp = current_temp;
     if (dashboard_get_config(DASHBOARD_IMPTEMP))
@@ -753,20 +691,26 @@ void lv_temp_update(void)
 
 void lv_overlay_update()
 {
-    if (blectl_cli_getconnected())
+    bool connected = blectl_cli_getconnected();
+    if (connected == overlay_connected)
     {
-        lv_style_set_line_opa(&overlay_style, LV_STATE_DEFAULT, LV_OPA_TRANSP);
-        lv_style_set_bg_opa(&overlay_style, LV_STATE_DEFAULT, LV_OPA_TRANSP);
-        lv_obj_add_style(overlay_bar, LV_OBJ_PART_MAIN, &overlay_style);
-        lv_obj_add_style(overlay_line, LV_OBJ_PART_MAIN, &overlay_style);
+        return;
+    }
+    if (connected)
+    {
+        lv_obj_remove_style(overlay_bar, LV_OBJ_PART_MAIN, &overlay_style);
+        lv_obj_remove_style(overlay_line, LV_OBJ_PART_MAIN, &overlay_style);
+        lv_obj_add_style(overlay_bar, LV_OBJ_PART_MAIN, &overlay_connected_style);
+        lv_obj_add_style(overlay_line, LV_OBJ_PART_MAIN, &overlay_connected_style);
     }
     else
     {
-        lv_style_set_line_opa(&overlay_style, LV_STATE_DEFAULT, LV_OPA_20);
-        lv_style_set_bg_opa(&overlay_style, LV_STATE_DEFAULT, LV_OPA_20);
+        lv_obj_remove_style(overlay_bar, LV_OBJ_PART_MAIN, &overlay_connected_style);
+        lv_obj_remove_style(overlay_line, LV_OBJ_PART_MAIN, &overlay_connected_style);
         lv_obj_add_style(overlay_bar, LV_OBJ_PART_MAIN, &overlay_style);
         lv_obj_add_style(overlay_line, LV_OBJ_PART_MAIN, &overlay_style);
     }
+    overlay_connected = connected;
 }
 
 void updateTime()
@@ -832,6 +776,14 @@ static void lv_time_task(lv_task_t *time_task)
     updateTime();
 }
 
+static void lv_anim_task(lv_task_t *anim_task)
+{
+    if (blectl_cli_getconnected())
+    {
+        lv_speed_anim_update();
+    }
+}
+
 void stop_dash_task()
 {
     Serial.println("check if dash is running");
@@ -839,11 +791,18 @@ void stop_dash_task()
     {
         Serial.println("shutting down dash");
         lv_task_del(dash_task);
+        dash_task = nullptr;
     }
     if (time_task != nullptr)
     {
         Serial.println("shutting down dashclock");
         lv_task_del(time_task);
+        time_task = nullptr;
+    }
+    if (anim_task != nullptr)
+    {
+        lv_task_del(anim_task);
+        anim_task = nullptr;
     }
 }
 
@@ -856,14 +815,27 @@ void fulldash_activate_cb(void)
 {
     time_task = lv_task_create(lv_time_task, 2000, LV_TASK_PRIO_LOWEST, NULL);
     lv_task_ready(time_task);
-    dash_task = lv_task_create(lv_dash_task, 250, LV_TASK_PRIO_LOWEST, NULL);
+    dash_task = callback_lv_task_create(lv_dash_task, dash_refresh, LV_TASK_PRIO_LOWEST, "dash task");
     lv_task_ready(dash_task);
+    anim_task = callback_lv_task_create(lv_anim_task, GAUGEANIM_FRAME_MS, LV_TASK_PRIO_LOWEST, "anim task");
+    lv_task_ready(anim_task);
 }
 
 void fulldash_hibernate_cb(void)
 {
     lv_task_del(time_task);
     lv_task_del(dash_task);
+    lv_task_del(anim_task);
+    time_task = nullptr;
+    dash_task = nullptr;
+    anim_task = nullptr;
+}
+
+void fulldash_set_refresh(uint32_t ms)
+{
+    dash_refresh = ms;
+    if (dash_task != nullptr)
+        lv_task_set_period(dash_task, ms);
 }
 
 void fulldash_tile_reload(void)
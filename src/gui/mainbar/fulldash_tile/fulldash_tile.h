@@ -93,6 +93,12 @@ void fulldash_tile_reload ( void );
      * @return  tile number
      */
 uint32_t fulldash_get_tile (void);
+/**
+     * @brief set the gauge update period, takes effect at once if the tile is shown
+     *
+     * @param   ms      update period in ms, 250 by default
+     */
+void fulldash_set_refresh (uint32_t ms);
 
 //variable declarations
 // extern struct Wheel_constants wheelconst;
@@ -55,6 +55,13 @@ static uint32_t tile_entrys = 0;
 static uint32_t app_tile_pos = MAINBAR_APP_TILE_X_START;
 uint32_t main_tile_nr = 0;
 bool fulldash_default = true;
+static lv_task_t *mainbar_release_task = NULL;
+
+static void mainbar_activate_tile( uint32_t tile_number );
+static void mainbar_hibernate_tile( uint32_t tile_number );
+static void mainbar_create_tile( uint32_t tile_number );
+static void mainbar_release_task_cb( lv_task_t *task );
+static uint32_t mainbar_get_mem_used( void );
 
 void mainbar_setup( void ) {
     lv_style_init( &mainbar_style );
@@ -97,6 +104,7 @@ void mainbar_setup( void ) {
 
     lv_obj_set_event_cb( mainbar, mainbar_event_cb );
 
+    mainbar_release_task = lv_task_create( mainbar_release_task_cb, 1000, LV_TASK_PRIO_LOWEST, NULL );
 }
 
 uint32_t mainbar_add_tile( uint16_t x, uint16_t y, const char *id ) {
@@ -141,6 +149,11 @@ uint32_t mainbar_add_tile( uint16_t x, uint16_t y, const char *id ) {
     tile[ tile_entrys - 1 ].tile = my_tile;
     tile[ tile_entrys - 1 ].activate_cb = NULL;
     tile[ tile_entrys - 1 ].hibernate_cb = NULL;
+    tile[ tile_entrys - 1 ].create_cb = NULL;
+    tile[ tile_entrys - 1 ].release_timeout = 0;
+    tile[ tile_entrys - 1 ].hibernate_time = 0;
+    tile[ tile_entrys - 1 ].mem_used = 0;
+    tile[ tile_entrys - 1 ].created = true;
     tile[ tile_entrys - 1 ].x = x;
     tile[ tile_entrys - 1 ].y = y;
     tile[ tile_entrys - 1 ].id = id;
@@ -179,20 +192,104 @@ void mainbar_event_cb(lv_obj_t * obj, lv_event_t event) {
     if(event == LV_EVENT_VALUE_CHANGED)
     { 
         uint32_t tile_number = *((uint32_t *)lv_event_get_data ());
-        // call hibernate callback for the old tile if exist
-        if ( tile[ current_tile ].hibernate_cb != NULL ) {
-            log_i("call hibernate cb for tile: %d", current_tile );
-            tile[ current_tile ].hibernate_cb();
-        }
-        // call activate callback for the new tile if exist
-        if ( tile[ tile_number ].activate_cb != NULL ) { 
-            log_i("call activate cb for tile: %d", tile_number );
-            tile[ tile_number ].activate_cb();
-        }
+        mainbar_hibernate_tile( current_tile );
+        mainbar_activate_tile( tile_number );
         current_tile = tile_number;
     }
 }
 
+static void mainbar_hibernate_tile( uint32_t tile_number ) {
+    // call hibernate callback for the old tile if exist
+    if ( tile[ tile_number ].hibernate_cb != NULL ) {
+        log_i("call hibernate cb for tile: %d", tile_number );
+        tile[ tile_number ].hibernate_cb();
+    }
+    tile[ tile_number ].hibernate_time = millis();
+}
+
+static void mainbar_activate_tile( uint32_t tile_number ) {
+    mainbar_create_tile( tile_number );
+    // call activate callback for the new tile if exist
+    if ( tile[ tile_number ].activate_cb != NULL ) { 
+        log_i("call activate cb for tile: %d", tile_number );
+        tile[ tile_number ].activate_cb();
+    }
+}
+
+static void mainbar_create_tile( uint32_t tile_number ) {
+    if ( tile[ tile_number ].created || tile[ tile_number ].create_cb == NULL )
+        return;
+
+    uint32_t mem_before = mainbar_get_mem_used();
+    tile[ tile_number ].create_cb();
+    tile[ tile_number ].created = true;
+    tile[ tile_number ].mem_used = mainbar_get_mem_used() - mem_before;
+    log_i("create tile: %d (%s), lvgl mem %d bytes", tile_number, tile[ tile_number ].id, tile[ tile_number ].mem_used );
+}
+
+static void mainbar_release_task_cb( lv_task_t *task ) {
+    for ( uint32_t tile_number = 0 ; tile_number < tile_entrys ; tile_number++ ) {
+        if ( tile_number == current_tile || !tile[ tile_number ].created || tile[ tile_number ].create_cb == NULL || tile[ tile_number ].release_timeout == 0 )
+            continue;
+        if ( millis() - tile[ tile_number ].hibernate_time < tile[ tile_number ].release_timeout )
+            continue;
+
+        uint32_t mem_before = mainbar_get_mem_used();
+        lv_obj_clean( tile[ tile_number ].tile );
+        tile[ tile_number ].created = false;
+        tile[ tile_number ].mem_used = 0;
+        log_i("release tile: %d (%s), lvgl mem %d bytes freed", tile_number, tile[ tile_number ].id, mem_before - mainbar_get_mem_used() );
+    }
+}
+
+static uint32_t mainbar_get_mem_used( void ) {
+#if LV_MEM_CUSTOM == 0
+    lv_mem_monitor_t mon;
+    lv_mem_monitor( &mon );
+    return( mon.total_size - mon.free_size );
+#else
+    /*
+     * lvgl uses the system heap, take the heap usage as best guess
+     */
+    return( heap_caps_get_total_size( MALLOC_CAP_8BIT ) - heap_caps_get_free_size( MALLOC_CAP_8BIT ) );
+#endif
+}
+
+bool mainbar_add_tile_create_cb( uint32_t tile_number, MAINBAR_CALLBACK_FUNC create_cb, uint32_t release_timeout ) {
+    if ( tile_number < tile_entrys ) {
+        tile[ tile_number ].create_cb = create_cb;
+        tile[ tile_number ].release_timeout = release_timeout;
+        tile[ tile_number ].created = false;
+        return( true );
+    }
+    else {
+        log_e("tile number %d do not exist", tile_number );
+        return( false );
+    }
+}
+
+uint32_t mainbar_get_tile_count( void ) {
+    return( tile_entrys );
+}
+
+uint32_t mainbar_get_current_tile( void ) {
+    return( current_tile );
+}
+
+const char *mainbar_get_tile_id( uint32_t tile_number ) {
+    if ( tile_number < tile_entrys ) {
+        return( tile[ tile_number ].id );
+    }
+    return( NULL );
+}
+
+uint32_t mainbar_get_tile_mem( uint32_t tile_number ) {
+    if ( tile_number < tile_entrys ) {
+        return( tile[ tile_number ].mem_used );
+    }
+    return( 0 );
+}
+
 bool mainbar_add_tile_hibernate_cb( uint32_t tile_number, MAINBAR_CALLBACK_FUNC hibernate_cb ) {
     if ( tile_number < tile_entrys ) {
         tile[ tile_number ].hibernate_cb = hibernate_cb;
@@ -267,17 +364,11 @@ void mainbar_jump_to_maintile( lv_anim_enable_t anim ) {
 void mainbar_jump_to_tilenumber( uint32_t tile_number, lv_anim_enable_t anim ) {
     if ( tile_number < tile_entrys ) {
         log_i("jump to tile %d from tile %d", tile_number, current_tile );
+        // build a lazy tile before it becomes visible
+        mainbar_create_tile( tile_number );
         lv_tileview_set_tile_act( mainbar, tile_pos_table[ tile_number ].x, tile_pos_table[ tile_number ].y, anim );
-        // call hibernate callback for the current tile if exist
-        if ( tile[ current_tile ].hibernate_cb != NULL ) {
-            log_i("call hibernate cb for tile: %d", current_tile );
-            tile[ current_tile ].hibernate_cb();
-        }
-        // call activate callback for the new tile if exist
-        if ( tile[ tile_number ].activate_cb != NULL ) { 
-            log_i("call activate cb for tile: %d", tile_number );
-            tile[ tile_number ].activate_cb();
-        }
+        mainbar_hibernate_tile( current_tile );
+        mainbar_activate_tile( tile_number );
         current_tile = tile_number;
     }
     else {
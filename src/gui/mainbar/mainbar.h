@@ -30,6 +30,11 @@
         lv_obj_t *tile;
         MAINBAR_CALLBACK_FUNC activate_cb;
         MAINBAR_CALLBACK_FUNC hibernate_cb;
+        MAINBAR_CALLBACK_FUNC create_cb;        /** @brief builds the tile content on first activation, NULL for eager tiles */
+        uint32_t release_timeout;               /** @brief ms in hibernation before the content is deleted, 0 keeps it */
+        uint32_t hibernate_time;                /** @brief millis() when the tile was left */
+        uint32_t mem_used;                      /** @brief lvgl memory used by the tile content */
+        bool created;                           /** @brief true if the tile content exist */
         uint16_t x;
         uint16_t y;
         const char *id;
@@ -37,6 +42,7 @@
 
     #define MAINBAR_APP_TILE_X_START     0
     #define MAINBAR_APP_TILE_Y_START     4
+    #define MAINBAR_TILE_RELEASE_TIMEOUT 60000  /** @brief default ms a lazy tile is kept after hibernation */
 
     static lv_color_t mainbar_text_colour = lv_color_make(0x5B, 0x9B, 0xD5); //(lighter blue) a9d18e
     static lv_color_t mainbar_switch_colour = lv_color_make(0xA9, 0xD1, 0x8E); // (light green)
@@ -117,6 +123,48 @@
      * @return  true or false, true means registration was success
      */
     bool mainbar_add_tile_activate_cb( uint32_t tile_number, MAINBAR_CALLBACK_FUNC activate_cb );
+    /**
+     * @brief register a create callback that builds the tile content on first activation.
+     * the tile object itself stays as placeholder, after release_timeout ms in hibernation
+     * all children are deleted and create_cb is called again on the next activation.
+     * only use it for tiles that are entered by jump and keep no object pointers outside
+     * the tile content
+     *
+     * @param   tile_number     tile number
+     * @param   create_cb       pointer to the create callback function
+     * @param   release_timeout ms before a hibernated tile is released, 0 means never release
+     *
+     * @return  true or false, true means registration was success
+     */
+    bool mainbar_add_tile_create_cb( uint32_t tile_number, MAINBAR_CALLBACK_FUNC create_cb, uint32_t release_timeout );
+    /**
+     * @brief get the number of tiles
+     *
+     * @return  number of tiles
+     */
+    uint32_t mainbar_get_tile_count( void );
+    /**
+     * @brief get the tile number of the visible tile
+     *
+     * @return  tile number
+     */
+    uint32_t mainbar_get_current_tile( void );
+    /**
+     * @brief get the id of a tile
+     *
+     * @param   tile_number     tile number
+     *
+     * @return  tile id or NULL if the tile do not exist
+     */
+    const char *mainbar_get_tile_id( uint32_t tile_number );
+    /**
+     * @brief get the lvgl memory used by a lazy tile, measured with lv_mem_monitor on creation
+     *
+     * @param   tile_number     tile number
+     *
+     * @return  bytes, 0 if the tile is not created or not lazy
+     */
+    uint32_t mainbar_get_tile_mem( uint32_t tile_number );
     /**
      * @brief get main tile style
      * 
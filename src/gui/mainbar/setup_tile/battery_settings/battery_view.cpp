@@ -178,10 +178,12 @@ void battery_view_tile_setup( uint32_t tile_num ) {
 }
 
 void battery_activate_cb( void ) {
+    pmu_set_detailed_telemetry( true );
     battery_view_task = lv_task_create(battery_view_update_task, 1000,  LV_TASK_PRIO_LOWEST, NULL );
 }
 
 void battery_hibernate_cb( void ) {
+    pmu_set_detailed_telemetry( false );
     lv_task_del( battery_view_task );
 }
 
@@ -39,6 +39,7 @@ lv_obj_t *bluetooth_enable_onoff = NULL;
 lv_obj_t *bluetooth_standby_onoff = NULL;
 lv_obj_t *bluetooth_advertising_onoff = NULL;
 lv_obj_t *txpower_list = NULL;
+lv_obj_t *bluetooth_relay_onoff = NULL;
 
 LV_IMG_DECLARE(exit_32px);
 LV_IMG_DECLARE(bluetooth_64px);
@@ -50,6 +51,7 @@ bool blectl_onoff_event_cb( EventBits_t event, void *arg );
 static void bluetooth_enable_onoff_event_handler(lv_obj_t * obj, lv_event_t event);
 static void bluetooth_standby_onoff_event_handler(lv_obj_t * obj, lv_event_t event);
 static void bluetooth_txpower_event_handler(lv_obj_t * obj, lv_event_t event);
+static void bluetooth_relay_onoff_event_handler(lv_obj_t * obj, lv_event_t event);
 
 void bluetooth_settings_tile_setup( void ) {
     // get an app tile and copy mainstyle
@@ -129,6 +131,22 @@ void bluetooth_settings_tile_setup( void ) {
     lv_obj_align( txpower_list, txpower_cont, LV_ALIGN_IN_RIGHT_MID, -5, 0);
     lv_obj_set_event_cb( txpower_list, bluetooth_txpower_event_handler );
 
+    lv_obj_t *bluetooth_relay_cont = lv_obj_create( bluetooth_settings_tile, NULL );
+    lv_obj_set_size( bluetooth_relay_cont, lv_disp_get_hor_res( NULL ) , 40);
+    lv_obj_add_style( bluetooth_relay_cont, LV_OBJ_PART_MAIN, &bluetooth_settings_style  );
+    lv_obj_align( bluetooth_relay_cont, txpower_cont, LV_ALIGN_OUT_BOTTOM_MID, 0, 0 );
+    bluetooth_relay_onoff = lv_switch_create( bluetooth_relay_cont, NULL );
+    lv_obj_add_protect( bluetooth_relay_onoff, LV_PROTECT_CLICK_FOCUS);
+    lv_obj_add_style( bluetooth_relay_onoff, LV_SWITCH_PART_INDIC, mainbar_get_switch_style() );
+    lv_obj_add_style( bluetooth_relay_onoff, LV_SWITCH_PART_KNOB, mainbar_get_knob_style() );
+    lv_switch_off( bluetooth_relay_onoff, LV_ANIM_ON );
+    lv_obj_align( bluetooth_relay_onoff, bluetooth_relay_cont, LV_ALIGN_IN_RIGHT_MID, -5, 0 );
+    lv_obj_set_event_cb( bluetooth_relay_onoff, bluetooth_relay_onoff_event_handler );
+    lv_obj_t *bluetooth_relay_label = lv_label_create( bluetooth_relay_cont, NULL);
+    lv_obj_add_style( bluetooth_relay_label, LV_OBJ_PART_MAIN, &bluetooth_settings_style  );
+    lv_label_set_text( bluetooth_relay_label, "relay to phone");
+    lv_obj_align( bluetooth_relay_label, bluetooth_relay_cont, LV_ALIGN_IN_LEFT_MID, 5, 0 );
+
     if ( blectl_get_autoon() ) {
         lv_switch_on( bluetooth_enable_onoff, LV_ANIM_OFF );
     }
@@ -146,6 +164,13 @@ void bluetooth_settings_tile_setup( void ) {
 
     lv_dropdown_set_selected( txpower_list, blectl_get_txpower() );
 
+    if ( blectl_get_relay() ) {
+        lv_switch_on( bluetooth_relay_onoff, LV_ANIM_OFF );
+    }
+    else {
+        lv_switch_off( bluetooth_relay_onoff, LV_ANIM_OFF );
+    }
+
 
     blectl_register_cb( BLECTL_ON | BLECTL_OFF, blectl_onoff_event_cb, "bluetooth settings");
 }
@@ -199,4 +224,11 @@ static void bluetooth_txpower_event_handler(lv_obj_t * obj, lv_event_t event) {
         case ( LV_EVENT_VALUE_CHANGED): blectl_set_txpower( lv_dropdown_get_selected( obj ) );
                                         break;
     }
-}
\ No newline at end of file
+}
+
+static void bluetooth_relay_onoff_event_handler(lv_obj_t * obj, lv_event_t event) {
+    switch( event ) {
+        case ( LV_EVENT_VALUE_CHANGED): blectl_set_relay( lv_switch_get_state( obj ) );
+                                        break;
+    }
+}
@@ -46,6 +46,7 @@ LV_IMG_DECLARE(dashboard_64px);
 
 static void enter_dashboard_setup_event_cb( lv_obj_t * obj, lv_event_t event );
 static void exit_dashboard_setup_event_cb( lv_obj_t * obj, lv_event_t event );
+static void dashboard_settings_tile_create( void );
 static void lights_onoff_event_handler(lv_obj_t * obj, lv_event_t event);
 static void simple_onoff_event_handler(lv_obj_t * obj, lv_event_t event);
 static void current_onoff_event_handler(lv_obj_t * obj, lv_event_t event);
@@ -73,6 +74,10 @@ void dashboard_settings_tile_setup( void ) {
     icon_t *dashboard_setup_icon = setup_register( "dashboard", &dashboard_64px, enter_dashboard_setup_event_cb );
     setup_hide_indicator( dashboard_setup_icon );
 
+    mainbar_add_tile_create_cb( dashboard_tile_num, dashboard_settings_tile_create, MAINBAR_TILE_RELEASE_TIMEOUT );
+}
+
+static void dashboard_settings_tile_create( void ) {
     lv_obj_t *exit_btn = lv_imgbtn_create( dashboard_settings_tile, NULL);
     lv_imgbtn_set_src( exit_btn, LV_BTN_STATE_RELEASED, &exit_32px);
     lv_imgbtn_set_src( exit_btn, LV_BTN_STATE_PRESSED, &exit_32px);
@@ -0,0 +1,247 @@
+/****************************************************************************
+ *   Copyright  2020  Jesper Ortlund
+ ****************************************************************************/
+/*
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+#include "config.h"
+#include <Arduino.h>
+#include "diagnostics.h"
+
+#include "gui/mainbar/mainbar.h"
+
+#include "hardware/bootctl.h"
+#include "hardware/alloc.h"
+#include "hardware/metrics.h"
+#include "hardware/callback.h"
+#include "hardware/arena.h"
+#include "hardware/wheelctl.h"
+#include "hardware/Kingsong.h"
+
+#define DIAGNOSTICS_LINE_LEN    48
+#define DIAGNOSTICS_MAX_LINES   128
+#define DIAGNOSTICS_REFRESH     1000
+
+lv_obj_t *diagnostics_tile = NULL;
+lv_obj_t *diagnostics_page = NULL;
+lv_obj_t *diagnostics_label = NULL;
+lv_style_t diagnostics_style;
+uint32_t diagnostics_tile_num;
+static uint32_t diagnostics_return_tile;
+static lv_task_t *diagnostics_refresh_task = NULL;
+
+LV_IMG_DECLARE(exit_32px);
+
+static void exit_diagnostics_event_cb( lv_obj_t * obj, lv_event_t event );
+static void diagnostics_tile_create( void );
+static void diagnostics_activate_cb( void );
+static void diagnostics_hibernate_cb( void );
+static void diagnostics_refresh_task_cb( lv_task_t *task );
+static void diagnostics_update( void );
+static void diagnostics_append( char *text, size_t *len, const char *format, ... );
+
+void diagnostics_tile_setup( uint32_t return_tile ) {
+    diagnostics_return_tile = return_tile;
+
+    // get an app tile and copy mainstyle
+    diagnostics_tile_num = mainbar_add_app_tile( 1, 1, "Diagnostics" );
+    diagnostics_tile = mainbar_get_tile_obj( diagnostics_tile_num );
+    lv_style_copy( &diagnostics_style, mainbar_get_style() );
+    lv_style_set_bg_color( &diagnostics_style, LV_OBJ_PART_MAIN, LV_COLOR_BLACK);
+    lv_style_set_bg_opa( &diagnostics_style, LV_OBJ_PART_MAIN, LV_OPA_100);
+    lv_style_set_border_width( &diagnostics_style, LV_OBJ_PART_MAIN, 0);
+    lv_obj_add_style( diagnostics_tile, LV_OBJ_PART_MAIN, &diagnostics_style );
+
+    mainbar_add_tile_create_cb( diagnostics_tile_num, diagnostics_tile_create, MAINBAR_TILE_RELEASE_TIMEOUT );
+    mainbar_add_tile_activate_cb( diagnostics_tile_num, diagnostics_activate_cb );
+    mainbar_add_tile_hibernate_cb( diagnostics_tile_num, diagnostics_hibernate_cb );
+}
+
+static void diagnostics_tile_create( void ) {
+    lv_obj_t *exit_btn = lv_imgbtn_create( diagnostics_tile, NULL);
+    lv_imgbtn_set_src( exit_btn, LV_BTN_STATE_RELEASED, &exit_32px);
+    lv_imgbtn_set_src( exit_btn, LV_BTN_STATE_PRESSED, &exit_32px);
+    lv_imgbtn_set_src( exit_btn, LV_BTN_STATE_CHECKED_RELEASED, &exit_32px);
+    lv_imgbtn_set_src( exit_btn, LV_BTN_STATE_CHECKED_PRESSED, &exit_32px);
+    lv_obj_add_style( exit_btn, LV_IMGBTN_PART_MAIN, &diagnostics_style );
+    lv_obj_align( exit_btn, diagnostics_tile, LV_ALIGN_IN_TOP_LEFT, 10, 10 );
+    lv_obj_set_event_cb( exit_btn, exit_diagnostics_event_cb );
+
+    lv_obj_t *exit_label = lv_label_create( diagnostics_tile, NULL);
+    lv_obj_add_style( exit_label, LV_OBJ_PART_MAIN, &diagnostics_style  );
+    lv_label_set_text( exit_label, "Diagnostics");
+    lv_obj_align( exit_label, exit_btn, LV_ALIGN_OUT_RIGHT_MID, 5, 0 );
+
+    diagnostics_page = lv_page_create( diagnostics_tile, NULL );
+    lv_obj_set_size( diagnostics_page, lv_disp_get_hor_res( NULL ) - 10, lv_disp_get_ver_res( NULL ) - 60 );
+    lv_obj_add_style( diagnostics_page, LV_OBJ_PART_MAIN, &diagnostics_style );
+    lv_page_set_scrlbar_mode( diagnostics_page, LV_SCRLBAR_MODE_AUTO );
+    lv_obj_align( diagnostics_page, diagnostics_tile, LV_ALIGN_IN_BOTTOM_MID, 0, -5 );
+
+    diagnostics_label = lv_label_create( diagnostics_page, NULL );
+    lv_obj_add_style( diagnostics_label, LV_OBJ_PART_MAIN, &diagnostics_style );
+    lv_label_set_long_mode( diagnostics_label, LV_LABEL_LONG_BREAK );
+    lv_obj_set_width( diagnostics_label, lv_page_get_width_fit( diagnostics_page ) );
+    lv_label_set_text( diagnostics_label, "" );
+}
+
+uint32_t diagnostics_get_tile_num( void ) {
+    return( diagnostics_tile_num );
+}
+
+static void diagnostics_activate_cb( void ) {
+    diagnostics_update();
+    if ( diagnostics_refresh_task == NULL )
+        diagnostics_refresh_task = callback_lv_task_create( diagnostics_refresh_task_cb, DIAGNOSTICS_REFRESH, LV_TASK_PRIO_LOWEST, "diagnostics task" );
+}
+
+static void diagnostics_hibernate_cb( void ) {
+    if ( diagnostics_refresh_task ) {
+        lv_task_del( diagnostics_refresh_task );
+        diagnostics_refresh_task = NULL;
+    }
+}
+
+static void diagnostics_refresh_task_cb( lv_task_t *task ) {
+    diagnostics_update();
+}
+
+static void diagnostics_update( void ) {
+    char *text = (char *)MALLOC( DIAGNOSTICS_LINE_LEN * DIAGNOSTICS_MAX_LINES );
+    size_t len = 0;
+
+    if ( text == NULL ) {
+        log_e("diagnostics text alloc failed");
+        return;
+    }
+
+    /*
+     * what a rider waits for after switching on, the full phase list is further down
+     */
+    int64_t setup_done = bootctl_get_time( BOOTCTL_MARK_SETUP_DONE );
+    int64_t first_frame = bootctl_get_time( BOOTCTL_MARK_FIRST_FRAME );
+    diagnostics_append( text, &len, "boot [ms after power on]\n" );
+    diagnostics_append( text, &len, "setup done: %lld\n", setup_done / 1000 );
+    if ( first_frame < 0 )
+        diagnostics_append( text, &len, "first wheel frame: -\n" );
+    else
+        diagnostics_append( text, &len, "first wheel frame: %lld\n", first_frame / 1000 );
+
+    /*
+     * name and serial stay empty until the wheel answered the requests from initks()
+     */
+    diagnostics_append( text, &len, "\nwheel\n" );
+    diagnostics_append( text, &len, "name: %s\n", *ks_get_name() ? ks_get_name() : "-" );
+    diagnostics_append( text, &len, "serial: %s\n", *ks_get_serial() ? ks_get_serial() : "-" );
+    diagnostics_append( text, &len, "max speed: %d km/h\n", wheelctl_get_constant( WHEELCTL_CONST_MAXSPEED ) );
+    diagnostics_append( text, &len, "max current: %d A\n", wheelctl_get_constant( WHEELCTL_CONST_MAXCURRENT ) );
+    diagnostics_append( text, &len, "batt: %d V, warn %d%%\n", wheelctl_get_constant( WHEELCTL_CONST_BATTVOLT ), wheelctl_get_constant( WHEELCTL_CONST_BATTWARN ) );
+
+    diagnostics_append( text, &len, "\nmetrics\n" );
+    for ( int counter = 0 ; counter < METRICS_COUNTER_NUM ; counter++ ) {
+        diagnostics_append( text, &len, "%s: %u\n", metrics_get_counter_name( counter ), metrics_counter[ counter ] );
+    }
+    for ( int gauge = 0 ; gauge < METRICS_GAUGE_NUM ; gauge++ ) {
+        diagnostics_append( text, &len, "%s: %d\n", metrics_get_gauge_name( gauge ), metrics_gauge[ gauge ] );
+    }
+    diagnostics_append( text, &len, "\nlatency p50/p99/max [us]\n" );
+    for ( int hist = 0 ; hist < METRICS_HIST_NUM ; hist++ ) {
+        diagnostics_append( text, &len, "%s: %u/%u/%u\n", metrics_get_histogram_name( hist ),
+                                                         metrics_get_percentile( hist, 50 ),
+                                                         metrics_get_percentile( hist, 99 ),
+                                                         metrics_histogram[ hist ].max );
+    }
+
+    diagnostics_append( text, &len, "\narenas used/reserved, frag\n" );
+    for ( int arena = 0 ; arena < ARENA_NUM ; arena++ ) {
+        uint32_t reserved, used;
+        arena_get_usage( arena, &reserved, &used );
+        diagnostics_append( text, &len, "%s: %u/%u, %u%%\n", arena_get( arena )->name, used, reserved, arena_get_fragmentation( arena ) );
+    }
+    for ( uint32_t pool = 0 ; pool < arena_get_pool_num() ; pool++ ) {
+        const arena_pool_t *arena_pool = arena_get_pool( pool );
+        diagnostics_append( text, &len, "%s: %u/%u, hw %u\n", arena_pool->name, arena_pool->in_use, arena_pool->blocks, arena_pool->high_water );
+    }
+
+    /*
+     * only callbacks that ran at least once, most of the event ones never do
+     */
+    diagnostics_append( text, &len, "\ncallbacks p50/p99/max [us]\n" );
+    for ( callback_t *callback = callback_get_first() ; callback ; callback = callback->next_callback_t ) {
+        for ( int entry = 0 ; entry < callback->entrys ; entry++ ) {
+            metrics_histogram_t *duration = &callback->table[ entry ].duration;
+            if ( duration->count ) {
+                diagnostics_append( text, &len, "%s: %u/%u/%u\n", callback->table[ entry ].id,
+                                                                 metrics_histogram_percentile( duration, 50 ),
+                                                                 metrics_histogram_percentile( duration, 99 ),
+                                                                 duration->max );
+            }
+        }
+    }
+
+    diagnostics_append( text, &len, "\noverruns > %dms\n", CALLBACK_BUDGET_US / 1000 );
+    for ( uint32_t n = 0 ; n < callback_get_overrun_num() ; n++ ) {
+        callback_overrun_t overrun;
+        if ( callback_get_overrun( n, &overrun ) ) {
+            diagnostics_append( text, &len, "%s: %u.%01u @ %u\n", overrun.id, overrun.duration / 1000, ( overrun.duration % 1000 ) / 100, overrun.timestamp / 1000 );
+        }
+    }
+
+    diagnostics_append( text, &len, "\nboot phases [ms]\n" );
+    for ( int phase = 0 ; phase < bootctl_get_phase_num() ; phase++ ) {
+        bootctl_phase_t *boot_phase = bootctl_get_phase( phase );
+        int64_t took = boot_phase->stop - boot_phase->start;
+        /*
+         * marks have no duration, show when they happened instead
+         */
+        if ( took == 0 ) {
+            diagnostics_append( text, &len, "%s @ %lld\n", boot_phase->name, boot_phase->start / 1000 );
+        }
+        else {
+            diagnostics_append( text, &len, "%s: %lld.%01lld (c%d)\n", boot_phase->name, took / 1000, ( took % 1000 ) / 100, boot_phase->core );
+        }
+    }
+
+    diagnostics_append( text, &len, "\nlazy tiles [bytes]\n" );
+    for ( uint32_t tile_number = 0 ; tile_number < mainbar_get_tile_count() ; tile_number++ ) {
+        if ( mainbar_get_tile_mem( tile_number ) ) {
+            diagnostics_append( text, &len, "%s: %d\n", mainbar_get_tile_id( tile_number ), mainbar_get_tile_mem( tile_number ) );
+        }
+    }
+    lv_label_set_text( diagnostics_label, text );
+    free( text );
+}
+
+static void diagnostics_append( char *text, size_t *len, const char *format, ... ) {
+    size_t size = DIAGNOSTICS_LINE_LEN * DIAGNOSTICS_MAX_LINES;
+    va_list args;
+
+    if ( *len >= size - 1 )
+        return;
+
+    va_start( args, format );
+    int written = vsnprintf( &text[ *len ], size - *len, format, args );
+    va_end( args );
+
+    if ( written > 0 )
+        *len = min( *len + written, size - 1 );
+}
+
+static void exit_diagnostics_event_cb( lv_obj_t * obj, lv_event_t event ) {
+    switch( event ) {
+        case( LV_EVENT_CLICKED ):       mainbar_jump_to_tilenumber( diagnostics_return_tile, LV_ANIM_OFF );
+                                        break;
+    }
+}
@@ -0,0 +1,37 @@
+/****************************************************************************
+ *   Copyright  2020  Jesper Ortlund
+ ****************************************************************************/
+/*
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+#ifndef _DIAGNOSTICS_H
+    #define _DIAGNOSTICS_H
+
+    #include <TTGO.h>
+
+    /**
+     * @brief setup the diagnostics tile, reached from the utilities tile
+     *
+     * @param   return_tile     tile number to jump back to on exit
+     */
+    void diagnostics_tile_setup( uint32_t return_tile );
+    /**
+     * @brief get the tile number for the diagnostics tile
+     *
+     * @return  tile number
+     */
+    uint32_t diagnostics_get_tile_num( void );
+
+#endif // _DIAGNOSTICS_H
@@ -38,16 +38,19 @@ lv_obj_t *stepcounter_onoff=NULL;
 lv_obj_t *doubleclick_onoff=NULL;
 lv_obj_t *tilt_onoff=NULL;
 lv_obj_t *daily_stepcounter_onoff=NULL;
+lv_obj_t *ride_gestures_onoff=NULL;
 
 LV_IMG_DECLARE(exit_32px);
 LV_IMG_DECLARE(wheel_64px);
 
 static void enter_move_setup_event_cb( lv_obj_t * obj, lv_event_t event );
 static void exit_move_setup_event_cb( lv_obj_t * obj, lv_event_t event );
+static void move_settings_tile_create( void );
 static void stepcounter_onoff_event_handler(lv_obj_t * obj, lv_event_t event);
 static void doubleclick_onoff_event_handler(lv_obj_t * obj, lv_event_t event);
 static void tilt_onoff_event_handler(lv_obj_t * obj, lv_event_t event);
 static void daily_stepcounter_onoff_event_handler(lv_obj_t * obj, lv_event_t event);
+static void ride_gestures_onoff_event_handler(lv_obj_t * obj, lv_event_t event);
 
 void move_settings_tile_setup( void ) {
     // get an app tile and copy mainstyle
@@ -66,6 +69,10 @@ void move_settings_tile_setup( void ) {
     icon_t *move_setup_icon = setup_register( "move", &wheel_64px, enter_move_setup_event_cb );
     setup_hide_indicator( move_setup_icon );
 
+    mainbar_add_tile_create_cb( move_tile_num, move_settings_tile_create, MAINBAR_TILE_RELEASE_TIMEOUT );
+}
+
+static void move_settings_tile_create( void ) {
     lv_obj_t *exit_btn = lv_imgbtn_create( move_settings_tile, NULL);
     lv_imgbtn_set_src( exit_btn, LV_BTN_STATE_RELEASED, &exit_32px);
     lv_imgbtn_set_src( exit_btn, LV_BTN_STATE_PRESSED, &exit_32px);
@@ -81,9 +88,9 @@ void move_settings_tile_setup( void ) {
     lv_obj_align( exit_label, move_settings_tile, LV_ALIGN_IN_TOP_MID, 0, 15 );
 
     lv_obj_t *stepcounter_cont = lv_obj_create( move_settings_tile, NULL );
-    lv_obj_set_size(stepcounter_cont, lv_disp_get_hor_res( NULL ) , 40);
+    lv_obj_set_size(stepcounter_cont, lv_disp_get_hor_res( NULL ) , 36);
     lv_obj_add_style( stepcounter_cont, LV_OBJ_PART_MAIN, &move_settings_style  );
-    lv_obj_align( stepcounter_cont, move_settings_tile, LV_ALIGN_IN_TOP_RIGHT, 0, 75 );
+    lv_obj_align( stepcounter_cont, move_settings_tile, LV_ALIGN_IN_TOP_RIGHT, 0, 55 );
     stepcounter_onoff = lv_switch_create( stepcounter_cont, NULL );
     lv_obj_add_protect( stepcounter_onoff, LV_PROTECT_CLICK_FOCUS);
     lv_obj_add_style( stepcounter_onoff, LV_SWITCH_PART_INDIC, mainbar_get_switch_style() );
@@ -96,7 +103,7 @@ void move_settings_tile_setup( void ) {
     lv_obj_align( stepcounter_label, stepcounter_cont, LV_ALIGN_IN_LEFT_MID, 5, 0 );
 
     lv_obj_t *doubleclick_cont = lv_obj_create( move_settings_tile, NULL );
-    lv_obj_set_size(doubleclick_cont, lv_disp_get_hor_res( NULL ) , 40);
+    lv_obj_set_size(doubleclick_cont, lv_disp_get_hor_res( NULL ) , 36);
     lv_obj_add_style( doubleclick_cont, LV_OBJ_PART_MAIN, &move_settings_style  );
     lv_obj_align( doubleclick_cont, stepcounter_cont, LV_ALIGN_OUT_BOTTOM_MID, 0, 0 );
     doubleclick_onoff = lv_switch_create( doubleclick_cont, NULL );
@@ -111,7 +118,7 @@ void move_settings_tile_setup( void ) {
     lv_obj_align( doubleclick_label, doubleclick_cont, LV_ALIGN_IN_LEFT_MID, 5, 0 );
 
     lv_obj_t *tilt_cont = lv_obj_create( move_settings_tile, NULL );
-    lv_obj_set_size(tilt_cont, lv_disp_get_hor_res( NULL ) , 40);
+    lv_obj_set_size(tilt_cont, lv_disp_get_hor_res( NULL ) , 36);
     lv_obj_add_style( tilt_cont, LV_OBJ_PART_MAIN, &move_settings_style  );
     lv_obj_align( tilt_cont, doubleclick_cont, LV_ALIGN_OUT_BOTTOM_MID, 0, 0 );
     tilt_onoff = lv_switch_create( tilt_cont, NULL );
@@ -126,7 +133,7 @@ void move_settings_tile_setup( void ) {
     lv_obj_align( tilt_label, tilt_cont, LV_ALIGN_IN_LEFT_MID, 5, 0 );
 
     lv_obj_t *daily_stepcounter_cont = lv_obj_create( move_settings_tile, NULL );
-    lv_obj_set_size(daily_stepcounter_cont, lv_disp_get_hor_res( NULL ) , 40);
+    lv_obj_set_size(daily_stepcounter_cont, lv_disp_get_hor_res( NULL ) , 36);
     lv_obj_add_style( daily_stepcounter_cont, LV_OBJ_PART_MAIN, &move_settings_style  );
     lv_obj_align( daily_stepcounter_cont, tilt_cont, LV_ALIGN_OUT_BOTTOM_MID, 0, 0 );
     daily_stepcounter_onoff = lv_switch_create( daily_stepcounter_cont, NULL );
@@ -140,6 +147,21 @@ void move_settings_tile_setup( void ) {
     lv_label_set_text( daily_stepcounter_label, "not implemented");
     lv_obj_align( daily_stepcounter_label, daily_stepcounter_cont, LV_ALIGN_IN_LEFT_MID, 5, 0 );
 
+    lv_obj_t *ride_gestures_cont = lv_obj_create( move_settings_tile, NULL );
+    lv_obj_set_size(ride_gestures_cont, lv_disp_get_hor_res( NULL ) , 36);
+    lv_obj_add_style( ride_gestures_cont, LV_OBJ_PART_MAIN, &move_settings_style  );
+    lv_obj_align( ride_gestures_cont, daily_stepcounter_cont, LV_ALIGN_OUT_BOTTOM_MID, 0, 0 );
+    ride_gestures_onoff = lv_switch_create( ride_gestures_cont, NULL );
+    lv_obj_add_protect( ride_gestures_onoff, LV_PROTECT_CLICK_FOCUS);
+    lv_obj_add_style( ride_gestures_onoff, LV_SWITCH_PART_INDIC, mainbar_get_switch_style() );
+    lv_switch_off( ride_gestures_onoff, LV_ANIM_ON );
+    lv_obj_align( ride_gestures_onoff, ride_gestures_cont, LV_ALIGN_IN_RIGHT_MID, -5, 0 );
+    lv_obj_set_event_cb( ride_gestures_onoff, ride_gestures_onoff_event_handler );
+    lv_obj_t *ride_gestures_label = lv_label_create( ride_gestures_cont, NULL);
+    lv_obj_add_style( ride_gestures_label, LV_OBJ_PART_MAIN, &move_settings_style  );
+    lv_label_set_text( ride_gestures_label, "raise / shake");
+    lv_obj_align( ride_gestures_label, ride_gestures_cont, LV_ALIGN_IN_LEFT_MID, 5, 0 );
+
     if ( bma_get_config( BMA_DOUBLECLICK ) )
         lv_switch_on( doubleclick_onoff, LV_ANIM_OFF );
     else
@@ -159,6 +181,11 @@ void move_settings_tile_setup( void ) {
         lv_switch_on( daily_stepcounter_onoff, LV_ANIM_OFF );
     else
         lv_switch_off( daily_stepcounter_onoff, LV_ANIM_OFF );
+
+    if ( bma_get_config( BMA_RIDE_GESTURES ) )
+        lv_switch_on( ride_gestures_onoff, LV_ANIM_OFF );
+    else
+        lv_switch_off( ride_gestures_onoff, LV_ANIM_OFF );
 }
 
 
@@ -198,4 +225,10 @@ static void daily_stepcounter_onoff_event_handler(lv_obj_t * obj, lv_event_t eve
     switch( event ) {
         case( LV_EVENT_VALUE_CHANGED):  bma_set_config( BMA_DAILY_STEPCOUNTER, lv_switch_get_state( obj ) );
     }
-}
\ No newline at end of file
+}
+
+static void ride_gestures_onoff_event_handler(lv_obj_t * obj, lv_event_t event) {
+    switch( event ) {
+        case( LV_EVENT_VALUE_CHANGED):  bma_set_config( BMA_RIDE_GESTURES, lv_switch_get_state( obj ) );
+    }
+}
@@ -35,7 +35,6 @@
 extern const uint8_t timezones_json_start[] asm("_binary_src_gui_mainbar_setup_tile_time_settings_timezones_json_start");
 extern const uint8_t timezones_json_end[] asm("_binary_src_gui_mainbar_setup_tile_time_settings_timezones_json_end");
 const size_t capacity = JSON_OBJECT_SIZE(460) + 14920;
-const char * timezone_options;
 uint16_t timezone_selected_index;
 
 lv_obj_t *time_settings_tile=NULL;
@@ -53,13 +52,13 @@ LV_IMG_DECLARE(time_64px);
 
 static void enter_time_setup_event_cb( lv_obj_t * obj, lv_event_t event );
 static void exit_time_setup_event_cb( lv_obj_t * obj, lv_event_t event );
+static void time_settings_tile_create( void );
 static void wifisync_onoff_event_handler(lv_obj_t * obj, lv_event_t event);
 static void utczone_event_handler(lv_obj_t * obj, lv_event_t event);
 static void clock_fmt_onoff_event_handler(lv_obj_t * obj, lv_event_t event);
 
-static void setup_timezone_data( char * selected_timezone ) {
+static void setup_timezone_data( lv_obj_t *dropdown, char * selected_timezone ) {
     String zones = String("");
-    if (timezone_options) return;
     SpiRamJsonDocument doc( capacity );
     DeserializationError error = deserializeJson( doc, (const char *)timezones_json_start );
     if ( error ) {
@@ -81,12 +80,11 @@ static void setup_timezone_data( char * selected_timezone ) {
         }
     }
     doc.clear();
-    timezone_options = zones.c_str();
+    // the dropdown keeps its own copy, the zone list is only needed while the tile exist
+    lv_dropdown_set_options( dropdown, zones.c_str() );
 }
 
 void time_settings_tile_setup( void ) {
-    setup_timezone_data( timesync_get_timezone_name() );
-
     // get an app tile and copy mainstyle
     time_tile_num = mainbar_add_app_tile( 1, 1, "time setup" );
     time_settings_tile = mainbar_get_tile_obj( time_tile_num );
@@ -103,6 +101,10 @@ void time_settings_tile_setup( void ) {
     icon_t *time_setup_icon = setup_register( "time", &time_64px, enter_time_setup_event_cb );
     setup_hide_indicator( time_setup_icon );
 
+    mainbar_add_tile_create_cb( time_tile_num, time_settings_tile_create, MAINBAR_TILE_RELEASE_TIMEOUT );
+}
+
+static void time_settings_tile_create( void ) {
     lv_obj_t *exit_btn = lv_imgbtn_create( time_settings_tile, NULL);
     lv_imgbtn_set_src( exit_btn, LV_BTN_STATE_RELEASED, &exit_32px);
     lv_imgbtn_set_src( exit_btn, LV_BTN_STATE_PRESSED, &exit_32px);
@@ -159,7 +161,7 @@ void time_settings_tile_setup( void ) {
     lv_obj_align( timezone_label, timezone_cont, LV_ALIGN_CENTER, 0, -15 );
 
     utczone_list = lv_dropdown_create( timezone_cont, NULL);
-    lv_dropdown_set_options( utczone_list, timezone_options );
+    setup_timezone_data( utczone_list, timesync_get_timezone_name() );
     lv_obj_set_size( utczone_list, lv_disp_get_hor_res( NULL )-20, 35 );
     lv_obj_align( utczone_list, timezone_cont, LV_ALIGN_IN_BOTTOM_MID, 0, 0 );
     lv_obj_set_event_cb(utczone_list, utczone_event_handler);
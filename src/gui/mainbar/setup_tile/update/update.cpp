@@ -33,6 +33,7 @@
 #include "gui/setup.h"
 
 #include "hardware/display.h"
+#include "hardware/configstore.h"
 #include "hardware/powermgm.h"
 #include "hardware/wifictl.h"
 #include "hardware/motor.h"
@@ -151,7 +152,7 @@ void update_tile_setup( void ) {
     lv_bar_set_value( update_progressbar, 0, LV_ANIM_ON );
 
     wifictl_register_cb( WIFICTL_CONNECT, update_wifictl_event_cb, "update" );
-    http_ota_register_cb( HTTP_OTA_PROGRESS | HTTP_OTA_ERROR, update_http_ota_event_cb, "http updater");
+    http_ota_register_cb( HTTP_OTA_ERROR, update_http_ota_event_cb, "http updater");
 
     mainbar_add_tile_activate_cb( update_tile_num, update_update_activate_cb );
     mainbar_add_tile_hibernate_cb( update_tile_num, update_update_hibernate_cb );
@@ -169,6 +170,9 @@ void update_update_hibernate_cb( void ) {
 }
 
 void update_progress_task( lv_task_t *task ) {
+    if ( xEventGroupGetBits( update_event_handle ) & UPDATE_REQUEST ) {
+        progress = http_ota_get_progress();
+    }
     if ( progress > 0 ) {
         char msg[16]="";
         lv_bar_set_value( update_progressbar, progress , LV_ANIM_ON );
@@ -181,9 +185,6 @@ void update_progress_task( lv_task_t *task ) {
 
 bool update_http_ota_event_cb( EventBits_t event, void *arg ) {
     switch( event ) {
-        case HTTP_OTA_PROGRESS:
-            progress = *(int16_t *)arg;
-            break;
         case HTTP_OTA_ERROR:        
             lv_label_set_text( update_status_label, (char *)arg );
             lv_obj_align( update_status_label, update_btn, LV_ALIGN_OUT_BOTTOM_MID, 0, 5 );
@@ -234,6 +235,7 @@ static void update_event_handler(lv_obj_t * obj, lv_event_t event) {
             motor_vibe(20);
             delay(20);
             display_standby();
+            configstore_flush();
             ttgo->stopLvglTick();
             SPIFFS.end();
             log_i("SPIFFS unmounted!");
@@ -303,7 +305,7 @@ void update_Task( void * pvParameters ) {
             lv_label_set_text( update_status_label, "start update ..." );
             lv_obj_align( update_status_label, update_btn, LV_ALIGN_OUT_BOTTOM_MID, 0, 5 );
 
-            if ( http_ota_start( update_get_url(), update_get_md5() ) ) {
+            if ( http_ota_start_delta( update_get_delta_url(), update_get_md5() ) || http_ota_start( update_get_url(), update_get_md5() ) ) {
                 reset = true;
                 progress = 0;
                 lv_label_set_text( update_status_label, "update ok, turn off and on!" );
@@ -29,6 +29,7 @@
 char *firmwarehost = NULL;
 char *firmwarefile = NULL;
 char *firmwareurl = NULL;
+char *firmwaredeltaurl = NULL;
 char *firmwaremd5 = NULL;
 
 int64_t firmwareversion = -1;
@@ -118,6 +119,18 @@ int64_t update_check_new_version( char *url ) {
         }
         snprintf( firmwareurl, strlen( firmwarehost ) + strlen( firmwarefile ) + 5, "%s/%s", firmwarehost, firmwarefile );
         log_i("firmwareurl: %s", firmwareurl );
+
+        /*
+         * a delta patch against our version sits next to the full image
+         */
+        size_t deltaurl_len = strlen( firmwareurl ) + strlen( "." __FIRMWARE__ ".delta" ) + 1;
+        char * tmp_firmwaredeltaurl = (char*)REALLOC( firmwaredeltaurl, deltaurl_len );
+        if ( tmp_firmwaredeltaurl == NULL ) {
+            log_e("realloc error");
+            while(true);
+        }
+        firmwaredeltaurl = tmp_firmwaredeltaurl;
+        snprintf( firmwaredeltaurl, deltaurl_len, "%s." __FIRMWARE__ ".delta", firmwareurl );
     }
 
     if ( doc["version"] ) {
@@ -156,6 +169,13 @@ const char* update_get_url( void ) {
     return( NULL );
 }
 
+const char* update_get_delta_url( void ) {
+    if ( firmwareversion > 0 ) {
+        return( (const char*)firmwaredeltaurl );
+    }
+    return( NULL );
+}
+
 const char* update_get_md5( void ) {
     if ( firmwareversion > 0 ) {
         return( (const char*)firmwaremd5 );
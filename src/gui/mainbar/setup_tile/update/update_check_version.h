@@ -26,6 +26,7 @@
 
     int64_t update_check_new_version( char *url );
     const char* update_get_url( void );
+    const char* update_get_delta_url( void );
     const char* update_get_md5( void );
 
 #endif // _UPDATE_CHECK_VERSION_H
\ No newline at end of file
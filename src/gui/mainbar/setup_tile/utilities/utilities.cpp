@@ -29,9 +29,11 @@
 #include "gui/mainbar/mainbar.h"
 #include "gui/mainbar/setup_tile/setup_tile.h"
 #include "gui/setup.h"
+#include "gui/mainbar/setup_tile/diagnostics/diagnostics.h"
 
 #include "hardware/motor.h"
 #include "hardware/display.h"
+#include "hardware/configstore.h"
 
 
 
@@ -43,6 +45,7 @@ lv_obj_t *reboot_btn = NULL;
 lv_obj_t *poweroff_btn = NULL;
 
 lv_obj_t *format_spiffs_btn = NULL;
+lv_obj_t *diagnostics_btn = NULL;
 
 lv_obj_t *SpiffsWarningBox = NULL;
 
@@ -54,6 +57,7 @@ LV_IMG_DECLARE(utilities_64px);
 
 static void enter_utilities_event_cb( lv_obj_t * obj, lv_event_t event );
 static void exit_utilities_event_cb( lv_obj_t * obj, lv_event_t event );
+static void utilities_tile_create( void );
 
 static void SpiffsWarningBox_event_handler( lv_obj_t * obj, lv_event_t event );
 static void format_SPIFFS_utilities_event_cb( lv_obj_t * obj, lv_event_t event );
@@ -61,6 +65,7 @@ static void format_SPIFFS(void);
 
 static void reboot_utilities_event_cb( lv_obj_t * obj, lv_event_t event );
 static void poweroff_utilities_event_cb( lv_obj_t * obj, lv_event_t event );
+static void diagnostics_utilities_event_cb( lv_obj_t * obj, lv_event_t event );
 
 
 void utilities_tile_setup( void ) {
@@ -76,6 +81,12 @@ void utilities_tile_setup( void ) {
     icon_t *utilities_setup_icon = setup_register( "Utilities", &utilities_64px, enter_utilities_event_cb );
     setup_hide_indicator( utilities_setup_icon );
 
+    mainbar_add_tile_create_cb( utilities_tile_num, utilities_tile_create, MAINBAR_TILE_RELEASE_TIMEOUT );
+
+    diagnostics_tile_setup( utilities_tile_num );
+}
+
+static void utilities_tile_create( void ) {
     lv_obj_t *exit_btn = lv_imgbtn_create( utilities_tile, NULL);
     lv_imgbtn_set_src( exit_btn, LV_BTN_STATE_RELEASED, &exit_32px);
     lv_imgbtn_set_src( exit_btn, LV_BTN_STATE_PRESSED, &exit_32px);
@@ -122,6 +133,15 @@ void utilities_tile_setup( void ) {
     lv_obj_align( poweroff_btn, utilities_tile, LV_ALIGN_IN_BOTTOM_RIGHT, -5, -5 );
     lv_obj_t *poweroff_btn_label = lv_label_create( poweroff_btn, NULL );
     lv_label_set_text( poweroff_btn_label, "Poweroff");
+
+    //Add button for diagnostics
+    diagnostics_btn = lv_btn_create( utilities_tile, NULL);
+    lv_obj_set_size(diagnostics_btn, 60, 40);
+    lv_obj_set_event_cb( diagnostics_btn, diagnostics_utilities_event_cb );
+    lv_obj_add_style( diagnostics_btn, LV_BTN_PART_MAIN, mainbar_get_button_style() );
+    lv_obj_align( diagnostics_btn, utilities_tile, LV_ALIGN_IN_TOP_RIGHT, -5, 5 );
+    lv_obj_t *diagnostics_btn_label = lv_label_create( diagnostics_btn, NULL );
+    lv_label_set_text( diagnostics_btn_label, "Diag");
     
     lv_obj_t *last_reboot_label = lv_label_create( utilities_tile, NULL);
     lv_obj_add_style( last_reboot_label, LV_OBJ_PART_MAIN, &utilities_style  );
@@ -184,6 +204,13 @@ static void enter_utilities_event_cb( lv_obj_t * obj, lv_event_t event ) {
 }
 
 
+static void diagnostics_utilities_event_cb( lv_obj_t * obj, lv_event_t event ) {
+    switch( event ) {
+        case( LV_EVENT_CLICKED ):       mainbar_jump_to_tilenumber( diagnostics_get_tile_num(), LV_ANIM_OFF );
+                                        break;
+    }
+}
+
 static void exit_utilities_event_cb( lv_obj_t * obj, lv_event_t event ) {
     switch( event ) {
         case( LV_EVENT_CLICKED ):       mainbar_jump_to_tilenumber( setup_get_tile_num(), LV_ANIM_OFF );
@@ -268,6 +295,7 @@ static void reboot_utilities_event_cb( lv_obj_t * obj, lv_event_t event ) {
                                         display_standby();
 
                                         TTGOClass *ttgo = TTGOClass::getWatch();
+                                        configstore_flush();
                                         ttgo->stopLvglTick();
                                         SPIFFS.end();
                                         log_i("SPIFFS unmounted!");
@@ -286,6 +314,7 @@ static void poweroff_utilities_event_cb( lv_obj_t * obj, lv_event_t event ) {
                                         delay(20);
                                         
                                         TTGOClass *ttgo = TTGOClass::getWatch();
+                                        configstore_flush();
                                         ttgo->stopLvglTick();
                                         SPIFFS.end();
                                         log_i("SPIFFS unmounted!");
@@ -300,9 +300,11 @@ static void exit_wifi_password_event_cb( lv_obj_t * obj, lv_event_t event ) {
 
 lv_obj_t *wifi_autoon_onoff = NULL;
 lv_obj_t *wifi_enabled_on_standby_onoff = NULL;
+lv_obj_t *wifi_webserver_onoff = NULL;
 static void wps_start_event_handler( lv_obj_t * obj, lv_event_t event );
 static void wifi_autoon_onoff_event_handler( lv_obj_t * obj, lv_event_t event );
 static void wifi_enabled_on_standby_onoff_event_handler( lv_obj_t * obj, lv_event_t event );
+static void wifi_webserver_onoff_event_handler( lv_obj_t * obj, lv_event_t event );
 bool wifi_setup_autoon_event_cb( EventBits_t event, void *arg );
 
 void wlan_setup_tile_setup( uint32_t wifi_setup_tile_num ) {
@@ -359,9 +361,24 @@ void wlan_setup_tile_setup( uint32_t wifi_setup_tile_num ) {
     lv_label_set_text( wifi_enabled_on_standby_label, "enable on standby");
     lv_obj_align( wifi_enabled_on_standby_label, wifi_enabled_on_standby_onoff_cont, LV_ALIGN_IN_LEFT_MID, 5, 0 );   
 
+    lv_obj_t *wifi_webserver_onoff_cont = lv_obj_create( wifi_setup_tile, NULL );
+    lv_obj_set_size(wifi_webserver_onoff_cont, lv_disp_get_hor_res( NULL ) , 32);
+    lv_obj_add_style( wifi_webserver_onoff_cont, LV_OBJ_PART_MAIN, &wifi_setup_style  );
+    lv_obj_align( wifi_webserver_onoff_cont, wifi_setup_tile, LV_ALIGN_IN_TOP_RIGHT, 0, 155 );
+    wifi_webserver_onoff = lv_switch_create( wifi_webserver_onoff_cont, NULL );
+    lv_obj_add_protect( wifi_webserver_onoff, LV_PROTECT_CLICK_FOCUS);
+    lv_obj_add_style( wifi_webserver_onoff, LV_SWITCH_PART_INDIC, mainbar_get_switch_style() );
+    lv_switch_off( wifi_webserver_onoff, LV_ANIM_ON );
+    lv_obj_align( wifi_webserver_onoff, wifi_webserver_onoff_cont, LV_ALIGN_IN_RIGHT_MID, -5, 0 );
+    lv_obj_set_event_cb( wifi_webserver_onoff, wifi_webserver_onoff_event_handler );
+    lv_obj_t *wifi_webserver_label = lv_label_create( wifi_webserver_onoff_cont, NULL);
+    lv_obj_add_style( wifi_webserver_label, LV_OBJ_PART_MAIN, &wifi_setup_style  );
+    lv_label_set_text( wifi_webserver_label, "live webserver");
+    lv_obj_align( wifi_webserver_label, wifi_webserver_onoff_cont, LV_ALIGN_IN_LEFT_MID, 5, 0 );
+
     lv_obj_t *wps_btn = lv_btn_create( wifi_setup_tile, NULL);
     lv_obj_set_event_cb( wps_btn, wps_start_event_handler );
-    lv_obj_align( wps_btn, wifi_enabled_on_standby_onoff_cont, LV_ALIGN_OUT_BOTTOM_MID, 0, 10);
+    lv_obj_align( wps_btn, wifi_webserver_onoff_cont, LV_ALIGN_OUT_BOTTOM_MID, 0, 5);
     lv_obj_t *wps_btn_label = lv_label_create( wps_btn, NULL );
     lv_label_set_text( wps_btn_label, "start WPS");
 
@@ -381,6 +398,13 @@ void wlan_setup_tile_setup( uint32_t wifi_setup_tile_num ) {
         setup_hide_indicator( wifi_setup_icon );
     }
 
+    if ( wifictl_get_webserver() ) {
+        lv_switch_on( wifi_webserver_onoff, LV_ANIM_OFF);
+    }
+    else {
+        lv_switch_off( wifi_webserver_onoff, LV_ANIM_OFF);
+    }
+
     blectl_register_cb( BLECTL_MSG, wifi_setup_bluetooth_message_event_cb, "wifi settings" );
     wifictl_register_cb( WIFICTL_AUTOON, wifi_setup_autoon_event_cb, "wifi setup");
 }
@@ -414,6 +438,13 @@ static void wifi_autoon_onoff_event_handler( lv_obj_t * obj, lv_event_t event )
 }
 
 
+static void wifi_webserver_onoff_event_handler( lv_obj_t * obj, lv_event_t event ) {
+    switch (event) {
+        case (LV_EVENT_VALUE_CHANGED):  wifictl_set_webserver( lv_switch_get_state( obj ) );
+                                        break;
+    }
+}
+
 static void wifi_enabled_on_standby_onoff_event_handler( lv_obj_t * obj, lv_event_t event ) {
     switch (event) {
         case (LV_EVENT_VALUE_CHANGED):  wifictl_set_enable_on_standby( lv_switch_get_state( obj ) );
@@ -20,19 +20,30 @@
 #include "config.h"
 #include <Arduino.h>
 #include "gui/mainbar/mainbar.h"
+#include "gui/bandstyle.h"
+#include "gui/gauge.h"
+#include "gui/digitsprite.h"
+#include "gui/gaugeanim.h"
 #include "simpledash_tile.h"
 #include "hardware/pmu.h"
 #include "hardware/Kingsong.h"
 #include "hardware/dashboard.h"
 #include "hardware/blectl.h"
 #include "hardware/wheelctl.h"
+#include "hardware/alarmctl.h"
+#include "hardware/callback.h"
 
 //task declarations
 lv_task_t *sd_dash_task = nullptr;
+lv_task_t *sd_anim_task = nullptr;
+static uint32_t sd_dash_refresh = 250;
+static gaugeanim_t sd_speed_anim;
 
 // Function declarations
 static void lv_sd_dash_task(lv_task_t *sd_dash_task);
+static void lv_sd_anim_task(lv_task_t *sd_anim_task);
 static void sd_overlay_event_cb(lv_obj_t * obj, lv_event_t event);
+static void lv_sd_marker_update(gauge_geometry_t *gauge, lv_obj_t *marker, float value);
 
 void sd_stop_dash_task();
 
@@ -91,6 +102,20 @@ static lv_style_t sd_bar_main_style;
 static lv_obj_t *sd_overlay_bar = NULL;
 static lv_obj_t *sd_overlay_line = NULL;
 static lv_style_t sd_overlay_style;
+static lv_style_t sd_overlay_connected_style;
+static bool sd_overlay_connected = false;
+
+//Gauge geometry for the max/min marker bars
+static gauge_geometry_t sd_batt_gauge;
+static gauge_geometry_t sd_current_gauge;
+
+//Colour band styles, built once and swapped only when a gauge changes band
+static bandstyle_t sd_speed_label_band;
+static bandstyle_t sd_batt_indic_band;
+static bandstyle_t sd_current_indic_band;
+static bandstyle_slot_t sd_speed_label_slot;
+static bandstyle_slot_t sd_batt_indic_slot;
+static bandstyle_slot_t sd_current_indic_slot;
 
 //End LV objects and styles
 
@@ -131,18 +156,21 @@ void lv_sd_define_styles_1(void)
 
     //Speed label
     lv_style_init(&sd_speed_label_style);
-    lv_style_set_text_color(&sd_speed_label_style, LV_STATE_DEFAULT, sd_speed_fg_clr);
-    lv_style_set_text_font(&sd_speed_label_style, LV_STATE_DEFAULT, &DIN1451_m_cond_180);
+    lv_style_set_image_recolor(&sd_speed_label_style, LV_STATE_DEFAULT, sd_speed_fg_clr);
+    lv_style_set_image_recolor_opa(&sd_speed_label_style, LV_STATE_DEFAULT, LV_OPA_COVER);
+    bandstyle_init(&sd_speed_label_band, &sd_speed_label_style, BANDSTYLE_IMAGE, sd_speed_fg_clr, LV_COLOR_YELLOW, LV_COLOR_RED, sd_speed_fg_clr);
 
     // Battery Arc
     lv_style_copy(&sd_batt_indic_style, &sd_arc_style);
     lv_style_copy(&sd_batt_main_style, &sd_arc_style);
     lv_style_set_line_color(&sd_batt_main_style, LV_STATE_DEFAULT, sd_batt_bg_clr);
+    bandstyle_init(&sd_batt_indic_band, &sd_batt_indic_style, BANDSTYLE_LINE, sd_batt_fg_clr, LV_COLOR_YELLOW, LV_COLOR_RED, sd_batt_fg_clr);
 
     // Current Arc
     lv_style_copy(&sd_current_indic_style, &sd_arc_style);
     lv_style_copy(&sd_current_main_style, &sd_arc_style);
     lv_style_set_line_color(&sd_current_main_style, LV_STATE_DEFAULT, sd_current_bg_clr);
+    bandstyle_init(&sd_current_indic_band, &sd_current_indic_style, BANDSTYLE_LINE, sd_current_fg_clr, LV_COLOR_YELLOW, LV_COLOR_RED, sd_speed_fg_clr);
 
     //Bar background -- transparent
     lv_style_copy(&sd_bar_main_style, &sd_arc_style);
@@ -167,6 +195,9 @@ void lv_sd_define_styles_1(void)
     lv_style_set_line_width(&sd_overlay_style, LV_STATE_DEFAULT, 20);
     lv_style_set_line_opa(&sd_overlay_style, LV_STATE_DEFAULT, LV_OPA_20);
     lv_style_set_bg_opa(&sd_overlay_style, LV_STATE_DEFAULT, LV_OPA_20);
+    lv_style_copy(&sd_overlay_connected_style, &sd_overlay_style);
+    lv_style_set_line_opa(&sd_overlay_connected_style, LV_STATE_DEFAULT, LV_OPA_TRANSP);
+    lv_style_set_bg_opa(&sd_overlay_connected_style, LV_STATE_DEFAULT, LV_OPA_TRANSP);
 
 } //End Define LVGL default object styles
 
@@ -179,9 +210,8 @@ void lv_sd_speed_arc_1(void)
     float tiltback_speed = wheelctl_get_data(WHEELCTL_TILTBACK);
     float current_speed = wheelctl_get_data(WHEELCTL_SPEED);
     //Label
-    sd_speed_label = lv_label_create(simpledash_cont, NULL);
-    lv_obj_reset_style_list(sd_speed_label, LV_OBJ_PART_MAIN);
-    lv_obj_add_style(sd_speed_label, LV_LABEL_PART_MAIN, &sd_speed_label_style);
+    sd_speed_label = digitsprite_create(simpledash_cont, &DIN1451_m_cond_180, 3);
+    bandstyle_attach(&sd_speed_label_slot, sd_speed_label, LV_OBJ_PART_MAIN, &sd_speed_label_band);
     char speedstring[4];
     if (current_speed > 10)
     {
@@ -191,10 +221,10 @@ void lv_sd_speed_arc_1(void)
     {
         dtostrf(current_speed, 1, 0, speedstring);
     }
-    lv_label_set_text(sd_speed_label, speedstring);
-    lv_label_set_align(sd_speed_label, LV_LABEL_ALIGN_CENTER);
+    digitsprite_set_text(sd_speed_label, speedstring);
     lv_obj_align(sd_speed_label, sd_speed_arc, LV_ALIGN_CENTER, 0, 8);
     mainbar_add_slide_element(sd_speed_label);
+    gaugeanim_init(&sd_speed_anim, 0, 100, 40);
 }
 
 void lv_sd_batt_arc_1(void)
@@ -215,7 +245,7 @@ void lv_sd_batt_arc_1(void)
     //Arc
     sd_batt_arc = lv_arc_create(simpledash_cont, NULL);
     lv_obj_reset_style_list(sd_batt_arc, LV_OBJ_PART_MAIN);
-    lv_obj_add_style(sd_batt_arc, LV_ARC_PART_INDIC, &sd_batt_indic_style);
+    bandstyle_attach(&sd_batt_indic_slot, sd_batt_arc, LV_ARC_PART_INDIC, &sd_batt_indic_band);
     lv_obj_add_style(sd_batt_arc, LV_OBJ_PART_MAIN, &sd_batt_main_style);
     //lv_arc_set_type(sd_batt_arc, LV_ARC_TYPE_REVERSE);
     lv_arc_set_bg_angles(sd_batt_arc, sd_batt_arc_start, sd_batt_arc_end);
@@ -223,6 +253,7 @@ void lv_sd_batt_arc_1(void)
     lv_arc_set_range(sd_batt_arc, 0, 100);
     lv_obj_set_size(sd_batt_arc, sd_out_arc_x, sd_out_arc_y);
     lv_obj_align(sd_batt_arc, NULL, LV_ALIGN_CENTER, 0, 0);
+    gauge_init(&sd_batt_gauge, sd_batt_arc_start, sd_batt_arc_end, 0, 100, sd_rev_batt_arc);
     mainbar_add_slide_element(sd_batt_arc);
 
     if (dashboard_get_config(DASHBOARD_BARS))
@@ -258,7 +289,7 @@ void lv_sd_current_arc_1(void)
     //Arc
     sd_current_arc = lv_arc_create(simpledash_cont, NULL);
     lv_obj_reset_style_list(sd_current_arc, LV_OBJ_PART_MAIN);
-    lv_obj_add_style(sd_current_arc, LV_ARC_PART_INDIC, &sd_current_indic_style);
+    bandstyle_attach(&sd_current_indic_slot, sd_current_arc, LV_ARC_PART_INDIC, &sd_current_indic_band);
     lv_obj_add_style(sd_current_arc, LV_OBJ_PART_MAIN, &sd_current_main_style);
     lv_arc_set_type(sd_current_arc, LV_ARC_TYPE_REVERSE);
     lv_arc_set_bg_angles(sd_current_arc, sd_current_arc_start, sd_current_arc_end);
@@ -266,6 +297,7 @@ void lv_sd_current_arc_1(void)
     lv_arc_set_range(sd_current_arc, 0, maxcurrent);
     lv_obj_set_size(sd_current_arc, sd_out_arc_x, sd_out_arc_y);
     lv_obj_align(sd_current_arc, NULL, LV_ALIGN_CENTER, 0, 0);
+    gauge_init(&sd_current_gauge, sd_current_arc_start, sd_current_arc_end, 0, maxcurrent, sd_rev_current_arc);
     mainbar_add_slide_element(sd_current_arc);
 
     if (dashboard_get_config(DASHBOARD_BARS))
@@ -301,6 +333,7 @@ void lv_sd_overlay(void)
     lv_obj_reset_style_list(sd_overlay_bar, LV_OBJ_PART_MAIN);
     lv_obj_set_size(sd_overlay_bar, lv_disp_get_hor_res(NULL), lv_disp_get_ver_res(NULL));
     lv_obj_add_style(sd_overlay_bar, LV_OBJ_PART_MAIN, &sd_overlay_style);
+    sd_overlay_connected = false;
     lv_obj_align(sd_overlay_bar, NULL, LV_ALIGN_CENTER, 0, 0);
     mainbar_add_slide_element(sd_overlay_bar);
     lv_obj_set_event_cb( sd_overlay_bar, sd_overlay_event_cb );
@@ -315,68 +348,40 @@ void lv_sd_overlay(void)
 
 } //End Create Dashboard objects
 
+static void lv_sd_marker_update(gauge_geometry_t *gauge, lv_obj_t *marker, float value)
+{
+    uint16_t start, end;
+
+    gauge_marker_angles(gauge, GAUGE_VALUE(value), &start, &end);
+    lv_arc_set_angles(marker, start, end);
+}
+
 static void sd_overlay_event_cb(lv_obj_t * obj, lv_event_t event) {
     switch( event ) {
         case( LV_EVENT_LONG_PRESSED ):  Serial.println("long press on overlay");
     }
 }
 
-int sd_value2angle(int arcstart, int arcstop, float minvalue, float maxvalue, float arcvalue, bool reverse)
-{
-    int rAngle;
-    int arcdegrees;
-    if (arcstop < arcstart)
-    {
-        arcdegrees = (arcstop + 360) - arcstart;
-    }
-    else
-    {
-        arcdegrees = arcstop - arcstart;
-    }
-    if (reverse)
-    {
-        rAngle = arcstop - (arcvalue * arcdegrees / (maxvalue - minvalue));
-    }
-    else
-    {
-        rAngle = arcstart + (arcvalue * arcdegrees / (maxvalue - minvalue));
-    }
-    if (rAngle >= 360)
-    {
-        rAngle = rAngle - 360;
-    }
-    else if (rAngle < 0)
-    {
-        rAngle = rAngle + 360;
-    }
-    return rAngle;
-}
-
 /***************************************************************
    Dashboard GUI Update Functions, called via the task handler
    runs every 250ms
  ***************************************************************/
 
+/*
+ * runs every animation frame, the label only redraws digits that changed
+ */
 static void lv_sd_speed_update(void)
 {
-    float tiltback_speed = wheelctl_get_data(WHEELCTL_TILTBACK);
-    float current_speed = wheelctl_get_data(WHEELCTL_SPEED);
-    float warn_speed = wheelctl_get_data(WHEELCTL_ALARM3);
+    float sample;
+    int64_t sample_time;
 
-    if (current_speed >= tiltback_speed)
-    {
-        lv_style_set_text_color(&sd_speed_label_style, LV_STATE_DEFAULT, LV_COLOR_RED);
-    }
-    else if (current_speed >= warn_speed)
-    {
-        lv_style_set_text_color(&sd_speed_label_style, LV_STATE_DEFAULT, LV_COLOR_YELLOW);
-    }
-    else
-    {
-        lv_style_set_text_color(&sd_speed_label_style, LV_STATE_DEFAULT, sd_speed_fg_clr);
-    }
+    wheelctl_get_sample(WHEELCTL_SPEED, &sample, &sample_time);
+    gaugeanim_add_sample(&sd_speed_anim, sample, sample_time);
+    float current_speed = gaugeanim_get_value(&sd_speed_anim, esp_timer_get_time());
+
+    int band = alarmctl_get_band(WHEELCTL_SPEED);
+    bandstyle_set(&sd_speed_label_slot, band);
 
-    lv_obj_add_style(sd_speed_label, LV_LABEL_PART_MAIN, &sd_speed_label_style);
     char speedstring[4];
     float converted_speed = current_speed;
     if (dashboard_get_config(DASHBOARD_IMPDIST)) {
@@ -390,27 +395,15 @@ static void lv_sd_speed_update(void)
     {
         dtostrf(converted_speed, 1, 0, speedstring);
     }
-    lv_label_set_text(sd_speed_label, speedstring);
-    lv_label_set_align(sd_speed_label, LV_LABEL_ALIGN_CENTER);
+    digitsprite_set_text(sd_speed_label, speedstring);
     lv_obj_align(sd_speed_label, sd_speed_arc, LV_ALIGN_CENTER, 0, 8);
 }
 
 void lv_sd_batt_update(void)
 {
     float current_battpct = wheelctl_get_data(WHEELCTL_BATTPCT);
-    if (current_battpct < 10)
-    {
-        lv_style_set_line_color(&sd_batt_indic_style, LV_STATE_DEFAULT, LV_COLOR_RED);
-    }
-    else if (current_battpct < wheelctl_get_constant(WHEELCTL_CONST_BATTWARN))
-    {
-        lv_style_set_line_color(&sd_batt_indic_style, LV_STATE_DEFAULT, LV_COLOR_YELLOW);
-    }
-    else
-    {
-        lv_style_set_line_color(&sd_batt_indic_style, LV_STATE_DEFAULT, sd_batt_fg_clr);
-    }
-    lv_obj_add_style(sd_batt_arc, LV_ARC_PART_INDIC, &sd_batt_indic_style);
+    int band = alarmctl_get_band(WHEELCTL_BATTPCT);
+    bandstyle_set(&sd_batt_indic_slot, band);
 
     // draw batt arc
 
@@ -418,21 +411,8 @@ void lv_sd_batt_update(void)
 
     if (dashboard_get_config(DASHBOARD_BARS))
     {
-        int ang_max = sd_value2angle(sd_batt_arc_start, sd_batt_arc_end, 0, 100, wheelctl_get_max_data(WHEELCTL_BATTPCT), sd_rev_batt_arc);
-        int ang_max2 = ang_max + 3;
-        if (ang_max2 >= 360)
-        {
-            ang_max2 = ang_max2 - 360;
-        }
-        lv_arc_set_angles(sd_batt_max_bar, ang_max, ang_max2);
-
-        int ang_min = sd_value2angle(sd_batt_arc_start, sd_batt_arc_end, 0, 100, wheelctl_get_min_data(WHEELCTL_BATTPCT), sd_rev_batt_arc);
-        int ang_min2 = ang_min + 3;
-        if (ang_min2 >= 360)
-        {
-            ang_min2 = ang_min2 - 360;
-        }
-        lv_arc_set_angles(sd_batt_min_bar, ang_min, ang_min2);
+        lv_sd_marker_update(&sd_batt_gauge, sd_batt_max_bar, wheelctl_get_max_data(WHEELCTL_BATTPCT));
+        lv_sd_marker_update(&sd_batt_gauge, sd_batt_min_bar, wheelctl_get_min_data(WHEELCTL_BATTPCT));
     }
 }
 
@@ -443,24 +423,12 @@ void lv_sd_current_update(void)
     float current_current = wheelctl_get_data(WHEELCTL_CURRENT);
     float amps = current_current;
 
-    if (current_current > (maxcurrent * 0.75))
-    {
-        lv_style_set_line_color(&sd_current_indic_style, LV_STATE_DEFAULT, LV_COLOR_RED);
-    }
-    else if (current_current > (maxcurrent * 0.5))
-    {
-        lv_style_set_line_color(&sd_current_indic_style, LV_STATE_DEFAULT, LV_COLOR_YELLOW);
-    }
-    else if (current_current < 0)
+    int band = alarmctl_get_band(WHEELCTL_CURRENT);
+    if (current_current < 0)
     {
-        lv_style_set_line_color(&sd_current_indic_style, LV_STATE_DEFAULT, sd_speed_fg_clr);
         amps = (current_current * -1);
     }
-    else
-    {
-        lv_style_set_line_color(&sd_current_indic_style, LV_STATE_DEFAULT, sd_current_fg_clr);
-    }
-    lv_obj_add_style(sd_current_arc, LV_ARC_PART_INDIC, &sd_current_indic_style);
+    bandstyle_set(&sd_current_indic_slot, band);
 
     if (sd_rev_current_arc)
     {
@@ -472,40 +440,34 @@ void lv_sd_current_update(void)
     }
     if (dashboard_get_config(DASHBOARD_BARS))
     {
-        int ang_max = sd_value2angle(sd_current_arc_start, sd_current_arc_end, 0, maxcurrent, wheelctl_get_max_data(WHEELCTL_CURRENT), sd_rev_current_arc);
-        int ang_max2 = ang_max + 3;
-        if (ang_max2 >= 360)
-        {
-            ang_max2 = ang_max2 - 360;
-        }
-        lv_arc_set_angles(sd_current_max_bar, ang_max, ang_max2);
-
-        int ang_regen = sd_value2angle(sd_current_arc_start, sd_current_arc_end, 0, maxcurrent, wheelctl_get_min_data(WHEELCTL_CURRENT), sd_rev_current_arc);
-        int ang_regen2 = ang_regen + 3;
-        if (ang_regen2 >= 360)
-        {
-            ang_regen2 = ang_regen2 - 360;
-        }
-        lv_arc_set_angles(sd_current_regen_bar, ang_regen, ang_regen2);
+        gauge_set_range(&sd_current_gauge, 0, maxcurrent);
+        lv_sd_marker_update(&sd_current_gauge, sd_current_max_bar, wheelctl_get_max_data(WHEELCTL_CURRENT));
+        lv_sd_marker_update(&sd_current_gauge, sd_current_regen_bar, -wheelctl_get_min_data(WHEELCTL_CURRENT));
     }
 }
 
 void lv_sd_overlay_update()
 {
-    if (blectl_cli_getconnected())
+    bool connected = blectl_cli_getconnected();
+    if (connected == sd_overlay_connected)
     {
-        lv_style_set_line_opa(&sd_overlay_style, LV_STATE_DEFAULT, LV_OPA_TRANSP);
-        lv_style_set_bg_opa(&sd_overlay_style, LV_STATE_DEFAULT, LV_OPA_TRANSP);
-        lv_obj_add_style(sd_overlay_bar, LV_OBJ_PART_MAIN, &sd_overlay_style);
-        lv_obj_add_style(sd_overlay_line, LV_OBJ_PART_MAIN, &sd_overlay_style);
+        return;
+    }
+    if (connected)
+    {
+        lv_obj_remove_style(sd_overlay_bar, LV_OBJ_PART_MAIN, &sd_overlay_style);
+        lv_obj_remove_style(sd_overlay_line, LV_OBJ_PART_MAIN, &sd_overlay_style);
+        lv_obj_add_style(sd_overlay_bar, LV_OBJ_PART_MAIN, &sd_overlay_connected_style);
+        lv_obj_add_style(sd_overlay_line, LV_OBJ_PART_MAIN, &sd_overlay_connected_style);
     }
     else
     {
-        lv_style_set_line_opa(&sd_overlay_style, LV_STATE_DEFAULT, LV_OPA_20);
-        lv_style_set_bg_opa(&sd_overlay_style, LV_STATE_DEFAULT, LV_OPA_20);
+        lv_obj_remove_style(sd_overlay_bar, LV_OBJ_PART_MAIN, &sd_overlay_connected_style);
+        lv_obj_remove_style(sd_overlay_line, LV_OBJ_PART_MAIN, &sd_overlay_connected_style);
         lv_obj_add_style(sd_overlay_bar, LV_OBJ_PART_MAIN, &sd_overlay_style);
         lv_obj_add_style(sd_overlay_line, LV_OBJ_PART_MAIN, &sd_overlay_style);
     }
+    sd_overlay_connected = connected;
 }
 
 /************************
@@ -514,7 +476,6 @@ void lv_sd_overlay_update()
 
 static void lv_sd_dash_task(lv_task_t *sd_dash_task)
 {
-    lv_sd_speed_update();
     lv_sd_batt_update();
     if (dashboard_get_config(DASHBOARD_CURRENT))
     {
@@ -523,6 +484,11 @@ static void lv_sd_dash_task(lv_task_t *sd_dash_task)
     lv_sd_overlay_update();
 }
 
+static void lv_sd_anim_task(lv_task_t *sd_anim_task)
+{
+    lv_sd_speed_update();
+}
+
 void sd_stop_dash_task()
 {
     Serial.println("check if dash is running");
@@ -530,6 +496,12 @@ void sd_stop_dash_task()
     {
         Serial.println("shutting down dash");
         lv_task_del(sd_dash_task);
+        sd_dash_task = nullptr;
+    }
+    if (sd_anim_task != nullptr)
+    {
+        lv_task_del(sd_anim_task);
+        sd_anim_task = nullptr;
     }
 }
 
@@ -539,13 +511,24 @@ uint32_t simpledash_get_tile(void)
 }
 
 void simpledash_activate_cb( void ) {
-    //Create task -- update freq 4/s
-    sd_dash_task = lv_task_create(lv_sd_dash_task, 250, LV_TASK_PRIO_LOWEST, NULL);
+    //Create task -- update freq 4/s by default
+    sd_dash_task = callback_lv_task_create(lv_sd_dash_task, sd_dash_refresh, LV_TASK_PRIO_LOWEST, "sd dash task");
     lv_task_ready(sd_dash_task);
+    sd_anim_task = callback_lv_task_create(lv_sd_anim_task, GAUGEANIM_FRAME_MS, LV_TASK_PRIO_LOWEST, "sd anim task");
+    lv_task_ready(sd_anim_task);
 }
 
 void simpledash_hibernate_cb( void ) {
     lv_task_del( sd_dash_task );
+    lv_task_del( sd_anim_task );
+    sd_dash_task = nullptr;
+    sd_anim_task = nullptr;
+}
+
+void simpledash_set_refresh( uint32_t ms ) {
+    sd_dash_refresh = ms;
+    if ( sd_dash_task != nullptr )
+        lv_task_set_period( sd_dash_task, ms );
 }
 
 void simpledash_tile_reload ( void ) {
@@ -80,6 +80,7 @@ LV_FONT_DECLARE(DIN1451_m_cond_180);
 void simpledash_tile_setup(void);
 uint32_t simpledash_get_tile (void);
 void simpledash_tile_reload ( void );
+void simpledash_set_refresh ( uint32_t ms );
 
 //variable declarations
 
@@ -0,0 +1,223 @@
+/****************************************************************************
+ *   Copyright  2020  Jesper Ortlund
+ ****************************************************************************/
+/*
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+#include "config.h"
+#include <TTGO.h>
+#include <SPIFFS.h>
+
+#include "screenshot.h"
+
+#include "hardware/alloc.h"
+
+#define SCREENSHOT_IDLE             0
+#define SCREENSHOT_CAPTURE          1
+#define SCREENSHOT_WRITE            2
+
+#define SCREENSHOT_MAX_PACKET       0x8000
+
+static volatile int screenshot_state = SCREENSHOT_IDLE;
+static lv_color_t *screenshot_frame = NULL;
+static uint32_t screenshot_width = 0;
+static uint32_t screenshot_height = 0;
+static uint32_t screenshot_pixels = 0;
+static int64_t screenshot_start = 0;
+static int64_t screenshot_captured = 0;
+
+/**
+ * @brief compressed output, written to spiffs whenever the buffer is full
+ */
+typedef struct {
+    fs::File file;
+    uint8_t *data;
+    size_t len;
+    size_t total;
+    bool failed;
+} screenshot_out_t;
+
+static void screenshot_Task( void * pvParameters );
+static void screenshot_out( screenshot_out_t *out, const void *data, size_t len );
+static void screenshot_out_flush( screenshot_out_t *out );
+static void screenshot_compress( screenshot_out_t *out, const uint16_t *pixel, uint32_t count );
+
+bool screenshot_take( void ) {
+    /*
+     * no full refresh reached the display, e.g. we went to standby
+     */
+    if ( screenshot_state == SCREENSHOT_CAPTURE && esp_timer_get_time() - screenshot_start > SCREENSHOT_TIMEOUT * 1000 ) {
+        log_w("screenshot capture timed out");
+        free( screenshot_frame );
+        screenshot_frame = NULL;
+        screenshot_state = SCREENSHOT_IDLE;
+    }
+
+    if ( screenshot_state != SCREENSHOT_IDLE ) {
+        log_w("screenshot already running");
+        return( false );
+    }
+
+    screenshot_width = lv_disp_get_hor_res( NULL );
+    screenshot_height = lv_disp_get_ver_res( NULL );
+    screenshot_frame = (lv_color_t *)MALLOC( screenshot_width * screenshot_height * sizeof( lv_color_t ) );
+    if ( screenshot_frame == NULL ) {
+        log_e("screenshot frame alloc failed");
+        return( false );
+    }
+
+    /*
+     * the display buffers only hold a few lines, so let lvgl redraw the whole
+     * screen and pick up every band on its way to the display
+     */
+    screenshot_pixels = 0;
+    screenshot_start = esp_timer_get_time();
+    screenshot_state = SCREENSHOT_CAPTURE;
+    lv_obj_invalidate( lv_scr_act() );
+    return( true );
+}
+
+void screenshot_capture( const lv_area_t *area, const lv_color_t *color_p ) {
+    if ( screenshot_state != SCREENSHOT_CAPTURE )
+        return;
+
+    int32_t x1 = max( area->x1, (lv_coord_t)0 );
+    int32_t x2 = min( area->x2, (lv_coord_t)( screenshot_width - 1 ) );
+    int32_t y1 = max( area->y1, (lv_coord_t)0 );
+    int32_t y2 = min( area->y2, (lv_coord_t)( screenshot_height - 1 ) );
+    int32_t area_w = area->x2 - area->x1 + 1;
+
+    if ( x1 > x2 || y1 > y2 )
+        return;
+
+    for ( int32_t y = y1 ; y <= y2 ; y++ ) {
+        memcpy( &screenshot_frame[ y * screenshot_width + x1 ], &color_p[ ( y - area->y1 ) * area_w + ( x1 - area->x1 ) ], ( x2 - x1 + 1 ) * sizeof( lv_color_t ) );
+    }
+    screenshot_pixels += ( x2 - x1 + 1 ) * ( y2 - y1 + 1 );
+
+    if ( screenshot_pixels < screenshot_width * screenshot_height )
+        return;
+
+    screenshot_captured = esp_timer_get_time();
+    screenshot_state = SCREENSHOT_WRITE;
+    BaseType_t created = xTaskCreatePinnedToCore(   screenshot_Task,            /* Function to implement the task */
+                                                    "screenshot Task",          /* Name of the task */
+                                                    SCREENSHOT_TASK_STACK,      /* Stack size in words */
+                                                    NULL,                       /* Task input parameter */
+                                                    1,                          /* Priority of the task */
+                                                    NULL,                       /* Task handle. */
+                                                    0 );
+    if ( created != pdPASS ) {
+        log_e("screenshot task create failed");
+        free( screenshot_frame );
+        screenshot_frame = NULL;
+        screenshot_state = SCREENSHOT_IDLE;
+    }
+}
+
+bool screenshot_busy( void ) {
+    return( screenshot_state != SCREENSHOT_IDLE );
+}
+
+static void screenshot_Task( void * pvParameters ) {
+    screenshot_out_t out;
+    screenshot_header_t header;
+
+    out.data = (uint8_t *)MALLOC( SCREENSHOT_OUT_SIZE );
+    out.len = 0;
+    out.total = 0;
+    out.failed = false;
+    out.file = SPIFFS.open( SCREENSHOT_FILE, FILE_WRITE );
+
+    if ( out.data == NULL || !out.file ) {
+        log_e("can't write %s", SCREENSHOT_FILE );
+    }
+    else {
+        header.magic = SCREENSHOT_MAGIC;
+        header.width = screenshot_width;
+        header.height = screenshot_height;
+        header.depth = LV_COLOR_DEPTH;
+        header.flags = LV_COLOR_16_SWAP ? SCREENSHOT_FLAG_SWAP : 0;
+        header.reserved = 0;
+        screenshot_out( &out, &header, sizeof( header ) );
+        screenshot_compress( &out, (const uint16_t *)screenshot_frame, screenshot_width * screenshot_height );
+        screenshot_out_flush( &out );
+
+        int64_t done = esp_timer_get_time();
+        Serial.printf("screenshot %s: %u -> %u bytes, captured in %lldms, done in %lldms%s\r\n", SCREENSHOT_FILE,
+                                                                                               screenshot_width * screenshot_height * sizeof( lv_color_t ),
+                                                                                               out.total,
+                                                                                               ( screenshot_captured - screenshot_start ) / 1000,
+                                                                                               ( done - screenshot_start ) / 1000,
+                                                                                               out.failed ? ", write failed" : "" );
+    }
+
+    if ( out.file )
+        out.file.close();
+    free( out.data );
+    free( screenshot_frame );
+    screenshot_frame = NULL;
+    screenshot_state = SCREENSHOT_IDLE;
+    vTaskDelete( NULL );
+}
+
+static void screenshot_compress( screenshot_out_t *out, const uint16_t *pixel, uint32_t count ) {
+    uint32_t i = 0;
+
+    while ( i < count ) {
+        uint32_t run = 1;
+        while ( i + run < count && run < SCREENSHOT_MAX_PACKET && pixel[ i + run ] == pixel[ i ] )
+            run++;
+
+        if ( run > 1 ) {
+            uint16_t packet = 0x8000 | ( run - 1 );
+            screenshot_out( out, &packet, sizeof( packet ) );
+            screenshot_out( out, &pixel[ i ], sizeof( uint16_t ) );
+            i += run;
+            continue;
+        }
+
+        /*
+         * literals end where the next run starts
+         */
+        uint32_t start = i;
+        while ( i < count && i - start < SCREENSHOT_MAX_PACKET && !( i + 1 < count && pixel[ i ] == pixel[ i + 1 ] ) )
+            i++;
+        uint16_t packet = i - start - 1;
+        screenshot_out( out, &packet, sizeof( packet ) );
+        screenshot_out( out, &pixel[ start ], ( i - start ) * sizeof( uint16_t ) );
+    }
+}
+
+static void screenshot_out( screenshot_out_t *out, const void *data, size_t len ) {
+    const uint8_t *bytes = (const uint8_t *)data;
+
+    while ( len > 0 ) {
+        size_t n = min( len, (size_t)( SCREENSHOT_OUT_SIZE - out->len ) );
+        memcpy( &out->data[ out->len ], bytes, n );
+        out->len += n;
+        bytes += n;
+        len -= n;
+        if ( out->len == SCREENSHOT_OUT_SIZE )
+            screenshot_out_flush( out );
+    }
+}
+
+static void screenshot_out_flush( screenshot_out_t *out ) {
+    if ( out->len && out->file.write( out->data, out->len ) != out->len )
+        out->failed = true;
+    out->total += out->len;
+    out->len = 0;
+}
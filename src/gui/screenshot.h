@@ -0,0 +1,67 @@
+/****************************************************************************
+ *   Copyright  2020  Jesper Ortlund
+ ****************************************************************************/
+/*
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+#ifndef _SCREENSHOT_H
+    #define _SCREENSHOT_H
+
+    #include <TTGO.h>
+
+    #define SCREENSHOT_FILE             "/screenshot.rle"   /** @brief capture file on spiffs, tools/rle2png.py turns it into a png */
+    #define SCREENSHOT_MAGIC            0x31535345          /** @brief "ESS1" little endian */
+    #define SCREENSHOT_FLAG_SWAP        0x01                /** @brief pixels are rgb565 with swapped bytes */
+    #define SCREENSHOT_OUT_SIZE         4096                /** @brief compressed bytes buffered per spiffs write */
+    #define SCREENSHOT_TASK_STACK       3072                /** @brief stack size of the compress task */
+    #define SCREENSHOT_TIMEOUT          2000                /** @brief ms after which a capture that saw no full refresh is given up */
+
+    /**
+     * @brief capture file header, followed by rle packets until the end of the file.
+     * a packet starts with a little endian uint16, bit 15 set means the next pixel
+     * repeats (n & 0x7fff) + 1 times, clear means n + 1 literal pixels follow
+     */
+    typedef struct __attribute__((packed)) {
+        uint32_t magic;                                     /** @brief SCREENSHOT_MAGIC */
+        uint16_t width;                                     /** @brief width in pixels */
+        uint16_t height;                                    /** @brief height in pixels */
+        uint8_t depth;                                      /** @brief bits per pixel, 16 */
+        uint8_t flags;                                      /** @brief SCREENSHOT_FLAG_SWAP */
+        uint16_t reserved;
+    } screenshot_header_t;
+
+    /**
+     * @brief start a capture, the next full refresh is copied to psram as lvgl flushes
+     * it, compressing and writing to spiffs runs in a task on core 0. call from the
+     * lvgl task
+     *
+     * @return  true if started, false if a capture is still running or out of memory
+     */
+    bool screenshot_take( void );
+    /**
+     * @brief copy a flushed area into a running capture, called by the display flush
+     *
+     * @param   area        flushed area
+     * @param   color_p     pixels of the area
+     */
+    void screenshot_capture( const lv_area_t *area, const lv_color_t *color_p );
+    /**
+     * @brief check for a running capture
+     *
+     * @return  true while capturing or writing
+     */
+    bool screenshot_busy( void );
+
+#endif // _SCREENSHOT_H
@@ -34,7 +34,8 @@
 
 int add_ride_millis (void);
 byte KS_BLEreq[20];
-String wheelmodel = "KS14D";
+static char ks_name[KS_NAME_LEN + 1] = "";
+static char ks_serial[KS_SERIAL_LEN + 1] = "";
 
 /**************************************************
    Decode big endian multi byte data from KS wheels
@@ -53,50 +54,46 @@ static int decode4byte(byte byte1, byte byte2, byte byte3, byte byte4)
     return val;
 }
 
-void setKSconstants(String model)
+static void setKSconstants(const ks_model_t *model)
 {
-    if (model = "KS14D")
-    {
-        wheelctl_set_constant(WHEELCTL_CONST_MAXCURRENT, KS_14D_MAXCURRENT);
-        wheelctl_set_constant(WHEELCTL_CONST_CRITTEMP, KS_14D_CRITTEMP);
-        wheelctl_set_constant(WHEELCTL_CONST_WARNTEMP, KS_14D_WARNTEMP);
-        wheelctl_set_constant(WHEELCTL_CONST_BATTVOLT, KS_14D_BATTVOLT);
-        wheelctl_set_constant(WHEELCTL_CONST_BATTWARN, KS_14D_BATTWARN);
-    }
-    else if (model = "KS14S")
-    {
-        wheelctl_set_constant(WHEELCTL_CONST_MAXCURRENT, KS_14S_MAXCURRENT);
-        wheelctl_set_constant(WHEELCTL_CONST_CRITTEMP, KS_14S_CRITTEMP);
-        wheelctl_set_constant(WHEELCTL_CONST_WARNTEMP, KS_14S_WARNTEMP);
-        wheelctl_set_constant(WHEELCTL_CONST_BATTVOLT, KS_14S_BATTVOLT);
-        wheelctl_set_constant(WHEELCTL_CONST_BATTWARN, KS_14S_BATTWARN);
-    }
-    else if (model = "KS16S")
-    {
-        wheelctl_set_constant(WHEELCTL_CONST_MAXCURRENT, KS_16S_MAXCURRENT);
-        wheelctl_set_constant(WHEELCTL_CONST_CRITTEMP, KS_16S_CRITTEMP);
-        wheelctl_set_constant(WHEELCTL_CONST_WARNTEMP, KS_16S_WARNTEMP);
-        wheelctl_set_constant(WHEELCTL_CONST_BATTVOLT, KS_16S_BATTVOLT);
-        wheelctl_set_constant(WHEELCTL_CONST_BATTWARN, KS_16S_BATTWARN);
-    }
-    else if (model = "KS16X")
+    wheelctl_set_constant(WHEELCTL_CONST_MAXCURRENT, model->maxcurrent);
+    wheelctl_set_constant(WHEELCTL_CONST_CRITTEMP, model->crittemp);
+    wheelctl_set_constant(WHEELCTL_CONST_WARNTEMP, model->warntemp);
+    wheelctl_set_constant(WHEELCTL_CONST_BATTVOLT, model->battvolt);
+    wheelctl_set_constant(WHEELCTL_CONST_BATTWARN, model->battwarn);
+    wheelctl_set_constant(WHEELCTL_CONST_MAXSPEED, model->maxspeed);
+}
+
+static void decodeKSname(byte KSdata[])
+{
+    const ks_model_t *entry = ks_model_decode_name(KSdata, ks_name);
+    if (entry)
     {
-        wheelctl_set_constant(WHEELCTL_CONST_MAXCURRENT, KS_16X_MAXCURRENT);
-        wheelctl_set_constant(WHEELCTL_CONST_CRITTEMP, KS_16X_CRITTEMP);
-        wheelctl_set_constant(WHEELCTL_CONST_WARNTEMP, KS_16X_WARNTEMP);
-        wheelctl_set_constant(WHEELCTL_CONST_BATTVOLT, KS_16X_BATTVOLT);
-        wheelctl_set_constant(WHEELCTL_CONST_BATTWARN, KS_16X_BATTWARN);
+        log_i("wheel %s, model %s", ks_name, entry->name);
+        setKSconstants(entry);
     }
     else
     {
-        wheelctl_set_constant(WHEELCTL_CONST_MAXCURRENT, KS_DEFAULT_MAXCURRENT);
-        wheelctl_set_constant(WHEELCTL_CONST_CRITTEMP, KS_DEFAULT_CRITTEMP);
-        wheelctl_set_constant(WHEELCTL_CONST_WARNTEMP, KS_DEFAULT_WARNTEMP);
-        wheelctl_set_constant(WHEELCTL_CONST_BATTVOLT, KS_DEFAULT_BATTVOLT);
-        wheelctl_set_constant(WHEELCTL_CONST_BATTWARN, KS_DEFAULT_BATTWARN);
+        log_w("wheel %s, unknown model, using defaults", ks_name);
     }
 }
 
+static void decodeKSserial(byte KSdata[])
+{
+    ks_model_decode_serial(KSdata, ks_serial);
+    log_i("wheel serial %s", ks_serial);
+}
+
+const char *ks_get_name(void)
+{
+    return (ks_name);
+}
+
+const char *ks_get_serial(void)
+{
+    return (ks_serial);
+}
+
 /*************************************************************
     Kingsong wheel data decoder adds current values to
     the wheeldata array. Prootocol decoding from Wheellog by
@@ -107,7 +104,6 @@ void setKSconstants(String model)
     Function is called on by the notifyCallback function in blectl
     decoded data is added to the data struct in wheelctl
     Todo:
-    - Add Serial and model number
     - Add periodical polling of speed settings? Verify by
       testing with low battery
  ************************************************************/
@@ -140,6 +136,14 @@ void decodeKS(byte KSdata[])
         wheelctl_set_data(WHEELCTL_ALARM3, KSdata[8]);
         wheelctl_set_data(WHEELCTL_TILTBACK, KSdata[10]);
     }
+    else if (KSdata[16] == 0xbb)
+    {   //Answer to 0x9b, wheel name with model
+        decodeKSname(KSdata);
+    }
+    else if (KSdata[16] == 0xb3)
+    {   //Answer to 0x63, serial number
+        decodeKSserial(KSdata);
+    }
     wheelctl_set_data(WHEELCTL_RIDETIME,  (add_ride_millis() / 1000));
 } // End decodeKS
 
@@ -147,8 +151,8 @@ void ks_ble_request(byte reqtype)
 {
     /****************************************************************
       reqtype is the byte representing the request id
-      0x9B -- Serial Number
-      0x63 -- Manufacturer and model
+      0x9B -- Manufacturer and model
+      0x63 -- Serial Number
       0x98 -- speed alarm settings and tiltback (Max) speed
       0x88 -- horn
       Responses to the request is handled by the notification handler
@@ -177,10 +181,10 @@ int add_ride_millis () {
 
 void initks()
 {
-    //temporary model strings, Todo: implement automated id;
-    //Setting of some model specific parametes,
-    //Todo: automatic model identification
-    setKSconstants(wheelmodel);
+    //Defaults until the name frame identifies the model
+    ks_name[0] = '\0';
+    ks_serial[0] = '\0';
+    setKSconstants(&ks_default_model);
     /*****************************************
        Request Kingsong Model Name, serial number and speed settings
        This must be done before any BLE notifications will be pused by the KS wheel
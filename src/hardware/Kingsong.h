@@ -22,44 +22,23 @@
 #ifndef __KINGSONG_H
 #define __KINGSONG_H
 
-/*define constants for specific KS wheel models 
-* add here when adding support for a new model
-*/
-#define KS_DEFAULT_MAXCURRENT   35
-#define KS_DEFAULT_CRITTEMP     65
-#define KS_DEFAULT_WARNTEMP     50
-#define KS_DEFAULT_BATTVOLT     67
-#define KS_DEFAULT_BATTWARN     40
-
-#define KS_14D_MAXCURRENT   35
-#define KS_14D_CRITTEMP     65
-#define KS_14D_WARNTEMP     50
-#define KS_14D_BATTVOLT     67
-#define KS_14D_BATTWARN     40
-
-#define KS_14S_MAXCURRENT   35
-#define KS_14S_CRITTEMP     65
-#define KS_14S_WARNTEMP     50
-#define KS_14S_BATTVOLT     67
-#define KS_14S_BATTWARN     25
-
-#define KS_16S_MAXCURRENT   40
-#define KS_16S_CRITTEMP     65
-#define KS_16S_WARNTEMP     50
-#define KS_16S_BATTVOLT     67
-#define KS_16S_BATTWARN     25
-
-#define KS_16X_MAXCURRENT   45
-#define KS_16X_CRITTEMP     65
-#define KS_16X_WARNTEMP     50
-#define KS_16X_BATTVOLT     84
-#define KS_16X_BATTWARN     25
-
-
 #include <TTGO.h>
 #include "callback.h"
+#include "ks_model.h"
 
 void decodeKS(byte KSData[]);
 void initks();
+/**
+ * @brief get the wheel name as reported by the wheel, like "KS-16X-0215"
+ *
+ * @return  name or an empty string until the wheel answered
+ */
+const char *ks_get_name(void);
+/**
+ * @brief get the wheel serial number
+ *
+ * @return  serial or an empty string until the wheel answered
+ */
+const char *ks_get_serial(void);
 
 #endif /* __KINGSONG */
\ No newline at end of file
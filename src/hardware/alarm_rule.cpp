@@ -0,0 +1,97 @@
+/****************************************************************************
+ *   Copyright  2020  Jesper Ortlund
+ ****************************************************************************/
+/*
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+#include <string.h>
+
+#include "alarm_rule.h"
+
+static bool alarm_rule_compare( uint8_t cmp, float value, float threshold );
+
+void alarm_rule_reset( alarm_rule_state_t *state, int rules ) {
+    memset( state, 0, sizeof( alarm_rule_state_t ) * rules );
+}
+
+float alarm_rule_threshold( const alarm_rule_t *rule, const float *data, int data_num, const uint8_t *constants, int const_num ) {
+    switch( rule->ref ) {
+        case ALARM_RULE_REF_DATA:       if ( rule->ref_entry >= data_num )
+                                            return( 0 );
+                                        return( rule->threshold * data[ rule->ref_entry ] );
+        case ALARM_RULE_REF_CONST:      if ( rule->ref_entry >= const_num )
+                                            return( 0 );
+                                        return( rule->threshold * constants[ rule->ref_entry ] );
+        default:                        return( rule->threshold );
+    }
+}
+
+uint32_t alarm_rule_eval( const alarm_rule_t *rule, alarm_rule_state_t *state, int rules, const float *data, int data_num, const uint8_t *constants, int const_num, uint32_t now, uint8_t *band ) {
+    uint32_t went_active = 0;
+
+    if ( band )
+        memset( band, 0, data_num );
+
+    for ( int n = 0 ; n < rules && n < ALARM_RULE_MAX ; n++, rule++, state++ ) {
+        if ( rule->field >= data_num )
+            continue;
+
+        float value = data[ rule->field ];
+        float threshold = alarm_rule_threshold( rule, data, data_num, constants, const_num );
+        /*
+         * a reference of 0 isn't known yet, e.g. the alarm speeds before their frame came in
+         */
+        bool known = rule->ref == ALARM_RULE_REF_NONE || threshold != 0;
+
+        /*
+         * an active rule only clears once the value is hysteresis back on the other side
+         */
+        if ( state->active ) {
+            if ( rule->cmp == ALARM_RULE_LT || rule->cmp == ALARM_RULE_LE )
+                threshold += rule->hysteresis;
+            else
+                threshold -= rule->hysteresis;
+        }
+
+        if ( !known || !alarm_rule_compare( rule->cmp, value, threshold ) ) {
+            state->active = false;
+            state->holding = false;
+        }
+        else if ( !state->active ) {
+            if ( !state->holding ) {
+                state->holding = true;
+                state->since = now;
+            }
+            if ( now - state->since >= rule->duration ) {
+                state->active = true;
+                went_active |= 1UL << n;
+            }
+        }
+
+        if ( band && state->active && ( rule->actions & ALARM_RULE_BAND ) && band[ rule->field ] == 0 )
+            band[ rule->field ] = rule->band;
+    }
+    return( went_active );
+}
+
+static bool alarm_rule_compare( uint8_t cmp, float value, float threshold ) {
+    switch( cmp ) {
+        case ALARM_RULE_GT:             return( value > threshold );
+        case ALARM_RULE_GE:             return( value >= threshold );
+        case ALARM_RULE_LT:             return( value < threshold );
+        case ALARM_RULE_LE:             return( value <= threshold );
+        default:                        return( false );
+    }
+}
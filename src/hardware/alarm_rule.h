@@ -0,0 +1,105 @@
+/****************************************************************************
+ *   Copyright  2020  Jesper Ortlund
+ ****************************************************************************/
+/*
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+#ifndef _ALARM_RULE_H
+    #define _ALARM_RULE_H
+
+    /*
+     * no arduino or freertos in here, rule evaluation builds and runs on the host
+     */
+    #include <stdint.h>
+
+    #define ALARM_RULE_MAX              24          /** @brief max rules in a table, edges are reported in a uint32_t */
+
+    #define ALARM_RULE_GT               0           /** @brief value > threshold */
+    #define ALARM_RULE_GE               1           /** @brief value >= threshold */
+    #define ALARM_RULE_LT               2           /** @brief value < threshold */
+    #define ALARM_RULE_LE               3           /** @brief value <= threshold */
+
+    #define ALARM_RULE_REF_NONE         0           /** @brief threshold is an absolute value */
+    #define ALARM_RULE_REF_DATA         1           /** @brief threshold is a fraction of a wheel data entry, like the tiltback speed */
+    #define ALARM_RULE_REF_CONST        2           /** @brief threshold is a fraction of a wheel constant, like the max current */
+
+    #define ALARM_RULE_BAND             ( 1 << 0 )  /** @brief action: show the colour band on the gauges of the field */
+    #define ALARM_RULE_HAPTIC           ( 1 << 1 )  /** @brief action: play the haptic pattern while active */
+    #define ALARM_RULE_JUMP             ( 1 << 2 )  /** @brief action: wake up and jump to the dash when going active */
+
+    /**
+     * @brief one alarm rule, plain data so a table can live in the config store
+     */
+    typedef struct {
+        uint8_t field;                              /** @brief wheel data entry compared */
+        uint8_t cmp;                                /** @brief ALARM_RULE_GT, ALARM_RULE_GE, ALARM_RULE_LT or ALARM_RULE_LE */
+        uint8_t ref;                                /** @brief ALARM_RULE_REF_NONE, ALARM_RULE_REF_DATA or ALARM_RULE_REF_CONST */
+        uint8_t ref_entry;                          /** @brief wheel data entry or constant the threshold is a fraction of */
+        float threshold;                            /** @brief absolute threshold or fraction of the reference */
+        float hysteresis;                           /** @brief how far the value has to fall back past the threshold to clear */
+        uint16_t duration;                          /** @brief ms the condition has to hold before the rule goes active */
+        uint8_t actions;                            /** @brief ALARM_RULE_BAND, ALARM_RULE_HAPTIC and ALARM_RULE_JUMP bits */
+        uint8_t band;                               /** @brief colour band while active, 0 is the normal band */
+        uint8_t haptic;                             /** @brief haptic pattern while active */
+    } alarm_rule_t;
+
+    /**
+     * @brief evaluation state of one rule
+     */
+    typedef struct {
+        bool active;                                /** @brief rule fired and didn't clear yet */
+        bool holding;                               /** @brief condition holds, waiting for the duration */
+        uint32_t since;                             /** @brief ms the condition started to hold */
+    } alarm_rule_state_t;
+
+    /**
+     * @brief reset the state of all rules
+     *
+     * @param   state       pointer to rules states
+     * @param   rules       number of rules
+     */
+    void alarm_rule_reset( alarm_rule_state_t *state, int rules );
+    /**
+     * @brief resolve the threshold of a rule
+     *
+     * @param   rule        pointer to the rule
+     * @param   data        wheel data values, indexed by entry
+     * @param   data_num    number of wheel data values
+     * @param   constants   wheel constants, indexed by entry
+     * @param   const_num   number of wheel constants
+     *
+     * @return  threshold, 0 if the reference is out of range
+     */
+    float alarm_rule_threshold( const alarm_rule_t *rule, const float *data, int data_num, const uint8_t *constants, int const_num );
+    /**
+     * @brief evaluate all rules once against the current wheel data, no allocation, O(rules).
+     * a rule with a reference that is still 0 doesn't hold
+     *
+     * @param   rule        pointer to the rule table
+     * @param   state       pointer to rules states
+     * @param   rules       number of rules, at most ALARM_RULE_MAX
+     * @param   data        wheel data values, indexed by entry
+     * @param   data_num    number of wheel data values
+     * @param   constants   wheel constants, indexed by entry
+     * @param   const_num   number of wheel constants
+     * @param   now         time in ms
+     * @param   band        data_num bands to fill, per field the band of the first active rule
+     *                      with ALARM_RULE_BAND in table order, 0 for none. can be NULL
+     *
+     * @return  bit n set if rule n went active in this evaluation
+     */
+    uint32_t alarm_rule_eval( const alarm_rule_t *rule, alarm_rule_state_t *state, int rules, const float *data, int data_num, const uint8_t *constants, int const_num, uint32_t now, uint8_t *band );
+
+#endif // _ALARM_RULE_H
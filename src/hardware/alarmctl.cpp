@@ -0,0 +1,352 @@
+/****************************************************************************
+ *   Copyright  2020  Jesper Ortlund
+ ****************************************************************************/
+/*
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+#include "config.h"
+#include <TTGO.h>
+
+#include "alarmctl.h"
+#include "wheelctl.h"
+#include "motor.h"
+#include "powermgm.h"
+
+#include "configstore.h"
+#include "json_psram_allocator.h"
+
+#include "gui/bandstyle.h"
+
+/**
+ * @brief a haptic pattern, pulses vibrations gap ms apart, repeated every period ms
+ */
+typedef struct {
+    uint16_t period;
+    uint8_t vibe;
+    uint8_t pulses;
+    uint16_t gap;
+} alarmctl_haptic_t;
+
+static const alarmctl_haptic_t alarmctl_haptic[ ALARMCTL_HAPTIC_NUM ] = {
+    { 0,      0,  0,  0 },
+    { 250,    10, 1,  0 },
+    { 500,    50, 1,  0 },
+    { 1000,   10, 2,  150 },
+};
+
+/*
+ * json names, indexed like the wheelctl, alarm_rule, bandstyle and haptic enums
+ */
+static const char *alarmctl_field_name[] = { "voltage", "speed", "odo", "current", "temp", "rmode", "battpct", "power", "trip",
+                                             "uptime", "topspeed", "fanstate", "alarm1", "alarm2", "alarm3", "tiltback", "ridetime" };
+static const char *alarmctl_const_name[] = { "maxcurrent", "crittemp", "warntemp", "battvolt", "battwarn", "maxspeed" };
+static const char *alarmctl_cmp_name[] = { ">", ">=", "<", "<=" };
+static const char *alarmctl_band_name[] = { "normal", "warn", "crit", "regen" };
+static const char *alarmctl_haptic_name[] = { "none", "tick", "pulse", "double" };
+
+static_assert( sizeof( alarmctl_field_name ) / sizeof( char * ) == WHEELCTL_DATA_NUM, "alarmctl_field_name doesn't match the wheelctl data entries" );
+static_assert( sizeof( alarmctl_const_name ) / sizeof( char * ) == WHEELCTL_CONST_NUM, "alarmctl_const_name doesn't match the wheelctl constants" );
+static_assert( sizeof( alarmctl_band_name ) / sizeof( char * ) == BANDSTYLE_NUM, "alarmctl_band_name doesn't match the colour bands" );
+static_assert( sizeof( alarmctl_haptic_name ) / sizeof( char * ) == ALARMCTL_HAPTIC_NUM, "alarmctl_haptic_name doesn't match the haptic patterns" );
+
+static const alarmctl_json_names_t alarmctl_json_names = {
+    alarmctl_field_name,    WHEELCTL_DATA_NUM,
+    alarmctl_cmp_name,      4,
+    alarmctl_const_name,    WHEELCTL_CONST_NUM,
+    alarmctl_band_name,     BANDSTYLE_NUM,
+    alarmctl_haptic_name,   ALARMCTL_HAPTIC_NUM,
+};
+
+/*
+ * what the tiles and haptics did before the rules, the band rules come first within a field
+ * as the first active one wins. the current haptic waits 200ms so a spike doesn't buzz
+ */
+static const alarm_rule_t alarmctl_default_rule[] = {
+   /* field             cmp            ref                   ref entry                  thres  hyst  ms   actions                                                band              haptic */
+    { WHEELCTL_SPEED,   ALARM_RULE_GE, ALARM_RULE_REF_DATA,  WHEELCTL_TILTBACK,         1.0,   1.0,  0,   ALARM_RULE_BAND,                                       BANDSTYLE_CRIT,   ALARMCTL_HAPTIC_NONE },
+    { WHEELCTL_SPEED,   ALARM_RULE_GE, ALARM_RULE_REF_DATA,  WHEELCTL_ALARM3,           1.0,   1.0,  0,   ALARM_RULE_BAND | ALARM_RULE_HAPTIC | ALARM_RULE_JUMP, BANDSTYLE_WARN,   ALARMCTL_HAPTIC_TICK },
+    { WHEELCTL_BATTPCT, ALARM_RULE_LT, ALARM_RULE_REF_NONE,  0,                         10.0,  1.0,  0,   ALARM_RULE_BAND,                                       BANDSTYLE_CRIT,   ALARMCTL_HAPTIC_NONE },
+    { WHEELCTL_BATTPCT, ALARM_RULE_LT, ALARM_RULE_REF_CONST, WHEELCTL_CONST_BATTWARN,   1.0,   1.0,  0,   ALARM_RULE_BAND,                                       BANDSTYLE_WARN,   ALARMCTL_HAPTIC_NONE },
+    { WHEELCTL_CURRENT, ALARM_RULE_GT, ALARM_RULE_REF_CONST, WHEELCTL_CONST_MAXCURRENT, 0.75,  2.0,  0,   ALARM_RULE_BAND,                                       BANDSTYLE_CRIT,   ALARMCTL_HAPTIC_NONE },
+    { WHEELCTL_CURRENT, ALARM_RULE_GT, ALARM_RULE_REF_CONST, WHEELCTL_CONST_MAXCURRENT, 0.5,   2.0,  0,   ALARM_RULE_BAND,                                       BANDSTYLE_WARN,   ALARMCTL_HAPTIC_NONE },
+    { WHEELCTL_CURRENT, ALARM_RULE_LT, ALARM_RULE_REF_NONE,  0,                         0.0,   0.5,  0,   ALARM_RULE_BAND,                                       BANDSTYLE_REGEN,  ALARMCTL_HAPTIC_NONE },
+    { WHEELCTL_CURRENT, ALARM_RULE_GT, ALARM_RULE_REF_CONST, WHEELCTL_CONST_MAXCURRENT, 0.75,  2.0,  200, ALARM_RULE_HAPTIC | ALARM_RULE_JUMP,                   BANDSTYLE_NORMAL, ALARMCTL_HAPTIC_PULSE },
+    { WHEELCTL_TEMP,    ALARM_RULE_GT, ALARM_RULE_REF_CONST, WHEELCTL_CONST_CRITTEMP,   1.0,   1.0,  0,   ALARM_RULE_BAND | ALARM_RULE_HAPTIC | ALARM_RULE_JUMP, BANDSTYLE_CRIT,   ALARMCTL_HAPTIC_DOUBLE },
+    { WHEELCTL_TEMP,    ALARM_RULE_GT, ALARM_RULE_REF_CONST, WHEELCTL_CONST_WARNTEMP,   1.0,   1.0,  0,   ALARM_RULE_BAND,                                       BANDSTYLE_WARN,   ALARMCTL_HAPTIC_NONE },
+};
+
+#define ALARMCTL_DEFAULT_RULES  ( (int)( sizeof( alarmctl_default_rule ) / sizeof( alarm_rule_t ) ) )
+
+callback_t *alarmctl_callback = NULL;
+portMUX_TYPE DRAM_ATTR alarmctlMux = portMUX_INITIALIZER_UNLOCKED;
+
+static alarmctl_config_t alarmctl_config;
+static alarmctl_config_t alarmctl_parsed;
+static alarm_rule_state_t alarmctl_state[ ALARM_RULE_MAX ];
+static uint8_t alarmctl_band[ WHEELCTL_DATA_NUM ];
+static uint32_t alarmctl_pending = 0;
+static uint32_t alarmctl_haptic_mask = 0;
+static uint32_t alarmctl_haptic_next[ ALARMCTL_HAPTIC_NUM ];
+static uint8_t alarmctl_haptic_pulse[ ALARMCTL_HAPTIC_NUM ];
+static bool alarmctl_haptic_running[ ALARMCTL_HAPTIC_NUM ];
+
+bool alarmctl_powermgm_loop_cb( EventBits_t event, void *arg );
+static bool alarmctl_send_event_cb( EventBits_t event, void *arg );
+static void alarmctl_haptic_play( uint32_t mask );
+static void alarmctl_set_rules( const alarmctl_config_t *config );
+static void alarmctl_set_default_rules( alarmctl_config_t *config );
+
+void alarmctl_setup( void ) {
+    alarmctl_read_config();
+    powermgm_register_loop_cb( POWERMGM_STANDBY | POWERMGM_SILENCE_WAKEUP | POWERMGM_WAKEUP, alarmctl_powermgm_loop_cb, "alarmctl loop" );
+}
+
+void alarmctl_eval( void ) {
+    float data[ WHEELCTL_DATA_NUM ];
+    uint8_t constants[ WHEELCTL_CONST_NUM ];
+    uint8_t band[ WHEELCTL_DATA_NUM ];
+    uint32_t now = millis();
+    uint32_t wake = 0;
+
+    for ( int entry = 0 ; entry < WHEELCTL_DATA_NUM ; entry++ ) {
+        data[ entry ] = wheelctl_get_data( entry );
+    }
+    for ( int entry = 0 ; entry < WHEELCTL_CONST_NUM ; entry++ ) {
+        constants[ entry ] = wheelctl_get_constant( entry );
+    }
+
+    portENTER_CRITICAL( &alarmctlMux );
+    uint32_t went_active = alarm_rule_eval( alarmctl_config.rule, alarmctl_state, alarmctl_config.rules, data, WHEELCTL_DATA_NUM, constants, WHEELCTL_CONST_NUM, now, band );
+    uint32_t haptic_mask = 0;
+    for ( int n = 0 ; n < alarmctl_config.rules ; n++ ) {
+        if ( alarmctl_state[ n ].active && ( alarmctl_config.rule[ n ].actions & ALARM_RULE_HAPTIC ) )
+            haptic_mask |= 1UL << alarmctl_config.rule[ n ].haptic;
+        if ( ( went_active & ( 1UL << n ) ) && ( alarmctl_config.rule[ n ].actions & ( ALARM_RULE_HAPTIC | ALARM_RULE_JUMP ) ) )
+            wake |= 1UL << n;
+    }
+    memcpy( alarmctl_band, band, sizeof( alarmctl_band ) );
+    alarmctl_haptic_mask = haptic_mask;
+    alarmctl_pending |= went_active;
+    portEXIT_CRITICAL( &alarmctlMux );
+
+    /*
+     * a wakeup request, not a doubleclick, that one sends an awake watch to standby
+     */
+    if ( wake )
+        powermgm_set_event( POWERMGM_WAKEUP_REQUEST );
+}
+
+int alarmctl_get_band( int field ) {
+    if ( field < 0 || field >= WHEELCTL_DATA_NUM )
+        return( BANDSTYLE_NORMAL );
+    return( alarmctl_band[ field ] );
+}
+
+int alarmctl_get_rule_num( void ) {
+    return( alarmctl_config.rules );
+}
+
+bool alarmctl_get_rule( int n, alarm_rule_t *rule, bool *active ) {
+    bool valid = false;
+
+    portENTER_CRITICAL( &alarmctlMux );
+    if ( n >= 0 && n < alarmctl_config.rules ) {
+        *rule = alarmctl_config.rule[ n ];
+        *active = alarmctl_state[ n ].active;
+        valid = true;
+    }
+    portEXIT_CRITICAL( &alarmctlMux );
+    return( valid );
+}
+
+void alarmctl_describe_rule( const alarm_rule_t *rule, char *text, size_t size ) {
+    const char *ref = "";
+
+    if ( rule->ref == ALARM_RULE_REF_DATA && rule->ref_entry < WHEELCTL_DATA_NUM )
+        ref = alarmctl_field_name[ rule->ref_entry ];
+    else if ( rule->ref == ALARM_RULE_REF_CONST && rule->ref_entry < WHEELCTL_CONST_NUM )
+        ref = alarmctl_const_name[ rule->ref_entry ];
+
+    snprintf( text, size, "%s %s %.2f %s h%.1f %ums%s%s%s%s",
+                          rule->field < WHEELCTL_DATA_NUM ? alarmctl_field_name[ rule->field ] : "?",
+                          rule->cmp < 4 ? alarmctl_cmp_name[ rule->cmp ] : "?",
+                          rule->threshold, ref, rule->hysteresis, rule->duration,
+                          ( rule->actions & ALARM_RULE_BAND ) && rule->band < BANDSTYLE_NUM ? " " : "",
+                          ( rule->actions & ALARM_RULE_BAND ) && rule->band < BANDSTYLE_NUM ? alarmctl_band_name[ rule->band ] : "",
+                          ( rule->actions & ALARM_RULE_HAPTIC ) && rule->haptic < ALARMCTL_HAPTIC_NUM ? " " : "",
+                          ( rule->actions & ALARM_RULE_HAPTIC ) && rule->haptic < ALARMCTL_HAPTIC_NUM ? alarmctl_haptic_name[ rule->haptic ] : "" );
+    if ( rule->actions & ALARM_RULE_JUMP )
+        strlcat( text, " jump", size );
+}
+
+bool alarmctl_powermgm_loop_cb( EventBits_t event, void *arg ) {
+    portENTER_CRITICAL( &alarmctlMux );
+    uint32_t pending = alarmctl_pending;
+    uint32_t haptic_mask = alarmctl_haptic_mask;
+    alarmctl_pending = 0;
+    portEXIT_CRITICAL( &alarmctlMux );
+
+    /*
+     * the callbacks run here and not in alarmctl_eval, that one is called from the ble task.
+     * they get a copy, the table can be reloaded while they run
+     */
+    for ( int n = 0 ; pending && n < ALARM_RULE_MAX ; n++ ) {
+        alarm_rule_t rule;
+        bool active;
+
+        if ( pending & ( 1UL << n ) ) {
+            pending &= ~( 1UL << n );
+            if ( !alarmctl_get_rule( n, &rule, &active ) )
+                continue;
+            log_i("alarm rule %d active", n );
+            alarmctl_send_event_cb( ALARMCTL_ON, (void *)&rule );
+        }
+    }
+
+    if ( event == POWERMGM_STANDBY )
+        haptic_mask = 0;
+    alarmctl_haptic_play( haptic_mask );
+
+    return( true );
+}
+
+/**
+ * @brief vibrate the active patterns, a pattern starts with its first pulse when it goes active
+ */
+static void alarmctl_haptic_play( uint32_t mask ) {
+    uint32_t now = millis();
+
+    for ( int haptic = ALARMCTL_HAPTIC_NONE + 1 ; haptic < ALARMCTL_HAPTIC_NUM ; haptic++ ) {
+        if ( !( mask & ( 1UL << haptic ) ) ) {
+            alarmctl_haptic_running[ haptic ] = false;
+            continue;
+        }
+        if ( !alarmctl_haptic_running[ haptic ] ) {
+            alarmctl_haptic_running[ haptic ] = true;
+            alarmctl_haptic_pulse[ haptic ] = 0;
+            alarmctl_haptic_next[ haptic ] = now;
+        }
+        if ( (int32_t)( now - alarmctl_haptic_next[ haptic ] ) < 0 )
+            continue;
+
+        const alarmctl_haptic_t *pattern = &alarmctl_haptic[ haptic ];
+        motor_vibe( pattern->vibe, true );
+        if ( ++alarmctl_haptic_pulse[ haptic ] < pattern->pulses ) {
+            alarmctl_haptic_next[ haptic ] += pattern->gap;
+        }
+        else {
+            alarmctl_haptic_next[ haptic ] += pattern->period - pattern->gap * ( pattern->pulses - 1 );
+            alarmctl_haptic_pulse[ haptic ] = 0;
+        }
+    }
+}
+
+void alarmctl_save_config( void ) {
+    configstore_save( CONFIGSTORE_ALARMCTL );
+}
+
+void alarmctl_read_config( void ) {
+    if ( !configstore_register( CONFIGSTORE_ALARMCTL, &alarmctl_config, sizeof( alarmctl_config ), alarmctl_read_json_config, alarmctl_save_json_config ) ) {
+        alarmctl_read_json_config();
+        alarmctl_save_config();
+    }
+    if ( alarmctl_config.rules > ALARM_RULE_MAX ) {
+        log_e("alarm rule table broken, using defaults");
+        alarmctl_set_default_rules( &alarmctl_parsed );
+        alarmctl_set_rules( &alarmctl_parsed );
+    }
+}
+
+void alarmctl_save_json_config( void ) {
+    fs::File file = SPIFFS.open( ALARMCTL_JSON_CONFIG_FILE, FILE_WRITE );
+
+    if (!file) {
+        log_e("Can't open file: %s!", ALARMCTL_JSON_CONFIG_FILE );
+    }
+    else {
+        SpiRamJsonDocument doc( 8192 );
+
+        alarmctl_config_to_json( &alarmctl_config, doc.to<JsonObject>(), &alarmctl_json_names );
+
+        if ( serializeJsonPretty( doc, file ) == 0) {
+            log_e("Failed to write config file");
+        }
+        doc.clear();
+    }
+    file.close();
+}
+
+void alarmctl_read_json_config( void ) {
+    fs::File file = SPIFFS.open( ALARMCTL_JSON_CONFIG_FILE, FILE_READ );
+    if (!file) {
+        log_e("Can't open file: %s!", ALARMCTL_JSON_CONFIG_FILE );
+        alarmctl_set_default_rules( &alarmctl_parsed );
+        alarmctl_set_rules( &alarmctl_parsed );
+        return;
+    }
+
+    int filesize = file.size();
+    SpiRamJsonDocument doc( filesize * 2 );
+
+    DeserializationError error = deserializeJson( doc, file );
+    if ( error ) {
+        log_e("update check deserializeJson() failed: %s", error.c_str() );
+        alarmctl_set_default_rules( &alarmctl_parsed );
+    }
+    else {
+        int skipped = alarmctl_config_from_json( &alarmctl_parsed, doc.as<JsonObjectConst>(), &alarmctl_json_names );
+        if ( skipped )
+            log_w("%d alarm rules with an unknown field, comparator or reference or past %d rules, ignored", skipped, ALARM_RULE_MAX );
+    }
+    doc.clear();
+    file.close();
+
+    alarmctl_set_rules( &alarmctl_parsed );
+}
+
+/**
+ * @brief swap in a new rule table, the ble task may be evaluating the old one
+ */
+static void alarmctl_set_rules( const alarmctl_config_t *config ) {
+    portENTER_CRITICAL( &alarmctlMux );
+    alarmctl_config = *config;
+    alarm_rule_reset( alarmctl_state, ALARM_RULE_MAX );
+    memset( alarmctl_band, 0, sizeof( alarmctl_band ) );
+    alarmctl_haptic_mask = 0;
+    alarmctl_pending = 0;
+    portEXIT_CRITICAL( &alarmctlMux );
+    log_i("%d alarm rules", config->rules );
+}
+
+static void alarmctl_set_default_rules( alarmctl_config_t *config ) {
+    *config = alarmctl_config_t();
+    memcpy( config->rule, alarmctl_default_rule, sizeof( alarmctl_default_rule ) );
+    config->rules = ALARMCTL_DEFAULT_RULES;
+}
+
+bool alarmctl_register_cb( EventBits_t event, CALLBACK_FUNC callback_func, const char *id ) {
+    if ( alarmctl_callback == NULL ) {
+        alarmctl_callback = callback_init( "alarmctl" );
+        if ( alarmctl_callback == NULL ) {
+            log_e("alarmctl_callback alloc failed");
+            while(true);
+        }
+    }
+    return( callback_register( alarmctl_callback, event, callback_func, id ) );
+}
+
+static bool alarmctl_send_event_cb( EventBits_t event, void *arg ) {
+    return( callback_send( alarmctl_callback, event, arg ) );
+}
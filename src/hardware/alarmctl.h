@@ -0,0 +1,98 @@
+/****************************************************************************
+ *   Copyright  2020  Jesper Ortlund
+ ****************************************************************************/
+/*
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+#ifndef _ALARMCTL_H
+    #define _ALARMCTL_H
+
+    #include "TTGO.h"
+    #include "callback.h"
+    #include "alarm_rule.h"
+    #include "alarmctl_config.h"
+
+    #define ALARMCTL_JSON_CONFIG_FILE   "/alarmctl.json"    /** @brief defines json config file name */
+
+    #define ALARMCTL_ON                 _BV(0)              /** @brief event mask rule went active, callback arg is (alarm_rule_t*) to a copy of the rule, valid during the call */
+
+    /**
+     * @brief setup alarmctl, read the rule table and start the haptics
+     */
+    void alarmctl_setup( void );
+    /**
+     * @brief evaluate the rule table against the wheel data, call once per decoded frame
+     */
+    void alarmctl_eval( void );
+    /**
+     * @brief get the colour band of a wheel data entry
+     *
+     * @param   field       wheel data entry, like WHEELCTL_SPEED
+     *
+     * @return  BANDSTYLE_NORMAL, BANDSTYLE_WARN, BANDSTYLE_CRIT or BANDSTYLE_REGEN
+     */
+    int alarmctl_get_band( int field );
+    /**
+     * @brief get the number of rules in the table
+     *
+     * @return  number of rules
+     */
+    int alarmctl_get_rule_num( void );
+    /**
+     * @brief get a rule and its state
+     *
+     * @param   n           rule number
+     * @param   rule        pointer to a rule to fill
+     * @param   active      pointer to the active flag to fill
+     *
+     * @return  true if n is a valid rule
+     */
+    bool alarmctl_get_rule( int n, alarm_rule_t *rule, bool *active );
+    /**
+     * @brief describe a rule in one line, like "speed >= 1.00 tiltback"
+     *
+     * @param   rule        pointer to a rule
+     * @param   text        buffer to fill
+     * @param   size        buffer size
+     */
+    void alarmctl_describe_rule( const alarm_rule_t *rule, char *text, size_t size );
+    /**
+     * @brief save the rule table
+     */
+    void alarmctl_save_config( void );
+    /**
+     * @brief read the rule table
+     */
+    void alarmctl_read_config( void );
+    /**
+     * @brief write the rule table as json file to spiffs
+     */
+    void alarmctl_save_json_config( void );
+    /**
+     * @brief read the rule table from the json file on spiffs, the default rules if there is none
+     */
+    void alarmctl_read_json_config( void );
+    /**
+     * @brief registers a callback function which is called on a corresponding event
+     *
+     * @param   event           possible values: ALARMCTL_ON
+     * @param   callback_func   pointer to the callback function
+     * @param   id              program id
+     *
+     * @return  true if success, false if failed
+     */
+    bool alarmctl_register_cb( EventBits_t event, CALLBACK_FUNC callback_func, const char *id );
+
+#endif // _ALARMCTL_H
@@ -0,0 +1,116 @@
+/****************************************************************************
+ *   Copyright  2020  Jesper Ortlund
+ ****************************************************************************/
+/*
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+#include <string.h>
+
+#include "alarmctl_config.h"
+
+static int alarmctl_config_find_name( const char * const *names, int num, const char *name ) {
+    for ( int n = 0 ; n < num ; n++ ) {
+        if ( !strcmp( names[ n ], name ) )
+            return( n );
+    }
+    return( -1 );
+}
+
+int alarmctl_config_from_json( alarmctl_config_t *config, JsonObjectConst json, const alarmctl_json_names_t *names ) {
+    int skipped = 0;
+
+    config->rules = 0;
+    for ( JsonVariantConst item : json["rules"].as<JsonArrayConst>() ) {
+        JsonObjectConst entry = item.as<JsonObjectConst>();
+
+        if ( config->rules == ALARM_RULE_MAX ) {
+            skipped++;
+            continue;
+        }
+
+        alarm_rule_t *rule = &config->rule[ config->rules ];
+        memset( rule, 0, sizeof( alarm_rule_t ) );
+
+        int field = alarmctl_config_find_name( names->field, names->fields, entry["field"] | "" );
+        int cmp = alarmctl_config_find_name( names->cmp, names->cmps, entry["cmp"] | ">" );
+        int ref_entry = 0;
+        if ( entry.containsKey("data") ) {
+            rule->ref = ALARM_RULE_REF_DATA;
+            ref_entry = alarmctl_config_find_name( names->field, names->fields, entry["data"] | "" );
+        }
+        else if ( entry.containsKey("const") ) {
+            rule->ref = ALARM_RULE_REF_CONST;
+            ref_entry = alarmctl_config_find_name( names->constant, names->constants, entry["const"] | "" );
+        }
+        if ( field < 0 || cmp < 0 || ref_entry < 0 ) {
+            skipped++;
+            continue;
+        }
+        rule->field = field;
+        rule->cmp = cmp;
+        rule->ref_entry = ref_entry;
+        rule->threshold = entry["threshold"] | 0.0f;
+        rule->hysteresis = entry["hysteresis"] | 0.0f;
+        rule->duration = entry["duration"] | 0;
+
+        /*
+         * band 0 and haptic 0 are the normal band and no vibration, no action to take
+         */
+        if ( entry.containsKey("band") ) {
+            int band = alarmctl_config_find_name( names->band, names->bands, entry["band"] | "" );
+            if ( band > 0 ) {
+                rule->band = band;
+                rule->actions |= ALARM_RULE_BAND;
+            }
+        }
+        if ( entry.containsKey("haptic") ) {
+            int haptic = alarmctl_config_find_name( names->haptic, names->haptics, entry["haptic"] | "" );
+            if ( haptic > ALARMCTL_HAPTIC_NONE ) {
+                rule->haptic = haptic;
+                rule->actions |= ALARM_RULE_HAPTIC;
+            }
+        }
+        if ( entry["jump"] | false )
+            rule->actions |= ALARM_RULE_JUMP;
+
+        config->rules++;
+    }
+    return( skipped );
+}
+
+void alarmctl_config_to_json( const alarmctl_config_t *config, JsonObject json, const alarmctl_json_names_t *names ) {
+    JsonArray rules = json.createNestedArray("rules");
+
+    for ( int n = 0 ; n < config->rules ; n++ ) {
+        const alarm_rule_t *rule = &config->rule[ n ];
+        JsonObject entry = rules.createNestedObject();
+
+        entry["field"] = names->field[ rule->field ];
+        entry["cmp"] = names->cmp[ rule->cmp ];
+        if ( rule->ref == ALARM_RULE_REF_DATA )
+            entry["data"] = names->field[ rule->ref_entry ];
+        else if ( rule->ref == ALARM_RULE_REF_CONST )
+            entry["const"] = names->constant[ rule->ref_entry ];
+        entry["threshold"] = rule->threshold;
+        entry["hysteresis"] = rule->hysteresis;
+        entry["duration"] = rule->duration;
+        if ( rule->actions & ALARM_RULE_BAND )
+            entry["band"] = names->band[ rule->band ];
+        if ( rule->actions & ALARM_RULE_HAPTIC )
+            entry["haptic"] = names->haptic[ rule->haptic ];
+        if ( rule->actions & ALARM_RULE_JUMP )
+            entry["jump"] = true;
+    }
+}
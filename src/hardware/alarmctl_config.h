@@ -0,0 +1,88 @@
+/****************************************************************************
+ *   Copyright  2020  Jesper Ortlund
+ ****************************************************************************/
+/*
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+#ifndef _ALARMCTL_CONFIG_H
+    #define _ALARMCTL_CONFIG_H
+
+    /*
+     * no arduino or spiffs in here, the config and its json mapping build and run on the host
+     */
+    #include <stdint.h>
+    #include <ArduinoJson.h>
+
+    #include "alarm_rule.h"
+
+
+    /**
+     * @brief haptic patterns a rule can play while active
+     */
+    enum {
+        ALARMCTL_HAPTIC_NONE,                               /** @brief no vibration */
+        ALARMCTL_HAPTIC_TICK,                               /** @brief short tick every 250ms */
+        ALARMCTL_HAPTIC_PULSE,                              /** @brief long pulse every 500ms */
+        ALARMCTL_HAPTIC_DOUBLE,                             /** @brief two ticks every second */
+        ALARMCTL_HAPTIC_NUM
+    };
+
+    /**
+     * @brief alarmctl config structure, the rule table. stored as is in the config store,
+     * only append fields to it and to alarm_rule_t, never reorder or resize them
+     */
+    typedef struct {
+        uint8_t rules = 0;                                  /** @brief rules in use */
+        alarm_rule_t rule[ ALARM_RULE_MAX ];                /** @brief rules, for colour bands the first active rule of a field wins */
+    } alarmctl_config_t;
+
+    /**
+     * @brief json names of the indices a rule stores, indexed like the wheelctl, alarm_rule,
+     * bandstyle and haptic enums
+     */
+    typedef struct {
+        const char * const *field;                          /** @brief wheel data entry names */
+        int fields;
+        const char * const *cmp;                            /** @brief comparator names */
+        int cmps;
+        const char * const *constant;                       /** @brief wheel constant names */
+        int constants;
+        const char * const *band;                           /** @brief colour band names */
+        int bands;
+        const char * const *haptic;                         /** @brief haptic pattern names */
+        int haptics;
+    } alarmctl_json_names_t;
+
+    /**
+     * @brief fill the rule table from the json, rules with an unknown field, comparator or
+     * reference are skipped, as are rules past ALARM_RULE_MAX
+     *
+     * @param   config      pointer to the config
+     * @param   json        root object of alarmctl.json
+     * @param   names       json names of the stored indices
+     *
+     * @return  number of rules skipped
+     */
+    int alarmctl_config_from_json( alarmctl_config_t *config, JsonObjectConst json, const alarmctl_json_names_t *names );
+    /**
+     * @brief write the rule table as json
+     *
+     * @param   config      pointer to the config
+     * @param   json        root object to fill
+     * @param   names       json names of the stored indices
+     */
+    void alarmctl_config_to_json( const alarmctl_config_t *config, JsonObject json, const alarmctl_json_names_t *names );
+
+#endif // _ALARMCTL_CONFIG_H
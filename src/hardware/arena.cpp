@@ -0,0 +1,255 @@
+/****************************************************************************
+ *   Copyright  2020  Jesper Ortlund
+ ****************************************************************************/
+/*
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+#include "config.h"
+#include <TTGO.h>
+
+#include "arena.h"
+
+static arena_t arena_table[ ARENA_NUM ] = {
+    { "fast", MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT, ARENA_FAST_SIZE, false },
+    { "dma", MALLOC_CAP_DMA | MALLOC_CAP_8BIT, ARENA_DMA_SIZE, false },
+    { "bulk", MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT, ARENA_BULK_CHUNK, true },
+};
+
+static arena_pool_t *arena_pool[ ARENA_MAX_POOLS ];
+static uint32_t arena_pool_num = 0;
+
+static SemaphoreHandle_t arena_mutex = NULL;
+portMUX_TYPE DRAM_ATTR arenaPoolMux = portMUX_INITIALIZER_UNLOCKED;
+
+static bool arena_add_chunk( arena_t *arena, uint32_t len );
+static void arena_account( arena_t *arena, const char *owner, uint32_t size );
+
+void arena_setup( void ) {
+    if ( arena_mutex != NULL )
+        return;
+
+    arena_mutex = xSemaphoreCreateMutex();
+    /*
+     * reserve the first chunk of every arena now, before wifi, ble and lvgl
+     * start to carve up the heap
+     */
+    for ( int arena = 0 ; arena < ARENA_NUM ; arena++ ) {
+        if ( !arena_add_chunk( &arena_table[ arena ], arena_table[ arena ].chunk_size ) ) {
+            log_e("arena %s: %u bytes not available", arena_table[ arena ].name, arena_table[ arena ].chunk_size );
+        }
+    }
+}
+
+void *arena_alloc( int arena, size_t size, const char *owner ) {
+    uint8_t *ptr = NULL;
+
+    if ( arena < 0 || arena >= ARENA_NUM || arena_mutex == NULL )
+        return( NULL );
+
+    arena_t *a = &arena_table[ arena ];
+    size = ( size + ARENA_ALIGN - 1 ) & ~( ARENA_ALIGN - 1 );
+
+    xSemaphoreTake( arena_mutex, portMAX_DELAY );
+    if ( a->chunks && a->chunk_used[ a->current ] + size <= a->chunk_len[ a->current ] ) {
+        ptr = a->chunk[ a->current ] + a->chunk_used[ a->current ];
+        a->chunk_used[ a->current ] += size;
+    }
+    else if ( a->grow ) {
+        /*
+         * big allocations get a chunk of their own, the current chunk keeps
+         * serving the small ones
+         */
+        bool own = size > a->chunk_size / 2;
+        if ( arena_add_chunk( a, own ? size : a->chunk_size ) ) {
+            ptr = a->chunk[ a->chunks - 1 ];
+            a->chunk_used[ a->chunks - 1 ] = size;
+            if ( !own )
+                a->current = a->chunks - 1;
+        }
+    }
+
+    if ( ptr ) {
+        arena_account( a, owner, size );
+    }
+    else {
+        a->failed++;
+    }
+    xSemaphoreGive( arena_mutex );
+
+    if ( ptr == NULL ) {
+        log_w("arena %s: no space for %u bytes for %s", a->name, size, owner );
+        return( NULL );
+    }
+    memset( ptr, 0, size );
+    return( ptr );
+}
+
+bool arena_owns( const void *ptr ) {
+    for ( int arena = 0 ; arena < ARENA_NUM ; arena++ ) {
+        const arena_t *a = &arena_table[ arena ];
+        for ( uint32_t chunk = 0 ; chunk < a->chunks ; chunk++ ) {
+            if ( (const uint8_t *)ptr >= a->chunk[ chunk ] && (const uint8_t *)ptr < a->chunk[ chunk ] + a->chunk_len[ chunk ] )
+                return( true );
+        }
+    }
+    return( false );
+}
+
+bool arena_pool_init( arena_pool_t *pool, int arena, size_t block_size, uint32_t blocks, const char *name ) {
+    block_size = max( ( block_size + ARENA_ALIGN - 1 ) & ~( ARENA_ALIGN - 1 ), sizeof( void * ) );
+
+    uint8_t *memory = (uint8_t *)arena_alloc( arena, block_size * blocks, name );
+    if ( memory == NULL )
+        return( false );
+
+    pool->name = name;
+    pool->block_size = block_size;
+    pool->blocks = blocks;
+    pool->in_use = 0;
+    pool->high_water = 0;
+    pool->failed = 0;
+    pool->free_list = NULL;
+    for ( uint32_t block = blocks ; block > 0 ; block-- ) {
+        void *free_block = &memory[ ( block - 1 ) * block_size ];
+        *(void **)free_block = pool->free_list;
+        pool->free_list = free_block;
+    }
+
+    portENTER_CRITICAL( &arenaPoolMux );
+    if ( arena_pool_num < ARENA_MAX_POOLS )
+        arena_pool[ arena_pool_num++ ] = pool;
+    portEXIT_CRITICAL( &arenaPoolMux );
+    return( true );
+}
+
+void *arena_pool_get( arena_pool_t *pool ) {
+    portENTER_CRITICAL( &arenaPoolMux );
+    void *block = pool->free_list;
+    if ( block ) {
+        pool->free_list = *(void **)block;
+        pool->in_use++;
+        if ( pool->in_use > pool->high_water )
+            pool->high_water = pool->in_use;
+    }
+    else {
+        pool->failed++;
+    }
+    portEXIT_CRITICAL( &arenaPoolMux );
+    return( block );
+}
+
+void arena_pool_put( arena_pool_t *pool, void *block ) {
+    if ( block == NULL )
+        return;
+
+    portENTER_CRITICAL( &arenaPoolMux );
+    *(void **)block = pool->free_list;
+    pool->free_list = block;
+    pool->in_use--;
+    portEXIT_CRITICAL( &arenaPoolMux );
+}
+
+const arena_t *arena_get( int arena ) {
+    return( &arena_table[ arena ] );
+}
+
+uint32_t arena_get_pool_num( void ) {
+    return( arena_pool_num );
+}
+
+const arena_pool_t *arena_get_pool( uint32_t pool ) {
+    if ( pool >= arena_pool_num )
+        return( NULL );
+    return( arena_pool[ pool ] );
+}
+
+void arena_get_usage( int arena, uint32_t *reserved, uint32_t *used ) {
+    const arena_t *a = &arena_table[ arena ];
+
+    *reserved = 0;
+    *used = 0;
+    for ( uint32_t chunk = 0 ; chunk < a->chunks ; chunk++ ) {
+        *reserved += a->chunk_len[ chunk ];
+        *used += a->chunk_used[ chunk ];
+    }
+}
+
+uint32_t arena_get_fragmentation( int arena ) {
+    uint32_t free_size = heap_caps_get_free_size( arena_table[ arena ].caps );
+    uint32_t largest = heap_caps_get_largest_free_block( arena_table[ arena ].caps );
+
+    if ( free_size == 0 )
+        return( 0 );
+    return( 100 - (uint64_t)largest * 100 / free_size );
+}
+
+void arena_print( void ) {
+    Serial.printf("arenas:\r\n");
+    for ( int arena = 0 ; arena < ARENA_NUM ; arena++ ) {
+        const arena_t *a = &arena_table[ arena ];
+        uint32_t reserved, used;
+
+        arena_get_usage( arena, &reserved, &used );
+        Serial.printf("  %-6s %7u/%7u bytes, %u chunks, %u failed, heap %u free, %u%% fragmented\r\n", a->name, used, reserved, a->chunks, a->failed,
+                                                                                                     heap_caps_get_free_size( a->caps ),
+                                                                                                     arena_get_fragmentation( arena ) );
+        for ( uint32_t owner = 0 ; owner < a->owners ; owner++ ) {
+            Serial.printf("    %-16s %7u bytes in %u\r\n", a->owner[ owner ].owner, a->owner[ owner ].bytes, a->owner[ owner ].allocs );
+        }
+    }
+    for ( uint32_t pool = 0 ; pool < arena_pool_num ; pool++ ) {
+        const arena_pool_t *p = arena_pool[ pool ];
+        Serial.printf("  pool %-16s %ux%u, %u in use, %u high water, %u failed\r\n", p->name, p->blocks, p->block_size, p->in_use, p->high_water, p->failed );
+    }
+}
+
+static bool arena_add_chunk( arena_t *arena, uint32_t len ) {
+    if ( arena->chunks >= ARENA_MAX_CHUNKS )
+        return( false );
+
+    uint8_t *chunk = (uint8_t *)heap_caps_malloc( len, arena->caps );
+    if ( chunk == NULL )
+        return( false );
+
+    arena->chunk[ arena->chunks ] = chunk;
+    arena->chunk_len[ arena->chunks ] = len;
+    arena->chunk_used[ arena->chunks ] = 0;
+    arena->chunks++;
+    return( true );
+}
+
+static void arena_account( arena_t *arena, const char *owner, uint32_t size ) {
+    uint32_t entry;
+
+    for ( entry = 0 ; entry < arena->owners ; entry++ ) {
+        if ( !strcmp( arena->owner[ entry ].owner, owner ) )
+            break;
+    }
+    /*
+     * owners past the table end are summed up in the last entry
+     */
+    if ( entry == arena->owners ) {
+        if ( arena->owners < ARENA_MAX_OWNERS ) {
+            arena->owner[ entry ].owner = owner;
+            arena->owners++;
+        }
+        else {
+            entry = ARENA_MAX_OWNERS - 1;
+            arena->owner[ entry ].owner = "other";
+        }
+    }
+    arena->owner[ entry ].bytes += size;
+    arena->owner[ entry ].allocs++;
+}
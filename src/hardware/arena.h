@@ -0,0 +1,172 @@
+/****************************************************************************
+ *   Copyright  2020  Jesper Ortlund
+ ****************************************************************************/
+/*
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+#ifndef _ARENA_H
+    #define _ARENA_H
+
+    #include <TTGO.h>
+
+    #define ARENA_FAST_SIZE             ( 12 * 1024 )   /** @brief internal ram for data touched every loop, callback tables */
+    #define ARENA_DMA_SIZE              ( 15 * 1024 )   /** @brief dma capable internal ram, two 16 line display buffers */
+    #define ARENA_BULK_CHUNK            ( 256 * 1024 )  /** @brief psram chunk size, the bulk arena grows chunk by chunk */
+    #define ARENA_MAX_CHUNKS            16          /** @brief max chunks per arena */
+    #define ARENA_MAX_OWNERS            12          /** @brief max owners tracked per arena for the report */
+    #define ARENA_MAX_POOLS             8           /** @brief max pools tracked for the report */
+    #define ARENA_ALIGN                 4           /** @brief allocation alignment, enough for dma and 32 bit access */
+
+    /**
+     * @brief arenas, memory in an arena is never given back to the heap
+     */
+    enum {
+        ARENA_FAST,                                 /** @brief internal ram, fixed size, reserved at boot */
+        ARENA_DMA,                                  /** @brief dma capable internal ram, fixed size, reserved at boot */
+        ARENA_BULK,                                 /** @brief psram, grows in ARENA_BULK_CHUNK steps */
+        ARENA_NUM
+    };
+
+    /**
+     * @brief bytes an owner took from an arena
+     */
+    typedef struct {
+        const char *owner;                          /** @brief owner name */
+        uint32_t bytes;                             /** @brief bytes allocated */
+        uint32_t allocs;                            /** @brief number of allocations */
+    } arena_owner_t;
+
+    /**
+     * @brief arena state
+     */
+    typedef struct {
+        const char *name;                           /** @brief arena name */
+        uint32_t caps;                              /** @brief heap caps for the chunks */
+        uint32_t chunk_size;                        /** @brief size of the first and every further chunk */
+        bool grow;                                  /** @brief false for arenas limited to the first chunk */
+        uint8_t *chunk[ ARENA_MAX_CHUNKS ];         /** @brief chunk memory */
+        uint32_t chunk_len[ ARENA_MAX_CHUNKS ];     /** @brief chunk size, larger than chunk_size for big allocations */
+        uint32_t chunk_used[ ARENA_MAX_CHUNKS ];    /** @brief bytes used in the chunk */
+        uint32_t chunks;                            /** @brief chunks in use */
+        uint32_t current;                           /** @brief chunk small allocations are taken from */
+        uint32_t failed;                            /** @brief allocations that did not fit */
+        arena_owner_t owner[ ARENA_MAX_OWNERS ];    /** @brief per owner usage */
+        uint32_t owners;                            /** @brief owners in use */
+    } arena_t;
+
+    /**
+     * @brief fixed size block pool carved from an arena, get and put are safe from any task
+     */
+    typedef struct {
+        const char *name;                           /** @brief pool name */
+        uint32_t block_size;                        /** @brief usable bytes per block */
+        uint32_t blocks;                            /** @brief number of blocks */
+        uint32_t in_use;                            /** @brief blocks handed out */
+        uint32_t high_water;                        /** @brief most blocks handed out at once */
+        uint32_t failed;                            /** @brief gets on an empty pool */
+        void *free_list;                            /** @brief free blocks, linked through their first word */
+    } arena_pool_t;
+
+    /**
+     * @brief reserve the fixed arenas, call first in setup() before the heap fragments
+     */
+    void arena_setup( void );
+    /**
+     * @brief take zeroed memory from an arena, for buffers that live until reboot
+     *
+     * @param   arena       ARENA_FAST, ARENA_DMA or ARENA_BULK
+     * @param   size        bytes
+     * @param   owner       owner name for the report, must be a static string
+     *
+     * @return  pointer to the memory, NULL if the arena is full or not set up
+     */
+    void *arena_alloc( int arena, size_t size, const char *owner );
+    /**
+     * @brief check if memory belongs to an arena, arena memory must not be freed
+     *
+     * @param   ptr         pointer to check
+     *
+     * @return  true if ptr lies in an arena chunk
+     */
+    bool arena_owns( const void *ptr );
+    /**
+     * @brief setup a block pool in an arena
+     *
+     * @param   pool        pointer to the arena_pool_t to setup
+     * @param   arena       ARENA_FAST, ARENA_DMA or ARENA_BULK
+     * @param   block_size  usable bytes per block
+     * @param   blocks      number of blocks
+     * @param   name        pool name for the report, must be a static string
+     *
+     * @return  true if success, false if the arena is full
+     */
+    bool arena_pool_init( arena_pool_t *pool, int arena, size_t block_size, uint32_t blocks, const char *name );
+    /**
+     * @brief take a block from a pool
+     *
+     * @param   pool        pointer to an initialized arena_pool_t
+     *
+     * @return  pointer to a block, NULL if all blocks are in use
+     */
+    void *arena_pool_get( arena_pool_t *pool );
+    /**
+     * @brief give a block back to its pool
+     *
+     * @param   pool        pointer to an initialized arena_pool_t
+     * @param   block       pointer from arena_pool_get, NULL is ignored
+     */
+    void arena_pool_put( arena_pool_t *pool, void *block );
+    /**
+     * @brief get an arena for the report
+     *
+     * @param   arena       ARENA_FAST, ARENA_DMA or ARENA_BULK
+     *
+     * @return  pointer to the arena_t
+     */
+    const arena_t *arena_get( int arena );
+    /**
+     * @brief get the number of pools
+     */
+    uint32_t arena_get_pool_num( void );
+    /**
+     * @brief get a pool for the report
+     *
+     * @param   pool        0 ... arena_get_pool_num() - 1
+     *
+     * @return  pointer to the arena_pool_t, NULL if out of range
+     */
+    const arena_pool_t *arena_get_pool( uint32_t pool );
+    /**
+     * @brief get the bytes reserved and used by an arena
+     *
+     * @param   arena       ARENA_FAST, ARENA_DMA or ARENA_BULK
+     * @param   reserved    pointer to the reserved bytes
+     * @param   used        pointer to the used bytes, the high water mark as arenas never shrink
+     */
+    void arena_get_usage( int arena, uint32_t *reserved, uint32_t *used );
+    /**
+     * @brief get the heap fragmentation for the heap behind an arena
+     *
+     * @param   arena       ARENA_FAST, ARENA_DMA or ARENA_BULK
+     *
+     * @return  percent of the free heap not in the largest free block
+     */
+    uint32_t arena_get_fragmentation( int arena );
+    /**
+     * @brief dump arenas, pools and heap fragmentation to serial
+     */
+    void arena_print( void );
+
+#endif // _ARENA_H
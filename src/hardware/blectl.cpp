@@ -35,6 +35,12 @@
 #include "pmu.h"
 #include "powermgm.h"
 #include "callback.h"
+#include "configstore.h"
+#include "bootctl.h"
+#include "webserver.h"
+#include "framequeue.h"
+#include "metrics.h"
+#include "alarmctl.h"
 #include "json_psram_allocator.h"
 #include "alloc.h"
 #include "alloc.h"
@@ -67,11 +73,11 @@ bool connectToServer(void);
 bool clidoConnect = false;
 bool cliconnected = false;
 bool cli_ondisconnect = false;
+bool blectl_scan_initialized = false;
 int scandelay = 0;
 
 BLEServer *pServer = NULL;
-BLECharacteristic *pTxCharacteristic;
-BLECharacteristic *pRxCharacteristic;
+BLECharacteristic *pRelayCharacteristic = NULL;
 uint8_t txValue = 0;
 String EUC_Brand = "KingSong";
 
@@ -84,6 +90,31 @@ BLECharacteristic *pBatteryPowerStateCharacteristic;
 char *gadgetbridge_msg = NULL;
 uint32_t gadgetbridge_msg_size = 0;
 static uint64_t NextMillis = millis();
+static bool blectl_first_frame = true;
+
+/*
+ * relay queues, wheel telemetry drops the oldest frame, phone commands are never reordered
+ */
+static framequeue_frame_t blectl_relay_wheel_frame[ BLECTL_RELAY_QUEUE_LEN ];
+static framequeue_frame_t blectl_relay_phone_frame[ BLECTL_RELAY_QUEUE_LEN ];
+static framequeue_t blectl_relay_wheel_queue;
+static framequeue_t blectl_relay_phone_queue;
+static TaskHandle_t _blectl_relay_Task = NULL;
+portMUX_TYPE DRAM_ATTR blectlRelayMux = portMUX_INITIALIZER_UNLOCKED;
+/*
+ * wheel requests from the main loop and phone writes from the relay task both end up in writeBLE()
+ */
+static SemaphoreHandle_t blectl_write_mutex = NULL;
+/*
+ * wheel notifications from the ble stack and injected frames from the main loop share the decoder
+ */
+static SemaphoreHandle_t blectl_decode_mutex = NULL;
+
+static void blectl_relay_setup(void);
+static void blectl_relay_push(framequeue_t *queue, const uint8_t *data, size_t len);
+static bool blectl_relay_pop(framequeue_t *queue, framequeue_frame_t *frame);
+static void blectl_relay_set_name(const char *name);
+static void blectl_relay_Task(void *pvParameters);
 
 
 class MyClientCallback : public BLEClientCallbacks
@@ -123,6 +154,35 @@ class MyAdvertisedDeviceCallbacks : public BLEAdvertisedDeviceCallbacks
     } // onResult
 };    // MyAdvertisedDeviceCallbacks
 
+class RelayServerCallbacks : public BLEServerCallbacks
+{
+    void onConnect(BLEServer *pServer)
+    {
+        log_i("relay client connected");
+        if (blectl_config.relay && pServer->getConnectedCount() < BLECTL_RELAY_MAX_CLIENTS)
+            BLEDevice::startAdvertising();
+    }
+    void onDisconnect(BLEServer *pServer)
+    {
+        log_i("relay client disconnected");
+        if (blectl_config.relay)
+            BLEDevice::startAdvertising();
+    }
+};
+
+class RelayCharacteristicCallbacks : public BLECharacteristicCallbacks
+{
+    /**
+        Called from the ble stack, the write to the wheel has to wait for the relay task
+    */
+    void onWrite(BLECharacteristic *pCharacteristic)
+    {
+        std::string value = pCharacteristic->getValue();
+        if (blectl_config.relay && cliconnected)
+            blectl_relay_push(&blectl_relay_phone_queue, (const uint8_t *)value.data(), value.length());
+    }
+};
+
 bool blectl_cli_powermgm_event_cb(EventBits_t event, void *arg)
 {
     bool retval = true;
@@ -223,6 +283,26 @@ void blectl_off(){
     
 }
 
+bool blectl_get_relay(void)
+{
+    return (blectl_config.relay);
+}
+
+void blectl_set_relay(bool relay)
+{
+    blectl_config.relay = relay;
+    if (relay)
+    {
+        if (pServer)
+            BLEDevice::startAdvertising();
+        else if (blectl_scan_initialized)
+            blectl_relay_setup();
+    }
+    else if (pServer)
+        BLEDevice::stopAdvertising();
+    blectl_save_config();
+}
+
 void blectl_set_txpower(int32_t txpower)
 {
     if (txpower >= 0 && txpower <= 4)
@@ -284,6 +364,20 @@ bool blectl_get_autoon(void)
 }
 
 void blectl_save_config(void)
+{
+    configstore_save(CONFIGSTORE_BLECTL);
+}
+
+void blectl_read_config(void)
+{
+    if (!configstore_register(CONFIGSTORE_BLECTL, &blectl_config, sizeof(blectl_config), blectl_read_json_config, blectl_save_json_config))
+    {
+        blectl_read_json_config();
+        blectl_save_config();
+    }
+}
+
+void blectl_save_json_config(void)
 {
     fs::File file = SPIFFS.open(BLECTL_JSON_COFIG_FILE, FILE_WRITE);
 
@@ -295,10 +389,7 @@ void blectl_save_config(void)
     {
         SpiRamJsonDocument doc(1000);
 
-        doc["autoon"] = blectl_config.autoon;
-        doc["enable_on_standby"] = blectl_config.enable_on_standby;
-        doc["tx_power"] = blectl_config.txpower;
-        doc["wheel_mac"] = blectl_config.wheelmac;
+        blectl_config_to_json(&blectl_config, doc.to<JsonObject>());
 
         if (serializeJsonPretty(doc, file) == 0)
         {
@@ -309,7 +400,7 @@ void blectl_save_config(void)
     file.close();
 }
 
-void blectl_read_config(void)
+void blectl_read_json_config(void)
 {
     fs::File file = SPIFFS.open(BLECTL_JSON_COFIG_FILE, FILE_READ);
 
@@ -329,10 +420,7 @@ void blectl_read_config(void)
         }
         else
         {
-            blectl_config.autoon = doc["autoon"] | true;
-            blectl_config.enable_on_standby = doc["enable_on_standby"] | false;
-            blectl_config.txpower = doc["tx_power"] | 1;
-            blectl_config.wheelmac = doc["wheel_mac"] | "NULL";
+            blectl_config_from_json(&blectl_config, doc.as<JsonObjectConst>());
         }
         doc.clear();
     }
@@ -382,23 +470,57 @@ void blectl_cli_loop(void)
 
 void writeBLE(byte *wBLEbyte, int alength)
 {
+    if (blectl_write_mutex == NULL || pRemoteCharacteristic == NULL)
+        return;
+
+    xSemaphoreTake(blectl_write_mutex, portMAX_DELAY);
     pRemoteCharacteristic->writeValue(wBLEbyte, alength);
+    xSemaphoreGive(blectl_write_mutex);
 }
 
-static void notifyCallback(
-    BLERemoteCharacteristic *pBLERemoteCharacteristic,
-    uint8_t *pData,
-    size_t length,
-    bool isNotify)
+static void blectl_decode_frame(uint8_t *pData, size_t length)
 {
+    if (blectl_decode_mutex)
+        xSemaphoreTake(blectl_decode_mutex, portMAX_DELAY);
+    metrics_count(METRICS_BLE_FRAMES);
     //Only decode if package contains relevant data
-    if (length == 20)
+    if (length == 20 && pData[0] == 0xAA && pData[1] == 0x55)
     {
-        if (pData[0] == 0xAA && pData[1] == 0x55)
+        int64_t start = esp_timer_get_time();
+        if (blectl_first_frame)
         {
-            decodeKS(pData); // For Kingsong only atm.                         
+            blectl_first_frame = false;
+            bootctl_mark(BOOTCTL_MARK_FIRST_FRAME);
         }
+        decodeKS(pData); // For Kingsong only atm.
+        alarmctl_eval();
+        metrics_sample_since(METRICS_DECODE_US, start);
+        webserver_notify_frame();
+    }
+    else
+    {
+        metrics_count(METRICS_BLE_DROPPED);
     }
+    if (blectl_decode_mutex)
+        xSemaphoreGive(blectl_decode_mutex);
+}
+
+static void notifyCallback(
+    BLERemoteCharacteristic *pBLERemoteCharacteristic,
+    uint8_t *pData,
+    size_t length,
+    bool isNotify)
+{
+    //Phone apps get every frame, they do their own decoding
+    if (blectl_config.relay && pServer && pServer->getConnectedCount())
+        blectl_relay_push(&blectl_relay_wheel_queue, pData, length);
+    blectl_decode_frame(pData, length);
+}
+
+void blectl_inject_frame(uint8_t *data, size_t length)
+{
+    //Injected frames are for the watch only, phones never see them
+    blectl_decode_frame(data, length);
 }
 
 bool connectToServer()
@@ -460,6 +582,8 @@ bool connectToServer()
         pRemoteCharacteristic->registerForNotify(notifyCallback);
     }
     cliconnected = true;
+    if (myDevice->haveName())
+        blectl_relay_set_name(myDevice->getName().c_str());
     return cliconnected;
 }
 
@@ -473,19 +597,140 @@ void blectl_scan_once(int scantime)
     BLEDevice::getScan()->start(scantime);
 }
 
-void blectl_scan_setup()
+void blectl_scan_init()
 {
+    if (blectl_scan_initialized)
+        return;
+
     Serial.println("Starting Arduino BLE Client application...");
     BLEDevice::init("");
     // Retrieve a Scanner and set the callback we want to use to be informed when we
     // have detected a new device.  Specify that we want active scanning and start the
     // scan to run for 2 seconds.
-    powermgm_register_cb(POWERMGM_SILENCE_WAKEUP | POWERMGM_STANDBY | POWERMGM_WAKEUP, blectl_cli_powermgm_event_cb, "blectl_cli");
-    powermgm_register_loop_cb(POWERMGM_SILENCE_WAKEUP | POWERMGM_STANDBY | POWERMGM_WAKEUP, blectl_cli_powermgm_loop_cb, "blectl_cli loop");
     BLEScan *pBLEScan = BLEDevice::getScan();
     pBLEScan->setAdvertisedDeviceCallbacks(new MyAdvertisedDeviceCallbacks());
     pBLEScan->setInterval(1349);
     pBLEScan->setWindow(449);
     pBLEScan->setActiveScan(true);
     pBLEScan->start(2, scanCompleteCB, false);
-}
\ No newline at end of file
+    blectl_scan_initialized = true;
+}
+
+void blectl_scan_setup()
+{
+    powermgm_register_cb(POWERMGM_SILENCE_WAKEUP | POWERMGM_STANDBY | POWERMGM_WAKEUP, blectl_cli_powermgm_event_cb, "blectl_cli");
+    powermgm_register_loop_cb(POWERMGM_SILENCE_WAKEUP | POWERMGM_STANDBY | POWERMGM_WAKEUP, blectl_cli_powermgm_loop_cb, "blectl_cli loop");
+    if (blectl_write_mutex == NULL)
+        blectl_write_mutex = xSemaphoreCreateMutex();
+    if (blectl_decode_mutex == NULL)
+        blectl_decode_mutex = xSemaphoreCreateMutex();
+    blectl_scan_init();
+    /*
+     * no gatt server, service and relay task as long as nobody asked for the relay
+     */
+    if (blectl_config.relay)
+        blectl_relay_setup();
+}
+
+static void blectl_relay_setup(void)
+{
+    if (pServer)
+        return;
+
+    framequeue_init(&blectl_relay_wheel_queue, blectl_relay_wheel_frame, BLECTL_RELAY_QUEUE_LEN, true);
+    framequeue_init(&blectl_relay_phone_queue, blectl_relay_phone_frame, BLECTL_RELAY_QUEUE_LEN, false);
+
+    /*
+     * same service and characteristic as a KingSong wheel, one characteristic for notify and write
+     */
+    pServer = BLEDevice::createServer();
+    pServer->setCallbacks(new RelayServerCallbacks());
+    BLEService *pService = pServer->createService(KS_SERVICE_UUID_2);
+    pRelayCharacteristic = pService->createCharacteristic(KS_CHAR_UUID, BLECharacteristic::PROPERTY_READ |
+                                                                        BLECharacteristic::PROPERTY_WRITE |
+                                                                        BLECharacteristic::PROPERTY_WRITE_NR |
+                                                                        BLECharacteristic::PROPERTY_NOTIFY);
+    pRelayCharacteristic->addDescriptor(new BLE2902());
+    pRelayCharacteristic->setCallbacks(new RelayCharacteristicCallbacks());
+    pService->start();
+
+    BLEAdvertising *pAdvertising = BLEDevice::getAdvertising();
+    pAdvertising->addServiceUUID(KS_SERVICE_UUID_1);
+    pAdvertising->addServiceUUID(KS_SERVICE_UUID_2);
+
+    xTaskCreatePinnedToCore(blectl_relay_Task,      /* Function to implement the task */
+                            "blectl relay Task",    /* Name of the task */
+                            BLECTL_RELAY_STACK,     /* Stack size in words */
+                            NULL,                   /* Task input parameter */
+                            2,                      /* Priority of the task */
+                            &_blectl_relay_Task,    /* Task handle. */
+                            0);
+
+    if (cliconnected && myDevice->haveName())
+        esp_ble_gap_set_device_name(myDevice->getName().c_str());
+    BLEDevice::startAdvertising();
+}
+
+/**
+ * @brief queue a frame and wake the relay task, called from the ble stack
+ */
+static void blectl_relay_push(framequeue_t *queue, const uint8_t *data, size_t len)
+{
+    portENTER_CRITICAL(&blectlRelayMux);
+    bool queued = framequeue_push(queue, data, len);
+    portEXIT_CRITICAL(&blectlRelayMux);
+
+    if (!queued)
+    {
+        metrics_count(METRICS_RELAY_DROPPED);
+        log_w("relay frame dropped, %d bytes", len);
+    }
+    if (_blectl_relay_Task)
+        xTaskNotifyGive(_blectl_relay_Task);
+}
+
+static bool blectl_relay_pop(framequeue_t *queue, framequeue_frame_t *frame)
+{
+    portENTER_CRITICAL(&blectlRelayMux);
+    bool popped = framequeue_pop(queue, frame);
+    portEXIT_CRITICAL(&blectlRelayMux);
+    return (popped);
+}
+
+/**
+ * @brief advertise with the wheel name, phone apps detect the wheel model from it
+ */
+static void blectl_relay_set_name(const char *name)
+{
+    esp_ble_gap_set_device_name(name);
+    if (blectl_config.relay)
+    {
+        BLEDevice::stopAdvertising();
+        BLEDevice::startAdvertising();
+    }
+}
+
+/**
+ * @brief notify() and writeValue() wait for confirmation events from the ble stack,
+ * so they can't be called from its callbacks and run here instead
+ */
+static void blectl_relay_Task(void *pvParameters)
+{
+    framequeue_frame_t frame;
+
+    log_i("start blectl relay task, heap: %d", ESP.getFreeHeap());
+    while (true)
+    {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        while (blectl_relay_pop(&blectl_relay_wheel_queue, &frame))
+        {
+            pRelayCharacteristic->setValue(frame.data, frame.len);
+            pRelayCharacteristic->notify();
+        }
+        while (blectl_relay_pop(&blectl_relay_phone_queue, &frame))
+        {
+            if (cliconnected)
+                writeBLE(frame.data, frame.len);
+        }
+    }
+}
@@ -24,6 +24,7 @@
 
     #include "TTGO.h"
     #include "callback.h"
+    #include "blectl_config.h"
 
     #define BLECTL_CONNECT               _BV(0)         /** @brief event mask for blectl connect to an client */
     #define BLECTL_DISCONNECT            _BV(1)         /** @brief event mask for blectl disconnect */
@@ -102,15 +103,9 @@
     #define BLECTL_CHUNKDELAY       20      /** @brief chunk delay in ms for each msg chunk */
     #define BLECTL_MSG_MTU          256     /** @brief max msg size */
 
-    /**
-     * @brief blectl config structure
-     */
-    typedef struct {
-        bool autoon = false;             /** @brief auto on/off */
-        bool enable_on_standby = false; /** @brief enable on standby on/off */
-        int32_t txpower = 1;            /** @brief tx power, valide values are from 0 to 4 */
-        String wheelmac = "NULL";      /** @brief Mac address of wheel, string */
-    } blectl_config_t;
+    #define BLECTL_RELAY_QUEUE_LEN      8       /** @brief frames queued per direction between the wheel and relay clients */
+    #define BLECTL_RELAY_MAX_CLIENTS    2       /** @brief phones that can connect to the relay at the same time */
+    #define BLECTL_RELAY_STACK          3072    /** @brief stack size for the relay task */
 
     /**
      * @brief blectl send msg structure
@@ -194,6 +189,14 @@
      * @brief read the configuration from SPIFFS
      */
     void blectl_read_config( void );
+    /**
+     * @brief write the config as legacy json file to spiffs
+     */
+    void blectl_save_json_config( void );
+    /**
+     * @brief import the config from the legacy json file on spiffs
+     */
+    void blectl_read_json_config( void );
     /**
      * @brief send an battery update over bluetooth to gadgetbridge
      * 
@@ -240,12 +243,42 @@
      * @param enable true if enabled, false if disable
      */
     void blectl_set_autoon( bool autoon );
+    /**
+     * @brief get the relay config
+     *
+     * @return  true if the wheel is mirrored to phone apps
+     */
+    bool blectl_get_relay( void );
+    /**
+     * @brief mirror the wheel to phone apps like WheelLog, the watch advertises the
+     * KingSong service, forwards wheel notifications to subscribed phones and phone
+     * writes to the wheel. the gatt server and relay task are only created on the
+     * first enable
+     *
+     * @param   relay   true to enable, false to disable
+     */
+    void blectl_set_relay( bool relay );
+    /**
+     * @brief feed a frame through the wheel notification path as if the wheel
+     * sent it, for bench testing without a wheel. serialized against the ble
+     * notifications and never relayed to phones
+     *
+     * @param   data    pointer to the frame
+     * @param   length  frame length, decoded only if 20
+     */
+    void blectl_inject_frame( uint8_t *data, size_t length );
 
     void writeBLE (byte*, int);
     /**
-     * @brief ble client setup function
+     * @brief ble client setup function, registers the powermgm callbacks and
+     * brings up the ble stack if blectl_scan_init() was not called before
      */
     void blectl_scan_setup(void);
+    /**
+     * @brief bring up the ble stack and start the first scan, does not touch
+     * lvgl or powermgm so it can run as boot job on core 0
+     */
+    void blectl_scan_init(void);
     /**
      * @brief get BLE connection status
      * 
@@ -0,0 +1,37 @@
+/****************************************************************************
+ *   Copyright  2020  Jesper Ortlund
+ ****************************************************************************/
+/*
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+#include <stdio.h>
+
+#include "blectl_config.h"
+
+void blectl_config_from_json( blectl_config_t *config, JsonObjectConst json ) {
+    config->autoon = json["autoon"] | true;
+    config->enable_on_standby = json["enable_on_standby"] | false;
+    config->txpower = json["tx_power"] | 1;
+    snprintf( config->wheelmac, sizeof( config->wheelmac ), "%s", json["wheel_mac"] | "NULL" );
+    config->relay = json["relay"] | false;
+}
+
+void blectl_config_to_json( const blectl_config_t *config, JsonObject json ) {
+    json["autoon"] = config->autoon;
+    json["enable_on_standby"] = config->enable_on_standby;
+    json["tx_power"] = config->txpower;
+    json["wheel_mac"] = config->wheelmac;
+    json["relay"] = config->relay;
+}
@@ -0,0 +1,56 @@
+/****************************************************************************
+ *   Copyright  2020  Jesper Ortlund
+ ****************************************************************************/
+/*
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+#ifndef _BLECTL_CONFIG_H
+    #define _BLECTL_CONFIG_H
+
+    /*
+     * no arduino or spiffs in here, the config and its json mapping build and run on the host
+     */
+    #include <stdint.h>
+    #include <ArduinoJson.h>
+
+
+    /**
+     * @brief blectl config structure, stored as is in the config store. only append
+     * fields, never reorder or resize them
+     */
+    typedef struct {
+        bool autoon = false;             /** @brief auto on/off */
+        bool enable_on_standby = false; /** @brief enable on standby on/off */
+        int32_t txpower = 1;            /** @brief tx power, valide values are from 0 to 4 */
+        char wheelmac[18] = "NULL";     /** @brief Mac address of wheel, string */
+        bool relay = false;             /** @brief mirror the wheel to phone apps over a KingSong compatible gatt server */
+    } blectl_config_t;
+
+    /**
+     * @brief fill the blectl config from the legacy json, missing keys get their defaults
+     *
+     * @param   config      pointer to the config
+     * @param   json        root object of blectl.json
+     */
+    void blectl_config_from_json( blectl_config_t *config, JsonObjectConst json );
+    /**
+     * @brief write the blectl config as legacy json
+     *
+     * @param   config      pointer to the config
+     * @param   json        root object to fill
+     */
+    void blectl_config_to_json( const blectl_config_t *config, JsonObject json );
+
+#endif // _BLECTL_CONFIG_H
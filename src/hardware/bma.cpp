@@ -26,11 +26,34 @@
 #include <soc/rtc.h>
 
 #include "bma.h"
+#include "gesture.h"
 #include "powermgm.h"
 #include "callback.h"
+#include "configstore.h"
 #include "json_psram_allocator.h"
 #include "alloc.h"
+#include "i2cctl.h"
 
+/*
+ * the TTGO BMA class has no fifo support, so the fifo registers are accessed
+ * directly over the watch i2c bus
+ */
+#define BMA_I2C_ADDR                0x18
+#define BMA_REG_FIFO_LENGTH         0x24
+#define BMA_REG_FIFO_DATA           0x26
+#define BMA_REG_ACC_CONF            0x40
+#define BMA_REG_ACC_RANGE           0x41
+#define BMA_REG_FIFO_DOWNS          0x45
+#define BMA_REG_FIFO_CONFIG_1       0x49
+#define BMA_REG_CMD                 0x7e
+
+#define BMA_ODR_100HZ               0x08        /** @brief acc_odr for 100Hz, each step halves or doubles the rate */
+#define BMA_FIFO_ACC_EN             0x40        /** @brief accel data only, no frame headers */
+#define BMA_FIFO_DOWNS_FILTERED     0x80        /** @brief use filtered data for downsampling */
+#define BMA_CMD_FIFO_FLUSH          0xb0
+#define BMA_FIFO_SIZE               1024        /** @brief fifo size in bytes */
+#define BMA_FIFO_FRAME              6           /** @brief bytes per headerless accel frame */
+#define BMA_FIFO_CHUNK              20          /** @brief frames per i2c read, fits into the wire buffer */
 
 volatile bool DRAM_ATTR bma_irq_flag = false;
 portMUX_TYPE DRAM_ATTR BMA_IRQ_Mux = portMUX_INITIALIZER_UNLOCKED;
@@ -47,10 +70,35 @@ callback_t *bma_callback = NULL;
 
 bool first_loop_run = true;
 
+static gesture_t bma_gesture;
+static bool bma_fifo_enabled = false;
+static int32_t bma_fifo_lsb_per_g = 1024;
+static uint64_t bma_fifo_next = 0;
+/*
+ * a fifo batch is read by the i2c task, the length first and the frames from its callback
+ */
+static uint8_t bma_fifo_length[ 2 ];
+static uint8_t bma_fifo_raw[ BMA_FIFO_SIZE ];
+static int bma_fifo_frames = 0;                 /** @brief frames in the batch */
+static int bma_fifo_frames_in = 0;              /** @brief frames read without error, in order */
+static bool bma_fifo_full = false;              /** @brief the fifo ran full and needs a flush */
+static bool bma_fifo_pending = false;
+static uint32_t bma_fifo_generation = 0;        /** @brief counts flushes, a batch read before the last flush is dropped */
+static uint32_t bma_fifo_read_generation = 0;
+static volatile bool bma_fifo_done = false;
+portMUX_TYPE DRAM_ATTR BMA_FIFO_Mux = portMUX_INITIALIZER_UNLOCKED;
+
 void IRAM_ATTR bma_irq( void );
 bool bma_send_event_cb( EventBits_t event, void *arg );
 bool bma_powermgm_event_cb( EventBits_t event, void *arg );
 bool bma_powermgm_loop_cb( EventBits_t event, void *arg );
+static void bma_fifo_enable( bool enable );
+static void bma_fifo_flush( void );
+static void bma_fifo_read( void );
+static void bma_fifo_length_cb( int result, void *arg );
+static void bma_fifo_data_cb( int result, void *arg );
+static void bma_fifo_set_done( void );
+static void bma_fifo_collect( void );
 
 void bma_setup( void ) {
     TTGOClass *ttgo = TTGOClass::getWatch();
@@ -58,6 +106,10 @@ void bma_setup( void ) {
     for ( int i = 0 ; i < BMA_CONFIG_NUM ; i++ ) {
         bma_config[ i ].enable = true;
     }
+    /*
+     * ride gestures keep the fifo running, off until enabled, also for a config stored before they existed
+     */
+    bma_config[ BMA_RIDE_GESTURES ].enable = false;
 
     if ( stepcounter_valid != 0xa5a5a5a5 ) {
       stepcounter = 0;
@@ -139,6 +191,12 @@ void bma_wakeup( void ) {
         }
     }
 
+    /*
+     * the fifo ran full while we were sleeping, old motion is no gesture
+     */
+    if ( bma_fifo_enabled )
+        bma_fifo_flush();
+
     first_loop_run = true;
 }
 
@@ -149,6 +207,7 @@ void bma_reload_settings( void ) {
     ttgo->bma->enableStepCountInterrupt( bma_config[ BMA_STEPCOUNTER ].enable );
     ttgo->bma->enableWakeupInterrupt( bma_config[ BMA_DOUBLECLICK ].enable );
     ttgo->bma->enableTiltInterrupt( bma_config[ BMA_TILT ].enable );
+    bma_fifo_enable( bma_config[ BMA_RIDE_GESTURES ].enable );
 }
 
 void IRAM_ATTR bma_irq( void ) {
@@ -187,6 +246,16 @@ void bma_loop( void ) {
         }
     }
 
+    /*
+     * ride gestures are classified in batches, the fifo collects the samples in between
+     */
+    if ( bma_fifo_enabled && !bma_fifo_pending && bma_fifo_next <= millis() ) {
+        bma_fifo_next = millis() + BMA_FIFO_INTERVAL;
+        bma_fifo_read();
+    }
+    if ( bma_fifo_pending )
+        bma_fifo_collect();
+
     // force update statusbar after restart/boot
     if ( first_loop_run ) {
         first_loop_run = false;
@@ -197,6 +266,166 @@ void bma_loop( void ) {
     }
 }
 
+static void bma_fifo_enable( bool enable ) {
+    TTGOClass *ttgo = TTGOClass::getWatch();
+    uint8_t reg = 0;
+
+    if ( !enable ) {
+        if ( bma_fifo_enabled )
+            ttgo->i2c->writeBytes( BMA_I2C_ADDR, BMA_REG_FIFO_CONFIG_1, &reg, 1 );
+        bma_fifo_enabled = false;
+        return;
+    }
+
+    /*
+     * the feature engine needs the full output data rate, only the fifo is downsampled
+     */
+    uint8_t acc_conf = BMA_ODR_100HZ;
+    uint8_t acc_range = 0;
+    ttgo->i2c->readBytes( BMA_I2C_ADDR, BMA_REG_ACC_CONF, &acc_conf, 1 );
+    ttgo->i2c->readBytes( BMA_I2C_ADDR, BMA_REG_ACC_RANGE, &acc_range, 1 );
+
+    int odr = acc_conf & 0x0f;
+    uint32_t rate = ( odr >= BMA_ODR_100HZ ) ? ( 100 << ( odr - BMA_ODR_100HZ ) ) : ( 100 >> ( BMA_ODR_100HZ - odr ) );
+    uint8_t downs = 0;
+    while ( ( rate >> downs ) > BMA_FIFO_RATE && downs < 7 )
+        downs++;
+    rate = max( rate >> downs, (uint32_t)1 );
+    bma_fifo_lsb_per_g = 1024 >> ( acc_range & 0x03 );
+
+    reg = BMA_FIFO_DOWNS_FILTERED | ( downs << 4 );
+    ttgo->i2c->writeBytes( BMA_I2C_ADDR, BMA_REG_FIFO_DOWNS, &reg, 1 );
+    reg = BMA_FIFO_ACC_EN;
+    ttgo->i2c->writeBytes( BMA_I2C_ADDR, BMA_REG_FIFO_CONFIG_1, &reg, 1 );
+
+    gesture_init( &bma_gesture, rate );
+    bma_fifo_flush();
+    bma_fifo_enabled = true;
+    log_i("ride gestures enabled, fifo at %dHz", rate );
+}
+
+static void bma_fifo_flush( void ) {
+    TTGOClass *ttgo = TTGOClass::getWatch();
+    uint8_t reg = BMA_CMD_FIFO_FLUSH;
+
+    ttgo->i2c->writeBytes( BMA_I2C_ADDR, BMA_REG_CMD, &reg, 1 );
+    gesture_reset( &bma_gesture );
+    /*
+     * a batch still in flight holds motion from before the flush
+     */
+    bma_fifo_generation++;
+    bma_fifo_next = millis() + BMA_FIFO_INTERVAL;
+}
+
+static void bma_fifo_read( void ) {
+    bma_fifo_read_generation = bma_fifo_generation;
+    bma_fifo_pending = i2cctl_read( BMA_I2C_ADDR, BMA_REG_FIFO_LENGTH, bma_fifo_length, sizeof( bma_fifo_length ), I2C_SCHED_NO_BURST, bma_fifo_length_cb, NULL );
+}
+
+/**
+ * @brief runs in the i2c task, queues the frames in chunks that fit into the wire buffer
+ */
+static void bma_fifo_length_cb( int result, void *arg ) {
+    bma_fifo_frames = 0;
+    bma_fifo_frames_in = 0;
+    bma_fifo_full = false;
+
+    if ( result == 0 )
+        bma_fifo_frames = ( ( ( bma_fifo_length[ 1 ] & 0x3f ) << 8 ) | bma_fifo_length[ 0 ] ) / BMA_FIFO_FRAME;
+    /*
+     * a full fifo has dropped samples, the motion history doesn't fit anymore
+     */
+    if ( bma_fifo_frames >= BMA_FIFO_SIZE / BMA_FIFO_FRAME ) {
+        bma_fifo_full = true;
+        bma_fifo_frames = 0;
+    }
+
+    /*
+     * the chunks run after this callback returns, the arg is the frame count after the chunk
+     */
+    for ( int frame = 0 ; frame < bma_fifo_frames ; frame += BMA_FIFO_CHUNK ) {
+        int num = min( bma_fifo_frames - frame, BMA_FIFO_CHUNK );
+        if ( !i2cctl_read( BMA_I2C_ADDR, BMA_REG_FIFO_DATA, &bma_fifo_raw[ frame * BMA_FIFO_FRAME ], num * BMA_FIFO_FRAME, I2C_SCHED_NO_BURST, bma_fifo_data_cb, (void *)(intptr_t)( frame + num ) ) ) {
+            bma_fifo_frames = frame;
+            break;
+        }
+    }
+
+    if ( bma_fifo_frames == 0 )
+        bma_fifo_set_done();
+}
+
+/**
+ * @brief runs in the i2c task, the last chunk hands the batch to bma_loop
+ */
+static void bma_fifo_data_cb( int result, void *arg ) {
+    int end = (int)(intptr_t)arg;
+
+    /*
+     * frames after a failed chunk are kept out, the motion would have a gap
+     */
+    if ( result == 0 && bma_fifo_frames_in == ( ( end - 1 ) / BMA_FIFO_CHUNK ) * BMA_FIFO_CHUNK )
+        bma_fifo_frames_in = end;
+    if ( end == bma_fifo_frames )
+        bma_fifo_set_done();
+}
+
+static void bma_fifo_set_done( void ) {
+    portENTER_CRITICAL( &BMA_FIFO_Mux );
+    bma_fifo_done = true;
+    portEXIT_CRITICAL( &BMA_FIFO_Mux );
+}
+
+static void bma_fifo_collect( void ) {
+    gesture_sample_t sample[ BMA_FIFO_CHUNK ];
+    uint32_t detected = 0;
+
+    portENTER_CRITICAL( &BMA_FIFO_Mux );
+    bool done = bma_fifo_done;
+    bma_fifo_done = false;
+    portEXIT_CRITICAL( &BMA_FIFO_Mux );
+
+    if ( !done )
+        return;
+
+    bma_fifo_pending = false;
+    if ( bma_fifo_read_generation != bma_fifo_generation )
+        return;
+    if ( bma_fifo_full ) {
+        bma_fifo_flush();
+        return;
+    }
+
+    int frames = bma_fifo_frames_in;
+
+    for ( int frame = 0 ; frame < frames ; frame += BMA_FIFO_CHUNK ) {
+        int num = min( frames - frame, BMA_FIFO_CHUNK );
+        const uint8_t *raw = &bma_fifo_raw[ frame * BMA_FIFO_FRAME ];
+        /*
+         * 12 bit samples, left aligned in 16 bit little endian
+         */
+        for ( int i = 0 ; i < num ; i++ ) {
+            int16_t axis[ 3 ];
+            for ( int j = 0 ; j < 3 ; j++ ) {
+                int16_t value = (int16_t)( ( raw[ i * BMA_FIFO_FRAME + j * 2 + 1 ] << 8 ) | raw[ i * BMA_FIFO_FRAME + j * 2 ] ) >> 4;
+                axis[ j ] = ( value * 1000 ) / bma_fifo_lsb_per_g;
+            }
+            sample[ i ].x = axis[ 0 ];
+            sample[ i ].y = axis[ 1 ];
+            sample[ i ].z = axis[ 2 ];
+        }
+        detected |= gesture_feed( &bma_gesture, sample, num );
+    }
+
+    if ( detected & GESTURE_WRIST_RAISE ) {
+        powermgm_set_event( POWERMGM_BMA_TILT );
+        bma_send_event_cb( BMACTL_WRIST_RAISE, (void *)"" );
+    }
+    if ( detected & GESTURE_SHAKE ) {
+        bma_send_event_cb( BMACTL_SHAKE, (void *)"" );
+    }
+}
+
 bool bma_register_cb( EventBits_t event, CALLBACK_FUNC callback_func, const char *id ) {
     if ( bma_callback == NULL ) {
         bma_callback = callback_init( "bma" );
@@ -213,6 +442,17 @@ bool bma_send_event_cb( EventBits_t event, void *arg ) {
 }
 
 void bma_save_config( void ) {
+    configstore_save( CONFIGSTORE_BMA );
+}
+
+void bma_read_config( void ) {
+    if ( !configstore_register( CONFIGSTORE_BMA, bma_config, sizeof( bma_config ), bma_read_json_config, bma_save_json_config ) ) {
+        bma_read_json_config();
+        bma_save_config();
+    }
+}
+
+void bma_save_json_config( void ) {
     fs::File file = SPIFFS.open( BMA_JSON_COFIG_FILE, FILE_WRITE );
 
     if (!file) {
@@ -221,10 +461,7 @@ void bma_save_config( void ) {
     else {
         SpiRamJsonDocument doc( 1000 );
 
-        doc["stepcounter"] = bma_config[ BMA_STEPCOUNTER ].enable;
-        doc["doubleclick"] = bma_config[ BMA_DOUBLECLICK ].enable;
-        doc["tilt"] = bma_config[ BMA_TILT ].enable;
-        doc["daily_stepcounter"] = bma_config[ BMA_DAILY_STEPCOUNTER ].enable;
+        bma_config_to_json( bma_config, doc.to<JsonObject>() );
 
         if ( serializeJsonPretty( doc, file ) == 0) {
             log_e("Failed to write config file");
@@ -234,7 +471,7 @@ void bma_save_config( void ) {
     file.close();
 }
 
-void bma_read_config( void ) {
+void bma_read_json_config( void ) {
     fs::File file = SPIFFS.open( BMA_JSON_COFIG_FILE, FILE_READ );
     if (!file) {
         log_e("Can't open file: %s!", BMA_JSON_COFIG_FILE );
@@ -248,10 +485,7 @@ void bma_read_config( void ) {
             log_e("update check deserializeJson() failed: %s", error.c_str() );
         }
         else {
-            bma_config[ BMA_STEPCOUNTER ].enable = doc["stepcounter"] | true;
-            bma_config[ BMA_DOUBLECLICK ].enable = doc["doubleclick"] | true;
-            bma_config[ BMA_TILT ].enable = doc["tilt"] | false;
-            bma_config[ BMA_DAILY_STEPCOUNTER ].enable = doc["daily_stepcounter"] | false;
+            bma_config_from_json( bma_config, doc.as<JsonObjectConst>() );
         }        
         doc.clear();
     }
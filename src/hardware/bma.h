@@ -24,29 +24,20 @@
 
     #include "TTGO.h"
     #include "callback.h"
+    #include "bma_config.h"
     
     #define BMACTL_EVENT_INT            _BV(0)              /** @brief event mask for bma interrupt */
     #define BMACTL_DOUBLECLICK          _BV(1)              /** @brief event mask for an doubleclick event */
     #define BMACTL_STEPCOUNTER          _BV(2)              /** @brief event mask for an stepcounter update event, callback arg is (uint32*) */
     #define BMACTL_TILT                 _BV(3)              /** @brief event mask for an tilt event */
     #define BMACTL_DAILY_STEPCOUNTER    _BV(4)              /** @brief event mask for an tilt event */
+    #define BMACTL_WRIST_RAISE          _BV(5)              /** @brief event mask for a wrist raise from the ride gestures */
+    #define BMACTL_SHAKE                _BV(6)              /** @brief event mask for a shake from the ride gestures */
 
     #define BMA_JSON_COFIG_FILE         "/bma.json"         /** @brief defines json config file name */
 
-    /**
-     * @brief bma config structure
-     */
-    typedef struct {
-        bool enable=true;
-    } bma_config_t;
-
-    enum {  
-        BMA_STEPCOUNTER,
-        BMA_DOUBLECLICK,
-        BMA_TILT,
-        BMA_DAILY_STEPCOUNTER,
-        BMA_CONFIG_NUM
-    };
+    #define BMA_FIFO_INTERVAL           250                 /** @brief ms between two fifo batches for the ride gestures */
+    #define BMA_FIFO_RATE               25                  /** @brief max fifo sample rate in Hz, the fifo is downsampled to this */
 
     /**
      * @brief setup bma activity measurement
@@ -76,6 +67,14 @@
      * @brief read the config structure from SPIFFS
      */
     void bma_read_config( void );
+    /**
+     * @brief write the config as legacy json file to spiffs
+     */
+    void bma_save_json_config( void );
+    /**
+     * @brief import the config from the legacy json file on spiffs
+     */
+    void bma_read_json_config( void );
     /**
      * @brief get config
      * 
@@ -98,7 +97,7 @@
     /**
      * @brief registers a callback function which is called on a corresponding event
      * 
-     * @param   event           possible values: BMACTL_DOUBLECLICK, BMACTL_STEPCOUNTER and BMACTL_TILT
+     * @param   event           possible values: BMACTL_DOUBLECLICK, BMACTL_STEPCOUNTER, BMACTL_TILT, BMACTL_WRIST_RAISE and BMACTL_SHAKE
      * @param   callback_func   pointer to the callback function
      * @param   id              program id
      * 
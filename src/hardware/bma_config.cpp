@@ -0,0 +1,35 @@
+/****************************************************************************
+ *   Copyright  2020  Jesper Ortlund
+ ****************************************************************************/
+/*
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+#include "bma_config.h"
+
+void bma_config_from_json( bma_config_t *config, JsonObjectConst json ) {
+    config[ BMA_STEPCOUNTER ].enable = json["stepcounter"] | true;
+    config[ BMA_DOUBLECLICK ].enable = json["doubleclick"] | true;
+    config[ BMA_TILT ].enable = json["tilt"] | false;
+    config[ BMA_DAILY_STEPCOUNTER ].enable = json["daily_stepcounter"] | false;
+    config[ BMA_RIDE_GESTURES ].enable = json["ride_gestures"] | false;
+}
+
+void bma_config_to_json( const bma_config_t *config, JsonObject json ) {
+    json["stepcounter"] = config[ BMA_STEPCOUNTER ].enable;
+    json["doubleclick"] = config[ BMA_DOUBLECLICK ].enable;
+    json["tilt"] = config[ BMA_TILT ].enable;
+    json["daily_stepcounter"] = config[ BMA_DAILY_STEPCOUNTER ].enable;
+    json["ride_gestures"] = config[ BMA_RIDE_GESTURES ].enable;
+}
@@ -0,0 +1,185 @@
+/****************************************************************************
+ *   Copyright  2020  Jesper Ortlund
+ ****************************************************************************/
+/*
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+#include "config.h"
+#include <TTGO.h>
+
+#include "bootctl.h"
+
+typedef struct {
+    const char *name;
+    BOOTCTL_JOB_FUNC func;
+    EventBits_t depends;
+    EventBits_t bit;
+    BaseType_t core;
+} bootctl_job_t;
+
+static bootctl_phase_t bootctl_phase[ BOOTCTL_MAX_PHASES ];
+static int bootctl_phase_num = 0;
+
+static bootctl_job_t bootctl_job[ BOOTCTL_MAX_JOBS ];
+static int bootctl_job_num = 0;
+static EventGroupHandle_t bootctl_job_status = NULL;
+
+portMUX_TYPE DRAM_ATTR bootctlMux = portMUX_INITIALIZER_UNLOCKED;
+
+void bootctl_run_job( bootctl_job_t *job );
+void bootctl_job_Task( void * pvParameters );
+
+int bootctl_phase_begin( const char *name ) {
+    int phase = -1;
+
+    portENTER_CRITICAL( &bootctlMux );
+    if ( bootctl_phase_num < BOOTCTL_MAX_PHASES ) {
+        phase = bootctl_phase_num++;
+        bootctl_phase[ phase ].name = name;
+        bootctl_phase[ phase ].start = esp_timer_get_time();
+        bootctl_phase[ phase ].stop = bootctl_phase[ phase ].start;
+        bootctl_phase[ phase ].core = xPortGetCoreID();
+    }
+    portEXIT_CRITICAL( &bootctlMux );
+
+    if ( phase == -1 ) {
+        log_w("boot phase table full, %s not recorded", name );
+    }
+    return( phase );
+}
+
+void bootctl_phase_end( int phase ) {
+    if ( phase < 0 || phase >= BOOTCTL_MAX_PHASES )
+        return;
+
+    portENTER_CRITICAL( &bootctlMux );
+    bootctl_phase[ phase ].stop = esp_timer_get_time();
+    portEXIT_CRITICAL( &bootctlMux );
+}
+
+void bootctl_mark( const char *name ) {
+    portENTER_CRITICAL( &bootctlMux );
+    for ( int phase = 0 ; phase < bootctl_phase_num ; phase++ ) {
+        if ( !strcmp( bootctl_phase[ phase ].name, name ) ) {
+            portEXIT_CRITICAL( &bootctlMux );
+            return;
+        }
+    }
+    portEXIT_CRITICAL( &bootctlMux );
+
+    bootctl_phase_begin( name );
+}
+
+void bootctl_print( void ) {
+    Serial.printf("boot phases (us since power on):\r\n");
+    for ( int phase = 0 ; phase < bootctl_phase_num ; phase++ ) {
+        Serial.printf("  %-20s core %d start %8lld took %8lld\r\n", bootctl_phase[ phase ].name,
+                                                                    bootctl_phase[ phase ].core,
+                                                                    bootctl_phase[ phase ].start,
+                                                                    bootctl_phase[ phase ].stop - bootctl_phase[ phase ].start );
+    }
+}
+
+int bootctl_get_phase_num( void ) {
+    return( bootctl_phase_num );
+}
+
+bootctl_phase_t *bootctl_get_phase( int phase ) {
+    if ( phase < 0 || phase >= bootctl_phase_num )
+        return( NULL );
+    return( &bootctl_phase[ phase ] );
+}
+
+int64_t bootctl_get_time( const char *name ) {
+    int64_t time = -1;
+
+    portENTER_CRITICAL( &bootctlMux );
+    for ( int phase = 0 ; phase < bootctl_phase_num ; phase++ ) {
+        if ( !strcmp( bootctl_phase[ phase ].name, name ) ) {
+            time = bootctl_phase[ phase ].start;
+            break;
+        }
+    }
+    portEXIT_CRITICAL( &bootctlMux );
+    return( time );
+}
+
+EventBits_t bootctl_add_job( const char *name, BOOTCTL_JOB_FUNC func, EventBits_t depends, BaseType_t core ) {
+    if ( bootctl_job_num >= BOOTCTL_MAX_JOBS ) {
+        log_e("no space for boot job %s", name );
+        return( 0 );
+    }
+
+    bootctl_job_t *job = &bootctl_job[ bootctl_job_num ];
+    job->name = name;
+    job->func = func;
+    job->depends = depends;
+    job->bit = _BV( bootctl_job_num );
+    job->core = core;
+    bootctl_job_num++;
+
+    return( job->bit );
+}
+
+void bootctl_run_job( bootctl_job_t *job ) {
+    if ( job->depends ) {
+        xEventGroupWaitBits( bootctl_job_status, job->depends, pdFALSE, pdTRUE, portMAX_DELAY );
+    }
+    int phase = bootctl_phase_begin( job->name );
+    job->func();
+    bootctl_phase_end( phase );
+    xEventGroupSetBits( bootctl_job_status, job->bit );
+}
+
+void bootctl_job_Task( void * pvParameters ) {
+    bootctl_run_job( (bootctl_job_t *)pvParameters );
+    vTaskDelete( NULL );
+}
+
+void bootctl_run( void ) {
+    EventBits_t all_jobs = 0;
+
+    if ( bootctl_job_num == 0 )
+        return;
+
+    bootctl_job_status = xEventGroupCreate();
+
+    /*
+     * start all jobs for the other core first, so they can run while we work through our own
+     */
+    for ( int job = 0 ; job < bootctl_job_num ; job++ ) {
+        all_jobs |= bootctl_job[ job ].bit;
+        if ( bootctl_job[ job ].core != xPortGetCoreID() ) {
+            xTaskCreatePinnedToCore(    bootctl_job_Task,           /* Function to implement the task */
+                                        bootctl_job[ job ].name,    /* Name of the task */
+                                        BOOTCTL_JOB_STACK,          /* Stack size in words */
+                                        &bootctl_job[ job ],        /* Task input parameter */
+                                        1,                          /* Priority of the task */
+                                        NULL,                       /* Task handle. */
+                                        bootctl_job[ job ].core );
+        }
+    }
+
+    for ( int job = 0 ; job < bootctl_job_num ; job++ ) {
+        if ( bootctl_job[ job ].core == xPortGetCoreID() ) {
+            bootctl_run_job( &bootctl_job[ job ] );
+        }
+    }
+
+    xEventGroupWaitBits( bootctl_job_status, all_jobs, pdFALSE, pdTRUE, portMAX_DELAY );
+    vEventGroupDelete( bootctl_job_status );
+    bootctl_job_status = NULL;
+    bootctl_job_num = 0;
+}
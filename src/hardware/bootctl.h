@@ -0,0 +1,105 @@
+/****************************************************************************
+ *   Copyright  2020  Jesper Ortlund
+ ****************************************************************************/
+/*
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+#ifndef _BOOTCTL_H
+    #define _BOOTCTL_H
+
+    #include "TTGO.h"
+
+    #define BOOTCTL_MAX_PHASES          24          /** @brief max recorded boot phases */
+    #define BOOTCTL_MAX_JOBS            8           /** @brief max init jobs per bootctl_run() */
+    #define BOOTCTL_JOB_STACK           8192        /** @brief stack size for jobs running on the other core */
+
+    #define BOOTCTL_MARK_SETUP_DONE     "setup done"        /** @brief mark at the end of setup() */
+    #define BOOTCTL_MARK_FIRST_FRAME    "first wheel frame" /** @brief mark at the first decoded wheel frame */
+
+    /**
+     * @brief boot phase structure
+     */
+    typedef struct {
+        const char *name;                           /** @brief phase name, must be a static string */
+        int64_t start;                              /** @brief start time in us since power on */
+        int64_t stop;                               /** @brief stop time in us since power on, equal to start for marks */
+        int core;                                   /** @brief core the phase ran on */
+    } bootctl_phase_t;
+
+    typedef void ( * BOOTCTL_JOB_FUNC ) ( void );
+
+    /**
+     * @brief start timing a boot phase
+     *
+     * @param   name    phase name, must be a static string
+     *
+     * @return  phase handle or -1 if the phase table is full
+     */
+    int bootctl_phase_begin( const char *name );
+    /**
+     * @brief stop timing a boot phase
+     *
+     * @param   phase   phase handle from bootctl_phase_begin()
+     */
+    void bootctl_phase_end( int phase );
+    /**
+     * @brief record a single point in time, like the first wheel data, only the first call per name is kept
+     *
+     * @param   name    mark name, must be a static string
+     */
+    void bootctl_mark( const char *name );
+    /**
+     * @brief print all recorded boot phases to serial
+     */
+    void bootctl_print( void );
+    /**
+     * @brief get the number of recorded boot phases
+     *
+     * @return  number of phases
+     */
+    int bootctl_get_phase_num( void );
+    /**
+     * @brief get a recorded boot phase
+     *
+     * @param   phase   phase number
+     *
+     * @return  pointer to the phase or NULL if not recorded
+     */
+    bootctl_phase_t *bootctl_get_phase( int phase );
+    /**
+     * @brief get when a boot phase started or a mark was recorded
+     *
+     * @param   name    phase or mark name
+     *
+     * @return  us since power on, -1 if not recorded (yet)
+     */
+    int64_t bootctl_get_time( const char *name );
+    /**
+     * @brief add an init job for the next bootctl_run()
+     *
+     * @param   name        job name, must be a static string
+     * @param   func        init function
+     * @param   depends     job bits that have to finish before this job starts, 0 for none
+     * @param   core        core to run on, jobs on the calling core run inline in the order they were added
+     *
+     * @return  job bit, use it as depends for later jobs, 0 if failed
+     */
+    EventBits_t bootctl_add_job( const char *name, BOOTCTL_JOB_FUNC func, EventBits_t depends, BaseType_t core );
+    /**
+     * @brief run all added init jobs and wait until all are finished
+     */
+    void bootctl_run( void );
+
+#endif // _BOOTCTL_H
@@ -22,12 +22,32 @@
 
 #include "callback.h"
 #include "alloc.h"
+#include "arena.h"
+
+/**
+ * @brief a timed lv_task function and its entry in callback_lv_task_table
+ */
+typedef struct {
+    lv_task_cb_t task_cb;
+    uint32_t entry;
+} callback_lv_task_t;
 
 void  display_record_event( callback_t *callback, EventBits_t event );
+static bool callback_call( callback_table_t *entry, EventBits_t event, void *arg );
+static void callback_account( callback_table_t *entry, int64_t start );
+static void callback_lv_task_run( lv_task_t *task );
 
 callback_t *callback_head = NULL;
 static bool display_event_logging = false;
 
+portMUX_TYPE DRAM_ATTR callbackOverrunMux = portMUX_INITIALIZER_UNLOCKED;
+static callback_overrun_t callback_overrun[ CALLBACK_OVERRUN_NUM ];
+static uint32_t callback_overrun_count = 0;
+
+static callback_t *callback_lv_task_table = NULL;
+static callback_lv_task_t callback_lv_task[ CALLBACK_LV_TASK_NUM ];
+static uint32_t callback_lv_task_num = 0;
+
 void callback_print( void ) {
     if ( callback_head == NULL ) {
         return;
@@ -38,7 +58,8 @@ void callback_print( void ) {
     do {
         log_i(" |--%s", callback_counter->name, callback_counter );
         for( int32_t i = 0 ; i < callback_counter->entrys ; i++ ) {
-            log_i(" |  |--id:%s, event mask:%04x", callback_counter->table[ i ].id, callback_counter->table[ i ].event );
+            callback_table_t *entry = &callback_counter->table[ i ];
+            log_i(" |  |--id:%s, event mask:%04x, calls:%llu, p99:%uus, max:%uus", entry->id, entry->event, entry->counter, metrics_histogram_percentile( &entry->duration, 99 ), entry->duration.max );
         }
         callback_counter = callback_counter->next_callback_t;
     }
@@ -48,7 +69,10 @@ void callback_print( void ) {
 callback_t *callback_init( const char *name ) {
     callback_t *callback = NULL;
 
-    callback = (callback_t*)CALLOC( sizeof( callback_t ), 1 );
+    callback = (callback_t*)arena_alloc( ARENA_FAST, sizeof( callback_t ), "callback" );
+    if ( callback == NULL ) {
+        callback = (callback_t*)CALLOC( sizeof( callback_t ), 1 );
+    }
 
     if ( callback == NULL ) {
         log_e("callback_t structure calloc faild for: %s", name );
@@ -59,6 +83,7 @@ callback_t *callback_init( const char *name ) {
         }
             
         callback->entrys = 0;
+        callback->capacity = 0;
         callback->table = NULL;
         callback->name = name;
         callback->next_callback_t = NULL;
@@ -85,32 +110,39 @@ bool callback_register( callback_t *callback, EventBits_t event, CALLBACK_FUNC c
         return( retval );
     }
 
-    callback->entrys++;
-
-    if ( callback->table == NULL ) {
-        callback->table = ( callback_table_t * )CALLOC( sizeof( callback_table_t ) * callback->entrys, 1 );
-        if ( callback->table == NULL ) {
-            log_e("callback_table_t calloc faild for: %s", id );
-            return( retval );
+    /*
+     * tables are walked on every loop, keep them in internal ram. they grow
+     * by doubling, an outgrown arena table stays behind as arena memory
+     * can't be freed, registering happens at setup so that is a few hundred
+     * bytes once
+     */
+    if ( callback->entrys == callback->capacity ) {
+        uint32_t capacity = callback->capacity ? callback->capacity * 2 : CALLBACK_TABLE_GROW;
+        callback_table_t *new_callback_table = ( callback_table_t * )arena_alloc( ARENA_FAST, sizeof( callback_table_t ) * capacity, "callback" );
+        if ( new_callback_table == NULL ) {
+            new_callback_table = ( callback_table_t * )CALLOC( sizeof( callback_table_t ) * capacity, 1 );
         }
-        retval = true;
-    }
-    else {
-        callback_table_t *new_callback_table = NULL;
-        new_callback_table = ( callback_table_t * )REALLOC( callback->table, sizeof( callback_table_t ) * callback->entrys );
         if ( new_callback_table == NULL ) {
-            log_e("callback_table_t realloc faild for: %s", id );
+            log_e("callback_table_t alloc faild for: %s", id );
             return( retval );
         }
-
+        if ( callback->table ) {
+            memcpy( new_callback_table, callback->table, sizeof( callback_table_t ) * callback->entrys );
+            if ( !arena_owns( callback->table ) ) {
+                free( callback->table );
+            }
+        }
         callback->table = new_callback_table;
-        retval = true;
+        callback->capacity = capacity;
     }
+    callback->entrys++;
+    retval = true;
 
     callback->table[ callback->entrys - 1 ].event = event;
     callback->table[ callback->entrys - 1 ].callback_func = callback_func;
     callback->table[ callback->entrys - 1 ].id = id;
     callback->table[ callback->entrys - 1 ].counter = 0;
+    memset( &callback->table[ callback->entrys - 1 ].duration, 0, sizeof( metrics_histogram_t ) );
     log_i("register callback_func for %s success (%p:%s)", callback->name, callback->table[ callback->entrys - 1 ].callback_func, callback->table[ callback->entrys - 1 ].id );
     return( retval );
 }
@@ -194,8 +226,7 @@ bool callback_send( callback_t *callback, EventBits_t event, void *arg ) {
         yield();
         if ( event & callback->table[ entry ].event ) {
             log_i("call %s cb (%p:%04x:%s)", callback->name, callback->table[ entry ].callback_func, event, callback->table[ entry ].id );
-            callback->table[ entry ].counter++;
-            if ( !callback->table[ entry ].callback_func( event, arg ) ) {
+            if ( !callback_call( &callback->table[ entry ], event, arg ) ) {
                 retval = false;
             }
         }
@@ -219,8 +250,7 @@ bool callback_send_no_log( callback_t *callback, EventBits_t event, void *arg )
     for ( int entry = 0 ; entry < callback->entrys ; entry++ ) {
         yield();
         if ( event & callback->table[ entry ].event ) {
-            callback->table[ entry ].counter++;
-            if ( !callback->table[ entry ].callback_func( event, arg ) ) {
+            if ( !callback_call( &callback->table[ entry ], event, arg ) ) {
                 retval = false;
             }
         }
@@ -231,3 +261,94 @@ bool callback_send_no_log( callback_t *callback, EventBits_t event, void *arg )
 void display_event_logging_enable( bool enable ) {
     display_event_logging = enable;
 }
+
+static bool callback_call( callback_table_t *entry, EventBits_t event, void *arg ) {
+    int64_t start = esp_timer_get_time();
+
+    entry->counter++;
+    bool retval = entry->callback_func( event, arg );
+    callback_account( entry, start );
+    return( retval );
+}
+
+static void callback_account( callback_table_t *entry, int64_t start ) {
+    uint32_t duration = esp_timer_get_time() - start;
+
+    metrics_histogram_add( &entry->duration, duration );
+    /*
+     * remember who blew the budget, the ring is shared by all callback
+     * tables and they are sent from more than one task
+     */
+    if ( duration > CALLBACK_BUDGET_US ) {
+        portENTER_CRITICAL( &callbackOverrunMux );
+        callback_overrun_t *overrun = &callback_overrun[ callback_overrun_count % CALLBACK_OVERRUN_NUM ];
+        overrun->id = entry->id;
+        overrun->duration = duration;
+        overrun->timestamp = millis();
+        callback_overrun_count++;
+        portEXIT_CRITICAL( &callbackOverrunMux );
+    }
+}
+
+lv_task_t *callback_lv_task_create( lv_task_cb_t task_cb, uint32_t period, lv_task_prio_t prio, const char *id ) {
+    callback_lv_task_t *timed = NULL;
+
+    if ( callback_lv_task_table == NULL ) {
+        callback_lv_task_table = callback_init( "lv task" );
+    }
+
+    for ( uint32_t i = 0 ; i < callback_lv_task_num ; i++ ) {
+        if ( callback_lv_task[ i ].task_cb == task_cb && !strcmp( callback_lv_task_table->table[ callback_lv_task[ i ].entry ].id, id ) ) {
+            timed = &callback_lv_task[ i ];
+            break;
+        }
+    }
+
+    /*
+     * the table entry is never called by callback_send, event 0 matches nothing
+     */
+    if ( timed == NULL && callback_lv_task_num < CALLBACK_LV_TASK_NUM && callback_register( callback_lv_task_table, 0, NULL, id ) ) {
+        timed = &callback_lv_task[ callback_lv_task_num++ ];
+        timed->task_cb = task_cb;
+        timed->entry = callback_lv_task_table->entrys - 1;
+    }
+
+    if ( timed == NULL ) {
+        log_w("lv task %s runs untimed", id );
+        return( lv_task_create( task_cb, period, prio, NULL ) );
+    }
+    return( lv_task_create( callback_lv_task_run, period, prio, timed ) );
+}
+
+static void callback_lv_task_run( lv_task_t *task ) {
+    callback_lv_task_t *timed = (callback_lv_task_t *)task->user_data;
+    int64_t start = esp_timer_get_time();
+
+    timed->task_cb( task );
+    /*
+     * the table may have grown while the task ran, look the entry up afterwards
+     */
+    callback_table_t *entry = &callback_lv_task_table->table[ timed->entry ];
+    entry->counter++;
+    callback_account( entry, start );
+}
+
+callback_t *callback_get_first( void ) {
+    return( callback_head );
+}
+
+uint32_t callback_get_overrun_num( void ) {
+    return( min( callback_overrun_count, (uint32_t)CALLBACK_OVERRUN_NUM ) );
+}
+
+bool callback_get_overrun( uint32_t n, callback_overrun_t *overrun ) {
+    bool retval = false;
+
+    portENTER_CRITICAL( &callbackOverrunMux );
+    if ( n < callback_overrun_count && n < CALLBACK_OVERRUN_NUM ) {
+        *overrun = callback_overrun[ ( callback_overrun_count - 1 - n ) % CALLBACK_OVERRUN_NUM ];
+        retval = true;
+    }
+    portEXIT_CRITICAL( &callbackOverrunMux );
+    return( retval );
+}
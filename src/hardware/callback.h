@@ -22,6 +22,13 @@
     #define _CALLBACK_H
 
     #include <stdint.h>
+    #include "config.h"
+    #include "metrics.h"
+
+    #define CALLBACK_BUDGET_US          30000       /** @brief a callback running longer than this is logged as overrun, one frame at 33fps */
+    #define CALLBACK_OVERRUN_NUM        16          /** @brief number of overruns kept, the oldest one is overwritten */
+    #define CALLBACK_TABLE_GROW         4           /** @brief first table size, doubled when full */
+    #define CALLBACK_LV_TASK_NUM        16          /** @brief max number of timed lv_task functions */
 
     /**
      * @brief typedef for the callback function call
@@ -41,6 +48,7 @@
         CALLBACK_FUNC callback_func;        /** @brief pointer to a callback function */
         const char *id;                     /** @brief id for the callback */
         uint64_t counter;                   /** @brief callback function call counter thair returned true */
+        metrics_histogram_t duration;       /** @brief callback function run time in us */
     } callback_table_t;
 
     /**
@@ -48,11 +56,21 @@
      */
     typedef struct callback_t {
         uint32_t entrys;                    /** @brief count callback entrys */
+        uint32_t capacity;                  /** @brief entrys the table has room for */
         callback_table_t *table;            /** @brief pointer to an callback table */
         const char *name;                   /** @brief id for the callback structure */
         callback_t *next_callback_t;
     } callback_t;
 
+    /**
+     * @brief callback budget overrun
+     */
+    typedef struct {
+        const char *id;                     /** @brief id of the callback function that ran too long */
+        uint32_t duration;                  /** @brief run time in us */
+        uint32_t timestamp;                 /** @brief millis() when the callback function returned */
+    } callback_overrun_t;
+
     /**
      * @brief init the callback structure
      * 
@@ -99,5 +117,39 @@
      */
     void display_event_logging_enable( bool enable );
     void callback_print( void );
+    /**
+     * @brief   get the first callback structure, follow next_callback_t for the others
+     *
+     * @return  pointer to a callback_t structure, NULL if none registered
+     */
+    callback_t *callback_get_first( void );
+    /**
+     * @brief   get the number of recorded overruns, at most CALLBACK_OVERRUN_NUM
+     *
+     * @return  number of overruns
+     */
+    uint32_t callback_get_overrun_num( void );
+    /**
+     * @brief   copy a recorded overrun
+     *
+     * @param   n           0 for the newest overrun, counting back
+     * @param   overrun     pointer to a callback_overrun_t to fill
+     *
+     * @return  true if success, false if n is out of range
+     */
+    bool callback_get_overrun( uint32_t n, callback_overrun_t *overrun );
+    /**
+     * @brief   create a lv_task whose runs are timed like callback functions. each id gets an
+     * entry with its own histogram in the "lv task" callback table, an overrun lands in the
+     * overrun ring with the id. a task deleted and created again with the same id keeps its entry
+     *
+     * @param   task_cb         lv_task function
+     * @param   period          period in ms
+     * @param   prio            LV_TASK_PRIO_LOWEST ...
+     * @param   id              pointer to an string thats contains the id aka name for the task
+     *
+     * @return  pointer to the lv_task, its user_data belongs to the timing
+     */
+    lv_task_t *callback_lv_task_create( lv_task_cb_t task_cb, uint32_t period, lv_task_prio_t prio, const char *id );
 
 #endif // _CALLBACK_H
\ No newline at end of file
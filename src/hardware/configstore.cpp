@@ -0,0 +1,321 @@
+/****************************************************************************
+ *   Copyright  2020  Jesper Ortlund
+ ****************************************************************************/
+/*
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+#include "config.h"
+#include <TTGO.h>
+#include <SPIFFS.h>
+#include <rom/crc.h>
+
+#include "configstore.h"
+#include "configstore_image.h"
+#include "powermgm.h"
+#include "alloc.h"
+
+/**
+ * file layout: configstore_header_t, followed by section_num times
+ * configstore_section_header_t + section data. the crc covers everything
+ * behind the header.
+ */
+typedef struct {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t section_num;
+    uint32_t payload_size;
+    uint32_t crc;
+} configstore_header_t;
+
+typedef struct {
+    void *data = NULL;                          /** @brief registered config in memory */
+    size_t size = 0;                            /** @brief size of the registered config */
+    uint8_t *image = NULL;                      /** @brief section data from the boot image */
+    size_t image_size = 0;                      /** @brief size of the section in the boot image */
+    CONFIGSTORE_JSON_FUNC json_read = NULL;
+    CONFIGSTORE_JSON_FUNC json_save = NULL;
+} configstore_section_t;
+
+static configstore_section_t configstore_section[ CONFIGSTORE_SECTION_NUM ];
+static uint8_t *configstore_image = NULL;
+static bool configstore_dirty = false;
+
+portMUX_TYPE DRAM_ATTR configstoreMux = portMUX_INITIALIZER_UNLOCKED;
+SemaphoreHandle_t configstore_write_mutex = NULL;
+TaskHandle_t _configstore_Task = NULL;
+
+bool configstore_load_image( const char *filename );
+void configstore_write_image( void );
+void configstore_Task( void * pvParameters );
+bool configstore_powermgm_event_cb( EventBits_t event, void *arg );
+
+void configstore_setup( void ) {
+    if ( configstore_write_mutex != NULL )
+        return;
+
+    configstore_write_mutex = xSemaphoreCreateMutex();
+
+    uint64_t start = esp_timer_get_time();
+    /*
+     * an interrupted write leaves a valid tmp file and no config file behind
+     */
+    if ( !configstore_load_image( CONFIGSTORE_FILE ) ) {
+        if ( configstore_load_image( CONFIGSTORE_TMP_FILE ) ) {
+            log_w("recovered config from %s", CONFIGSTORE_TMP_FILE );
+            SPIFFS.rename( CONFIGSTORE_TMP_FILE, CONFIGSTORE_FILE );
+        }
+        else {
+            log_i("no binary config, import from json");
+        }
+    }
+    log_i("config store read in %lluus", esp_timer_get_time() - start );
+
+    xTaskCreatePinnedToCore(  configstore_Task,     /* Function to implement the task */
+                              "configstore Task",   /* Name of the task */
+                              3000,                 /* Stack size in words */
+                              NULL,                 /* Task input parameter */
+                              1,                    /* Priority of the task */
+                              &_configstore_Task,   /* Task handle. */
+                              0 );
+
+    powermgm_register_cb( POWERMGM_STANDBY, configstore_powermgm_event_cb, "configstore" );
+}
+
+bool configstore_load_image( const char *filename ) {
+    configstore_header_t header;
+
+    if ( !SPIFFS.exists( filename ) )
+        return( false );
+
+    fs::File file = SPIFFS.open( filename, FILE_READ );
+    if ( !file ) {
+        log_e("Can't open file: %s!", filename );
+        return( false );
+    }
+
+    if ( file.read( (uint8_t*)&header, sizeof( header ) ) != sizeof( header ) || header.magic != CONFIGSTORE_MAGIC ) {
+        log_e("%s: bad header", filename );
+        file.close();
+        return( false );
+    }
+
+    if ( header.version != CONFIGSTORE_VERSION ) {
+        log_w("%s: version %d, expected %d", filename, header.version, CONFIGSTORE_VERSION );
+        file.close();
+        return( false );
+    }
+
+    uint8_t *image = (uint8_t*)MALLOC( header.payload_size );
+    if ( image == NULL ) {
+        log_e("config image alloc failed");
+        while(true);
+    }
+
+    if ( file.read( image, header.payload_size ) != header.payload_size ) {
+        log_e("%s: truncated", filename );
+        file.close();
+        free( image );
+        return( false );
+    }
+    file.close();
+
+    if ( crc32_le( 0, image, header.payload_size ) != header.crc ) {
+        log_e("%s: crc mismatch", filename );
+        free( image );
+        return( false );
+    }
+
+    /*
+     * walk the sections and point into the image
+     */
+    configstore_image_section_t sections[ CONFIGSTORE_SECTION_NUM ];
+    configstore_image_parse( image, header.payload_size, header.section_num, sections, CONFIGSTORE_SECTION_NUM );
+    for ( int i = 0 ; i < CONFIGSTORE_SECTION_NUM ; i++ ) {
+        configstore_section[ i ].image = (uint8_t*)sections[ i ].data;
+        configstore_section[ i ].image_size = sections[ i ].size;
+    }
+
+    if ( configstore_image )
+        free( configstore_image );
+    configstore_image = image;
+
+    return( true );
+}
+
+bool configstore_register( int section, void *data, size_t size, CONFIGSTORE_JSON_FUNC json_read, CONFIGSTORE_JSON_FUNC json_save ) {
+    if ( section >= CONFIGSTORE_SECTION_NUM ) {
+        log_e("unknown config section %d", section );
+        return( false );
+    }
+
+    configstore_section[ section ].data = data;
+    configstore_section[ section ].size = size;
+    configstore_section[ section ].json_read = json_read;
+    configstore_section[ section ].json_save = json_save;
+
+    if ( configstore_section[ section ].image == NULL )
+        return( false );
+
+    /*
+     * a size mismatch means the struct grew or shrank, keep the stored prefix and the
+     * defaults for a new tail, then write the section back in its new size
+     */
+    configstore_image_load( data, size, configstore_section[ section ].image, configstore_section[ section ].image_size );
+    if ( configstore_section[ section ].image_size != size ) {
+        log_w("config section %d size changed (%d -> %d)", section, configstore_section[ section ].image_size, size );
+        configstore_save( section );
+    }
+    return( true );
+}
+
+void configstore_save( int section ) {
+    if ( section >= CONFIGSTORE_SECTION_NUM || configstore_section[ section ].data == NULL )
+        return;
+
+    portENTER_CRITICAL( &configstoreMux );
+    configstore_dirty = true;
+    portEXIT_CRITICAL( &configstoreMux );
+
+    if ( _configstore_Task )
+        xTaskNotifyGive( _configstore_Task );
+}
+
+void configstore_flush( void ) {
+    portENTER_CRITICAL( &configstoreMux );
+    bool dirty = configstore_dirty;
+    portEXIT_CRITICAL( &configstoreMux );
+
+    if ( dirty )
+        configstore_write_image();
+}
+
+void configstore_write_image( void ) {
+    configstore_header_t header;
+
+    if ( configstore_write_mutex == NULL )
+        return;
+
+    xSemaphoreTake( configstore_write_mutex, portMAX_DELAY );
+
+    /*
+     * registered sections come from memory, unregistered ones are kept from the boot image
+     */
+    size_t payload_size = 0;
+    for ( int i = 0 ; i < CONFIGSTORE_SECTION_NUM ; i++ ) {
+        if ( configstore_section[ i ].data )
+            payload_size += sizeof( configstore_section_header_t ) + configstore_section[ i ].size;
+        else if ( configstore_section[ i ].image )
+            payload_size += sizeof( configstore_section_header_t ) + configstore_section[ i ].image_size;
+    }
+
+    uint8_t *payload = (uint8_t*)MALLOC( payload_size );
+    if ( payload == NULL ) {
+        log_e("config payload alloc failed");
+        xSemaphoreGive( configstore_write_mutex );
+        return;
+    }
+
+    header.magic = CONFIGSTORE_MAGIC;
+    header.version = CONFIGSTORE_VERSION;
+    header.section_num = 0;
+    header.payload_size = payload_size;
+
+    size_t pos = 0;
+    portENTER_CRITICAL( &configstoreMux );
+    for ( int i = 0 ; i < CONFIGSTORE_SECTION_NUM ; i++ ) {
+        const void *data;
+        uint16_t size;
+
+        if ( configstore_section[ i ].data ) {
+            data = configstore_section[ i ].data;
+            size = configstore_section[ i ].size;
+        }
+        else if ( configstore_section[ i ].image ) {
+            data = configstore_section[ i ].image;
+            size = configstore_section[ i ].image_size;
+        }
+        else {
+            continue;
+        }
+        pos = configstore_image_put( payload, pos, i, data, size );
+        header.section_num++;
+    }
+    configstore_dirty = false;
+    portEXIT_CRITICAL( &configstoreMux );
+
+    header.crc = crc32_le( 0, payload, payload_size );
+
+    /*
+     * write to a tmp file first, a power loss during write never leaves a torn config behind
+     */
+    fs::File file = SPIFFS.open( CONFIGSTORE_TMP_FILE, FILE_WRITE );
+    if ( !file ) {
+        log_e("Can't open file: %s!", CONFIGSTORE_TMP_FILE );
+    }
+    else {
+        bool written = file.write( (uint8_t*)&header, sizeof( header ) ) == sizeof( header ) && file.write( payload, payload_size ) == payload_size;
+        file.close();
+        if ( written ) {
+            SPIFFS.remove( CONFIGSTORE_FILE );
+            if ( !SPIFFS.rename( CONFIGSTORE_TMP_FILE, CONFIGSTORE_FILE ) ) {
+                log_e("rename %s failed", CONFIGSTORE_TMP_FILE );
+            }
+            log_i("config store written, %d sections, %d bytes", header.section_num, payload_size );
+        }
+        else {
+            log_e("Failed to write config file");
+            SPIFFS.remove( CONFIGSTORE_TMP_FILE );
+        }
+    }
+    free( payload );
+
+    xSemaphoreGive( configstore_write_mutex );
+}
+
+void configstore_export_json( void ) {
+    for ( int i = 0 ; i < CONFIGSTORE_SECTION_NUM ; i++ ) {
+        if ( configstore_section[ i ].json_save )
+            configstore_section[ i ].json_save();
+    }
+}
+
+void configstore_import_json( void ) {
+    for ( int i = 0 ; i < CONFIGSTORE_SECTION_NUM ; i++ ) {
+        if ( configstore_section[ i ].json_read ) {
+            configstore_section[ i ].json_read();
+            configstore_save( i );
+        }
+    }
+}
+
+bool configstore_powermgm_event_cb( EventBits_t event, void *arg ) {
+    switch( event ) {
+        case POWERMGM_STANDBY:          configstore_flush();
+                                        break;
+    }
+    return( true );
+}
+
+void configstore_Task( void * pvParameters ) {
+    log_i("start config store task, heap: %d", ESP.getFreeHeap() );
+    while( true ) {
+        ulTaskNotifyTake( pdTRUE, portMAX_DELAY );
+        /*
+         * coalesce changes until the config has been quiet for CONFIGSTORE_WRITE_DELAY ms
+         */
+        while( ulTaskNotifyTake( pdTRUE, pdMS_TO_TICKS( CONFIGSTORE_WRITE_DELAY ) ) );
+        configstore_flush();
+    }
+}
@@ -0,0 +1,90 @@
+/****************************************************************************
+ *   Copyright  2020  Jesper Ortlund
+ ****************************************************************************/
+/*
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+#ifndef _CONFIGSTORE_H
+    #define _CONFIGSTORE_H
+
+    #include <stdint.h>
+    #include <stddef.h>
+
+    #define CONFIGSTORE_FILE            "/config.bin"       /** @brief defines binary config file name */
+    #define CONFIGSTORE_TMP_FILE        "/config.tmp"       /** @brief temporary file used for atomic writes */
+    #define CONFIGSTORE_MAGIC           0x47464345          /** @brief "ECFG" */
+    #define CONFIGSTORE_VERSION         1                   /** @brief binary layout version, bump on incompatible header changes */
+    #define CONFIGSTORE_WRITE_DELAY     2000                /** @brief ms without further changes before the writer persists */
+
+    /**
+     * @brief config sections inside the binary store, never reorder, only append
+     */
+    enum {
+        CONFIGSTORE_DASHBOARD,
+        CONFIGSTORE_DISPLAY,
+        CONFIGSTORE_BLECTL,
+        CONFIGSTORE_WIFICTL,
+        CONFIGSTORE_NETWORKLIST,
+        CONFIGSTORE_BMA,
+        CONFIGSTORE_PMU,
+        CONFIGSTORE_MOTOR,
+        CONFIGSTORE_TIMESYNC,
+        CONFIGSTORE_RTCCTL,
+        CONFIGSTORE_MQTTCTL,
+        CONFIGSTORE_ALARMCTL,
+        CONFIGSTORE_SECTION_NUM
+    };
+
+    typedef void ( * CONFIGSTORE_JSON_FUNC ) ( void );
+
+    /**
+     * @brief read the binary config store from SPIFFS once, call right after SPIFFS.begin()
+     * and before any subsystem reads its config
+     */
+    void configstore_setup( void );
+    /**
+     * @brief register a subsystem config section. if the boot image holds the section,
+     * it is copied into data. a section stored in an older size only fills the prefix,
+     * the rest of data keeps its defaults
+     *
+     * @param   section     section id, CONFIGSTORE_DASHBOARD ... CONFIGSTORE_ALARMCTL
+     * @param   data        pointer to the subsystem config in memory, must stay valid
+     * @param   size        size of the config in bytes
+     * @param   json_read   function to import the legacy json config, can be NULL
+     * @param   json_save   function to export the legacy json config, can be NULL
+     *
+     * @return  true if data was loaded from the binary store, false if the caller has to import/default it
+     */
+    bool configstore_register( int section, void *data, size_t size, CONFIGSTORE_JSON_FUNC json_read, CONFIGSTORE_JSON_FUNC json_save );
+    /**
+     * @brief mark a section as changed, the background writer persists it after CONFIGSTORE_WRITE_DELAY ms
+     *
+     * @param   section     section id
+     */
+    void configstore_save( int section );
+    /**
+     * @brief write pending changes immediately, call before reboot
+     */
+    void configstore_flush( void );
+    /**
+     * @brief write all registered sections out as the legacy json files
+     */
+    void configstore_export_json( void );
+    /**
+     * @brief read all registered sections from the legacy json files and persist them
+     */
+    void configstore_import_json( void );
+
+#endif // _CONFIGSTORE_H
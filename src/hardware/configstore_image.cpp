@@ -0,0 +1,67 @@
+/****************************************************************************
+ *   Copyright  2020  Jesper Ortlund
+ ****************************************************************************/
+/*
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+#include <string.h>
+
+#include "configstore_image.h"
+
+int configstore_image_parse( const uint8_t *payload, size_t payload_size, int section_num, configstore_image_section_t *sections, int max_sections ) {
+    size_t pos = 0;
+    int found = 0;
+
+    for ( int i = 0 ; i < max_sections ; i++ ) {
+        sections[ i ].data = NULL;
+        sections[ i ].size = 0;
+    }
+
+    for ( int i = 0 ; i < section_num ; i++ ) {
+        configstore_section_header_t section_header;
+
+        if ( pos + sizeof( section_header ) > payload_size )
+            break;
+        memcpy( &section_header, &payload[ pos ], sizeof( section_header ) );
+        pos += sizeof( section_header );
+        if ( pos + section_header.size > payload_size )
+            break;
+        if ( section_header.id < max_sections ) {
+            sections[ section_header.id ].data = &payload[ pos ];
+            sections[ section_header.id ].size = section_header.size;
+            found++;
+        }
+        pos += section_header.size;
+    }
+    return( found );
+}
+
+size_t configstore_image_put( uint8_t *payload, size_t pos, uint16_t id, const void *data, uint16_t size ) {
+    configstore_section_header_t section_header;
+
+    section_header.id = id;
+    section_header.size = size;
+    memcpy( &payload[ pos ], &section_header, sizeof( section_header ) );
+    pos += sizeof( section_header );
+    memcpy( &payload[ pos ], data, size );
+    return( pos + size );
+}
+
+size_t configstore_image_load( void *data, size_t size, const uint8_t *image, size_t image_size ) {
+    size_t copy = image_size < size ? image_size : size;
+
+    memcpy( data, image, copy );
+    return( copy );
+}
@@ -0,0 +1,81 @@
+/****************************************************************************
+ *   Copyright  2020  Jesper Ortlund
+ ****************************************************************************/
+/*
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+#ifndef _CONFIGSTORE_IMAGE_H
+    #define _CONFIGSTORE_IMAGE_H
+
+    /*
+     * no arduino or spiffs in here, the section layout builds and runs on the host
+     */
+    #include <stdint.h>
+    #include <stddef.h>
+
+    /**
+     * @brief section header in front of each section inside the payload
+     */
+    typedef struct {
+        uint16_t id;
+        uint16_t size;
+    } configstore_section_header_t;
+
+    /**
+     * @brief section found in a payload
+     */
+    typedef struct {
+        const uint8_t *data;                        /** @brief section data inside the payload, NULL if not present */
+        size_t size;                                /** @brief size of the section data */
+    } configstore_image_section_t;
+
+    /**
+     * @brief walk the sections of a payload, a truncated section ends the walk
+     *
+     * @param   payload         pointer to the payload behind the file header
+     * @param   payload_size    size of the payload
+     * @param   section_num     number of sections the file header claims
+     * @param   sections        pointer to max_sections entries, filled by section id
+     * @param   max_sections    sections with an id >= max_sections are skipped
+     *
+     * @return  number of sections found
+     */
+    int configstore_image_parse( const uint8_t *payload, size_t payload_size, int section_num, configstore_image_section_t *sections, int max_sections );
+    /**
+     * @brief append a section to a payload
+     *
+     * @param   payload         pointer to the payload, must hold pos + header + size bytes
+     * @param   pos             write position
+     * @param   id              section id
+     * @param   data            pointer to the section data
+     * @param   size            size of the section data
+     *
+     * @return  write position behind the section
+     */
+    size_t configstore_image_put( uint8_t *payload, size_t pos, uint16_t id, const void *data, uint16_t size );
+    /**
+     * @brief copy a stored section into a config struct. when the struct grew the new
+     * tail keeps what data held before, when it shrank the stored tail is dropped
+     *
+     * @param   data            pointer to the config in memory, holds defaults
+     * @param   size            size of the config
+     * @param   image           pointer to the stored section
+     * @param   image_size      size of the stored section
+     *
+     * @return  number of bytes copied
+     */
+    size_t configstore_image_load( void *data, size_t size, const uint8_t *image, size_t image_size );
+
+#endif // _CONFIGSTORE_IMAGE_H
@@ -0,0 +1,281 @@
+/****************************************************************************
+ *   Copyright  2020  Jesper Ortlund
+ ****************************************************************************/
+/*
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+#include "config.h"
+#include <TTGO.h>
+
+#include "console.h"
+#include "console_cmd.h"
+#include "powermgm.h"
+#include "callback.h"
+#include "metrics.h"
+#include "bootctl.h"
+#include "blectl.h"
+#include "arena.h"
+#include "alarmctl.h"
+#include "configstore.h"
+#include "mqttctl.h"
+
+#include "gui/screenshot.h"
+#include "gui/mainbar/fulldash_tile/fulldash_tile.h"
+#include "gui/mainbar/simpledash_tile/simpledash_tile.h"
+
+static char console_line[ CONSOLE_LINE_LEN ];
+static size_t console_line_len = 0;
+static bool console_line_overflow = false;
+static uint32_t console_load = 0;
+
+bool console_powermgm_loop_cb( EventBits_t event, void *arg );
+static void console_execute( char *line );
+static int console_help( int argc, char **argv );
+static int console_metrics( int argc, char **argv );
+static int console_callbacks( int argc, char **argv );
+static int console_overruns( int argc, char **argv );
+static int console_boot( int argc, char **argv );
+static int console_arenas( int argc, char **argv );
+static int console_alarms( int argc, char **argv );
+static int console_config( int argc, char **argv );
+static int console_mqtt( int argc, char **argv );
+static int console_screenshot( int argc, char **argv );
+static int console_eventlog( int argc, char **argv );
+static int console_refresh( int argc, char **argv );
+static int console_inject( int argc, char **argv );
+static int console_load_cmd( int argc, char **argv );
+
+static const console_cmd_t console_cmd_table[] = {
+    { "help",       "",                     "list commands",                                0,  0,  console_help },
+    { "metrics",    "",                     "dump counters, gauges and latencies",          0,  0,  console_metrics },
+    { "callbacks",  "",                     "dump callback tables with run times",          0,  0,  console_callbacks },
+    { "overruns",   "",                     "dump callbacks that blew the budget",          0,  0,  console_overruns },
+    { "boot",       "",                     "dump boot phases",                             0,  0,  console_boot },
+    { "arenas",     "",                     "dump arenas, pools and heap fragmentation",    0,  0,  console_arenas },
+    { "alarms",     "[reload]",             "dump alarm rules or reload them from json",    0,  1,  console_alarms },
+    { "config",     "import|export",        "read or write the legacy json config files",   1,  1,  console_config },
+    { "mqtt",       "[cmd ...]",            "uplink status or on|off|reload|server|login",  0,  3,  console_mqtt },
+    { "screenshot", "",                     "capture the screen to " SCREENSHOT_FILE,       0,  0,  console_screenshot },
+    { "eventlog",   "on|off",               "event logging to spiffs",                      1,  1,  console_eventlog },
+    { "refresh",    "<ms>",                 "dash gauge update period",                     1,  1,  console_refresh },
+    { "inject",     "<hex> ...",            "feed a raw wheel frame to the decoder",        1,  20, console_inject },
+    { "load",       "<us>|off",             "busy wait each loop to simulate load",         1,  1,  console_load_cmd },
+};
+
+#define CONSOLE_CMD_NUM     ( (int)( sizeof( console_cmd_table ) / sizeof( console_cmd_t ) ) )
+
+void console_setup( void ) {
+    powermgm_register_loop_cb( POWERMGM_STANDBY | POWERMGM_SILENCE_WAKEUP | POWERMGM_WAKEUP, console_powermgm_loop_cb, "console loop" );
+}
+
+bool console_powermgm_loop_cb( EventBits_t event, void *arg ) {
+    /*
+     * take what the uart driver has buffered, never wait for more
+     */
+    while ( Serial.available() ) {
+        char c = Serial.read();
+
+        if ( c == '\r' || c == '\n' ) {
+            if ( console_line_overflow ) {
+                Serial.printf("line too long\r\n");
+            }
+            else if ( console_line_len ) {
+                console_line[ console_line_len ] = '\0';
+                console_execute( console_line );
+            }
+            console_line_len = 0;
+            console_line_overflow = false;
+        }
+        else if ( console_line_len < CONSOLE_LINE_LEN - 1 ) {
+            console_line[ console_line_len++ ] = c;
+        }
+        else {
+            console_line_overflow = true;
+        }
+    }
+
+    if ( console_load ) {
+        delayMicroseconds( console_load );
+    }
+    return( true );
+}
+
+static void console_execute( char *line ) {
+    switch( console_cmd_dispatch( console_cmd_table, CONSOLE_CMD_NUM, line ) ) {
+        case CONSOLE_CMD_UNKNOWN:       Serial.printf("unknown command, try help\r\n");
+                                        break;
+        case CONSOLE_CMD_USAGE:         Serial.printf("usage error, try help\r\n");
+                                        break;
+        case CONSOLE_CMD_FAILED:        Serial.printf("failed\r\n");
+                                        break;
+    }
+}
+
+static int console_help( int argc, char **argv ) {
+    for ( int cmd = 0 ; cmd < CONSOLE_CMD_NUM ; cmd++ ) {
+        Serial.printf("  %-10s %-12s %s\r\n", console_cmd_table[ cmd ].name, console_cmd_table[ cmd ].args, console_cmd_table[ cmd ].help );
+    }
+    return( CONSOLE_CMD_OK );
+}
+
+static int console_metrics( int argc, char **argv ) {
+    metrics_print();
+    return( CONSOLE_CMD_OK );
+}
+
+static int console_callbacks( int argc, char **argv ) {
+    callback_print();
+    return( CONSOLE_CMD_OK );
+}
+
+static int console_overruns( int argc, char **argv ) {
+    Serial.printf("overruns > %dms, newest first:\r\n", CALLBACK_BUDGET_US / 1000 );
+    for ( uint32_t n = 0 ; n < callback_get_overrun_num() ; n++ ) {
+        callback_overrun_t overrun;
+        if ( callback_get_overrun( n, &overrun ) ) {
+            Serial.printf("  %-20s %8uus @ %ums\r\n", overrun.id, overrun.duration, overrun.timestamp );
+        }
+    }
+    return( CONSOLE_CMD_OK );
+}
+
+static int console_boot( int argc, char **argv ) {
+    bootctl_print();
+    return( CONSOLE_CMD_OK );
+}
+
+static int console_arenas( int argc, char **argv ) {
+    arena_print();
+    return( CONSOLE_CMD_OK );
+}
+
+static int console_alarms( int argc, char **argv ) {
+    char text[ 80 ];
+
+    if ( argc == 2 ) {
+        if ( strcmp( argv[ 1 ], "reload" ) )
+            return( CONSOLE_CMD_USAGE );
+        alarmctl_read_json_config();
+        alarmctl_save_config();
+    }
+
+    for ( int n = 0 ; n < alarmctl_get_rule_num() ; n++ ) {
+        alarm_rule_t rule;
+        bool active;
+        if ( alarmctl_get_rule( n, &rule, &active ) ) {
+            alarmctl_describe_rule( &rule, text, sizeof( text ) );
+            Serial.printf("%2d %c %s\r\n", n, active ? '*' : ' ', text );
+        }
+    }
+    return( CONSOLE_CMD_OK );
+}
+
+static int console_config( int argc, char **argv ) {
+    if ( !strcmp( argv[ 1 ], "import" ) )
+        configstore_import_json();
+    else if ( !strcmp( argv[ 1 ], "export" ) )
+        configstore_export_json();
+    else
+        return( CONSOLE_CMD_USAGE );
+    Serial.printf("config %s done\r\n", argv[ 1 ] );
+    return( CONSOLE_CMD_OK );
+}
+
+static int console_mqtt( int argc, char **argv ) {
+    mqttctl_config_t config;
+    mqttctl_stats_t stats;
+    uint32_t port = 1883;
+
+    if ( argc == 2 && !strcmp( argv[ 1 ], "on" ) )
+        mqttctl_set_enable( true );
+    else if ( argc == 2 && !strcmp( argv[ 1 ], "off" ) )
+        mqttctl_set_enable( false );
+    else if ( argc == 2 && !strcmp( argv[ 1 ], "reload" ) ) {
+        mqttctl_read_json_config();
+        mqttctl_save_config();
+    }
+    else if ( argc >= 3 && !strcmp( argv[ 1 ], "server" ) ) {
+        if ( argc == 4 && ( !console_cmd_parse_uint( argv[ 3 ], &port ) || port == 0 || port > UINT16_MAX ) )
+            return( CONSOLE_CMD_USAGE );
+        mqttctl_set_server( argv[ 2 ], port );
+    }
+    else if ( argc >= 3 && !strcmp( argv[ 1 ], "login" ) )
+        mqttctl_set_login( argv[ 2 ], argc == 4 ? argv[ 3 ] : "" );
+    else if ( argc != 1 )
+        return( CONSOLE_CMD_USAGE );
+
+    mqttctl_get_config( &config );
+    mqttctl_get_stats( &stats );
+    Serial.printf("uplink %s, %s:%u, user \"%s\", topic %s, every %us\r\n", config.enable ? "on" : "off", config.server, config.port, config.user, config.topic, config.interval );
+    Serial.printf("%s, %u queued, %u dropped, %u messages, %u bytes\r\n", stats.connected ? "connected" : "not connected", stats.queued, stats.dropped, stats.messages, stats.bytes );
+    return( CONSOLE_CMD_OK );
+}
+
+static int console_screenshot( int argc, char **argv ) {
+    if ( !screenshot_take() )
+        return( CONSOLE_CMD_FAILED );
+    return( CONSOLE_CMD_OK );
+}
+
+static int console_eventlog( int argc, char **argv ) {
+    if ( !strcmp( argv[ 1 ], "on" ) )
+        display_event_logging_enable( true );
+    else if ( !strcmp( argv[ 1 ], "off" ) )
+        display_event_logging_enable( false );
+    else
+        return( CONSOLE_CMD_USAGE );
+    return( CONSOLE_CMD_OK );
+}
+
+static int console_refresh( int argc, char **argv ) {
+    uint32_t ms;
+
+    if ( !console_cmd_parse_uint( argv[ 1 ], &ms ) || ms == 0 )
+        return( CONSOLE_CMD_USAGE );
+    fulldash_set_refresh( ms );
+    simpledash_set_refresh( ms );
+    Serial.printf("dash refresh %ums\r\n", ms );
+    return( CONSOLE_CMD_OK );
+}
+
+static int console_inject( int argc, char **argv ) {
+    uint8_t frame[ 20 ];
+    size_t len = 0;
+
+    /*
+     * "aa55..." in one word or split up in as many words as you like
+     */
+    for ( int arg = 1 ; arg < argc ; arg++ ) {
+        int n = console_cmd_parse_hex( argv[ arg ], &frame[ len ], sizeof( frame ) - len );
+        if ( n < 0 )
+            return( CONSOLE_CMD_USAGE );
+        len += n;
+    }
+    blectl_inject_frame( frame, len );
+    Serial.printf("injected %u bytes\r\n", len );
+    return( CONSOLE_CMD_OK );
+}
+
+static int console_load_cmd( int argc, char **argv ) {
+    uint32_t us;
+
+    if ( !strcmp( argv[ 1 ], "off" ) )
+        us = 0;
+    else if ( !console_cmd_parse_uint( argv[ 1 ], &us ) || us > CONSOLE_MAX_LOAD )
+        return( CONSOLE_CMD_USAGE );
+    console_load = us;
+    Serial.printf("synthetic load %uus per loop\r\n", console_load );
+    return( CONSOLE_CMD_OK );
+}
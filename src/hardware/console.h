@@ -0,0 +1,33 @@
+/****************************************************************************
+ *   Copyright  2020  Jesper Ortlund
+ ****************************************************************************/
+/*
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+#ifndef _CONSOLE_H
+    #define _CONSOLE_H
+
+    #include <TTGO.h>
+
+    #define CONSOLE_LINE_LEN            128         /** @brief max line length, longer lines are dropped */
+    #define CONSOLE_MAX_LOAD            100000      /** @brief max synthetic load per loop in us */
+
+    /**
+     * @brief setup the serial command console, lines are read from the uart rx
+     * buffer in the powermgm loop without blocking, type "help" for the commands
+     */
+    void console_setup( void );
+
+#endif // _CONSOLE_H
@@ -0,0 +1,117 @@
+/****************************************************************************
+ *   Copyright  2020  Jesper Ortlund
+ ****************************************************************************/
+/*
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+#include <string.h>
+
+#include "console_cmd.h"
+
+static bool console_cmd_is_space( char c );
+static int console_cmd_hex_digit( char c );
+
+int console_cmd_split( char *line, char **argv, int max_args ) {
+    int argc = 0;
+
+    while ( *line ) {
+        while ( console_cmd_is_space( *line ) ) {
+            *line++ = '\0';
+        }
+        if ( *line == '\0' )
+            break;
+        if ( argc == max_args )
+            return( -1 );
+        argv[ argc++ ] = line;
+        while ( *line && !console_cmd_is_space( *line ) ) {
+            line++;
+        }
+    }
+    return( argc );
+}
+
+int console_cmd_dispatch( const console_cmd_t *table, int entries, char *line ) {
+    char *argv[ CONSOLE_CMD_MAX_ARGS ];
+    int argc = console_cmd_split( line, argv, CONSOLE_CMD_MAX_ARGS );
+
+    if ( argc < 0 )
+        return( CONSOLE_CMD_USAGE );
+    if ( argc == 0 )
+        return( CONSOLE_CMD_EMPTY );
+
+    for ( int entry = 0 ; entry < entries ; entry++ ) {
+        if ( strcmp( table[ entry ].name, argv[ 0 ] ) )
+            continue;
+        if ( argc - 1 < table[ entry ].min_args || argc - 1 > table[ entry ].max_args )
+            return( CONSOLE_CMD_USAGE );
+        return( table[ entry ].func( argc, argv ) );
+    }
+    return( CONSOLE_CMD_UNKNOWN );
+}
+
+bool console_cmd_parse_uint( const char *text, uint32_t *value ) {
+    uint32_t base = 10;
+    uint64_t result = 0;
+
+    if ( text[ 0 ] == '0' && ( text[ 1 ] == 'x' || text[ 1 ] == 'X' ) ) {
+        base = 16;
+        text += 2;
+    }
+    if ( *text == '\0' )
+        return( false );
+
+    for ( ; *text ; text++ ) {
+        int digit = console_cmd_hex_digit( *text );
+        if ( digit < 0 || (uint32_t)digit >= base )
+            return( false );
+        result = result * base + digit;
+        if ( result > UINT32_MAX )
+            return( false );
+    }
+    *value = (uint32_t)result;
+    return( true );
+}
+
+int console_cmd_parse_hex( const char *text, uint8_t *data, size_t size ) {
+    size_t len = 0;
+
+    while ( *text ) {
+        if ( *text == ':' || *text == '-' ) {
+            text++;
+            continue;
+        }
+        int high = console_cmd_hex_digit( text[ 0 ] );
+        int low = high < 0 ? -1 : console_cmd_hex_digit( text[ 1 ] );
+        if ( low < 0 || len == size )
+            return( -1 );
+        data[ len++ ] = ( high << 4 ) | low;
+        text += 2;
+    }
+    return( (int)len );
+}
+
+static bool console_cmd_is_space( char c ) {
+    return( c == ' ' || c == '\t' || c == '\r' || c == '\n' );
+}
+
+static int console_cmd_hex_digit( char c ) {
+    if ( c >= '0' && c <= '9' )
+        return( c - '0' );
+    if ( c >= 'a' && c <= 'f' )
+        return( c - 'a' + 10 );
+    if ( c >= 'A' && c <= 'F' )
+        return( c - 'A' + 10 );
+    return( -1 );
+}
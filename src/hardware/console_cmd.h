@@ -0,0 +1,98 @@
+/****************************************************************************
+ *   Copyright  2020  Jesper Ortlund
+ ****************************************************************************/
+/*
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+#ifndef _CONSOLE_CMD_H
+    #define _CONSOLE_CMD_H
+
+    /*
+     * no arduino or freertos in here, the parser builds and runs on the host
+     */
+    #include <stdint.h>
+    #include <stddef.h>
+
+    #define CONSOLE_CMD_MAX_ARGS        24          /** @brief max words per line, command included, a raw frame is 20 bytes */
+
+    #define CONSOLE_CMD_OK              0           /** @brief command ran */
+    #define CONSOLE_CMD_EMPTY           1           /** @brief blank line, nothing to do */
+    #define CONSOLE_CMD_UNKNOWN         2           /** @brief no such command */
+    #define CONSOLE_CMD_USAGE           3           /** @brief wrong number or form of arguments */
+    #define CONSOLE_CMD_FAILED          4           /** @brief command ran but failed */
+
+    /**
+     * @brief typedef for a console command
+     *
+     * @param argc      number of words, argv[0] is the command
+     * @param argv      words of the line
+     *
+     * @return          CONSOLE_CMD_OK, CONSOLE_CMD_USAGE or CONSOLE_CMD_FAILED
+     */
+    typedef int ( * CONSOLE_CMD_FUNC ) ( int argc, char **argv );
+
+    /**
+     * @brief console command table entry
+     */
+    typedef struct {
+        const char *name;                           /** @brief command word */
+        const char *args;                           /** @brief argument synopsis for help */
+        const char *help;                           /** @brief one line description */
+        int min_args;                               /** @brief min arguments after the command word */
+        int max_args;                               /** @brief max arguments after the command word */
+        CONSOLE_CMD_FUNC func;                      /** @brief pointer to the command function */
+    } console_cmd_t;
+
+    /**
+     * @brief split a line in place into whitespace separated words
+     *
+     * @param   line        null terminated line, gets modified
+     * @param   argv        pointer to max_args word pointers
+     * @param   max_args    size of argv
+     *
+     * @return  number of words, -1 if the line has more than max_args words
+     */
+    int console_cmd_split( char *line, char **argv, int max_args );
+    /**
+     * @brief split a line and call the matching command
+     *
+     * @param   table       pointer to the command table
+     * @param   entries     number of commands in the table
+     * @param   line        null terminated line, gets modified
+     *
+     * @return  CONSOLE_CMD_OK ... CONSOLE_CMD_FAILED
+     */
+    int console_cmd_dispatch( const console_cmd_t *table, int entries, char *line );
+    /**
+     * @brief parse a decimal or 0x prefixed hex number
+     *
+     * @param   text        word to parse
+     * @param   value       pointer to the result
+     *
+     * @return  true if the whole word is a number, false if not
+     */
+    bool console_cmd_parse_uint( const char *text, uint32_t *value );
+    /**
+     * @brief parse hex bytes, "aa55" and "aa:55" both give two bytes
+     *
+     * @param   text        word to parse
+     * @param   data        pointer to the output buffer
+     * @param   size        size of the output buffer
+     *
+     * @return  number of bytes, -1 on a bad digit, an odd digit count or a full buffer
+     */
+    int console_cmd_parse_hex( const char *text, uint8_t *data, size_t size );
+
+#endif // _CONSOLE_CMD_H
@@ -25,6 +25,7 @@
 #include "gui/gui.h"
 #include "gui/mainbar/simpledash_tile/simpledash_tile.h"
 
+#include "configstore.h"
 #include "json_psram_allocator.h"
 
 callback_t *dashboard_callback = NULL;
@@ -36,6 +37,17 @@ void dashboard_setup( void ) {
 }
 
 void dashboard_save_config( void ) {
+    configstore_save( CONFIGSTORE_DASHBOARD );
+}
+
+void dashboard_read_config( void ) {
+    if ( !configstore_register( CONFIGSTORE_DASHBOARD, dashboard_config, sizeof( dashboard_config ), dashboard_read_json_config, dashboard_save_json_config ) ) {
+        dashboard_read_json_config();
+        dashboard_save_config();
+    }
+}
+
+void dashboard_save_json_config( void ) {
     fs::File file = SPIFFS.open( DASHBOARD_JSON_CONFIG_FILE, FILE_WRITE );
 
     if (!file) {
@@ -44,12 +56,7 @@ void dashboard_save_config( void ) {
     else {
         SpiRamJsonDocument doc( 1000 );
 
-        doc["lights"] = dashboard_config[ DASHBOARD_LIGHTS ].enable;
-        doc["bars"] = dashboard_config[ DASHBOARD_BARS ].enable;
-        doc["current"] = dashboard_config[ DASHBOARD_CURRENT ].enable;
-        doc["simple"] = dashboard_config[ DASHBOARD_SIMPLE ].enable;
-        doc["impdist"] = dashboard_config[ DASHBOARD_IMPDIST ].enable;
-        doc["imptemp"] = dashboard_config[ DASHBOARD_IMPTEMP ].enable;
+        dashboard_config_to_json( dashboard_config, doc.to<JsonObject>() );
 
         if ( serializeJsonPretty( doc, file ) == 0) {
             log_e("Failed to write config file");
@@ -59,7 +66,7 @@ void dashboard_save_config( void ) {
     file.close();
 }
 
-void dashboard_read_config( void ) {
+void dashboard_read_json_config( void ) {
     fs::File file = SPIFFS.open( DASHBOARD_JSON_CONFIG_FILE, FILE_READ );
     if (!file) {
         log_e("Can't open file: %s!", DASHBOARD_JSON_CONFIG_FILE );
@@ -73,12 +80,7 @@ void dashboard_read_config( void ) {
             log_e("update check deserializeJson() failed: %s", error.c_str() );
         }
         else {
-            dashboard_config[ DASHBOARD_LIGHTS ].enable = doc["lights"] | true;
-            dashboard_config[ DASHBOARD_BARS ].enable = doc["bars"] | true;
-            dashboard_config[ DASHBOARD_CURRENT ].enable = doc["current"] | false;
-            dashboard_config[ DASHBOARD_SIMPLE ].enable = doc["simple"] | false;
-            dashboard_config[ DASHBOARD_IMPDIST ].enable = doc["impdist"] | false;
-            dashboard_config[ DASHBOARD_IMPTEMP ].enable = doc["imptemp"] | false;
+            dashboard_config_from_json( dashboard_config, doc.as<JsonObjectConst>() );
         }        
         doc.clear();
     }
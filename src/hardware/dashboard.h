@@ -21,29 +21,13 @@
     #define _DASHBOARD_H
 
     #include "callback.h"
+    #include "dashboard_config.h"
 
     #define DASHBOARD_JSON_CONFIG_FILE    "/dashboard.json" /** @brief defines json config file name */
 
     #define DASHCTL_BARS       _BV(0)          /** @brief event mask dashboard bar display, callback arg is (uint32_t*) */
     #define DASHCTL_CURRENT    _BV(1)          /** @brief event mask dashboard current display, callback arg is (uint32_t*) */
 
-    /**
-     * @brief dashboard config structure
-     */
-    typedef struct {
-        bool enable=true;
-    } dashboard_config_t;
-
-    enum { 
-        DASHBOARD_LIGHTS,
-        DASHBOARD_BARS,
-        DASHBOARD_CURRENT,
-        DASHBOARD_SIMPLE,
-        DASHBOARD_IMPDIST,
-        DASHBOARD_IMPTEMP,
-        DASHBOARD_CONFIG_NUM
-    };
-
     /*
      * @brief display config structure
      */
@@ -75,6 +59,14 @@
      * @brief read config for dashboard from spiffs
      */
     void dashboard_read_config( void );
+    /**
+     * @brief write the config as legacy json file to spiffs
+     */
+    void dashboard_save_json_config( void );
+    /**
+     * @brief import the config from the legacy json file on spiffs
+     */
+    void dashboard_read_json_config( void );
     /**
      * @brief read the config for a specific dashboard setting
      * 
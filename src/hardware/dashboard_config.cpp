@@ -0,0 +1,37 @@
+/****************************************************************************
+ *   Copyright  2020  Jesper Ortlund
+ ****************************************************************************/
+/*
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+#include "dashboard_config.h"
+
+void dashboard_config_from_json( dashboard_config_t *config, JsonObjectConst json ) {
+    config[ DASHBOARD_LIGHTS ].enable = json["lights"] | true;
+    config[ DASHBOARD_BARS ].enable = json["bars"] | true;
+    config[ DASHBOARD_CURRENT ].enable = json["current"] | false;
+    config[ DASHBOARD_SIMPLE ].enable = json["simple"] | false;
+    config[ DASHBOARD_IMPDIST ].enable = json["impdist"] | false;
+    config[ DASHBOARD_IMPTEMP ].enable = json["imptemp"] | false;
+}
+
+void dashboard_config_to_json( const dashboard_config_t *config, JsonObject json ) {
+    json["lights"] = config[ DASHBOARD_LIGHTS ].enable;
+    json["bars"] = config[ DASHBOARD_BARS ].enable;
+    json["current"] = config[ DASHBOARD_CURRENT ].enable;
+    json["simple"] = config[ DASHBOARD_SIMPLE ].enable;
+    json["impdist"] = config[ DASHBOARD_IMPDIST ].enable;
+    json["imptemp"] = config[ DASHBOARD_IMPTEMP ].enable;
+}
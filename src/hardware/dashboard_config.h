@@ -0,0 +1,61 @@
+/****************************************************************************
+ *   Copyright  2020  Jesper Ortlund
+ ****************************************************************************/
+/*
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+#ifndef _DASHBOARD_CONFIG_H
+    #define _DASHBOARD_CONFIG_H
+
+    /*
+     * no arduino or spiffs in here, the config and its json mapping build and run on the host
+     */
+    #include <ArduinoJson.h>
+
+
+    /**
+     * @brief dashboard config structure, one per DASHBOARD_* entry. stored as is in the
+     * config store, only append new entries to the enum
+     */
+    typedef struct {
+        bool enable=true;
+    } dashboard_config_t;
+
+    enum { 
+        DASHBOARD_LIGHTS,
+        DASHBOARD_BARS,
+        DASHBOARD_CURRENT,
+        DASHBOARD_SIMPLE,
+        DASHBOARD_IMPDIST,
+        DASHBOARD_IMPTEMP,
+        DASHBOARD_CONFIG_NUM
+    };
+
+    /**
+     * @brief fill the dashboard config from the legacy json, missing keys get their defaults
+     *
+     * @param   config      pointer to DASHBOARD_CONFIG_NUM entries
+     * @param   json        root object of dashboard.json
+     */
+    void dashboard_config_from_json( dashboard_config_t *config, JsonObjectConst json );
+    /**
+     * @brief write the dashboard config as legacy json
+     *
+     * @param   config      pointer to DASHBOARD_CONFIG_NUM entries
+     * @param   json        root object to fill
+     */
+    void dashboard_config_to_json( const dashboard_config_t *config, JsonObject json );
+
+#endif // _DASHBOARD_CONFIG_H
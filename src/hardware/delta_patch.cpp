@@ -0,0 +1,174 @@
+/****************************************************************************
+ *   Copyright  2020  Jesper Ortlund
+ ****************************************************************************/
+/*
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+#include <string.h>
+
+#include "delta_patch.h"
+
+#define DELTA_PATCH_STATE_HEADER    3
+#define DELTA_PATCH_STATE_OP        4
+#define DELTA_PATCH_STATE_ARGS      5
+#define DELTA_PATCH_STATE_DATA      6
+
+static uint32_t delta_patch_get32( const uint8_t *data );
+static int delta_patch_field( delta_patch_t *patch );
+static bool delta_patch_copy( delta_patch_t *patch, uint32_t offset, uint32_t len );
+
+void delta_patch_init( delta_patch_t *patch, DELTA_PATCH_BEGIN_FUNC begin, DELTA_PATCH_READ_FUNC read, DELTA_PATCH_WRITE_FUNC write ) {
+    patch->state = DELTA_PATCH_STATE_HEADER;
+    patch->op = DELTA_PATCH_OP_END;
+    patch->field_len = 0;
+    patch->field_need = DELTA_PATCH_HEADER_SIZE;
+    patch->source_size = 0;
+    patch->target_size = 0;
+    patch->add_left = 0;
+    patch->written = 0;
+    patch->error = NULL;
+    patch->begin = begin;
+    patch->read = read;
+    patch->write = write;
+}
+
+int delta_patch_feed( delta_patch_t *patch, const uint8_t *data, size_t len ) {
+    while ( len > 0 && patch->state != DELTA_PATCH_DONE && patch->state != DELTA_PATCH_ERROR ) {
+        /*
+         * literal bytes go straight from the download buffer to the target
+         */
+        if ( patch->state == DELTA_PATCH_STATE_DATA ) {
+            size_t n = len < patch->add_left ? len : patch->add_left;
+            if ( !patch->write( data, n ) ) {
+                patch->error = "target write failed";
+                patch->state = DELTA_PATCH_ERROR;
+                break;
+            }
+            data += n;
+            len -= n;
+            patch->add_left -= n;
+            patch->written += n;
+            if ( patch->add_left == 0 ) {
+                patch->state = DELTA_PATCH_STATE_OP;
+                patch->field_need = 1;
+            }
+            continue;
+        }
+
+        size_t n = patch->field_need - patch->field_len;
+        if ( n > len )
+            n = len;
+        memcpy( &patch->field[ patch->field_len ], data, n );
+        patch->field_len += n;
+        data += n;
+        len -= n;
+        if ( patch->field_len < patch->field_need )
+            break;
+
+        patch->field_len = 0;
+        patch->state = delta_patch_field( patch );
+    }
+
+    switch( patch->state ) {
+        case DELTA_PATCH_DONE:      return( DELTA_PATCH_DONE );
+        case DELTA_PATCH_ERROR:     return( DELTA_PATCH_ERROR );
+        default:                    return( DELTA_PATCH_MORE );
+    }
+}
+
+/**
+ * @brief handle a complete field and return the next state
+ */
+static int delta_patch_field( delta_patch_t *patch ) {
+    uint32_t len;
+
+    switch( patch->state ) {
+        case DELTA_PATCH_STATE_HEADER:
+            if ( delta_patch_get32( &patch->field[ 0 ] ) != DELTA_PATCH_MAGIC ) {
+                patch->error = "bad patch magic";
+                return( DELTA_PATCH_ERROR );
+            }
+            patch->source_size = delta_patch_get32( &patch->field[ 4 ] );
+            patch->target_size = delta_patch_get32( &patch->field[ 8 ] );
+            if ( patch->begin && !patch->begin( patch->source_size, &patch->field[ 12 ], patch->target_size ) ) {
+                patch->error = "patch rejected for this source";
+                return( DELTA_PATCH_ERROR );
+            }
+            patch->field_need = 1;
+            return( DELTA_PATCH_STATE_OP );
+
+        case DELTA_PATCH_STATE_OP:
+            patch->op = patch->field[ 0 ];
+            switch( patch->op ) {
+                case DELTA_PATCH_OP_END:
+                    if ( patch->written != patch->target_size ) {
+                        patch->error = "patch ended before the target size";
+                        return( DELTA_PATCH_ERROR );
+                    }
+                    return( DELTA_PATCH_DONE );
+                case DELTA_PATCH_OP_COPY:
+                    patch->field_need = 8;
+                    return( DELTA_PATCH_STATE_ARGS );
+                case DELTA_PATCH_OP_ADD:
+                    patch->field_need = 4;
+                    return( DELTA_PATCH_STATE_ARGS );
+            }
+            patch->error = "unknown patch op";
+            return( DELTA_PATCH_ERROR );
+
+        case DELTA_PATCH_STATE_ARGS:
+            len = delta_patch_get32( &patch->field[ patch->op == DELTA_PATCH_OP_COPY ? 4 : 0 ] );
+            if ( len > patch->target_size - patch->written ) {
+                patch->error = "patch op overruns the target";
+                return( DELTA_PATCH_ERROR );
+            }
+            patch->field_need = 1;
+            if ( patch->op == DELTA_PATCH_OP_COPY ) {
+                if ( !delta_patch_copy( patch, delta_patch_get32( &patch->field[ 0 ] ), len ) )
+                    return( DELTA_PATCH_ERROR );
+                return( DELTA_PATCH_STATE_OP );
+            }
+            patch->add_left = len;
+            return( len ? DELTA_PATCH_STATE_DATA : DELTA_PATCH_STATE_OP );
+    }
+    return( DELTA_PATCH_ERROR );
+}
+
+static bool delta_patch_copy( delta_patch_t *patch, uint32_t offset, uint32_t len ) {
+    if ( offset > patch->source_size || len > patch->source_size - offset ) {
+        patch->error = "patch copy outside the source";
+        return( false );
+    }
+
+    while ( len > 0 ) {
+        size_t n = len < DELTA_PATCH_COPY_SIZE ? len : DELTA_PATCH_COPY_SIZE;
+        if ( !patch->read( offset, patch->copy, n ) ) {
+            patch->error = "source read failed";
+            return( false );
+        }
+        if ( !patch->write( patch->copy, n ) ) {
+            patch->error = "target write failed";
+            return( false );
+        }
+        offset += n;
+        len -= n;
+        patch->written += n;
+    }
+    return( true );
+}
+
+static uint32_t delta_patch_get32( const uint8_t *data ) {
+    return( data[ 0 ] | ( data[ 1 ] << 8 ) | ( data[ 2 ] << 16 ) | ( (uint32_t)data[ 3 ] << 24 ) );
+}
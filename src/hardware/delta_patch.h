@@ -0,0 +1,93 @@
+/****************************************************************************
+ *   Copyright  2020  Jesper Ortlund
+ ****************************************************************************/
+/*
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+#ifndef _DELTA_PATCH_H
+    #define _DELTA_PATCH_H
+
+    /*
+     * no arduino in here, the decoder builds and runs on the host
+     */
+    #include <stdint.h>
+    #include <stddef.h>
+
+    #define DELTA_PATCH_MAGIC           0x31504445  /** @brief "EDP1" little endian */
+    #define DELTA_PATCH_HEADER_SIZE     28          /** @brief magic, source size, target size, source md5 */
+    #define DELTA_PATCH_COPY_SIZE       4096        /** @brief bytes read from the source image per step */
+
+    #define DELTA_PATCH_OP_END          0           /** @brief end of patch, no arguments */
+    #define DELTA_PATCH_OP_COPY         1           /** @brief uint32 source offset, uint32 length */
+    #define DELTA_PATCH_OP_ADD          2           /** @brief uint32 length, followed by length literal bytes */
+
+    #define DELTA_PATCH_MORE            0           /** @brief patch needs more data */
+    #define DELTA_PATCH_DONE            1           /** @brief patch complete, target fully written */
+    #define DELTA_PATCH_ERROR           2           /** @brief malformed patch or a callback failed */
+
+    /**
+     * patch layout, all values little endian:
+     *
+     * header:  uint32 magic, uint32 source size, uint32 target size, uint8 source md5[16]
+     * ops:     uint8 op + arguments, repeated until DELTA_PATCH_OP_END
+     *
+     * the target is written strictly in order, so a patch can be applied
+     * while it is still downloading. generate patches with tools/mkdelta.py
+     */
+    typedef bool ( * DELTA_PATCH_BEGIN_FUNC ) ( uint32_t source_size, const uint8_t *source_md5, uint32_t target_size );
+    typedef bool ( * DELTA_PATCH_READ_FUNC ) ( uint32_t offset, uint8_t *data, size_t len );
+    typedef bool ( * DELTA_PATCH_WRITE_FUNC ) ( const uint8_t *data, size_t len );
+
+    /**
+     * @brief patch decoder state, carried over from one fed block to the next
+     */
+    typedef struct {
+        uint8_t state;                              /** @brief field being collected or DELTA_PATCH_DONE/ERROR */
+        uint8_t op;                                 /** @brief current op */
+        uint8_t field[ DELTA_PATCH_HEADER_SIZE ];   /** @brief collected bytes of the current fixed size field */
+        size_t field_len;                           /** @brief bytes in field */
+        size_t field_need;                          /** @brief size of the current field */
+        uint32_t source_size;                       /** @brief source image size from the header */
+        uint32_t target_size;                       /** @brief target image size from the header */
+        uint32_t add_left;                          /** @brief literal bytes left in the current add op */
+        uint32_t written;                           /** @brief target bytes written */
+        const char *error;                          /** @brief why the patch was rejected, NULL if not */
+        DELTA_PATCH_BEGIN_FUNC begin;               /** @brief called once with the header, false rejects the patch */
+        DELTA_PATCH_READ_FUNC read;                 /** @brief reads from the source image */
+        DELTA_PATCH_WRITE_FUNC write;               /** @brief appends to the target image */
+        uint8_t copy[ DELTA_PATCH_COPY_SIZE ];      /** @brief bounce buffer for copy ops */
+    } delta_patch_t;
+
+    /**
+     * @brief setup a patch decoder
+     *
+     * @param   patch   pointer to the delta_patch_t to setup
+     * @param   begin   header callback
+     * @param   read    source read callback
+     * @param   write   target write callback
+     */
+    void delta_patch_init( delta_patch_t *patch, DELTA_PATCH_BEGIN_FUNC begin, DELTA_PATCH_READ_FUNC read, DELTA_PATCH_WRITE_FUNC write );
+    /**
+     * @brief feed the next block of patch data, in any size
+     *
+     * @param   patch   pointer to an initialized delta_patch_t
+     * @param   data    pointer to the patch data
+     * @param   len     length of the patch data
+     *
+     * @return  DELTA_PATCH_MORE, DELTA_PATCH_DONE or DELTA_PATCH_ERROR
+     */
+    int delta_patch_feed( delta_patch_t *patch, const uint8_t *data, size_t len );
+
+#endif // _DELTA_PATCH_H
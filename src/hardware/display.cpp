@@ -26,8 +26,10 @@
 #include "powermgm.h"
 #include "motor.h"
 #include "bma.h"
+#include "framebuffer.h"
 #include "gui/gui.h"
 
+#include "configstore.h"
 #include "json_psram_allocator.h"
 
 display_config_t display_config;
@@ -49,6 +51,7 @@ void display_setup( void ) {
     ttgo->bl->adjust( 0 );
     ttgo->tft->setRotation( display_config.rotation / 90 );
     bma_set_rotate_tilt( display_config.rotation );
+    framebuffer_setup();
 
     powermgm_register_cb( POWERMGM_SILENCE_WAKEUP | POWERMGM_STANDBY | POWERMGM_WAKEUP, display_powermgm_event_cb, "display" );
     powermgm_register_loop_cb( POWERMGM_WAKEUP, display_powermgm_loop_cb, "display loop" );
@@ -143,6 +146,17 @@ void display_wakeup( bool silence ) {
 }
 
 void display_save_config( void ) {
+    configstore_save( CONFIGSTORE_DISPLAY );
+}
+
+void display_read_config( void ) {
+    if ( !configstore_register( CONFIGSTORE_DISPLAY, &display_config, sizeof( display_config ), display_read_json_config, display_save_json_config ) ) {
+        display_read_json_config();
+        display_save_config();
+    }
+}
+
+void display_save_json_config( void ) {
     fs::File file = SPIFFS.open( DISPLAY_JSON_CONFIG_FILE, FILE_WRITE );
 
     if (!file) {
@@ -151,11 +165,7 @@ void display_save_config( void ) {
     else {
         SpiRamJsonDocument doc( 1000 );
 
-        doc["brightness"] = display_config.brightness;
-        doc["rotation"] = display_config.rotation;
-        doc["timeout"] = display_config.timeout;
-        doc["block_return_maintile"] = display_config.block_return_maintile;
-        doc["background_image"] = display_config.background_image;
+        display_config_to_json( &display_config, doc.to<JsonObject>() );
 
         if ( serializeJsonPretty( doc, file ) == 0) {
             log_e("Failed to write config file");
@@ -165,7 +175,7 @@ void display_save_config( void ) {
     file.close();
 }
 
-void display_read_config( void ) {
+void display_read_json_config( void ) {
     fs::File file = SPIFFS.open( DISPLAY_JSON_CONFIG_FILE, FILE_READ );
     if (!file) {
         log_e("Can't open file: %s!", DISPLAY_JSON_CONFIG_FILE );
@@ -180,11 +190,7 @@ void display_read_config( void ) {
         }
       
         else {
-            display_config.brightness = doc["brightness"] | DISPLAY_MAX_BRIGHTNESS / 2;
-            display_config.rotation = doc["rotation"] | DISPLAY_MIN_ROTATE;
-            display_config.timeout = doc["timeout"] | DISPLAY_MIN_TIMEOUT;
-            display_config.block_return_maintile = doc["block_return_maintile"] | false;
-            display_config.background_image = doc["background_image"] | 2;
+            display_config_from_json( &display_config, doc.as<JsonObjectConst>() );
         }        
         doc.clear();
     }
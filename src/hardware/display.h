@@ -23,30 +23,13 @@
     #define _DISPLAY_H
 
     #include "callback.h"
+    #include "display_config.h"
 
     #define DISPLAYCTL_BRIGHTNESS       _BV(0)          /** @brief event mask display brightness, callback arg is (uint32_t*) */
     #define DISPLAYCTL_TIMEOUT          _BV(1)          /** @brief event mask display brightness, callback arg is (uint32_t*) */
 
     #define DISPLAY_JSON_CONFIG_FILE    "/display.json" /** @brief defines json config file name */
     
-    #define DISPLAY_MIN_TIMEOUT         15              /** @brief min display timeout */
-    #define DISPLAY_MAX_TIMEOUT         300             /** @brief max display timeout */
-    #define DISPLAY_MIN_BRIGHTNESS      8               /** @brief min display brightness */
-    #define DISPLAY_MAX_BRIGHTNESS      255             /** @brief max display brightness */
-    #define DISPLAY_MIN_ROTATE          0               /** @brief min display rotation */
-    #define DISPLAY_MAX_ROTATE          270             /** @brief max display rotation */
-
-    /**
-     * @brief display config structure
-     */
-    typedef struct {
-        uint32_t brightness = 128;                      /** @brief display brightness */
-        uint32_t timeout = 30;                          /** @brief display time out */
-        uint32_t rotation = 180;                        /** @brief display rotation */
-        bool block_return_maintile = true;              /** @brief block back to main tile on standby */
-        uint32_t background_image = 4;                  /** @brief background image */
-    } display_config_t;
-
     /**
      * @brief setup display
      * 
@@ -67,6 +50,14 @@
      * @brief read config for display from spiffs
      */
     void display_read_config( void );
+    /**
+     * @brief write the config as legacy json file to spiffs
+     */
+    void display_save_json_config( void );
+    /**
+     * @brief import the config from the legacy json file on spiffs
+     */
+    void display_read_json_config( void );
     /**
      * @brief read the timeout from config
      * 
@@ -0,0 +1,35 @@
+/****************************************************************************
+ *   Copyright  2020  Jesper Ortlund
+ ****************************************************************************/
+/*
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+#include "display_config.h"
+
+void display_config_from_json( display_config_t *config, JsonObjectConst json ) {
+    config->brightness = json["brightness"] | DISPLAY_MAX_BRIGHTNESS / 2;
+    config->rotation = json["rotation"] | DISPLAY_MIN_ROTATE;
+    config->timeout = json["timeout"] | DISPLAY_MIN_TIMEOUT;
+    config->block_return_maintile = json["block_return_maintile"] | false;
+    config->background_image = json["background_image"] | 2;
+}
+
+void display_config_to_json( const display_config_t *config, JsonObject json ) {
+    json["brightness"] = config->brightness;
+    json["rotation"] = config->rotation;
+    json["timeout"] = config->timeout;
+    json["block_return_maintile"] = config->block_return_maintile;
+    json["background_image"] = config->background_image;
+}
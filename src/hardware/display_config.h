@@ -0,0 +1,63 @@
+/****************************************************************************
+ *   Copyright  2020  Jesper Ortlund
+ ****************************************************************************/
+/*
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+#ifndef _DISPLAY_CONFIG_H
+    #define _DISPLAY_CONFIG_H
+
+    /*
+     * no arduino or spiffs in here, the config and its json mapping build and run on the host
+     */
+    #include <stdint.h>
+    #include <ArduinoJson.h>
+
+
+    #define DISPLAY_MIN_TIMEOUT         15              /** @brief min display timeout */
+    #define DISPLAY_MAX_TIMEOUT         300             /** @brief max display timeout */
+    #define DISPLAY_MIN_BRIGHTNESS      8               /** @brief min display brightness */
+    #define DISPLAY_MAX_BRIGHTNESS      255             /** @brief max display brightness */
+    #define DISPLAY_MIN_ROTATE          0               /** @brief min display rotation */
+    #define DISPLAY_MAX_ROTATE          270             /** @brief max display rotation */
+
+    /**
+     * @brief display config structure, stored as is in the config store. only append
+     * fields, never reorder or resize them
+     */
+    typedef struct {
+        uint32_t brightness = 128;                      /** @brief display brightness */
+        uint32_t timeout = 30;                          /** @brief display time out */
+        uint32_t rotation = 180;                        /** @brief display rotation */
+        bool block_return_maintile = true;              /** @brief block back to main tile on standby */
+        uint32_t background_image = 4;                  /** @brief background image */
+    } display_config_t;
+
+    /**
+     * @brief fill the display config from the legacy json, missing keys get their defaults
+     *
+     * @param   config      pointer to the config
+     * @param   json        root object of display.json
+     */
+    void display_config_from_json( display_config_t *config, JsonObjectConst json );
+    /**
+     * @brief write the display config as legacy json
+     *
+     * @param   config      pointer to the config
+     * @param   json        root object to fill
+     */
+    void display_config_to_json( const display_config_t *config, JsonObject json );
+
+#endif // _DISPLAY_CONFIG_H
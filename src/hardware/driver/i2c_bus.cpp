@@ -40,7 +40,10 @@ uint16_t I2C_Bus::readBytes(uint8_t addr, uint8_t *data, uint16_t len, uint16_t
     }
     uint16_t index = 0;
     while (_port->available()) {
-        if (index > len)return 1 << 14;
+        if (index >= len) {
+            ret = 1 << 14;
+            break;
+        }
         if (delay_ms)delay(delay_ms);
         data[index++] = _port->read();
     }
@@ -62,7 +65,10 @@ uint16_t I2C_Bus::readBytes(uint8_t addr, uint8_t reg, uint8_t *data, uint16_t l
     }
     uint16_t index = 0;
     while (_port->available()) {
-        if (index > len)return 1 << 14;
+        if (index >= len) {
+            ret = 1 << 14;
+            break;
+        }
         data[index++] = _port->read();
     }
     xSemaphoreGiveRecursive(_i2c_mux);
@@ -25,13 +25,17 @@
 
 #include "framebuffer.h"
 #include "powermgm.h"
+#include "metrics.h"
+#include "arena.h"
+#include "gui/screenshot.h"
 
 lv_color_t *framebuffer;
+lv_color_t *framebuffer2 = NULL;
 
 static lv_disp_buf_t disp_buf;
 
 lv_disp_drv_t *framebuffer_disp_drv = NULL;
-const lv_area_t *framebuffer_area = NULL;
+lv_area_t framebuffer_area;
 lv_color_t *framebuffer_color_p = NULL;
 
 volatile bool DRAM_ATTR framebuffer_flag = false;
@@ -45,12 +49,23 @@ void framebuffer_ipc_call( void * arg );
 static void framebuffer_flush(lv_disp_drv_t *disp_drv, const lv_area_t *area, lv_color_t *color_p);
 
 void framebuffer_setup( void ) {
-    framebuffer = (lv_color_t*)ps_malloc( lv_disp_get_hor_res( NULL ) * lv_disp_get_ver_res( NULL ) * sizeof( lv_color_t ) );
-    if ( framebuffer == NULL ) {
-        log_e("framebuffer 1 malloc failed");
-        return;
+    uint32_t lines = FRAMEBUFFER_LINES;
+    /*
+     * lvgl renders and the spi transfer reads these on every frame, keep them
+     * out of psram. without the dma arena fall back to one full frame in psram
+     */
+    framebuffer = (lv_color_t*)arena_alloc( ARENA_DMA, lv_disp_get_hor_res( NULL ) * lines * sizeof( lv_color_t ), "framebuffer" );
+    framebuffer2 = (lv_color_t*)arena_alloc( ARENA_DMA, lv_disp_get_hor_res( NULL ) * lines * sizeof( lv_color_t ), "framebuffer" );
+    if ( framebuffer == NULL || framebuffer2 == NULL ) {
+        lines = lv_disp_get_ver_res( NULL );
+        framebuffer2 = NULL;
+        framebuffer = (lv_color_t*)ps_malloc( lv_disp_get_hor_res( NULL ) * lines * sizeof( lv_color_t ) );
+        if ( framebuffer == NULL ) {
+            log_e("framebuffer 1 malloc failed");
+            return;
+        }
     }
-    lv_disp_buf_init( &disp_buf, framebuffer, NULL, lv_disp_get_hor_res( NULL ) * lv_disp_get_ver_res( NULL ) );
+    lv_disp_buf_init( &disp_buf, framebuffer, framebuffer2, lv_disp_get_hor_res( NULL ) * lines );
 
     powermgm_register_cb( POWERMGM_STANDBY | POWERMGM_WAKEUP | POWERMGM_SILENCE_WAKEUP, framebuffer_powermgm_event_cb, "framebuffer" );
 
@@ -82,12 +97,18 @@ bool framebuffer_powermgm_event_cb( EventBits_t event, void *arg ) {
 static void framebuffer_flush(lv_disp_drv_t *disp_drv, const lv_area_t *area, lv_color_t *color_p) {
     static uint64_t nextmillis = 0;
 
-    if ( framebuffer_flag )
+    if ( framebuffer_flag ) {
+        lv_disp_flush_ready( disp_drv );
         return;
+    }
 
+    /*
+     * with two buffers lvgl moves on to the next area while core 0 is still
+     * pushing this one, take a copy of the area
+     */
     portENTER_CRITICAL(&FRAMEBUFFER_Mux);
     framebuffer_disp_drv = disp_drv;
-    framebuffer_area = area;
+    framebuffer_area = *area;
     framebuffer_color_p = color_p;
     framebuffer_flag = true;
 
@@ -97,16 +118,20 @@ static void framebuffer_flush(lv_disp_drv_t *disp_drv, const lv_area_t *area, lv
         frame = 0;
     }
     portEXIT_CRITICAL(&FRAMEBUFFER_Mux);
+    metrics_set_gauge( METRICS_FRAMERATE, framerate );
+    screenshot_capture( area, color_p );
 
     esp_ipc_call( 0, framebuffer_ipc_call, NULL );
 }
 
 void framebuffer_ipc_call( void * arg ) {
     TTGOClass *ttgo = TTGOClass::getWatch();
+    int64_t start = esp_timer_get_time();
 
-    uint32_t size = (framebuffer_area->x2 - framebuffer_area->x1 + 1) * (framebuffer_area->y2 - framebuffer_area->y1 + 1) ;
-    ttgo->tft->setAddrWindow(framebuffer_area->x1, framebuffer_area->y1, (framebuffer_area->x2 - framebuffer_area->x1 + 1), (framebuffer_area->y2 - framebuffer_area->y1 + 1)); /* set the working window */
+    uint32_t size = (framebuffer_area.x2 - framebuffer_area.x1 + 1) * (framebuffer_area.y2 - framebuffer_area.y1 + 1) ;
+    ttgo->tft->setAddrWindow(framebuffer_area.x1, framebuffer_area.y1, (framebuffer_area.x2 - framebuffer_area.x1 + 1), (framebuffer_area.y2 - framebuffer_area.y1 + 1)); /* set the working window */
     ttgo->tft->pushColors(( uint16_t *)framebuffer_color_p, size, false);
+    metrics_sample_since( METRICS_FLUSH_US, start );
     portENTER_CRITICAL(&FRAMEBUFFER_Mux);
     frame++;
     framebuffer_flag = false;
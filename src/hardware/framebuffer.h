@@ -22,6 +22,12 @@
 #ifndef _FRAMEBUFFER_H
     #define _FRAMEBUFFER_H
 
+    #define FRAMEBUFFER_LINES           16          /** @brief lines per display buffer, two of them live in the dma arena */
+
+    /**
+     * @brief take over lvgl rendering with two internal dma line buffers, lvgl renders
+     * into one while core 0 pushes the other to the display
+     */
     void framebuffer_setup( void );
     
 #endif // _FRAMEBUFFER_H
\ No newline at end of file
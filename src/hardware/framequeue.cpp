@@ -0,0 +1,63 @@
+/****************************************************************************
+ *   Copyright  2020  Jesper Ortlund
+ ****************************************************************************/
+/*
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+#include <string.h>
+
+#include "framequeue.h"
+
+void framequeue_init( framequeue_t *queue, framequeue_frame_t *frame, uint16_t size, bool drop_oldest ) {
+    queue->frame = frame;
+    queue->size = size;
+    queue->drop_oldest = drop_oldest;
+    queue->dropped = 0;
+    framequeue_clear( queue );
+}
+
+void framequeue_clear( framequeue_t *queue ) {
+    queue->head = 0;
+    queue->count = 0;
+}
+
+bool framequeue_push( framequeue_t *queue, const uint8_t *data, size_t len ) {
+    if ( len > FRAMEQUEUE_FRAME_SIZE || queue->size == 0 )
+        return( false );
+
+    if ( queue->count == queue->size ) {
+        queue->dropped++;
+        if ( !queue->drop_oldest )
+            return( false );
+        queue->head = ( queue->head + 1 ) % queue->size;
+        queue->count--;
+    }
+
+    framequeue_frame_t *frame = &queue->frame[ ( queue->head + queue->count ) % queue->size ];
+    memcpy( frame->data, data, len );
+    frame->len = len;
+    queue->count++;
+    return( true );
+}
+
+bool framequeue_pop( framequeue_t *queue, framequeue_frame_t *frame ) {
+    if ( queue->count == 0 )
+        return( false );
+
+    *frame = queue->frame[ queue->head ];
+    queue->head = ( queue->head + 1 ) % queue->size;
+    queue->count--;
+    return( true );
+}
@@ -0,0 +1,87 @@
+/****************************************************************************
+ *   Copyright  2020  Jesper Ortlund
+ ****************************************************************************/
+/*
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+#ifndef _FRAMEQUEUE_H
+    #define _FRAMEQUEUE_H
+
+    /*
+     * no arduino in here, the queue builds and runs on the host
+     */
+    #include <stdint.h>
+    #include <stddef.h>
+
+    #define FRAMEQUEUE_FRAME_SIZE       20          /** @brief max frame size, one ble notification with the default mtu */
+
+    /**
+     * @brief one queued frame
+     */
+    typedef struct {
+        uint8_t data[ FRAMEQUEUE_FRAME_SIZE ];      /** @brief frame data */
+        uint8_t len;                                /** @brief valid bytes in data */
+    } framequeue_frame_t;
+
+    /**
+     * @brief bounded frame queue in caller provided slots, not locked, the caller has
+     * to serialize push and pop when producer and consumer run in different tasks
+     */
+    typedef struct {
+        framequeue_frame_t *frame;                  /** @brief slot array */
+        uint16_t size;                              /** @brief number of slots */
+        uint16_t head;                              /** @brief next slot to pop */
+        uint16_t count;                             /** @brief queued frames */
+        bool drop_oldest;                           /** @brief on a full queue drop the oldest frame instead of the new one */
+        uint32_t dropped;                           /** @brief frames lost to a full queue */
+    } framequeue_t;
+
+    /**
+     * @brief setup a frame queue
+     *
+     * @param   queue           pointer to the framequeue_t to setup
+     * @param   frame           pointer to size slots
+     * @param   size            number of slots
+     * @param   drop_oldest     true for telemetry where only the latest frames matter,
+     *                          false for commands that must not be reordered or lost silently
+     */
+    void framequeue_init( framequeue_t *queue, framequeue_frame_t *frame, uint16_t size, bool drop_oldest );
+    /**
+     * @brief drop all queued frames
+     *
+     * @param   queue           pointer to an initialized framequeue_t
+     */
+    void framequeue_clear( framequeue_t *queue );
+    /**
+     * @brief queue a frame
+     *
+     * @param   queue           pointer to an initialized framequeue_t
+     * @param   data            pointer to the frame data
+     * @param   len             frame length, at most FRAMEQUEUE_FRAME_SIZE
+     *
+     * @return  true if queued, false if too long or the queue is full and drops new frames
+     */
+    bool framequeue_push( framequeue_t *queue, const uint8_t *data, size_t len );
+    /**
+     * @brief take the oldest frame from the queue
+     *
+     * @param   queue           pointer to an initialized framequeue_t
+     * @param   frame           pointer to a frame to fill
+     *
+     * @return  true if a frame was taken, false if the queue is empty
+     */
+    bool framequeue_pop( framequeue_t *queue, framequeue_frame_t *frame );
+
+#endif // _FRAMEQUEUE_H
@@ -0,0 +1,136 @@
+/****************************************************************************
+ *   Copyright  2020  Jesper Ortlund
+ ****************************************************************************/
+/*
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+#include <stdlib.h>
+
+#include "gesture.h"
+
+static uint16_t gesture_ms2samples( uint16_t rate, uint32_t ms );
+static uint32_t gesture_step( gesture_t *gesture, const gesture_sample_t *sample );
+
+void gesture_init( gesture_t *gesture, uint16_t rate ) {
+    gesture->hold_samples = gesture_ms2samples( rate, GESTURE_RAISE_HOLD );
+    gesture->raise_window = gesture_ms2samples( rate, GESTURE_RAISE_WINDOW );
+    gesture->shake_window = gesture_ms2samples( rate, GESTURE_SHAKE_WINDOW );
+    gesture->shake_holdoff = gesture_ms2samples( rate, GESTURE_SHAKE_HOLDOFF );
+    gesture_reset( gesture );
+}
+
+void gesture_reset( gesture_t *gesture ) {
+    gesture->primed = false;
+    gesture->low_age = UINT16_MAX;
+    gesture->hold = 0;
+    gesture->shake_age = 0;
+    gesture->shake_peaks = 0;
+    gesture->shake_dir = 0;
+    gesture->holdoff = 0;
+}
+
+uint32_t gesture_feed( gesture_t *gesture, const gesture_sample_t *sample, int num ) {
+    uint32_t detected = 0;
+
+    for ( int i = 0 ; i < num ; i++ ) {
+        detected |= gesture_step( gesture, &sample[ i ] );
+    }
+    return( detected );
+}
+
+static uint16_t gesture_ms2samples( uint16_t rate, uint32_t ms ) {
+    uint32_t samples = ( ms * rate + 999 ) / 1000;
+    return( samples ? samples : 1 );
+}
+
+static uint32_t gesture_step( gesture_t *gesture, const gesture_sample_t *sample ) {
+    int32_t axis[ 3 ] = { sample->x, sample->y, sample->z };
+    int32_t motion = 0;
+    int32_t peak = 0;
+    int8_t dir = 0;
+    uint32_t detected = 0;
+
+    if ( !gesture->primed ) {
+        for ( int i = 0 ; i < 3 ; i++ )
+            gesture->gravity[ i ] = axis[ i ];
+        gesture->primed = true;
+    }
+
+    /*
+     * split each sample into slow gravity and fast motion, the motion
+     * is summed up as |x|+|y|+|z| and the strongest axis gives the direction
+     */
+    for ( int i = 0 ; i < 3 ; i++ ) {
+        gesture->gravity[ i ] += ( axis[ i ] - gesture->gravity[ i ] ) >> GESTURE_LOWPASS_SHIFT;
+        int32_t delta = axis[ i ] - gesture->gravity[ i ];
+        int32_t magnitude = abs( delta );
+        motion += magnitude;
+        if ( magnitude > peak ) {
+            peak = magnitude;
+            dir = ( delta > 0 ) ? ( i + 1 ) : -( i + 1 );
+        }
+    }
+
+    /*
+     * wrist raise: the face pointed away from the rider not long ago
+     * and now points up and stays still for a moment
+     */
+    if ( gesture->gravity[ 2 ] < GESTURE_RAISE_LOW )
+        gesture->low_age = 0;
+    else if ( gesture->low_age < UINT16_MAX )
+        gesture->low_age++;
+
+    if ( gesture->gravity[ 2 ] > GESTURE_RAISE_HIGH && abs( gesture->gravity[ 0 ] ) < GESTURE_RAISE_TILT && abs( gesture->gravity[ 1 ] ) < GESTURE_RAISE_TILT && motion < GESTURE_RAISE_STILL ) {
+        if ( gesture->hold < UINT16_MAX )
+            gesture->hold++;
+        if ( gesture->hold == gesture->hold_samples && gesture->low_age <= gesture->raise_window )
+            detected |= GESTURE_WRIST_RAISE;
+    }
+    else {
+        gesture->hold = 0;
+    }
+
+    /*
+     * shake: several strong peaks with changing direction in a short time,
+     * road bumps give single peaks and don't reach the count
+     */
+    if ( gesture->holdoff ) {
+        gesture->holdoff--;
+        return( detected );
+    }
+
+    if ( gesture->shake_peaks ) {
+        gesture->shake_age++;
+        if ( gesture->shake_age > gesture->shake_window ) {
+            gesture->shake_peaks = 0;
+            gesture->shake_dir = 0;
+        }
+    }
+
+    if ( motion >= GESTURE_SHAKE_LEVEL && dir != gesture->shake_dir ) {
+        if ( gesture->shake_peaks == 0 )
+            gesture->shake_age = 0;
+        gesture->shake_peaks++;
+        gesture->shake_dir = dir;
+        if ( gesture->shake_peaks >= GESTURE_SHAKE_PEAKS ) {
+            detected |= GESTURE_SHAKE;
+            gesture->shake_peaks = 0;
+            gesture->shake_dir = 0;
+            gesture->holdoff = gesture->shake_holdoff;
+        }
+    }
+
+    return( detected );
+}
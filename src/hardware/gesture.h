@@ -0,0 +1,93 @@
+/****************************************************************************
+ *   Copyright  2020  Jesper Ortlund
+ ****************************************************************************/
+/*
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+#ifndef _GESTURE_H
+    #define _GESTURE_H
+
+    /*
+     * no arduino in here, the classifier builds and runs on the host
+     */
+    #include <stdint.h>
+
+    #define GESTURE_WRIST_RAISE         ( 1 << 0 )  /** @brief wrist turned up and held still, rider looks at the watch */
+    #define GESTURE_SHAKE               ( 1 << 1 )  /** @brief repeated back and forth shake */
+
+    #define GESTURE_LOWPASS_SHIFT       2           /** @brief gravity lowpass, new = old + ( sample - old ) >> shift */
+    #define GESTURE_RAISE_LOW           300         /** @brief z gravity in mg below which the watch face points away from the rider */
+    #define GESTURE_RAISE_HIGH          750         /** @brief z gravity in mg above which the watch face points up */
+    #define GESTURE_RAISE_TILT          500         /** @brief max x/y gravity in mg while the face points up */
+    #define GESTURE_RAISE_STILL         400         /** @brief max motion in mg, |x|+|y|+|z| without gravity, while holding */
+    #define GESTURE_RAISE_HOLD          300         /** @brief ms the face has to point up before a wrist raise is reported */
+    #define GESTURE_RAISE_WINDOW        1500        /** @brief ms from face away to wrist raise, slower turns are ignored */
+    #define GESTURE_SHAKE_LEVEL         1500        /** @brief min motion in mg, |x|+|y|+|z| without gravity, for a shake peak */
+    #define GESTURE_SHAKE_PEAKS         4           /** @brief alternating peaks for a shake */
+    #define GESTURE_SHAKE_WINDOW        1000        /** @brief ms in which all shake peaks have to happen */
+    #define GESTURE_SHAKE_HOLDOFF       1500        /** @brief ms after a shake before the next one is detected */
+
+    /**
+     * @brief one accelerometer sample in mg
+     */
+    typedef struct {
+        int16_t x;
+        int16_t y;
+        int16_t z;
+    } gesture_sample_t;
+
+    /**
+     * @brief classifier state, carried over from one batch to the next
+     */
+    typedef struct {
+        int32_t gravity[ 3 ];                       /** @brief lowpass filtered sample in mg */
+        bool primed;                                /** @brief gravity holds a valid value */
+        uint16_t hold_samples;                      /** @brief GESTURE_RAISE_HOLD in samples */
+        uint16_t raise_window;                      /** @brief GESTURE_RAISE_WINDOW in samples */
+        uint16_t shake_window;                      /** @brief GESTURE_SHAKE_WINDOW in samples */
+        uint16_t shake_holdoff;                     /** @brief GESTURE_SHAKE_HOLDOFF in samples */
+        uint16_t low_age;                           /** @brief samples since the face pointed away */
+        uint16_t hold;                              /** @brief samples the face points up and is still */
+        uint16_t shake_age;                         /** @brief samples since the first peak of the current shake */
+        uint16_t shake_peaks;                       /** @brief peaks seen in the current shake */
+        int8_t shake_dir;                           /** @brief axis and sign of the last peak, ( axis + 1 ) * sign */
+        uint16_t holdoff;                           /** @brief samples left until the next shake can be detected */
+    } gesture_t;
+
+    /**
+     * @brief setup a classifier for a given sample rate
+     *
+     * @param   gesture     pointer to the gesture_t to setup
+     * @param   rate        sample rate in Hz
+     */
+    void gesture_init( gesture_t *gesture, uint16_t rate );
+    /**
+     * @brief forget the motion history, call after a gap in the samples
+     *
+     * @param   gesture     pointer to an initialized gesture_t
+     */
+    void gesture_reset( gesture_t *gesture );
+    /**
+     * @brief run a batch of samples through the classifier
+     *
+     * @param   gesture     pointer to an initialized gesture_t
+     * @param   sample      pointer to the samples, oldest first
+     * @param   num         number of samples
+     *
+     * @return  GESTURE_WRIST_RAISE and/or GESTURE_SHAKE if detected in this batch, 0 otherwise
+     */
+    uint32_t gesture_feed( gesture_t *gesture, const gesture_sample_t *sample, int num );
+
+#endif // _GESTURE_H
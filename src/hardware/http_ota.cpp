@@ -27,103 +27,387 @@
 #include "config.h"
 #include <HTTPClient.h>
 #include <Update.h>
+#include <lwip/sockets.h>
+#include <esp_ota_ops.h>
+#include <MD5Builder.h>
 
 #include "callback.h"
 #include "http_ota.h"
+#include "alloc.h"
+#include "delta_patch.h"
+
+/**
+ * @brief one download buffer, handed between the download and the flash task
+ */
+typedef struct {
+    uint8_t *data;                              /** @brief buffer memory, HTTP_OTA_BUFFER_SIZE bytes */
+    size_t len;                                 /** @brief valid bytes, 0 stops the flash task */
+} http_ota_buffer_t;
 
 callback_t *http_ota_callback = NULL;
+static volatile int16_t http_ota_progress = 0;
+static volatile bool http_ota_flash_failed = false;
+static QueueHandle_t http_ota_free_queue = NULL;
+static QueueHandle_t http_ota_full_queue = NULL;
+static SemaphoreHandle_t http_ota_flash_done = NULL;
+static const esp_partition_t *http_ota_running = NULL;
+static const char *http_ota_md5 = NULL;
+static volatile uint64_t http_ota_flash_us = 0;     /** @brief time the flash task spent writing */
+
 bool http_ota_send_event_cb( EventBits_t event, void *arg );
+static int http_ota_connect( HTTPClient *http, const char *url, size_t offset, size_t total );
+static int http_ota_fill( WiFiClient *stream, uint8_t *data, size_t size );
+static void http_ota_flash_Task( void * pvParameters );
+static bool http_ota_run( const char *url, const char *md5, delta_patch_t *delta );
+static bool http_ota_delta_begin( uint32_t source_size, const uint8_t *source_md5, uint32_t target_size );
+static bool http_ota_delta_read( uint32_t offset, uint8_t *data, size_t len );
+static bool http_ota_delta_write( const uint8_t *data, size_t len );
 
 bool http_ota_start( const char* url, const char* md5 ) {
-    int downloaded = 0;
-    int written = 0;
-    int total = 1;
-    int len = 1;
-    uint8_t buff[ 1024 * 2 ] = { 0 };
-    size_t size = sizeof( buff );
-    bool ret = true;
+    return( http_ota_run( url, md5, NULL ) );
+}
 
-    HTTPClient http;
+bool http_ota_start_delta( const char* url, const char* md5 ) {
+    if ( url == NULL )
+        return( false );
+
+    delta_patch_t *delta = (delta_patch_t*)MALLOC( sizeof( delta_patch_t ) );
+    if ( delta == NULL ) {
+        log_e("delta patch alloc failed");
+        return( false );
+    }
+    delta_patch_init( delta, http_ota_delta_begin, http_ota_delta_read, http_ota_delta_write );
+    http_ota_running = esp_ota_get_running_partition();
+    http_ota_md5 = md5;
+
+    bool ret = http_ota_run( url, md5, delta );
+
+    free( delta );
+    return( ret );
+}
 
+/**
+ * @brief download url and flash it, as full image or as delta patch against the running image
+ */
+static bool http_ota_run( const char *url, const char *md5, delta_patch_t *delta ) {
+    http_ota_buffer_t buffer[ HTTP_OTA_BUFFER_NUM ];
+    int64_t start = esp_timer_get_time();
+    size_t downloaded = 0;
+    size_t total = 0;
+    int retry = 0;
+    bool ret = false;
+
+    http_ota_progress = 0;
+    http_ota_flash_failed = false;
+    http_ota_flash_us = 0;
+
+    HTTPClient http;
     http.setUserAgent( "ESP32-UPDATE-" __FIRMWARE__ );
-    http.begin( url );
-    int httpCode = http.GET();
-
-    if ( httpCode > 0 && httpCode == HTTP_CODE_OK ) {
-        http_ota_send_event_cb( HTTP_OTA_START, (void *)NULL );
-
-        len = http.getSize();
-        total = len;
-        downloaded = 0;
-
-        WiFiClient * stream = http.getStreamPtr();
-
-        if ( Update.begin( total, U_FLASH ) ) {
-            Update.setMD5( md5 );
-            downloaded = 0;
-            while ( !Update.isFinished() ) {
-                if( http.connected() && ( len > 0 ) ) {
-                    size = stream->available();
-                    if( size > 0 ) {
-                        int c = stream->readBytes( buff, ( ( size > sizeof( buff ) ) ? sizeof( buff ) : size ) );
-                        written = Update.write( buff, c );
-                        if ( written > 0 ) {
-                            if( written != c ) {
-                                http_ota_send_event_cb( HTTP_OTA_ERROR, (void*)"Flashing chunk not full ... warning!" );
-                                log_w("Flashing chunk not full ... warning!");
-                            }
-                            downloaded += written;
-                            static int16_t old_progress = 0;
-                            int16_t progress = ( 100 * downloaded ) / total ;
-                            if ( old_progress != progress ) {
-                                http_ota_send_event_cb( HTTP_OTA_PROGRESS, (void*)&progress );
-                                log_i("progress: %d", progress );
-                                old_progress = progress;
-                            }
-                        } else {
-                            http_ota_send_event_cb( HTTP_OTA_ERROR, (void*)"Flashing ... failed!" );
-                            log_e("Flashing ... failed!");
-                            ret = false;
-                            break;
-                        }
-                        if(len > 0) {
-                            len -= c;
-                        }
-                    }
-                    delay( 1 );
-                }
-            }
+    http.setReuse( false );
+
+    int len = http_ota_connect( &http, url, 0, 0 );
+    if ( len <= 0 ) {
+        /*
+         * no patch for our version on the server, not worth an error
+         */
+        if ( delta ) {
+            log_i("no delta patch, full image needed");
         }
         else {
-            http_ota_send_event_cb( HTTP_OTA_ERROR, (void*)"Flashing init ... failed!" );
-            log_e("Flashing init ... failed!");
+            http_ota_send_event_cb( HTTP_OTA_ERROR, (void*)"[HTTP] GET... failed!" );
+            log_e("[HTTP] GET... failed!");
         }
-        http_ota_send_event_cb( HTTP_OTA_FINISH, (void*)NULL );
+        http.end();
+        return( false );
     }
-    else {
-        http_ota_send_event_cb( HTTP_OTA_ERROR, (void*)"[HTTP] GET... failed!" );
-        log_e("[HTTP] GET... failed!");
-        ret = false;        
+    total = len;
+
+    /*
+     * a delta patch starts the updater from its header, the target size is in there
+     */
+    if ( delta == NULL && !Update.begin( total, U_FLASH ) ) {
+        http_ota_send_event_cb( HTTP_OTA_ERROR, (void*)"Flashing init ... failed!" );
+        log_e("Flashing init ... failed!");
+        http.end();
+        return( false );
+    }
+    /*
+     * the updater hashes every written block, Update.end() only compares the result
+     */
+    if ( delta == NULL && md5 )
+        Update.setMD5( md5 );
+
+    http_ota_free_queue = xQueueCreate( HTTP_OTA_BUFFER_NUM, sizeof( http_ota_buffer_t ) );
+    http_ota_full_queue = xQueueCreate( HTTP_OTA_BUFFER_NUM + 1, sizeof( http_ota_buffer_t ) );
+    http_ota_flash_done = xSemaphoreCreateBinary();
+    for ( int i = 0 ; i < HTTP_OTA_BUFFER_NUM ; i++ ) {
+        buffer[ i ].data = (uint8_t*)MALLOC( HTTP_OTA_BUFFER_SIZE );
+        buffer[ i ].len = 0;
+        if ( buffer[ i ].data == NULL ) {
+            log_e("http ota buffer alloc failed");
+            while(true);
+        }
+        xQueueSend( http_ota_free_queue, &buffer[ i ], portMAX_DELAY );
+    }
+
+    xTaskCreatePinnedToCore(    http_ota_flash_Task,        /* Function to implement the task */
+                                "http ota flash Task",      /* Name of the task */
+                                HTTP_OTA_FLASH_STACK,       /* Stack size in words */
+                                delta,                      /* Task input parameter */
+                                2,                          /* Priority of the task */
+                                NULL,                       /* Task handle. */
+                                1 );
+
+    http_ota_send_event_cb( HTTP_OTA_START, (void *)NULL );
+
+    /*
+     * download into one buffer while the flash task writes the other one
+     */
+    while ( downloaded < total && !http_ota_flash_failed ) {
+        http_ota_buffer_t next;
+
+        if ( len <= 0 ) {
+            if ( retry++ >= HTTP_OTA_RETRIES ) {
+                log_e("giving up after %d retries", HTTP_OTA_RETRIES );
+                break;
+            }
+            vTaskDelay( pdMS_TO_TICKS( HTTP_OTA_RETRY_DELAY * retry ) );
+            log_w("resume download at %u/%u, retry %d", (unsigned int)downloaded, (unsigned int)total, retry );
+            len = http_ota_connect( &http, url, downloaded, total );
+            continue;
+        }
+
+        xQueueReceive( http_ota_free_queue, &next, portMAX_DELAY );
+        int filled = http_ota_fill( http.getStreamPtr(), next.data, min( (size_t)HTTP_OTA_BUFFER_SIZE, total - downloaded ) );
+        /*
+         * a short fill means the connection dropped, keep what arrived and resume behind it
+         */
+        if ( filled < (int)min( (size_t)HTTP_OTA_BUFFER_SIZE, total - downloaded ) ) {
+            http.end();
+            len = 0;
+        }
+        if ( filled <= 0 ) {
+            xQueueSend( http_ota_free_queue, &next, portMAX_DELAY );
+            continue;
+        }
+        next.len = filled;
+        xQueueSend( http_ota_full_queue, &next, portMAX_DELAY );
+        downloaded += filled;
+        retry = 0;
+        http_ota_progress = ( 100 * (uint64_t)downloaded ) / total;
     }
     http.end();
 
-    if( downloaded == total && len == 0 ) {
-        if( Update.end() ) {
-            http_ota_send_event_cb( HTTP_OTA_FINISH, (void*)"Flashing ... done!" );
-            log_i("Flashing ... done!");
-        } else {
-            http_ota_send_event_cb( HTTP_OTA_ERROR, (void*)"Flashing md5 ... failed!" );
-            log_e("Flashing md5 ... failed!");
-            ret = false;
+    /*
+     * stop the flash task after it has drained all queued buffers
+     */
+    http_ota_buffer_t stop = { NULL, 0 };
+    xQueueSend( http_ota_full_queue, &stop, portMAX_DELAY );
+    xSemaphoreTake( http_ota_flash_done, portMAX_DELAY );
+
+    for ( int i = 0 ; i < HTTP_OTA_BUFFER_NUM ; i++ ) {
+        free( buffer[ i ].data );
+    }
+    vQueueDelete( http_ota_free_queue );
+    vQueueDelete( http_ota_full_queue );
+    vSemaphoreDelete( http_ota_flash_done );
+    http_ota_free_queue = NULL;
+    http_ota_full_queue = NULL;
+    http_ota_flash_done = NULL;
+
+    if ( delta && delta->state != DELTA_PATCH_DONE && !http_ota_flash_failed && downloaded == total ) {
+        log_e("delta patch incomplete");
+        http_ota_flash_failed = true;
+    }
+
+    const char *error = NULL;
+    if ( http_ota_flash_failed ) {
+        error = "Flashing ... failed!";
+        Update.abort();
+    }
+    else if ( downloaded != total ) {
+        error = "Download firmware ... failed!";
+        Update.abort();
+    }
+    else if ( Update.end() ) {
+        /*
+         * download and flash overlap, flash busy next to the total shows which one held the update up
+         */
+        uint64_t total_ms = ( esp_timer_get_time() - start ) / 1000;
+        log_i("Flashing ... done! %u bytes downloaded, %u bytes flashed in %llums, %llukB/s, flash busy %llums",
+                                                                (unsigned int)downloaded, (unsigned int)Update.size(), total_ms,
+                                                                total_ms ? (uint64_t)downloaded / total_ms : 0, http_ota_flash_us / 1000 );
+        http_ota_send_event_cb( HTTP_OTA_FINISH, (void*)"Flashing ... done!" );
+        ret = true;
+    }
+    else {
+        error = "Flashing md5 ... failed!";
+    }
+    /*
+     * a failed delta falls back to the full image, no error on the ui for that
+     */
+    if ( error ) {
+        if ( delta == NULL ) {
+            http_ota_send_event_cb( HTTP_OTA_ERROR, (void*)error );
         }
-    } else {
-        http_ota_send_event_cb( HTTP_OTA_ERROR, (void*)"Download firmware ... failed!" );
-        log_e("Download firmware ... failed!");
-        ret = false;
+        log_e("%s", error );
     }
+    http_ota_progress = 0;
     return( ret );
 }
 
+int16_t http_ota_get_progress( void ) {
+    return( http_ota_progress );
+}
+
+/**
+ * @brief open the firmware url, from offset on if offset > 0
+ *
+ * @return  bytes to expect from this response, or 0 if failed
+ */
+static int http_ota_connect( HTTPClient *http, const char *url, size_t offset, size_t total ) {
+    char range[ 32 ] = "";
+
+    http->begin( url );
+    if ( offset ) {
+        snprintf( range, sizeof( range ), "bytes=%u-", (unsigned int)offset );
+        http->addHeader( "Range", range );
+    }
+
+    int httpCode = http->GET();
+    int size = http->getSize();
+
+    /*
+     * a server without range support answers 200, resuming would flash the image twice
+     */
+    if ( offset == 0 && httpCode == HTTP_CODE_OK && size > 0 ) {
+        return( size );
+    }
+    if ( offset > 0 && httpCode == HTTP_CODE_PARTIAL_CONTENT && size > 0 && offset + size == total ) {
+        return( size );
+    }
+    log_e("GET %s failed, code %d size %d", range, httpCode, size );
+    http->end();
+    return( 0 );
+}
+
+/**
+ * @brief fill a buffer from the stream, sleeping on the socket instead of polling it
+ *
+ * @return  bytes read, less than size if the connection dropped or stalled
+ */
+static int http_ota_fill( WiFiClient *stream, uint8_t *data, size_t size ) {
+    size_t filled = 0;
+
+    if ( stream == NULL )
+        return( 0 );
+
+    while ( filled < size ) {
+        if ( !stream->available() ) {
+            fd_set readset;
+            struct timeval timeout;
+            int fd = stream->fd();
+
+            if ( fd < 0 )
+                break;
+            FD_ZERO( &readset );
+            FD_SET( fd, &readset );
+            timeout.tv_sec = HTTP_OTA_READ_TIMEOUT / 1000;
+            timeout.tv_usec = ( HTTP_OTA_READ_TIMEOUT % 1000 ) * 1000;
+            if ( select( fd + 1, &readset, NULL, NULL, &timeout ) <= 0 ) {
+                log_w("stream stalled");
+                break;
+            }
+        }
+        int c = stream->read( &data[ filled ], size - filled );
+        if ( c <= 0 )
+            break;
+        filled += c;
+    }
+    return( filled );
+}
+
+static void http_ota_flash_Task( void * pvParameters ) {
+    delta_patch_t *delta = (delta_patch_t*)pvParameters;
+    http_ota_buffer_t buffer;
+
+    log_i("start http ota flash task, heap: %d", ESP.getFreeHeap() );
+    while( true ) {
+        xQueueReceive( http_ota_full_queue, &buffer, portMAX_DELAY );
+        if ( buffer.len == 0 )
+            break;
+        /*
+         * after a failure just hand buffers back so the download side never blocks
+         */
+        if ( !http_ota_flash_failed ) {
+            int64_t write_start = esp_timer_get_time();
+            if ( delta ) {
+                if ( delta_patch_feed( delta, buffer.data, buffer.len ) == DELTA_PATCH_ERROR ) {
+                    log_e("delta patch failed: %s", delta->error ? delta->error : "unknown" );
+                    http_ota_flash_failed = true;
+                }
+            }
+            else if ( Update.write( buffer.data, buffer.len ) != buffer.len ) {
+                log_e("flash write failed: %s", Update.errorString() );
+                http_ota_flash_failed = true;
+            }
+            http_ota_flash_us += esp_timer_get_time() - write_start;
+        }
+        xQueueSend( http_ota_free_queue, &buffer, portMAX_DELAY );
+    }
+    xSemaphoreGive( http_ota_flash_done );
+    vTaskDelete( NULL );
+}
+
+/**
+ * @brief check that the patch was made against the running image and start the updater
+ */
+static bool http_ota_delta_begin( uint32_t source_size, const uint8_t *source_md5, uint32_t target_size ) {
+    uint8_t md5[ 16 ];
+    MD5Builder source;
+
+    if ( http_ota_running == NULL || source_size > http_ota_running->size ) {
+        log_e("patch source larger than the running partition");
+        return( false );
+    }
+
+    source.begin();
+    for ( uint32_t offset = 0 ; offset < source_size ; ) {
+        uint8_t chunk[ 512 ];
+        size_t n = min( source_size - offset, (uint32_t)sizeof( chunk ) );
+        if ( esp_partition_read( http_ota_running, offset, chunk, n ) != ESP_OK )
+            return( false );
+        source.add( chunk, n );
+        offset += n;
+    }
+    source.calculate();
+    source.getBytes( md5 );
+    if ( memcmp( md5, source_md5, sizeof( md5 ) ) ) {
+        log_w("patch was made for another firmware");
+        return( false );
+    }
+
+    if ( !Update.begin( target_size, U_FLASH ) ) {
+        log_e("Flashing init ... failed!");
+        return( false );
+    }
+    if ( http_ota_md5 )
+        Update.setMD5( http_ota_md5 );
+    return( true );
+}
+
+static bool http_ota_delta_read( uint32_t offset, uint8_t *data, size_t len ) {
+    return( esp_partition_read( http_ota_running, offset, data, len ) == ESP_OK );
+}
+
+static bool http_ota_delta_write( const uint8_t *data, size_t len ) {
+    if ( Update.write( (uint8_t*)data, len ) != len ) {
+        log_e("flash write failed: %s", Update.errorString() );
+        return( false );
+    }
+    return( true );
+}
+
 bool http_ota_register_cb( EventBits_t event, CALLBACK_FUNC callback_func, const char *id ) {
     if ( http_ota_callback == NULL ) {
         http_ota_callback = callback_init( "http ota" );
@@ -6,10 +6,17 @@
     #define HTTP_OTA_START          _BV(0)      /** @brief http ota start event mask, callback arg is (char*) */
     #define HTTP_OTA_FINISH         _BV(1)      /** @brief http ota finish event mask, callback arg is (char*) */
     #define HTTP_OTA_ERROR          _BV(2)      /** @brief http ota error event mask, callback arg is (char*) */
-    #define HTTP_OTA_PROGRESS       _BV(3)      /** @brief http ota progress event mask, callback arg is (int16_t*) */
-	
+
+    #define HTTP_OTA_BUFFER_SIZE    32768       /** @brief size of each download buffer, allocated in PSRAM */
+    #define HTTP_OTA_BUFFER_NUM     2           /** @brief download buffers, one fills while the other is flashed */
+    #define HTTP_OTA_FLASH_STACK    4096        /** @brief stack size for the flash task */
+    #define HTTP_OTA_READ_TIMEOUT   5000        /** @brief socket stall in ms before the connection is resumed */
+    #define HTTP_OTA_RETRIES        5           /** @brief resume attempts in a row without new data */
+    #define HTTP_OTA_RETRY_DELAY    1000        /** @brief delay before a resume in ms, times the attempt number */
+
     /**
-     * @brief   start an http ota update
+     * @brief   start an http ota update, blocks until finished. a dropped connection
+     *          is resumed with an http range request, the server has to support it
      * 
      * @param   url     pointer to an url
      * @param   md5     pointer to an md5 hash
@@ -17,6 +24,22 @@
      * @return  true if success or false if failed
      */
     bool http_ota_start( const char* url, const char* md5 );
+    /**
+     * @brief   get the progress of the running http ota update
+     *
+     * @return  downloaded percent
+     */
+    int16_t http_ota_get_progress( void );
+    /**
+     * @brief   start a delta ota update, url points to a patch against the running
+     *          firmware made with tools/mkdelta.py. the patch is applied while it downloads
+     *
+     * @param   url     pointer to the patch url
+     * @param   md5     pointer to the md5 hash of the resulting image
+     *
+     * @return  true if success, false if failed or no patch exists, fall back to http_ota_start()
+     */
+    bool http_ota_start_delta( const char* url, const char* md5 );
     /**
      * @brief register an callback function for an http_ota event
      * 
@@ -0,0 +1,153 @@
+/****************************************************************************
+ *   Copyright  2020  Jesper Ortlund
+ ****************************************************************************/
+/*
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+#include <string.h>
+
+#include "i2c_sched.h"
+
+static i2c_sched_txn_t *i2c_sched_push( i2c_sched_t *sched );
+static bool i2c_sched_can_merge( const i2c_sched_txn_t *first, int total, const i2c_sched_txn_t *next );
+
+void i2c_sched_init( i2c_sched_t *sched ) {
+    sched->head = 0;
+    sched->count = 0;
+    sched->dropped = 0;
+}
+
+bool i2c_sched_read( i2c_sched_t *sched, uint8_t addr, uint8_t reg, uint8_t *data, uint16_t len, uint8_t flags, I2C_SCHED_CB cb, void *arg ) {
+    i2c_sched_txn_t *txn = i2c_sched_push( sched );
+
+    if ( txn == NULL )
+        return( false );
+
+    txn->addr = addr;
+    txn->reg = reg;
+    txn->write = false;
+    txn->flags = flags;
+    txn->len = len;
+    txn->data = data;
+    txn->cb = cb;
+    txn->arg = arg;
+    return( true );
+}
+
+bool i2c_sched_write( i2c_sched_t *sched, uint8_t addr, uint8_t reg, const uint8_t *data, uint16_t len, I2C_SCHED_CB cb, void *arg ) {
+    i2c_sched_txn_t *txn = i2c_sched_push( sched );
+
+    if ( txn == NULL )
+        return( false );
+
+    txn->addr = addr;
+    txn->reg = reg;
+    txn->write = true;
+    txn->flags = 0;
+    txn->len = len;
+    /*
+     * small writes are copied, the slot is copied again on take, so no pointer into it is kept
+     */
+    if ( len <= I2C_SCHED_INLINE ) {
+        memcpy( txn->inline_data, data, len );
+        txn->data = NULL;
+    }
+    else {
+        txn->data = (uint8_t *)data;
+    }
+    txn->cb = cb;
+    txn->arg = arg;
+    return( true );
+}
+
+int i2c_sched_take( i2c_sched_t *sched, i2c_sched_txn_t *batch, int max ) {
+    int num = 0;
+
+    while ( sched->count > 0 && num < max ) {
+        batch[ num++ ] = sched->txn[ sched->head ];
+        sched->head = ( sched->head + 1 ) % I2C_SCHED_QUEUE_LEN;
+        sched->count--;
+    }
+    return( num );
+}
+
+int i2c_sched_run( i2c_sched_txn_t *batch, int num, const i2c_sched_bus_t *bus ) {
+    uint8_t burst[ I2C_SCHED_BURST_MAX ];
+    int transfers = 0;
+    int i = 0;
+
+    while ( i < num ) {
+        i2c_sched_txn_t *txn = &batch[ i ];
+        int result;
+
+        if ( txn->write ) {
+            result = bus->write( txn->addr, txn->reg, txn->data ? txn->data : txn->inline_data, txn->len, bus->arg );
+            transfers++;
+            if ( txn->cb )
+                txn->cb( result, txn->arg );
+            i++;
+            continue;
+        }
+
+        /*
+         * collect the reads that continue where the one before ended
+         */
+        int total = txn->len;
+        int last = i;
+        while ( last + 1 < num && i2c_sched_can_merge( txn, total, &batch[ last + 1 ] ) ) {
+            last++;
+            total += batch[ last ].len;
+        }
+
+        if ( last == i ) {
+            result = bus->read( txn->addr, txn->reg, txn->data, txn->len, bus->arg );
+        }
+        else {
+            result = bus->read( txn->addr, txn->reg, burst, total, bus->arg );
+            int offset = 0;
+            for ( int j = i ; j <= last ; j++ ) {
+                if ( result == 0 )
+                    memcpy( batch[ j ].data, &burst[ offset ], batch[ j ].len );
+                offset += batch[ j ].len;
+            }
+        }
+        transfers++;
+
+        for ( int j = i ; j <= last ; j++ ) {
+            if ( batch[ j ].cb )
+                batch[ j ].cb( result, batch[ j ].arg );
+        }
+        i = last + 1;
+    }
+    return( transfers );
+}
+
+static i2c_sched_txn_t *i2c_sched_push( i2c_sched_t *sched ) {
+    if ( sched->count == I2C_SCHED_QUEUE_LEN ) {
+        sched->dropped++;
+        return( NULL );
+    }
+    return( &sched->txn[ ( sched->head + sched->count++ ) % I2C_SCHED_QUEUE_LEN ] );
+}
+
+static bool i2c_sched_can_merge( const i2c_sched_txn_t *first, int total, const i2c_sched_txn_t *next ) {
+    if ( next->write || next->addr != first->addr )
+        return( false );
+    if ( ( first->flags | next->flags ) & I2C_SCHED_NO_BURST )
+        return( false );
+    if ( next->reg != first->reg + total )
+        return( false );
+    return( total + next->len <= I2C_SCHED_BURST_MAX );
+}
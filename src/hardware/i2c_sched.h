@@ -0,0 +1,136 @@
+/****************************************************************************
+ *   Copyright  2020  Jesper Ortlund
+ ****************************************************************************/
+/*
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+#ifndef _I2C_SCHED_H
+    #define _I2C_SCHED_H
+
+    /*
+     * no arduino in here, the scheduler builds and runs on the host against a mock bus
+     */
+    #include <stdint.h>
+    #include <stddef.h>
+
+    #define I2C_SCHED_QUEUE_LEN         16          /** @brief max queued transactions */
+    #define I2C_SCHED_INLINE            8           /** @brief writes up to this size are copied, the caller may reuse its buffer */
+    #define I2C_SCHED_BURST_MAX         64          /** @brief max bytes of one merged burst read, fits into the wire buffer */
+
+    #define I2C_SCHED_NO_BURST          ( 1 << 0 )  /** @brief never merge this read with its neighbours, for fifo registers that don't auto increment */
+
+    /**
+     * @brief completion callback, runs in the task that executes the batch and may submit more transactions
+     *
+     * @param   result      0 on success, the error from the bus otherwise
+     * @param   arg         arg given on submit
+     */
+    typedef void ( * I2C_SCHED_CB ) ( int result, void *arg );
+
+    /**
+     * @brief one queued register transaction
+     */
+    typedef struct {
+        uint8_t addr;                               /** @brief 7 bit device address */
+        uint8_t reg;                                /** @brief first register */
+        bool write;                                 /** @brief write instead of read */
+        uint8_t flags;                              /** @brief I2C_SCHED_NO_BURST */
+        uint16_t len;                               /** @brief bytes to transfer */
+        uint8_t *data;                              /** @brief read target, or write source, NULL when inline_data holds the write */
+        uint8_t inline_data[ I2C_SCHED_INLINE ];    /** @brief copy of a small write */
+        I2C_SCHED_CB cb;                            /** @brief completion callback or NULL */
+        void *arg;                                  /** @brief callback arg */
+    } i2c_sched_txn_t;
+
+    /**
+     * @brief the bus a batch runs on, both return 0 on success
+     */
+    typedef struct {
+        int ( *read )( uint8_t addr, uint8_t reg, uint8_t *data, uint16_t len, void *arg );
+        int ( *write )( uint8_t addr, uint8_t reg, const uint8_t *data, uint16_t len, void *arg );
+        void *arg;                                  /** @brief arg for read and write */
+    } i2c_sched_bus_t;
+
+    /**
+     * @brief transaction queue, not locked, the caller has to serialize submit and take
+     * when they run in different tasks. i2c_sched_run() works on a taken batch and needs no lock
+     */
+    typedef struct {
+        i2c_sched_txn_t txn[ I2C_SCHED_QUEUE_LEN ];
+        uint16_t head;                              /** @brief next transaction to take */
+        uint16_t count;                             /** @brief queued transactions */
+        uint32_t dropped;                           /** @brief transactions refused on a full queue */
+    } i2c_sched_t;
+
+    /**
+     * @brief setup an empty queue
+     *
+     * @param   sched       pointer to the i2c_sched_t to setup
+     */
+    void i2c_sched_init( i2c_sched_t *sched );
+    /**
+     * @brief queue a register read
+     *
+     * @param   sched       pointer to an initialized i2c_sched_t
+     * @param   addr        device address
+     * @param   reg         first register
+     * @param   data        read target, must stay valid until the callback
+     * @param   len         bytes to read
+     * @param   flags       0 or I2C_SCHED_NO_BURST
+     * @param   cb          completion callback or NULL
+     * @param   arg         callback arg
+     *
+     * @return  true if queued, false if the queue is full
+     */
+    bool i2c_sched_read( i2c_sched_t *sched, uint8_t addr, uint8_t reg, uint8_t *data, uint16_t len, uint8_t flags, I2C_SCHED_CB cb, void *arg );
+    /**
+     * @brief queue a register write
+     *
+     * @param   sched       pointer to an initialized i2c_sched_t
+     * @param   addr        device address
+     * @param   reg         first register
+     * @param   data        bytes to write, up to I2C_SCHED_INLINE they are copied, above that
+     *                      they have to stay valid until the callback
+     * @param   len         bytes to write
+     * @param   cb          completion callback or NULL
+     * @param   arg         callback arg
+     *
+     * @return  true if queued, false if the queue is full
+     */
+    bool i2c_sched_write( i2c_sched_t *sched, uint8_t addr, uint8_t reg, const uint8_t *data, uint16_t len, I2C_SCHED_CB cb, void *arg );
+    /**
+     * @brief move the queued transactions into a batch, oldest first
+     *
+     * @param   sched       pointer to an initialized i2c_sched_t
+     * @param   batch       pointer to max transactions
+     * @param   max         batch size
+     *
+     * @return  number of transactions taken
+     */
+    int i2c_sched_take( i2c_sched_t *sched, i2c_sched_txn_t *batch, int max );
+    /**
+     * @brief execute a batch in order and call the completion callbacks. reads of adjacent
+     * registers on the same device that follow each other are merged into one burst read,
+     * an error of the burst is reported to every transaction in it
+     *
+     * @param   batch       pointer to the transactions
+     * @param   num         number of transactions
+     * @param   bus         bus to run on
+     *
+     * @return  number of bus transfers
+     */
+    int i2c_sched_run( i2c_sched_txn_t *batch, int num, const i2c_sched_bus_t *bus );
+
+#endif // _I2C_SCHED_H
@@ -0,0 +1,134 @@
+/****************************************************************************
+ *   Copyright  2020  Jesper Ortlund
+ ****************************************************************************/
+/*
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+#include "config.h"
+#include <TTGO.h>
+
+#include "i2cctl.h"
+#include "metrics.h"
+
+static i2c_sched_t i2cctl_sched;
+static volatile bool i2cctl_busy = false;
+portMUX_TYPE DRAM_ATTR i2cctlMux = portMUX_INITIALIZER_UNLOCKED;
+TaskHandle_t _i2cctl_Task = NULL;
+
+static void i2cctl_Task( void * pvParameters );
+static int i2cctl_bus_read( uint8_t addr, uint8_t reg, uint8_t *data, uint16_t len, void *arg );
+static int i2cctl_bus_write( uint8_t addr, uint8_t reg, const uint8_t *data, uint16_t len, void *arg );
+
+static const i2c_sched_bus_t i2cctl_bus = { i2cctl_bus_read, i2cctl_bus_write, NULL };
+
+void i2cctl_setup( void ) {
+    if ( _i2cctl_Task != NULL )
+        return;
+
+    i2c_sched_init( &i2cctl_sched );
+
+    xTaskCreatePinnedToCore(    i2cctl_Task,            /* Function to implement the task */
+                                "i2cctl Task",          /* Name of the task */
+                                I2CCTL_TASK_STACK,      /* Stack size in words */
+                                NULL,                   /* Task input parameter */
+                                2,                      /* Priority of the task */
+                                &_i2cctl_Task,          /* Task handle. */
+                                1 );
+}
+
+bool i2cctl_read( uint8_t addr, uint8_t reg, uint8_t *data, uint16_t len, uint8_t flags, I2C_SCHED_CB cb, void *arg ) {
+    portENTER_CRITICAL( &i2cctlMux );
+    bool queued = i2c_sched_read( &i2cctl_sched, addr, reg, data, len, flags, cb, arg );
+    portEXIT_CRITICAL( &i2cctlMux );
+
+    if ( !queued )
+        log_w("i2c queue full, read 0x%02x:0x%02x dropped", addr, reg );
+    else if ( _i2cctl_Task )
+        xTaskNotifyGive( _i2cctl_Task );
+    return( queued );
+}
+
+bool i2cctl_write( uint8_t addr, uint8_t reg, const uint8_t *data, uint16_t len, I2C_SCHED_CB cb, void *arg ) {
+    portENTER_CRITICAL( &i2cctlMux );
+    bool queued = i2c_sched_write( &i2cctl_sched, addr, reg, data, len, cb, arg );
+    portEXIT_CRITICAL( &i2cctlMux );
+
+    if ( !queued )
+        log_w("i2c queue full, write 0x%02x:0x%02x dropped", addr, reg );
+    else if ( _i2cctl_Task )
+        xTaskNotifyGive( _i2cctl_Task );
+    return( queued );
+}
+
+bool i2cctl_sync( uint32_t timeout_ms ) {
+    uint64_t timeout = millis() + timeout_ms;
+
+    while( true ) {
+        portENTER_CRITICAL( &i2cctlMux );
+        bool idle = i2cctl_sched.count == 0 && !i2cctl_busy;
+        portEXIT_CRITICAL( &i2cctlMux );
+
+        if ( idle )
+            return( true );
+        if ( millis() >= timeout )
+            return( false );
+        vTaskDelay( 1 );
+    }
+}
+
+/**
+ * @brief takes everything queued in one go and runs it without holding the queue lock,
+ * the callbacks can queue the next step right away
+ */
+static void i2cctl_Task( void * pvParameters ) {
+    i2c_sched_txn_t batch[ I2C_SCHED_QUEUE_LEN ];
+
+    log_i("start i2cctl task, heap: %d", ESP.getFreeHeap() );
+    while( true ) {
+        ulTaskNotifyTake( pdTRUE, portMAX_DELAY );
+        while( true ) {
+            portENTER_CRITICAL( &i2cctlMux );
+            int num = i2c_sched_take( &i2cctl_sched, batch, I2C_SCHED_QUEUE_LEN );
+            i2cctl_busy = num != 0;
+            portEXIT_CRITICAL( &i2cctlMux );
+
+            if ( num == 0 )
+                break;
+            i2c_sched_run( batch, num, &i2cctl_bus );
+        }
+    }
+}
+
+/*
+ * each transfer is timed with the wait for the bus lock, a long wait means the
+ * TTGO library held the bus from another task
+ */
+static int i2cctl_bus_read( uint8_t addr, uint8_t reg, uint8_t *data, uint16_t len, void *arg ) {
+    TTGOClass *ttgo = TTGOClass::getWatch();
+    int64_t start = esp_timer_get_time();
+
+    int ret = ttgo->i2c->readBytes( addr, reg, data, len );
+    metrics_sample_since( METRICS_I2C_US, start );
+    return( ret );
+}
+
+static int i2cctl_bus_write( uint8_t addr, uint8_t reg, const uint8_t *data, uint16_t len, void *arg ) {
+    TTGOClass *ttgo = TTGOClass::getWatch();
+    int64_t start = esp_timer_get_time();
+
+    int ret = ttgo->i2c->writeBytes( addr, reg, (uint8_t *)data, len );
+    metrics_sample_since( METRICS_I2C_US, start );
+    return( ret );
+}
@@ -0,0 +1,54 @@
+/****************************************************************************
+ *   Copyright  2020  Jesper Ortlund
+ ****************************************************************************/
+/*
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+#ifndef _I2CCTL_H
+    #define _I2CCTL_H
+
+    #include "TTGO.h"
+    #include "i2c_sched.h"
+
+    #define I2CCTL_TASK_STACK           2500        /** @brief service task stack in words */
+
+    /**
+     * @brief start the i2c service task, it owns the queued transactions on the watch bus.
+     * direct calls into the TTGO library still work, the bus lock in I2C_Bus keeps them apart
+     */
+    void i2cctl_setup( void );
+    /**
+     * @brief queue a register read and return at once, see i2c_sched_read
+     *
+     * @return  true if queued, false if the queue is full
+     */
+    bool i2cctl_read( uint8_t addr, uint8_t reg, uint8_t *data, uint16_t len, uint8_t flags, I2C_SCHED_CB cb, void *arg );
+    /**
+     * @brief queue a register write and return at once, see i2c_sched_write
+     *
+     * @return  true if queued, false if the queue is full
+     */
+    bool i2cctl_write( uint8_t addr, uint8_t reg, const uint8_t *data, uint16_t len, I2C_SCHED_CB cb, void *arg );
+    /**
+     * @brief wait until everything queued so far and the callbacks are done, for setup code
+     * that needs the result before it goes on. not from a completion callback
+     *
+     * @param   timeout_ms  max wait in ms
+     *
+     * @return  true if idle, false on timeout
+     */
+    bool i2cctl_sync( uint32_t timeout_ms );
+
+#endif // _I2CCTL_H
@@ -0,0 +1,122 @@
+/****************************************************************************
+ * 2020 Jesper Ortlund
+ * KingSong decoding derived from Wheellog
+ ****************************************************************************/
+
+/****************************************************************************
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *****************************************************************************/
+
+#include <string.h>
+
+#include "ks_model.h"
+
+/**************************************************
+   Wheel model table
+   models sit in the slot their name hashes to, so a lookup is one
+   hash and one strcmp. when adding a model, put it in its slot or
+   pick a new KS_MODEL_SEED with tools/ksmodelseed.py, the
+   static_assert below refuses tables that don't match
+ **************************************************/
+#define KS_MODEL_SLOT_BITS  4
+#define KS_MODEL_SLOTS      (1 << KS_MODEL_SLOT_BITS)
+#define KS_MODEL_SEED       5
+
+const ks_model_t ks_default_model = {"KS", 35, 65, 50, 67, 40, 30};
+
+static constexpr ks_model_t ks_model_table[KS_MODEL_SLOTS] = {
+    {"KS-18A", 45, 65, 50, 84, 25, 35},     // 0
+    {"KS-18L", 50, 65, 50, 84, 25, 50},     // 1
+    {"KS-16X", 45, 65, 50, 84, 25, 50},     // 2
+    {"KS-16S", 40, 65, 50, 67, 25, 35},     // 3
+    {NULL, 0, 0, 0, 0, 0, 0},               // 4
+    {NULL, 0, 0, 0, 0, 0, 0},               // 5
+    {NULL, 0, 0, 0, 0, 0, 0},               // 6
+    {NULL, 0, 0, 0, 0, 0, 0},               // 7
+    {NULL, 0, 0, 0, 0, 0, 0},               // 8
+    {"KS-S18", 45, 65, 50, 84, 25, 50},     // 9
+    {"KS-18XL", 50, 65, 50, 84, 25, 50},    // 10
+    {NULL, 0, 0, 0, 0, 0, 0},               // 11
+    {"KS-14D", 35, 65, 50, 67, 40, 30},     // 12
+    {"KS-14M", 35, 65, 50, 67, 25, 30},     // 13
+    {"KS-14S", 35, 65, 50, 67, 25, 30},     // 14
+    {NULL, 0, 0, 0, 0, 0, 0},               // 15
+};
+
+// FNV-1a, the upper bits are used as slot, the lower ones mix poorly
+static constexpr uint32_t ks_model_hash(const char *name, uint32_t hash = KS_MODEL_SEED)
+{
+    return (*name ? ks_model_hash(name + 1, (hash ^ (uint8_t)*name) * 16777619u) : hash);
+}
+
+static constexpr uint32_t ks_model_slot(const char *name)
+{
+    return (ks_model_hash(name) >> (32 - KS_MODEL_SLOT_BITS));
+}
+
+static constexpr bool ks_model_table_ok(uint32_t slot = 0)
+{
+    return (slot == KS_MODEL_SLOTS || ((ks_model_table[slot].name == NULL || ks_model_slot(ks_model_table[slot].name) == slot) && ks_model_table_ok(slot + 1)));
+}
+
+static_assert(ks_model_table_ok(), "ks_model_table: a model is not in its hash slot, fix the slot or KS_MODEL_SEED");
+
+const ks_model_t *ks_model_find(const char *model)
+{
+    const ks_model_t *entry = &ks_model_table[ks_model_slot(model)];
+
+    if (entry->name && !strcmp(entry->name, model))
+        return (entry);
+    return (NULL);
+}
+
+/**************************************************
+   Name frame, "KS-16X-0215": model is everything
+   before the last dash, the rest is the firmware
+ **************************************************/
+const ks_model_t *ks_model_decode_name(const uint8_t *frame, char *name)
+{
+    char model[KS_NAME_LEN + 1];
+    int len = 0;
+
+    while (len < KS_NAME_LEN && frame[len + 2] != 0)
+    {
+        name[len] = frame[len + 2];
+        len++;
+    }
+    name[len] = '\0';
+
+    memcpy(model, name, len + 1);
+    char *dash = strrchr(model, '-');
+    if (dash && dash != model)
+        *dash = '\0';
+
+    // a name without firmware part, like "KS-18L", is the model itself
+    const ks_model_t *entry = ks_model_find(model);
+    if (entry == NULL && dash)
+        entry = ks_model_find(name);
+    return (entry);
+}
+
+/**************************************************
+   Serial frame, 14 bytes from offset 2 and the last
+   3 behind the frame type at offset 16
+ **************************************************/
+void ks_model_decode_serial(const uint8_t *frame, char *serial)
+{
+    memcpy(serial, &frame[2], 14);
+    memcpy(&serial[14], &frame[17], 3);
+    serial[KS_SERIAL_LEN] = '\0';
+}
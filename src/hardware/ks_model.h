@@ -0,0 +1,75 @@
+/****************************************************************************
+ * 2020 Jesper Ortlund
+ * KingSong decoding derived from Wheellog
+ ****************************************************************************/
+
+/****************************************************************************
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *****************************************************************************/
+
+#ifndef __KS_MODEL_H
+#define __KS_MODEL_H
+
+/*
+ * no arduino in here, the model table and the name/serial frames build and run on the host
+ */
+#include <stdint.h>
+
+#define KS_NAME_LEN     14      /** @brief max wheel name length in the 0xbb name frame */
+#define KS_SERIAL_LEN   17      /** @brief serial number length in the 0xb3 serial frame */
+
+/**
+ * @brief limits of a wheel model
+ */
+typedef struct
+{
+    const char *name;   // model part of the wheel name, NULL for a free slot
+    uint8_t maxcurrent; // A
+    uint8_t crittemp;   // C
+    uint8_t warntemp;   // C
+    uint8_t battvolt;   // V, full pack
+    uint8_t battwarn;   // % remaining
+    uint8_t maxspeed;   // km/h, rated top speed
+} ks_model_t;
+
+/**
+ * @brief limits for wheels that are not in the model table
+ */
+extern const ks_model_t ks_default_model;
+
+/**
+ * @brief find a model by the model part of its name, like "KS-16X"
+ *
+ * @return  pointer to the model or NULL if unknown
+ */
+const ks_model_t *ks_model_find(const char *model);
+/**
+ * @brief copy the wheel name out of a 0xbb name frame and find its model
+ *
+ * @param   frame   20 byte name frame
+ * @param   name    KS_NAME_LEN + 1 bytes for the name, like "KS-16X-0215"
+ *
+ * @return  pointer to the model or NULL if unknown
+ */
+const ks_model_t *ks_model_decode_name(const uint8_t *frame, char *name);
+/**
+ * @brief copy the serial number out of a 0xb3 serial frame
+ *
+ * @param   frame   20 byte serial frame
+ * @param   serial  KS_SERIAL_LEN + 1 bytes for the serial
+ */
+void ks_model_decode_serial(const uint8_t *frame, char *serial);
+
+#endif /* __KS_MODEL_H */
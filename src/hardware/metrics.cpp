@@ -0,0 +1,120 @@
+/****************************************************************************
+ *   Copyright  2020  Jesper Ortlund
+ ****************************************************************************/
+/*
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+#include "config.h"
+#include <TTGO.h>
+
+#include "metrics.h"
+#include "powermgm.h"
+
+uint32_t metrics_counter[ METRICS_COUNTER_NUM ];
+int32_t metrics_gauge[ METRICS_GAUGE_NUM ];
+metrics_histogram_t metrics_histogram[ METRICS_HIST_NUM ];
+
+static const char *metrics_counter_name[ METRICS_COUNTER_NUM ] = { "ble frames", "ble dropped", "relay dropped" };
+static const char *metrics_gauge_name[ METRICS_GAUGE_NUM ] = { "heap free", "heap min free", "psram free", "framerate" };
+static const char *metrics_histogram_name[ METRICS_HIST_NUM ] = { "decode", "loop", "render", "flush", "i2c" };
+
+static uint64_t metrics_next_gauge = 0;
+
+bool metrics_powermgm_event_cb( EventBits_t event, void *arg );
+bool metrics_powermgm_loop_cb( EventBits_t event, void *arg );
+static void metrics_update_gauges( void );
+
+void metrics_setup( void ) {
+    metrics_update_gauges();
+    powermgm_register_cb( POWERMGM_STANDBY, metrics_powermgm_event_cb, "metrics" );
+    powermgm_register_loop_cb( POWERMGM_STANDBY | POWERMGM_SILENCE_WAKEUP | POWERMGM_WAKEUP, metrics_powermgm_loop_cb, "metrics loop" );
+}
+
+bool metrics_powermgm_event_cb( EventBits_t event, void *arg ) {
+    switch( event ) {
+        case POWERMGM_STANDBY:          metrics_update_gauges();
+                                        metrics_print();
+                                        break;
+    }
+    return( true );
+}
+
+bool metrics_powermgm_loop_cb( EventBits_t event, void *arg ) {
+    if ( metrics_next_gauge < millis() ) {
+        metrics_next_gauge = millis() + METRICS_GAUGE_INTERVAL;
+        metrics_update_gauges();
+    }
+    return( true );
+}
+
+static void metrics_update_gauges( void ) {
+    metrics_set_gauge( METRICS_HEAP_FREE, heap_caps_get_free_size( MALLOC_CAP_INTERNAL ) );
+    metrics_set_gauge( METRICS_HEAP_MIN_FREE, heap_caps_get_minimum_free_size( MALLOC_CAP_INTERNAL ) );
+    metrics_set_gauge( METRICS_PSRAM_FREE, heap_caps_get_free_size( MALLOC_CAP_SPIRAM ) );
+}
+
+const char *metrics_get_counter_name( int counter ) {
+    if ( counter < 0 || counter >= METRICS_COUNTER_NUM )
+        return( "" );
+    return( metrics_counter_name[ counter ] );
+}
+
+const char *metrics_get_gauge_name( int gauge ) {
+    if ( gauge < 0 || gauge >= METRICS_GAUGE_NUM )
+        return( "" );
+    return( metrics_gauge_name[ gauge ] );
+}
+
+const char *metrics_get_histogram_name( int hist ) {
+    if ( hist < 0 || hist >= METRICS_HIST_NUM )
+        return( "" );
+    return( metrics_histogram_name[ hist ] );
+}
+
+uint32_t metrics_get_percentile( int hist, int percent ) {
+    return( metrics_histogram_percentile( &metrics_histogram[ hist ], percent ) );
+}
+
+uint32_t metrics_histogram_percentile( const metrics_histogram_t *histogram, int percent ) {
+    uint32_t rank = ( (uint64_t)histogram->count * percent + 99 ) / 100;
+    uint32_t seen = 0;
+
+    if ( histogram->count == 0 )
+        return( 0 );
+
+    for ( int bucket = 0 ; bucket < METRICS_HIST_BUCKETS - 1 ; bucket++ ) {
+        seen += histogram->bucket[ bucket ];
+        if ( seen >= rank )
+            return( min( (uint32_t)( 1 << bucket ), histogram->max ) );
+    }
+    return( histogram->max );
+}
+
+void metrics_print( void ) {
+    Serial.printf("metrics:\r\n");
+    for ( int counter = 0 ; counter < METRICS_COUNTER_NUM ; counter++ ) {
+        Serial.printf("  %-14s %10u\r\n", metrics_counter_name[ counter ], metrics_counter[ counter ] );
+    }
+    for ( int gauge = 0 ; gauge < METRICS_GAUGE_NUM ; gauge++ ) {
+        Serial.printf("  %-14s %10d\r\n", metrics_gauge_name[ gauge ], metrics_gauge[ gauge ] );
+    }
+    for ( int hist = 0 ; hist < METRICS_HIST_NUM ; hist++ ) {
+        Serial.printf("  %-14s n %8u p50 %6uus p99 %6uus max %6uus\r\n", metrics_histogram_name[ hist ],
+                                                                        metrics_histogram[ hist ].count,
+                                                                        metrics_get_percentile( hist, 50 ),
+                                                                        metrics_get_percentile( hist, 99 ),
+                                                                        metrics_histogram[ hist ].max );
+    }
+}
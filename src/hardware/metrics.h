@@ -0,0 +1,164 @@
+/****************************************************************************
+ *   Copyright  2020  Jesper Ortlund
+ ****************************************************************************/
+/*
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+#ifndef _METRICS_H
+    #define _METRICS_H
+
+    #include <TTGO.h>
+
+    #define METRICS_HIST_BUCKETS        16          /** @brief histogram buckets, bucket n holds samples < 2^n us, the last one everything above */
+    #define METRICS_GAUGE_INTERVAL      1000        /** @brief ms between heap gauge updates */
+
+    /**
+     * @brief counters, only ever go up
+     */
+    enum {
+        METRICS_BLE_FRAMES,                         /** @brief wheel notifications received */
+        METRICS_BLE_DROPPED,                        /** @brief wheel notifications not decoded, bad length or header */
+        METRICS_RELAY_DROPPED,                      /** @brief frames lost to a full relay queue */
+        METRICS_COUNTER_NUM
+    };
+
+    /**
+     * @brief gauges, last value wins
+     */
+    enum {
+        METRICS_HEAP_FREE,                          /** @brief free internal heap in bytes */
+        METRICS_HEAP_MIN_FREE,                      /** @brief lowest free internal heap since boot in bytes */
+        METRICS_PSRAM_FREE,                         /** @brief free psram in bytes */
+        METRICS_FRAMERATE,                          /** @brief display flushes in the last second */
+        METRICS_GAUGE_NUM
+    };
+
+    /**
+     * @brief latency histograms in us
+     */
+    enum {
+        METRICS_DECODE_US,                          /** @brief wheel frame decode */
+        METRICS_LOOP_US,                            /** @brief one main loop iteration, without the standby delay */
+        METRICS_RENDER_US,                          /** @brief lv_task_handler including flushes */
+        METRICS_FLUSH_US,                           /** @brief one display flush */
+        METRICS_I2C_US,                             /** @brief one i2c transfer of the i2c service task including bus lock wait */
+        METRICS_HIST_NUM
+    };
+
+    /**
+     * @brief latency histogram
+     */
+    typedef struct {
+        uint32_t count;                             /** @brief samples taken */
+        uint32_t max;                               /** @brief largest sample in us */
+        uint32_t bucket[ METRICS_HIST_BUCKETS ];    /** @brief samples per power of two bucket */
+    } metrics_histogram_t;
+
+    extern uint32_t metrics_counter[ METRICS_COUNTER_NUM ];
+    extern int32_t metrics_gauge[ METRICS_GAUGE_NUM ];
+    extern metrics_histogram_t metrics_histogram[ METRICS_HIST_NUM ];
+
+    /**
+     * @brief setup the heap gauges and the serial dump on standby
+     */
+    void metrics_setup( void );
+    /**
+     * @brief count an event, safe from any task or core
+     *
+     * @param   counter     METRICS_BLE_FRAMES ...
+     */
+    static inline void metrics_count( int counter ) {
+        __atomic_fetch_add( &metrics_counter[ counter ], 1, __ATOMIC_RELAXED );
+    }
+    /**
+     * @brief set a gauge
+     *
+     * @param   gauge       METRICS_HEAP_FREE ...
+     * @param   value       new value
+     */
+    static inline void metrics_set_gauge( int gauge, int32_t value ) {
+        __atomic_store_n( &metrics_gauge[ gauge ], value, __ATOMIC_RELAXED );
+    }
+    /**
+     * @brief add a latency sample to a histogram, safe from any task or core,
+     * max may miss a sample when two cores race on the same histogram
+     *
+     * @param   histogram   pointer to a metrics_histogram_t
+     * @param   us          latency in us
+     */
+    static inline void metrics_histogram_add( metrics_histogram_t *histogram, uint32_t us ) {
+        int bucket = us ? 32 - __builtin_clz( us ) : 0;
+
+        if ( bucket >= METRICS_HIST_BUCKETS )
+            bucket = METRICS_HIST_BUCKETS - 1;
+        __atomic_fetch_add( &histogram->bucket[ bucket ], 1, __ATOMIC_RELAXED );
+        __atomic_fetch_add( &histogram->count, 1, __ATOMIC_RELAXED );
+        if ( us > histogram->max )
+            histogram->max = us;
+    }
+    /**
+     * @brief add a latency sample
+     *
+     * @param   hist        METRICS_DECODE_US ...
+     * @param   us          latency in us
+     */
+    static inline void metrics_sample( int hist, uint32_t us ) {
+        metrics_histogram_add( &metrics_histogram[ hist ], us );
+    }
+    /**
+     * @brief add the time since start as latency sample
+     *
+     * @param   hist        METRICS_DECODE_US ...
+     * @param   start       start time from esp_timer_get_time()
+     */
+    static inline void metrics_sample_since( int hist, int64_t start ) {
+        metrics_sample( hist, esp_timer_get_time() - start );
+    }
+    /**
+     * @brief get a counter name
+     */
+    const char *metrics_get_counter_name( int counter );
+    /**
+     * @brief get a gauge name
+     */
+    const char *metrics_get_gauge_name( int gauge );
+    /**
+     * @brief get a histogram name
+     */
+    const char *metrics_get_histogram_name( int hist );
+    /**
+     * @brief estimate a percentile from the histogram buckets
+     *
+     * @param   hist        METRICS_DECODE_US ...
+     * @param   percent     percentile, 50 for the median
+     *
+     * @return  upper bound of the bucket holding the percentile in us, 0 if no samples
+     */
+    uint32_t metrics_get_percentile( int hist, int percent );
+    /**
+     * @brief estimate a percentile from any histogram, see metrics_get_percentile
+     *
+     * @param   histogram   pointer to a metrics_histogram_t
+     * @param   percent     percentile, 50 for the median
+     *
+     * @return  upper bound of the bucket holding the percentile in us, 0 if no samples
+     */
+    uint32_t metrics_histogram_percentile( const metrics_histogram_t *histogram, int percent );
+    /**
+     * @brief dump all metrics to serial
+     */
+    void metrics_print( void );
+
+#endif // _METRICS_H
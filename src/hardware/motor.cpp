@@ -21,6 +21,7 @@
  */
 #include "config.h"
 #include <TTGO.h>
+#include "configstore.h"
 #include "json_psram_allocator.h"
 
 #include "motor.h"
@@ -83,6 +84,17 @@ void motor_set_vibe_config( bool enable ) {
 }
 
 void motor_save_config( void ) {
+    configstore_save( CONFIGSTORE_MOTOR );
+}
+
+void motor_read_config( void ) {
+    if ( !configstore_register( CONFIGSTORE_MOTOR, &motor_config, sizeof( motor_config ), motor_read_json_config, motor_save_json_config ) ) {
+        motor_read_json_config();
+        motor_save_config();
+    }
+}
+
+void motor_save_json_config( void ) {
     fs::File file = SPIFFS.open( MOTOR_JSON_CONFIG_FILE, FILE_WRITE );
 
     if (!file) {
@@ -91,7 +103,7 @@ void motor_save_config( void ) {
     else {
         SpiRamJsonDocument doc( 1000 );
 
-        doc["motor"] = motor_config.vibe;
+        motor_config_to_json( &motor_config, doc.to<JsonObject>() );
 
         if ( serializeJsonPretty( doc, file ) == 0) {
             log_e("Failed to write config file");
@@ -101,7 +113,7 @@ void motor_save_config( void ) {
     file.close();
 }
 
-void motor_read_config( void ) {
+void motor_read_json_config( void ) {
     fs::File file = SPIFFS.open( MOTOR_JSON_CONFIG_FILE, FILE_READ );
     if (!file) {
         log_e("Can't open file: %s!", MOTOR_JSON_CONFIG_FILE );
@@ -115,7 +127,7 @@ void motor_read_config( void ) {
             log_e("update check deserializeJson() failed: %s", error.c_str() );
         }
         else {
-            motor_config.vibe = doc["motor"].as<bool>();
+            motor_config_from_json( &motor_config, doc.as<JsonObjectConst>() );
         }        
         doc.clear();
     }
@@ -23,16 +23,10 @@
     #define _MOTOR_H
 
     #include "TTGO.h"
+    #include "motor_config.h"
 
     #define MOTOR_JSON_CONFIG_FILE  "/motor.json"           /** @brief defines binary config file name */
 
-    /**
-     * @brief motor config structure in memory
-     */
-    typedef struct {
-        bool vibe = true;           /** @brief vibe config item, true if vibe enabled, false if disabled */
-    } motor_config_t;
-
     /**
      * @brief setup motor I/O
      */
@@ -65,5 +59,13 @@
      * @brief   read the configuration from SPIFFS
      */
     void motor_read_config( void );
+    /**
+     * @brief write the config as legacy json file to spiffs
+     */
+    void motor_save_json_config( void );
+    /**
+     * @brief import the config from the legacy json file on spiffs
+     */
+    void motor_read_json_config( void );
 
 #endif // _MOTOR_H
\ No newline at end of file
@@ -0,0 +1,52 @@
+/****************************************************************************
+ *   Copyright  2020  Jesper Ortlund
+ ****************************************************************************/
+/*
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+#ifndef _MOTOR_CONFIG_H
+    #define _MOTOR_CONFIG_H
+
+    /*
+     * no arduino or spiffs in here, the config and its json mapping build and run on the host
+     */
+    #include <ArduinoJson.h>
+
+
+    /**
+     * @brief motor config structure, stored as is in the config store. only append
+     * fields, never reorder or resize them
+     */
+    typedef struct {
+        bool vibe = true;           /** @brief vibe config item, true if vibe enabled, false if disabled */
+    } motor_config_t;
+
+    /**
+     * @brief fill the motor config from the legacy json, a missing key turns the vibe off
+     * like the json reader always did
+     *
+     * @param   config      pointer to the config
+     * @param   json        root object of motor.json
+     */
+    void motor_config_from_json( motor_config_t *config, JsonObjectConst json );
+    /**
+     * @brief write the motor config as legacy json
+     *
+     * @param   config      pointer to the config
+     * @param   json        root object to fill
+     */
+    void motor_config_to_json( const motor_config_t *config, JsonObject json );
+
+#endif // _MOTOR_CONFIG_H
@@ -0,0 +1,394 @@
+/****************************************************************************
+ *   Copyright  2020  Jesper Ortlund
+ ****************************************************************************/
+/*
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+#include "config.h"
+#include <Arduino.h>
+#include <WiFi.h>
+#include <PubSubClient.h>
+#include <time.h>
+
+#include "mqttctl.h"
+#include "wheelctl.h"
+#include "blectl.h"
+#include "configstore.h"
+#include "json_psram_allocator.h"
+#include "alloc.h"
+#include "arena.h"
+
+#define MQTTCTL_PAYLOAD_SIZE        4096        /** @brief payload buffer, fits MQTTCTL_BATCH_MAX samples in both formats */
+
+mqttctl_config_t mqttctl_config;
+
+static WiFiClient mqttctl_wifi_client;
+static PubSubClient mqttctl_client( mqttctl_wifi_client );
+static char mqttctl_client_id[ 24 ] = "";
+
+/*
+ * the ring and the payload buffer are only touched by the mqttctl task,
+ * the stats and the config are shared with the gui and the console
+ */
+static mqttctl_sample_t *mqttctl_ring = NULL;
+static uint16_t mqttctl_ring_tail = 0;
+static uint16_t mqttctl_ring_count = 0;
+static char *mqttctl_payload = NULL;
+static mqttctl_stats_t mqttctl_stats;
+static bool mqttctl_config_changed = false;
+
+portMUX_TYPE DRAM_ATTR mqttctlMux = portMUX_INITIALIZER_UNLOCKED;
+TaskHandle_t _mqttctl_Task = NULL;
+
+void mqttctl_Task( void * pvParameters );
+static void mqttctl_sample( void );
+static bool mqttctl_connect( const mqttctl_config_t *config );
+static void mqttctl_publish_pending( const mqttctl_config_t *config );
+static size_t mqttctl_build_json( int count );
+static size_t mqttctl_build_binary( int count );
+
+void mqttctl_setup( void ) {
+    if ( _mqttctl_Task != NULL )
+        return;
+
+    mqttctl_read_config();
+
+    mqttctl_ring = (mqttctl_sample_t *)arena_alloc( ARENA_BULK, sizeof( mqttctl_sample_t ) * MQTTCTL_RING_SIZE, "mqttctl" );
+    mqttctl_payload = (char *)arena_alloc( ARENA_BULK, MQTTCTL_PAYLOAD_SIZE, "mqttctl" );
+    if ( mqttctl_ring == NULL )
+        mqttctl_ring = (mqttctl_sample_t *)MALLOC( sizeof( mqttctl_sample_t ) * MQTTCTL_RING_SIZE );
+    if ( mqttctl_payload == NULL )
+        mqttctl_payload = (char *)MALLOC( MQTTCTL_PAYLOAD_SIZE );
+    if ( mqttctl_ring == NULL || mqttctl_payload == NULL ) {
+        log_e("mqttctl buffer alloc failed");
+        while(true);
+    }
+
+    uint64_t mac = ESP.getEfuseMac();
+    snprintf( mqttctl_client_id, sizeof( mqttctl_client_id ), "eucdash-%04x%08x", (uint16_t)( mac >> 32 ), (uint32_t)mac );
+
+    xTaskCreatePinnedToCore(  mqttctl_Task,             /* Function to implement the task */
+                              "mqttctl Task",           /* Name of the task */
+                              MQTTCTL_TASK_STACK,       /* Stack size in words */
+                              NULL,                     /* Task input parameter */
+                              1,                        /* Priority of the task */
+                              &_mqttctl_Task,           /* Task handle. */
+                              0 );
+}
+
+void mqttctl_Task( void * pvParameters ) {
+    /*
+     * PubSubClient keeps the server name pointer, so the task works on its own copy
+     */
+    static mqttctl_config_t config;
+    uint64_t next_sample = 0;
+    uint64_t next_publish = 0;
+    uint64_t next_connect = 0;
+
+    log_i("start mqttctl task, heap: %d", ESP.getFreeHeap() );
+
+    while( true ) {
+        vTaskDelay( 100 );
+
+        portENTER_CRITICAL( &mqttctlMux );
+        bool changed = mqttctl_config_changed;
+        mqttctl_config_changed = false;
+        if ( changed )
+            config = mqttctl_config;
+        portEXIT_CRITICAL( &mqttctlMux );
+
+        /*
+         * a new server or login only takes effect with a new connection
+         */
+        if ( changed && mqttctl_client.connected() ) {
+            mqttctl_client.disconnect();
+            next_connect = 0;
+        }
+
+        if ( !config.enable ) {
+            if ( mqttctl_client.connected() )
+                mqttctl_client.disconnect();
+            continue;
+        }
+
+        /*
+         * sample while the wheel is connected, even without wifi. the ring
+         * carries the samples over until the broker is reachable again
+         */
+        if ( next_sample <= millis() ) {
+            next_sample = millis() + MQTTCTL_SAMPLE_INTERVAL;
+            if ( blectl_cli_getconnected() )
+                mqttctl_sample();
+        }
+
+        if ( !WiFi.isConnected() || config.server[ 0 ] == '\0' )
+            continue;
+
+        if ( !mqttctl_client.connected() ) {
+            if ( next_connect > millis() )
+                continue;
+            next_connect = millis() + MQTTCTL_RECONNECT_DELAY;
+            if ( !mqttctl_connect( &config ) )
+                continue;
+        }
+        mqttctl_client.loop();
+
+        if ( next_publish <= millis() ) {
+            next_publish = millis() + config.interval * 1000;
+            mqttctl_publish_pending( &config );
+        }
+    }
+}
+
+static void mqttctl_sample( void ) {
+    uint16_t head = ( mqttctl_ring_tail + mqttctl_ring_count ) % MQTTCTL_RING_SIZE;
+    mqttctl_sample_t *sample = &mqttctl_ring[ head ];
+
+    sample->time = time( NULL );
+    sample->speed = wheelctl_get_data( WHEELCTL_SPEED ) * 100;
+    sample->voltage = wheelctl_get_data( WHEELCTL_VOLTAGE ) * 100;
+    sample->current = wheelctl_get_data( WHEELCTL_CURRENT ) * 100;
+    sample->temp = wheelctl_get_data( WHEELCTL_TEMP ) * 100;
+    sample->battery = wheelctl_get_data( WHEELCTL_BATTPCT );
+    sample->odo = wheelctl_get_data( WHEELCTL_ODO ) * 1000;
+
+    portENTER_CRITICAL( &mqttctlMux );
+    if ( mqttctl_ring_count == MQTTCTL_RING_SIZE ) {
+        /*
+         * ring full, the new sample has overwritten the oldest one
+         */
+        mqttctl_ring_tail = ( mqttctl_ring_tail + 1 ) % MQTTCTL_RING_SIZE;
+        mqttctl_stats.dropped++;
+    }
+    else {
+        mqttctl_ring_count++;
+    }
+    mqttctl_stats.queued = mqttctl_ring_count;
+    portEXIT_CRITICAL( &mqttctlMux );
+}
+
+static bool mqttctl_connect( const mqttctl_config_t *config ) {
+    bool connected;
+
+    mqttctl_client.setServer( config->server, config->port );
+    if ( config->user[ 0 ] )
+        connected = mqttctl_client.connect( mqttctl_client_id, config->user, config->password );
+    else
+        connected = mqttctl_client.connect( mqttctl_client_id );
+
+    if ( connected )
+        log_i("connected to %s:%d as %s", config->server, config->port, mqttctl_client_id );
+    else
+        log_w("connect to %s:%d failed, state %d", config->server, config->port, mqttctl_client.state() );
+
+    portENTER_CRITICAL( &mqttctlMux );
+    mqttctl_stats.connected = connected;
+    portEXIT_CRITICAL( &mqttctlMux );
+
+    return( connected );
+}
+
+static void mqttctl_publish_pending( const mqttctl_config_t *config ) {
+    static uint64_t last_publish = 0;
+    char topic[ sizeof( config->topic ) + 4 ];
+    uint32_t messages = 0;
+    uint32_t bytes = 0;
+
+    if ( config->format == MQTTCTL_FORMAT_BINARY )
+        snprintf( topic, sizeof( topic ), "%s/bin", config->topic );
+    else
+        strlcpy( topic, config->topic, sizeof( topic ) );
+
+    /*
+     * a batch leaves the ring only after the broker took it, so a disconnect
+     * in between publishes it again with the next round
+     */
+    while ( mqttctl_ring_count ) {
+        int count = min( (int)mqttctl_ring_count, MQTTCTL_BATCH_MAX );
+        size_t len;
+
+        if ( config->format == MQTTCTL_FORMAT_BINARY )
+            len = mqttctl_build_binary( count );
+        else
+            len = mqttctl_build_json( count );
+
+        if ( !mqttctl_client.beginPublish( topic, len, false ) || mqttctl_client.write( (const uint8_t *)mqttctl_payload, len ) != len || !mqttctl_client.endPublish() ) {
+            log_w("publish failed, %d samples kept", mqttctl_ring_count );
+            break;
+        }
+
+        portENTER_CRITICAL( &mqttctlMux );
+        mqttctl_ring_tail = ( mqttctl_ring_tail + count ) % MQTTCTL_RING_SIZE;
+        mqttctl_ring_count -= count;
+        mqttctl_stats.queued = mqttctl_ring_count;
+        portEXIT_CRITICAL( &mqttctlMux );
+
+        messages++;
+        bytes += len;
+    }
+
+    uint64_t now = millis();
+    float elapsed = last_publish ? ( now - last_publish ) / 1000.0 : config->interval;
+    last_publish = now;
+
+    portENTER_CRITICAL( &mqttctlMux );
+    mqttctl_stats.messages += messages;
+    mqttctl_stats.bytes += bytes;
+    mqttctl_stats.messages_per_s = elapsed > 0 ? messages / elapsed : 0;
+    mqttctl_stats.bytes_per_s = elapsed > 0 ? bytes / elapsed : 0;
+    mqttctl_stats.connected = mqttctl_client.connected();
+    portEXIT_CRITICAL( &mqttctlMux );
+
+    if ( messages )
+        log_i("published %d messages, %d bytes, %.2f msg/s, %.1f byte/s", messages, bytes, mqttctl_stats.messages_per_s, mqttctl_stats.bytes_per_s );
+}
+
+static size_t mqttctl_build_json( int count ) {
+    size_t len = snprintf( mqttctl_payload, MQTTCTL_PAYLOAD_SIZE, "{\"id\":\"%s\",\"n\":%d,\"d\":[", mqttctl_client_id, count );
+
+    for ( int i = 0 ; i < count && len < MQTTCTL_PAYLOAD_SIZE ; i++ ) {
+        mqttctl_sample_t *sample = &mqttctl_ring[ ( mqttctl_ring_tail + i ) % MQTTCTL_RING_SIZE ];
+        len += snprintf( &mqttctl_payload[ len ], MQTTCTL_PAYLOAD_SIZE - len, "%s[%u,%d,%u,%d,%d,%u,%u]", i ? "," : "",
+                                                                            sample->time, sample->speed, sample->voltage, sample->current,
+                                                                            sample->temp, sample->battery, sample->odo );
+    }
+    if ( len < MQTTCTL_PAYLOAD_SIZE )
+        len += snprintf( &mqttctl_payload[ len ], MQTTCTL_PAYLOAD_SIZE - len, "]}" );
+
+    return( min( len, (size_t)MQTTCTL_PAYLOAD_SIZE - 1 ) );
+}
+
+static size_t mqttctl_build_binary( int count ) {
+    mqttctl_batch_header_t header;
+
+    header.version = 1;
+    header.sample_size = sizeof( mqttctl_sample_t );
+    header.count = count;
+    portENTER_CRITICAL( &mqttctlMux );
+    header.dropped = mqttctl_stats.dropped;
+    portEXIT_CRITICAL( &mqttctlMux );
+
+    size_t len = sizeof( header );
+    memcpy( mqttctl_payload, &header, sizeof( header ) );
+    for ( int i = 0 ; i < count ; i++ ) {
+        memcpy( &mqttctl_payload[ len ], &mqttctl_ring[ ( mqttctl_ring_tail + i ) % MQTTCTL_RING_SIZE ], sizeof( mqttctl_sample_t ) );
+        len += sizeof( mqttctl_sample_t );
+    }
+    return( len );
+}
+
+void mqttctl_get_stats( mqttctl_stats_t *stats ) {
+    portENTER_CRITICAL( &mqttctlMux );
+    *stats = mqttctl_stats;
+    portEXIT_CRITICAL( &mqttctlMux );
+}
+
+void mqttctl_set_enable( bool enable ) {
+    portENTER_CRITICAL( &mqttctlMux );
+    mqttctl_config.enable = enable;
+    mqttctl_config_changed = true;
+    portEXIT_CRITICAL( &mqttctlMux );
+    mqttctl_save_config();
+}
+
+bool mqttctl_get_enable( void ) {
+    return( mqttctl_config.enable );
+}
+
+void mqttctl_set_server( const char *server, uint16_t port ) {
+    portENTER_CRITICAL( &mqttctlMux );
+    strlcpy( mqttctl_config.server, server, sizeof( mqttctl_config.server ) );
+    mqttctl_config.port = port;
+    mqttctl_config_changed = true;
+    portEXIT_CRITICAL( &mqttctlMux );
+    mqttctl_save_config();
+}
+
+void mqttctl_set_login( const char *user, const char *password ) {
+    portENTER_CRITICAL( &mqttctlMux );
+    strlcpy( mqttctl_config.user, user, sizeof( mqttctl_config.user ) );
+    strlcpy( mqttctl_config.password, password, sizeof( mqttctl_config.password ) );
+    mqttctl_config_changed = true;
+    portEXIT_CRITICAL( &mqttctlMux );
+    mqttctl_save_config();
+}
+
+void mqttctl_get_config( mqttctl_config_t *config ) {
+    portENTER_CRITICAL( &mqttctlMux );
+    *config = mqttctl_config;
+    portEXIT_CRITICAL( &mqttctlMux );
+}
+
+void mqttctl_save_config( void ) {
+    configstore_save( CONFIGSTORE_MQTTCTL );
+}
+
+void mqttctl_read_config( void ) {
+    if ( !configstore_register( CONFIGSTORE_MQTTCTL, &mqttctl_config, sizeof( mqttctl_config ), mqttctl_read_json_config, mqttctl_save_json_config ) ) {
+        mqttctl_read_json_config();
+        mqttctl_save_config();
+    }
+    mqttctl_config_changed = true;
+}
+
+void mqttctl_save_json_config( void ) {
+    fs::File file = SPIFFS.open( MQTTCTL_JSON_CONFIG_FILE, FILE_WRITE );
+
+    if (!file) {
+        log_e("Can't open file: %s!", MQTTCTL_JSON_CONFIG_FILE );
+    }
+    else {
+        SpiRamJsonDocument doc( 1000 );
+
+        mqttctl_config_to_json( &mqttctl_config, doc.to<JsonObject>() );
+
+        if ( serializeJsonPretty( doc, file ) == 0) {
+            log_e("Failed to write config file");
+        }
+        doc.clear();
+    }
+    file.close();
+}
+
+void mqttctl_read_json_config( void ) {
+    fs::File file = SPIFFS.open( MQTTCTL_JSON_CONFIG_FILE, FILE_READ );
+    if (!file) {
+        log_e("Can't open file: %s!", MQTTCTL_JSON_CONFIG_FILE );
+    }
+    else {
+        int filesize = file.size();
+        SpiRamJsonDocument doc( filesize * 2 );
+
+        DeserializationError error = deserializeJson( doc, file );
+        if ( error ) {
+            log_e("update check deserializeJson() failed: %s", error.c_str() );
+        }
+        else {
+            mqttctl_config_t config;
+
+            mqttctl_config_from_json( &config, doc.as<JsonObjectConst>() );
+
+            /*
+             * the console reloads the json while the uplink task runs
+             */
+            portENTER_CRITICAL( &mqttctlMux );
+            mqttctl_config = config;
+            mqttctl_config_changed = true;
+            portEXIT_CRITICAL( &mqttctlMux );
+        }        
+        doc.clear();
+    }
+    file.close();
+}
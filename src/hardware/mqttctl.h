@@ -0,0 +1,127 @@
+/****************************************************************************
+ *   Copyright  2020  Jesper Ortlund
+ ****************************************************************************/
+/*
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+#ifndef _MQTTCTL_H
+    #define _MQTTCTL_H
+
+    #include "TTGO.h"
+    #include "mqttctl_config.h"
+
+    #define MQTTCTL_JSON_CONFIG_FILE    "/mqttctl.json"     /** @brief defines json config file name */
+    #define MQTTCTL_SAMPLE_INTERVAL     1000                /** @brief ms between two samples of the wheel data */
+    #define MQTTCTL_RING_SIZE           900                 /** @brief samples kept while the broker is not reachable, oldest are dropped */
+    #define MQTTCTL_BATCH_MAX           60                  /** @brief max samples in one message */
+    #define MQTTCTL_RECONNECT_DELAY     5000                /** @brief ms between two broker connect attempts */
+    #define MQTTCTL_TASK_STACK          4096                /** @brief stack size of the uplink task in words */
+
+    /**
+     * @brief one telemetry sample, fixed point to keep batches small
+     */
+    typedef struct __attribute__((packed)) {
+        uint32_t time;                                      /** @brief unix time in s */
+        int16_t speed;                                      /** @brief speed in 1/100 km/h */
+        uint16_t voltage;                                   /** @brief battery voltage in 1/100 V */
+        int16_t current;                                    /** @brief current in 1/100 A, negative while braking */
+        int16_t temp;                                       /** @brief temperature in 1/100 C */
+        uint8_t battery;                                    /** @brief battery in percent */
+        uint32_t odo;                                       /** @brief odometer in m */
+    } mqttctl_sample_t;
+
+    /**
+     * @brief header of a binary batch
+     */
+    typedef struct __attribute__((packed)) {
+        uint8_t version;                                    /** @brief format version, 1 */
+        uint8_t sample_size;                                /** @brief sizeof( mqttctl_sample_t ) */
+        uint16_t count;                                     /** @brief samples following the header */
+        uint32_t dropped;                                   /** @brief samples dropped since boot because the ring was full */
+    } mqttctl_batch_header_t;
+
+    /**
+     * @brief uplink statistics
+     */
+    typedef struct {
+        uint32_t messages;                                  /** @brief published messages since boot */
+        uint32_t bytes;                                     /** @brief published payload bytes since boot */
+        uint32_t dropped;                                   /** @brief samples dropped since boot */
+        uint32_t queued;                                    /** @brief samples waiting in the ring */
+        float messages_per_s;                               /** @brief messages/s over the last publish interval */
+        float bytes_per_s;                                  /** @brief payload bytes/s over the last publish interval */
+        bool connected;                                     /** @brief broker connection is up */
+    } mqttctl_stats_t;
+
+    /**
+     * @brief setup the mqtt telemetry uplink and start its task
+     */
+    void mqttctl_setup( void );
+    /**
+     * @brief enable or disable the uplink
+     *
+     * @param   enable  true means enable, false means disable
+     */
+    void mqttctl_set_enable( bool enable );
+    /**
+     * @brief get the uplink enable config
+     *
+     * @return  true means enable, false means disable
+     */
+    bool mqttctl_get_enable( void );
+    /**
+     * @brief set the broker, a running connection is closed and opened again
+     *
+     * @param   server  broker host name or ip
+     * @param   port    broker port
+     */
+    void mqttctl_set_server( const char *server, uint16_t port );
+    /**
+     * @brief set the broker login, an empty user connects anonymous
+     *
+     * @param   user        broker user
+     * @param   password    broker password
+     */
+    void mqttctl_set_login( const char *user, const char *password );
+    /**
+     * @brief get a copy of the uplink config
+     *
+     * @param   config  pointer to the mqttctl_config_t to fill
+     */
+    void mqttctl_get_config( mqttctl_config_t *config );
+    /**
+     * @brief get a copy of the uplink statistics
+     *
+     * @param   stats   pointer to the mqttctl_stats_t to fill
+     */
+    void mqttctl_get_stats( mqttctl_stats_t *stats );
+    /**
+     * @brief save the config structure to SPIFFS
+     */
+    void mqttctl_save_config( void );
+    /**
+     * @brief read the config structure from SPIFFS
+     */
+    void mqttctl_read_config( void );
+    /**
+     * @brief write the config as legacy json file to spiffs
+     */
+    void mqttctl_save_json_config( void );
+    /**
+     * @brief import the config from the legacy json file on spiffs
+     */
+    void mqttctl_read_json_config( void );
+
+#endif // _MQTTCTL_H
@@ -0,0 +1,46 @@
+/****************************************************************************
+ *   Copyright  2020  Jesper Ortlund
+ ****************************************************************************/
+/*
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+#include <stdio.h>
+#include <string.h>
+
+#include "mqttctl_config.h"
+
+void mqttctl_config_from_json( mqttctl_config_t *config, JsonObjectConst json ) {
+    int interval = json["interval"] | MQTTCTL_PUBLISH_INTERVAL;
+
+    config->enable = json["enable"] | false;
+    snprintf( config->server, sizeof( config->server ), "%s", json["server"] | "" );
+    config->port = json["port"] | 1883;
+    snprintf( config->user, sizeof( config->user ), "%s", json["user"] | "" );
+    snprintf( config->password, sizeof( config->password ), "%s", json["password"] | "" );
+    snprintf( config->topic, sizeof( config->topic ), "%s", json["topic"] | "eucdash/telemetry" );
+    config->interval = interval < 1 ? 1 : interval;
+    config->format = strcmp( json["format"] | "json", "binary" ) ? MQTTCTL_FORMAT_JSON : MQTTCTL_FORMAT_BINARY;
+}
+
+void mqttctl_config_to_json( const mqttctl_config_t *config, JsonObject json ) {
+    json["enable"] = config->enable;
+    json["server"] = config->server;
+    json["port"] = config->port;
+    json["user"] = config->user;
+    json["password"] = config->password;
+    json["topic"] = config->topic;
+    json["interval"] = config->interval;
+    json["format"] = config->format == MQTTCTL_FORMAT_BINARY ? "binary" : "json";
+}
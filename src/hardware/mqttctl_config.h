@@ -0,0 +1,67 @@
+/****************************************************************************
+ *   Copyright  2020  Jesper Ortlund
+ ****************************************************************************/
+/*
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+#ifndef _MQTTCTL_CONFIG_H
+    #define _MQTTCTL_CONFIG_H
+
+    /*
+     * no arduino or spiffs in here, the config and its json mapping build and run on the host
+     */
+    #include <stdint.h>
+    #include <ArduinoJson.h>
+
+
+    #define MQTTCTL_PUBLISH_INTERVAL    10                  /** @brief default seconds between two batches */
+
+    enum {
+        MQTTCTL_FORMAT_JSON,                                /** @brief compact json, {"id":client id,"n":count,"d":[[time,speed,voltage,current,temp,battery,odo],...]} */
+        MQTTCTL_FORMAT_BINARY,                              /** @brief mqttctl_batch_header_t followed by count mqttctl_sample_t, little endian */
+        MQTTCTL_FORMAT_NUM
+    };
+
+    /**
+     * @brief mqttctl config structure, stored as is in the config store. only append
+     * fields, never reorder or resize them
+     */
+    typedef struct {
+        bool enable = false;                                /** @brief enable the telemetry uplink */
+        char server[64] = "";                               /** @brief broker host name or ip */
+        uint16_t port = 1883;                               /** @brief broker port */
+        char user[32] = "";                                 /** @brief broker user, empty for anonymous */
+        char password[32] = "";                             /** @brief broker password */
+        char topic[64] = "eucdash/telemetry";               /** @brief topic for the batches, binary batches go to topic/bin */
+        uint16_t interval = MQTTCTL_PUBLISH_INTERVAL;       /** @brief seconds between two batches */
+        uint8_t format = MQTTCTL_FORMAT_JSON;               /** @brief MQTTCTL_FORMAT_JSON or MQTTCTL_FORMAT_BINARY */
+    } mqttctl_config_t;
+
+    /**
+     * @brief fill the mqttctl config from the json, missing keys get their defaults
+     *
+     * @param   config      pointer to the config
+     * @param   json        root object of mqttctl.json
+     */
+    void mqttctl_config_from_json( mqttctl_config_t *config, JsonObjectConst json );
+    /**
+     * @brief write the mqttctl config as json
+     *
+     * @param   config      pointer to the config
+     * @param   json        root object to fill
+     */
+    void mqttctl_config_to_json( const mqttctl_config_t *config, JsonObject json );
+
+#endif // _MQTTCTL_CONFIG_H
@@ -1,6 +1,7 @@
 #include "config.h"
 #include <TTGO.h>
 #include <soc/rtc.h>
+#include "configstore.h"
 #include "json_psram_allocator.h"
 
 #include "display.h"
@@ -9,6 +10,41 @@
 #include "motor.h"
 #include "blectl.h"
 #include "callback.h"
+#include "i2cctl.h"
+
+/*
+ * AXP202 registers behind the telemetry, they are read through the i2c queue
+ * instead of the TTGO getters, adjacent ones go out as one burst
+ */
+#define PMU_I2C_ADDR                0x35
+#define PMU_REG_STATUS              0x00        /** @brief 0x00 input status, bit 5 vbus present, 0x01 charge status, bit 6 charging, bit 5 battery */
+#define PMU_REG_VBUS_VOLTAGE        0x5a        /** @brief H8 L4, 1.7mV */
+#define PMU_REG_BATT_VOLTAGE        0x78        /** @brief H8 L4, 1.1mV */
+#define PMU_REG_CHARGE_CURRENT      0x7a        /** @brief H8 L4, 0.5mA */
+#define PMU_REG_DISCHARGE_CURRENT   0x7c        /** @brief H8 L5, 0.5mA */
+#define PMU_REG_ADC_RATE            0x84        /** @brief bit 6-7, 25Hz * 2^n */
+#define PMU_REG_CHARGE_COULOMB      0xb0        /** @brief 32 bit big endian */
+#define PMU_REG_DISCHARGE_COULOMB   0xb4        /** @brief 32 bit big endian */
+#define PMU_REG_PERCENT             0xb9        /** @brief bit 7 set while the fuel gauge is not ready */
+
+/**
+ * @brief raw registers of one telemetry sample, filled by the i2c service task
+ */
+typedef struct {
+    uint8_t status[ 2 ];
+    uint8_t vbus_voltage[ 2 ];
+    uint8_t battery_voltage[ 2 ];
+    uint8_t charge_current[ 2 ];
+    uint8_t discharge_current[ 2 ];
+    uint8_t adc_rate;
+    uint8_t charge_coulomb[ 4 ];
+    uint8_t discharge_coulomb[ 4 ];
+    uint8_t percent;
+    bool state;                                 /** @brief charging and plug were read */
+    bool coulomb;                               /** @brief the adc rate for the coulomb counter was read */
+    bool detailed;                              /** @brief currents and vbus were read */
+    int result;                                 /** @brief first bus error of the sample */
+} pmu_raw_t;
 
 
 static bool pmu_update = true;
@@ -17,12 +53,25 @@ portMUX_TYPE DRAM_ATTR PMU_IRQ_Mux = portMUX_INITIALIZER_UNLOCKED;
 
 callback_t *pmu_callback = NULL;
 pmu_config_t pmu_config;
+static pmu_telemetry_t pmu_telemetry;
+static uint64_t pmu_next_sample = 0;
+static uint32_t pmu_sample_interval = PMU_SAMPLE_INTERVAL;
+static bool pmu_detailed_telemetry = false;
+static pmu_raw_t pmu_raw;
+static bool pmu_sample_pending = false;
+static bool pmu_sample_state = false;
+static volatile bool pmu_sample_ready = false;
+portMUX_TYPE DRAM_ATTR PMU_Sample_Mux = portMUX_INITIALIZER_UNLOCKED;
 
 void IRAM_ATTR pmu_irq( void );
 bool pmu_powermgm_event_cb( EventBits_t event, void *arg );
 bool pmu_powermgm_loop_cb( EventBits_t event, void *arg );
 bool pmu_blectl_event_cb( EventBits_t event, void *arg );
 bool pmu_send_cb( EventBits_t event, void *arg );
+static void pmu_sample( bool state );
+static void pmu_sample_cb( int result, void *arg );
+static void pmu_sample_collect( void );
+static void pmu_sample_decode( void );
 
 void pmu_setup( void ) {
 
@@ -65,6 +114,14 @@ void pmu_setup( void ) {
     pinMode( AXP202_INT, INPUT );
     attachInterrupt( AXP202_INT, &pmu_irq, FALLING );
 
+    /*
+     * fill the telemetry cache, the wifi autoon check reads it right after setup
+     */
+    pmu_sample( true );
+    if ( !i2cctl_sync( 100 ) )
+        log_w("first pmu sample not done");
+    pmu_sample_collect();
+
     powermgm_register_cb( POWERMGM_SILENCE_WAKEUP | POWERMGM_STANDBY | POWERMGM_WAKEUP, pmu_powermgm_event_cb, "pmu" );
     powermgm_register_loop_cb( POWERMGM_SILENCE_WAKEUP | POWERMGM_STANDBY | POWERMGM_WAKEUP , pmu_powermgm_loop_cb, "pmu loop" );
     //blectl_register_cb( BLECTL_CONNECT, pmu_blectl_event_cb, "pmu blectl" );
@@ -102,7 +159,6 @@ void IRAM_ATTR  pmu_irq( void ) {
 }
 
 void pmu_loop( void ) {
-    static uint64_t nextmillis = 0;
     static int32_t percent = 0;
     TTGOClass *ttgo = TTGOClass::getWatch();
     /*
@@ -140,29 +196,33 @@ void pmu_loop( void ) {
             return;
         }
         ttgo->power->clearIRQ();
-        bool plug = ttgo->power->isVBUSPlug();
-        bool charging = ttgo->power->isChargeing();
-        //pmu_send_cb( PMUCTL_VBUS_PLUG, (void *)&plug );
-        //pmu_send_cb( PMUCTL_CHARGING, (void *)&charging );
-        pmu_update = true;
+        /*
+         * plug and charging state changed, don't wait for the next sample
+         */
+        pmu_sample( true );
     }
 
-    if ( nextmillis < millis() ) {
-        nextmillis = millis() + 1000;
-        if ( pmu_get_battery_percent() != percent ) {
-            pmu_update = true;
-        }
+    if ( pmu_next_sample <= millis() ) {
+        pmu_sample( false );
+    }
+
+    /*
+     * the sample comes back from the i2c task some loops later
+     */
+    pmu_sample_collect();
+    if ( pmu_telemetry.percent != percent ) {
+        pmu_update = true;
     }
 
     if ( pmu_update ) {
 
         char msg[64]="";
-        percent = pmu_get_battery_percent();
+        percent = pmu_telemetry.percent;
         snprintf( msg, sizeof(msg), "\r\n{t:\"status\", bat:%d}\r\n", percent );
         //blectl_send_msg( msg );
 
-        bool plug = ttgo->power->isVBUSPlug();
-        bool charging = ttgo->power->isChargeing();
+        bool plug = pmu_telemetry.vbus_plug;
+        bool charging = pmu_telemetry.charging;
         pmu_send_cb( PMUCTL_BATTERY_PERCENT, (void*)&percent );
         pmu_send_cb( PMUCTL_CHARGING, (void*)&charging );
         pmu_send_cb( PMUCTL_VBUS_PLUG, (void*)&plug );
@@ -210,6 +270,12 @@ void pmu_standby( void ) {
     }
     ttgo->power->setPowerOutPut( AXP202_LDO2, AXP202_OFF );
 
+    /*
+     * nothing shows the battery in standby, a plug or charge change still comes in by irq
+     */
+    pmu_sample_interval = PMU_STANDBY_SAMPLE_INTERVAL;
+    pmu_next_sample = millis() + pmu_sample_interval;
+
     gpio_wakeup_enable( (gpio_num_t)AXP202_INT, GPIO_INTR_LOW_LEVEL );
     esp_sleep_enable_gpio_wakeup ();
 }
@@ -231,10 +297,23 @@ void pmu_wakeup( void ) {
 
     ttgo->power->setPowerOutPut( AXP202_LDO2, AXP202_ON );
 
+    pmu_sample_interval = PMU_SAMPLE_INTERVAL;
+    pmu_sample( true );
     pmu_update = true;
 }
 
 void pmu_save_config( void ) {
+    configstore_save( CONFIGSTORE_PMU );
+}
+
+void pmu_read_config( void ) {
+    if ( !configstore_register( CONFIGSTORE_PMU, &pmu_config, sizeof( pmu_config ), pmu_read_json_config, pmu_save_json_config ) ) {
+        pmu_read_json_config();
+        pmu_save_config();
+    }
+}
+
+void pmu_save_json_config( void ) {
     fs::File file = SPIFFS.open( PMU_JSON_CONFIG_FILE, FILE_WRITE );
 
     if (!file) {
@@ -243,17 +322,7 @@ void pmu_save_config( void ) {
     else {
         SpiRamJsonDocument doc( 3000 );
 
-        doc["silence_wakeup"] = pmu_config.silence_wakeup;
-        doc["silence_wakeup_interval"] = pmu_config.silence_wakeup_interval;
-        doc["silence_wakeup_interval_vbplug"] = pmu_config.silence_wakeup_interval_vbplug;
-        doc["experimental_power_save"] = pmu_config.experimental_power_save;
-        doc["normal_voltage"] = pmu_config.normal_voltage;
-        doc["normal_power_save_voltage"] = pmu_config.normal_power_save_voltage;
-        doc["experimental_normal_voltage"] = pmu_config.experimental_normal_voltage;
-        doc["experimental_power_save_voltage"] = pmu_config.experimental_power_save_voltage;
-        doc["compute_percent"] = pmu_config.compute_percent;
-        doc["high_charging_target_voltage"] = pmu_config.high_charging_target_voltage;
-        doc["designed_battery_cap"] = pmu_config.designed_battery_cap;
+        pmu_config_to_json( &pmu_config, doc.to<JsonObject>() );
 
         if ( serializeJsonPretty( doc, file ) == 0) {
             log_e("Failed to write config file");
@@ -263,7 +332,7 @@ void pmu_save_config( void ) {
     file.close();
 }
 
-void pmu_read_config( void ) {
+void pmu_read_json_config( void ) {
     fs::File file = SPIFFS.open( PMU_JSON_CONFIG_FILE, FILE_READ );
 
     if (!file) {
@@ -278,17 +347,7 @@ void pmu_read_config( void ) {
             log_e("update check deserializeJson() failed: %s", error.c_str() );
         }
         else {
-            pmu_config.silence_wakeup = doc["silence_wakeup"] | false;
-            pmu_config.silence_wakeup_interval = doc["silence_wakeup_interval"] | SILENCEWAKEINTERVAL;
-            pmu_config.silence_wakeup_interval_vbplug = doc["silence_wakeup_interval_vbplug"] | SILENCEWAKEINTERVAL_PLUG;
-            pmu_config.experimental_power_save = doc["experimental_power_save"] | false;
-            pmu_config.compute_percent = doc["compute_percent"] | false;
-            pmu_config.high_charging_target_voltage = doc["high_charging_target_voltage"] | false;
-            pmu_config.designed_battery_cap = doc["designed_battery_cap"] | 300;
-            pmu_config.normal_voltage = doc["normal_voltage"] | NORMALVOLTAGE;
-            pmu_config.normal_power_save_voltage = doc["normal_power_save_voltage"] | NORMALPOWERSAVEVOLTAGE;
-            pmu_config.experimental_normal_voltage = doc["experimental_normal_voltage"] | EXPERIMENTALNORMALVOLTAGE;
-            pmu_config.experimental_power_save_voltage = doc["experimental_power_save_voltage"] | EXPERIMENTALPOWERSAVEVOLTAGE;
+            pmu_config_from_json( &pmu_config, doc.as<JsonObjectConst>() );
         }        
         doc.clear();
     }
@@ -341,6 +400,7 @@ bool pmu_get_experimental_power_save( void ) {
 
 void pmu_set_calculated_percent( bool value ) {
     pmu_config.compute_percent = value;
+    pmu_next_sample = 0;
     pmu_save_config();
 }
 
@@ -349,52 +409,172 @@ void pmu_set_experimental_power_save( bool value ) {
     pmu_save_config();
 }
 
-int32_t pmu_get_battery_percent( void ) {
+void pmu_set_detailed_telemetry( bool enable ) {
+    pmu_detailed_telemetry = enable;
+    if ( enable )
+        pmu_next_sample = 0;
+}
+
+/*
+ * read the AXP202 telemetry into the cache, the getters below only return the cached values
+ * so the gui and dash tiles can poll them every refresh without an i2c transfer each. the
+ * registers are queued to the i2c task and decoded in pmu_loop once the last one is in, a
+ * plain sample only reads what the battery percent needs, like the percent poll did before
+ */
+static void pmu_sample( bool state ) {
+    /*
+     * one sample in flight, a state request waits for the next one
+     */
+    if ( pmu_sample_pending ) {
+        pmu_sample_state |= state;
+        return;
+    }
+
+    pmu_raw.state = state || pmu_sample_state;
+    pmu_raw.coulomb = pmu_get_calculated_percent() || pmu_detailed_telemetry;
+    pmu_raw.detailed = pmu_detailed_telemetry;
+    pmu_raw.result = 0;
+    pmu_sample_state = false;
+
+    bool queued = true;
+    if ( pmu_raw.state || !pmu_get_calculated_percent() )
+        queued &= i2cctl_read( PMU_I2C_ADDR, PMU_REG_STATUS, pmu_raw.status, sizeof( pmu_raw.status ), 0, pmu_sample_cb, NULL );
+    if ( pmu_raw.detailed ) {
+        queued &= i2cctl_read( PMU_I2C_ADDR, PMU_REG_VBUS_VOLTAGE, pmu_raw.vbus_voltage, sizeof( pmu_raw.vbus_voltage ), 0, pmu_sample_cb, NULL );
+    }
+    queued &= i2cctl_read( PMU_I2C_ADDR, PMU_REG_BATT_VOLTAGE, pmu_raw.battery_voltage, sizeof( pmu_raw.battery_voltage ), 0, pmu_sample_cb, NULL );
+    if ( pmu_raw.detailed ) {
+        queued &= i2cctl_read( PMU_I2C_ADDR, PMU_REG_CHARGE_CURRENT, pmu_raw.charge_current, sizeof( pmu_raw.charge_current ), 0, pmu_sample_cb, NULL );
+        queued &= i2cctl_read( PMU_I2C_ADDR, PMU_REG_DISCHARGE_CURRENT, pmu_raw.discharge_current, sizeof( pmu_raw.discharge_current ), 0, pmu_sample_cb, NULL );
+    }
+    if ( pmu_raw.coulomb )
+        queued &= i2cctl_read( PMU_I2C_ADDR, PMU_REG_ADC_RATE, &pmu_raw.adc_rate, sizeof( pmu_raw.adc_rate ), 0, pmu_sample_cb, NULL );
+    queued &= i2cctl_read( PMU_I2C_ADDR, PMU_REG_CHARGE_COULOMB, pmu_raw.charge_coulomb, sizeof( pmu_raw.charge_coulomb ), 0, pmu_sample_cb, NULL );
+    queued &= i2cctl_read( PMU_I2C_ADDR, PMU_REG_DISCHARGE_COULOMB, pmu_raw.discharge_coulomb, sizeof( pmu_raw.discharge_coulomb ), 0, pmu_sample_cb, NULL );
+    /*
+     * the queue runs in order, so the last read completes the sample
+     */
+    if ( queued && i2cctl_read( PMU_I2C_ADDR, PMU_REG_PERCENT, &pmu_raw.percent, sizeof( pmu_raw.percent ), 0, pmu_sample_cb, &pmu_raw ) ) {
+        pmu_sample_pending = true;
+    }
+    else {
+        pmu_sample_state |= pmu_raw.state;
+    }
+    pmu_next_sample = millis() + pmu_sample_interval;
+}
+
+/**
+ * @brief runs in the i2c task
+ */
+static void pmu_sample_cb( int result, void *arg ) {
+    portENTER_CRITICAL( &PMU_Sample_Mux );
+    if ( result && !pmu_raw.result )
+        pmu_raw.result = result;
+    if ( arg )
+        pmu_sample_ready = true;
+    portEXIT_CRITICAL( &PMU_Sample_Mux );
+}
+
+static void pmu_sample_collect( void ) {
+    portENTER_CRITICAL( &PMU_Sample_Mux );
+    bool ready = pmu_sample_ready;
+    pmu_sample_ready = false;
+    portEXIT_CRITICAL( &PMU_Sample_Mux );
+
+    if ( !ready )
+        return;
+
+    pmu_sample_pending = false;
+    if ( pmu_raw.result ) {
+        log_w("pmu sample failed: %d", pmu_raw.result );
+        pmu_sample_state |= pmu_raw.state;
+    }
+    else {
+        pmu_sample_decode();
+    }
+
+    if ( pmu_sample_state )
+        pmu_sample( true );
+}
+
+/*
+ * same conversions as the TTGO AXP20X getters
+ */
+static void pmu_sample_decode( void ) {
     TTGOClass *ttgo = TTGOClass::getWatch();
+    uint32_t charge_coulomb = ( pmu_raw.charge_coulomb[ 0 ] << 24 ) | ( pmu_raw.charge_coulomb[ 1 ] << 16 ) | ( pmu_raw.charge_coulomb[ 2 ] << 8 ) | pmu_raw.charge_coulomb[ 3 ];
+    uint32_t discharge_coulomb = ( pmu_raw.discharge_coulomb[ 0 ] << 24 ) | ( pmu_raw.discharge_coulomb[ 1 ] << 16 ) | ( pmu_raw.discharge_coulomb[ 2 ] << 8 ) | pmu_raw.discharge_coulomb[ 3 ];
 
-    if ( ttgo->power->getBattChargeCoulomb() < ttgo->power->getBattDischargeCoulomb() || ttgo->power->getBattVoltage() < 3200 ) {
+    pmu_telemetry.battery_voltage = ( ( pmu_raw.battery_voltage[ 0 ] << 4 ) | ( pmu_raw.battery_voltage[ 1 ] & 0x0f ) ) * 1.1;
+    if ( charge_coulomb < discharge_coulomb || pmu_telemetry.battery_voltage < 3200 ) {
         ttgo->power->ClearCoulombcounter();
     }
 
+    if ( pmu_raw.coulomb ) {
+        uint32_t rate = 25 << ( ( pmu_raw.adc_rate >> 6 ) & 0x03 );
+        pmu_telemetry.coulumb_data = 65536.0 * 0.5 * ( (float)charge_coulomb - (float)discharge_coulomb ) / 3600.0 / rate;
+    }
+
     if ( pmu_get_calculated_percent() ) {
-        return( ( ttgo->power->getCoulombData() / pmu_config.designed_battery_cap ) * 100 );
+        pmu_telemetry.percent = ( pmu_telemetry.coulumb_data / pmu_config.designed_battery_cap ) * 100;
+    }
+    else if ( !( pmu_raw.status[ 1 ] & 0x20 ) || ( pmu_raw.percent & 0x80 ) ) {
+        pmu_telemetry.percent = 0;
     }
     else {
-        return( ttgo->power->getBattPercentage() );
+        pmu_telemetry.percent = pmu_raw.percent & 0x7f;
     }
+
+    /*
+     * plug and charging only change with a pmu irq
+     */
+    if ( pmu_raw.state ) {
+        pmu_telemetry.charging = pmu_raw.status[ 1 ] & 0x40;
+        pmu_telemetry.vbus_plug = pmu_raw.status[ 0 ] & 0x20;
+        pmu_update = true;
+    }
+
+    if ( pmu_raw.detailed ) {
+        pmu_telemetry.charge_current = ( ( pmu_raw.charge_current[ 0 ] << 4 ) | ( pmu_raw.charge_current[ 1 ] & 0x0f ) ) * 0.5;
+        pmu_telemetry.discharge_current = ( ( pmu_raw.discharge_current[ 0 ] << 5 ) | ( pmu_raw.discharge_current[ 1 ] & 0x1f ) ) * 0.5;
+        pmu_telemetry.vbus_voltage = ( ( pmu_raw.vbus_voltage[ 0 ] << 4 ) | ( pmu_raw.vbus_voltage[ 1 ] & 0x0f ) ) * 1.7;
+    }
+
+    pmu_telemetry.timestamp = millis();
+}
+
+int32_t pmu_get_battery_percent( void ) {
+    return( pmu_telemetry.percent );
 }
 
 float pmu_get_battery_voltage( void ) {
-    TTGOClass *ttgo = TTGOClass::getWatch();
-    return( ttgo->power->getBattVoltage() );
+    return( pmu_telemetry.battery_voltage );
 }
 
 float pmu_get_battery_charge_current( void ) {
-    TTGOClass *ttgo = TTGOClass::getWatch();
-    return( ttgo->power->getBattChargeCurrent() );
+    return( pmu_telemetry.charge_current );
 }
 
 float pmu_get_battery_discharge_current( void ) {
-    TTGOClass *ttgo = TTGOClass::getWatch();
-    return( ttgo->power->getBattDischargeCurrent() );
+    return( pmu_telemetry.discharge_current );
 }
 
 float pmu_get_vbus_voltage( void ) {
-    TTGOClass *ttgo = TTGOClass::getWatch();
-    return( ttgo->power->getVbusVoltage() );
+    return( pmu_telemetry.vbus_voltage );
 }
 
 float pmu_get_coulumb_data( void ) {
-    TTGOClass *ttgo = TTGOClass::getWatch();
-    return( ttgo->power->getCoulombData() );
+    return( pmu_telemetry.coulumb_data );
 }
 
 bool pmu_is_charging( void ) {
-    TTGOClass *ttgo = TTGOClass::getWatch();
-    return( ttgo->power->isChargeing() );
+    return( pmu_telemetry.charging );
 }
 
 bool pmu_is_vbus_plug( void ) {
-    TTGOClass *ttgo = TTGOClass::getWatch();
-    return( ttgo->power->isVBUSPlug() );
-}
\ No newline at end of file
+    return( pmu_telemetry.vbus_plug );
+}
+
+const pmu_telemetry_t *pmu_get_telemetry( void ) {
+    return( &pmu_telemetry );
+}
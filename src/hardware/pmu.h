@@ -24,34 +24,30 @@
 
     #include "TTGO.h"
     #include "callback.h"
+    #include "pmu_config.h"
 
     #define PMUCTL_BATTERY_PERCENT      _BV(0)                  /** @brief event mask for pmuctl battery percent update, callback arg is (int32_t*) */
     #define PMUCTL_VBUS_PLUG            _BV(1)                  /** @brief event mask for pmuctl plug/unplug update, callback arg is (bool*) */
     #define PMUCTL_CHARGING             _BV(2)                  /** @brief event mask for pmuctl charging, callback arg is (bool*) */
 
     #define PMU_JSON_CONFIG_FILE    "/pmu.json"                 /** @brief defines json config file name */
+    #define PMU_SAMPLE_INTERVAL     1000                        /** @brief interval in ms between two AXP202 telemetry samples */
+    #define PMU_STANDBY_SAMPLE_INTERVAL 60000                   /** @brief interval in ms between two AXP202 telemetry samples in standby */
 
-	//Some default values, used below as well as in pmu.cpp during json reads
-    #define SILENCEWAKEINTERVAL             45                  /** @brief defines the silence wakeup interval in minutes */
-	#define SILENCEWAKEINTERVAL_PLUG		3                   /** @brief defines the silence wakeup interval in minutes when plugged*/
-    #define NORMALVOLTAGE                   3300                /** @brief defines the norminal voltages while working */
-    #define NORMALPOWERSAVEVOLTAGE          3000                /** @brief defines the norminal voltages while in powersave */
-    #define EXPERIMENTALNORMALVOLTAGE       3000                /** @brief defines the norminal voltages while working with exprimental powersave enabled */
-    #define EXPERIMENTALPOWERSAVEVOLTAGE    2700                /** @brief defines the norminal voltages while in powersave with exprimental powersave enabled */
-
+    /**
+     * @brief cached AXP202 telemetry, all pmu_get_* and pmu_is_* getters read from here
+     */
     typedef struct {
-        int32_t designed_battery_cap = 300;
-        int32_t silence_wakeup_interval = SILENCEWAKEINTERVAL;
-        int32_t silence_wakeup_interval_vbplug = SILENCEWAKEINTERVAL_PLUG;
-        int32_t normal_voltage = NORMALVOLTAGE;
-        int32_t normal_power_save_voltage = NORMALPOWERSAVEVOLTAGE;
-        int32_t experimental_normal_voltage = EXPERIMENTALNORMALVOLTAGE;
-        int32_t experimental_power_save_voltage = EXPERIMENTALPOWERSAVEVOLTAGE;
-        bool high_charging_target_voltage = false;
-        bool compute_percent = false;
-        bool experimental_power_save = false;
-        bool silence_wakeup = false;
-    } pmu_config_t;
+        int32_t percent = 0;                                    /** @brief battery percent */
+        float battery_voltage = 0;                              /** @brief battery voltage in mV */
+        float charge_current = 0;                               /** @brief battery charge current in mA */
+        float discharge_current = 0;                            /** @brief battery discharge current in mA */
+        float vbus_voltage = 0;                                 /** @brief vbus voltage in mV */
+        float coulumb_data = 0;                                 /** @brief coulumb counter in mAh */
+        bool charging = false;                                  /** @brief battery is charging */
+        bool vbus_plug = false;                                 /** @brief vbus is plugged */
+        uint64_t timestamp = 0;                                 /** @brief millis() when sampled */
+    } pmu_telemetry_t;
 
     /**
      * @brief setup pmu: axp202
@@ -83,6 +79,14 @@
      * @brief read the config structure from SPIFFS
      */
     void pmu_read_config( void );
+    /**
+     * @brief write the config as legacy json file to spiffs
+     */
+    void pmu_save_json_config( void );
+    /**
+     * @brief import the config from the legacy json file on spiffs
+     */
+    void pmu_read_json_config( void );
     /**
      * @brief read the config for calculated mAh based on the axp202 coloumb counter
      */
@@ -167,6 +171,20 @@
      * @return  true means plugged, false means not plugged
      */
     bool pmu_is_vbus_plug( void );
+    /**
+     * @brief   enable reading charge/discharge current, vbus voltage and the coulomb counter
+     *          with each sample, only needed while a view shows them
+     *
+     * @param   enable  true to read them, false to keep the last values
+     */
+    void pmu_set_detailed_telemetry( bool enable );
+    /**
+     * @brief   get the last AXP202 telemetry sample, refreshed every PMU_SAMPLE_INTERVAL ms,
+     *          every PMU_STANDBY_SAMPLE_INTERVAL ms in standby and right after a pmu irq or wakeup
+     * 
+     * @return  pointer to the cached sample
+     */
+    const pmu_telemetry_t *pmu_get_telemetry( void );
     /**
      * @brief get the high charging voltage config
      * 
@@ -0,0 +1,47 @@
+/****************************************************************************
+ *   Copyright  2020  Jesper Ortlund
+ ****************************************************************************/
+/*
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+#include "pmu_config.h"
+
+void pmu_config_from_json( pmu_config_t *config, JsonObjectConst json ) {
+    config->silence_wakeup = json["silence_wakeup"] | false;
+    config->silence_wakeup_interval = json["silence_wakeup_interval"] | SILENCEWAKEINTERVAL;
+    config->silence_wakeup_interval_vbplug = json["silence_wakeup_interval_vbplug"] | SILENCEWAKEINTERVAL_PLUG;
+    config->experimental_power_save = json["experimental_power_save"] | false;
+    config->compute_percent = json["compute_percent"] | false;
+    config->high_charging_target_voltage = json["high_charging_target_voltage"] | false;
+    config->designed_battery_cap = json["designed_battery_cap"] | 300;
+    config->normal_voltage = json["normal_voltage"] | NORMALVOLTAGE;
+    config->normal_power_save_voltage = json["normal_power_save_voltage"] | NORMALPOWERSAVEVOLTAGE;
+    config->experimental_normal_voltage = json["experimental_normal_voltage"] | EXPERIMENTALNORMALVOLTAGE;
+    config->experimental_power_save_voltage = json["experimental_power_save_voltage"] | EXPERIMENTALPOWERSAVEVOLTAGE;
+}
+
+void pmu_config_to_json( const pmu_config_t *config, JsonObject json ) {
+    json["silence_wakeup"] = config->silence_wakeup;
+    json["silence_wakeup_interval"] = config->silence_wakeup_interval;
+    json["silence_wakeup_interval_vbplug"] = config->silence_wakeup_interval_vbplug;
+    json["experimental_power_save"] = config->experimental_power_save;
+    json["normal_voltage"] = config->normal_voltage;
+    json["normal_power_save_voltage"] = config->normal_power_save_voltage;
+    json["experimental_normal_voltage"] = config->experimental_normal_voltage;
+    json["experimental_power_save_voltage"] = config->experimental_power_save_voltage;
+    json["compute_percent"] = config->compute_percent;
+    json["high_charging_target_voltage"] = config->high_charging_target_voltage;
+    json["designed_battery_cap"] = config->designed_battery_cap;
+}
@@ -0,0 +1,69 @@
+/****************************************************************************
+ *   Copyright  2020  Jesper Ortlund
+ ****************************************************************************/
+/*
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+#ifndef _PMU_CONFIG_H
+    #define _PMU_CONFIG_H
+
+    /*
+     * no arduino or spiffs in here, the config and its json mapping build and run on the host
+     */
+    #include <stdint.h>
+    #include <ArduinoJson.h>
+
+
+    #define SILENCEWAKEINTERVAL             45                  /** @brief defines the silence wakeup interval in minutes */
+    #define SILENCEWAKEINTERVAL_PLUG        3                   /** @brief defines the silence wakeup interval in minutes when plugged*/
+    #define NORMALVOLTAGE                   3300                /** @brief defines the norminal voltages while working */
+    #define NORMALPOWERSAVEVOLTAGE          3000                /** @brief defines the norminal voltages while in powersave */
+    #define EXPERIMENTALNORMALVOLTAGE       3000                /** @brief defines the norminal voltages while working with exprimental powersave enabled */
+    #define EXPERIMENTALPOWERSAVEVOLTAGE    2700                /** @brief defines the norminal voltages while in powersave with exprimental powersave enabled */
+
+    /**
+     * @brief pmu config structure, stored as is in the config store. only append
+     * fields, never reorder or resize them
+     */
+    typedef struct {
+        int32_t designed_battery_cap = 300;
+        int32_t silence_wakeup_interval = SILENCEWAKEINTERVAL;
+        int32_t silence_wakeup_interval_vbplug = SILENCEWAKEINTERVAL_PLUG;
+        int32_t normal_voltage = NORMALVOLTAGE;
+        int32_t normal_power_save_voltage = NORMALPOWERSAVEVOLTAGE;
+        int32_t experimental_normal_voltage = EXPERIMENTALNORMALVOLTAGE;
+        int32_t experimental_power_save_voltage = EXPERIMENTALPOWERSAVEVOLTAGE;
+        bool high_charging_target_voltage = false;
+        bool compute_percent = false;
+        bool experimental_power_save = false;
+        bool silence_wakeup = false;
+    } pmu_config_t;
+
+    /**
+     * @brief fill the pmu config from the legacy json, missing keys get their defaults
+     *
+     * @param   config      pointer to the config
+     * @param   json        root object of pmu.json
+     */
+    void pmu_config_from_json( pmu_config_t *config, JsonObjectConst json );
+    /**
+     * @brief write the pmu config as legacy json
+     *
+     * @param   config      pointer to the config
+     * @param   json        root object to fill
+     */
+    void pmu_config_to_json( const pmu_config_t *config, JsonObject json );
+
+#endif // _PMU_CONFIG_H
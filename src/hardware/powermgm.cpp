@@ -37,6 +37,8 @@
 #include "touch.h"
 #include "display.h"
 #include "rtcctl.h"
+#include "metrics.h"
+#include "i2cctl.h"
 
 #include "gui/mainbar/mainbar.h"
 
@@ -53,6 +55,7 @@ void powermgm_setup( void ) {
 
     powermgm_status = xEventGroupCreate();
 
+    i2cctl_setup();
     pmu_setup();
     bma_setup();
     wifictl_setup();
@@ -65,6 +68,8 @@ void powermgm_setup( void ) {
 }
 
 void powermgm_loop( void ) {
+    int64_t loop_start = esp_timer_get_time();
+
     // check if a button or doubleclick was release
     if( powermgm_get_event( POWERMGM_PMU_BUTTON | POWERMGM_BMA_DOUBLECLICK | POWERMGM_BMA_TILT | POWERMGM_RTC_ALARM ) ) {
         if ( powermgm_get_event( POWERMGM_STANDBY ) || powermgm_get_event( POWERMGM_SILENCE_WAKEUP ) ) {
@@ -127,6 +132,7 @@ void powermgm_loop( void ) {
             delay( 100 );
             setCpuFrequencyMhz( 80 );
             esp_light_sleep_start();
+            loop_start = esp_timer_get_time();
             // from here, the consumption is round about 2.5mA
             // total standby time is 152h (6days) without use?
         }
@@ -145,6 +151,7 @@ void powermgm_loop( void ) {
     // send loop event depending on powermem state
     if ( powermgm_get_event( POWERMGM_STANDBY ) ) {
         vTaskDelay( 100 );
+        loop_start = esp_timer_get_time();
         powermgm_send_loop_event_cb( POWERMGM_STANDBY );
     }
     else if ( powermgm_get_event( POWERMGM_WAKEUP ) ) {
@@ -153,6 +160,7 @@ void powermgm_loop( void ) {
     else if ( powermgm_get_event( POWERMGM_SILENCE_WAKEUP ) ) {
         powermgm_send_loop_event_cb( POWERMGM_SILENCE_WAKEUP );
     }
+    metrics_sample_since( METRICS_LOOP_US, loop_start );
 }
 
 void powermgm_set_event( EventBits_t bits ) {
@@ -29,14 +29,9 @@
 #include "timesync.h"
 
 #include "hardware/powermgm.h"
+#include "hardware/configstore.h"
 #include "hardware/json_psram_allocator.h"
 
-#define VERSION_KEY "version"
-#define ENABLED_KEY "enabled"
-#define HOUR_KEY "hour"
-#define MINUTE_KEY "minute"
-#define WEEK_DAYS_KEY "week_days" 
-
 static rtcctl_alarm_t alarm_data = {
     .enabled = false,
     .hour = 0,
@@ -55,6 +50,8 @@ bool rtcctl_timesync_event_cb( EventBits_t event, void *arg );
 bool rtcctl_send_event_cb( EventBits_t event );
 void rtcctl_load_data( void );
 void rtcctl_store_data( void );
+void rtcctl_load_json_data( void );
+void rtcctl_store_json_data( void );
 
 callback_t *rtcctl_callback = NULL;
 
@@ -219,6 +216,23 @@ bool rtcctl_register_cb( EventBits_t event, CALLBACK_FUNC callback_func, const c
 }
 
 void rtcctl_load_data( void ) {
+    if ( configstore_register( CONFIGSTORE_RTCCTL, &alarm_data, sizeof( alarm_data ), rtcctl_load_json_data, rtcctl_store_json_data ) ) {
+        /*
+         * alarm_data is already filled from the config store, arm the rtc with it
+         */
+        rtcctl_alarm_t stored_data = alarm_data;
+        alarm_data.enabled = false;
+        rtcctl_set_alarm( &stored_data );
+        return;
+    }
+    rtcctl_load_json_data();
+}
+
+void rtcctl_store_data( void ) {
+    configstore_save( CONFIGSTORE_RTCCTL );
+}
+
+void rtcctl_load_json_data( void ) {
     if (! SPIFFS.exists( CONFIG_FILE_PATH ) ) {
         return; //wil be used default values set during theier creation
     }
@@ -238,13 +252,7 @@ void rtcctl_load_data( void ) {
         }
         else {
             rtcctl_alarm_t stored_data;
-            stored_data.enabled = doc[ENABLED_KEY].as<bool>();
-            stored_data.hour = doc[HOUR_KEY].as<uint8_t>();
-            stored_data.minute =  doc[MINUTE_KEY].as<uint8_t>();
-            uint8_t stored_week_days = doc[WEEK_DAYS_KEY].as<uint8_t>();
-            for (int index = 0; index < DAYS_IN_WEEK; ++index){
-                stored_data.week_days[index] = ((stored_week_days >> index) & 1) != 0;
-            }
+            rtcctl_alarm_from_json( &stored_data, doc.as<JsonObjectConst>() );
             rtcctl_set_alarm(&stored_data);
             doc.clear();
         }
@@ -252,7 +260,7 @@ void rtcctl_load_data( void ) {
     file.close();
 }
 
-void rtcctl_store_data( void ) {
+void rtcctl_store_json_data( void ) {
     fs::File file = SPIFFS.open( CONFIG_FILE_PATH, FILE_WRITE );
     if (!file) {
         log_e("Can't open file: %s!", CONFIG_FILE_PATH );
@@ -260,16 +268,7 @@ void rtcctl_store_data( void ) {
     else {
         SpiRamJsonDocument doc( 1000 );
 
-        doc[VERSION_KEY] = 1;
-        doc[ENABLED_KEY] = alarm_data.enabled;
-        doc[HOUR_KEY] = alarm_data.hour;
-        doc[MINUTE_KEY] = alarm_data.minute;
-
-        uint8_t week_days_to_store = 0;
-        for (int index = 0; index < DAYS_IN_WEEK; ++index){
-            week_days_to_store |= alarm_data.week_days[index] << index; 
-        }
-        doc[WEEK_DAYS_KEY] = week_days_to_store;
+        rtcctl_alarm_to_json( &alarm_data, doc.to<JsonObject>() );
         
         if ( serializeJsonPretty( doc, file ) == 0) {
             log_e("Failed to write rtcctl config file");
@@ -24,6 +24,7 @@
 
     #include "TTGO.h"
     #include "callback.h"
+    #include "rtcctl_config.h"
 
     #define CONFIG_FILE_PATH         "/rtcctr.json"
 
@@ -32,16 +33,8 @@
     #define RTCCTL_ALARM_DISABLED    _BV(2)     /** @brief event mask for alarm disabled */
     #define RTCCTL_ALARM_ENABLED     _BV(3)     /** @brief event mask for alarm enabled */
 
-    #define DAYS_IN_WEEK 7
     #define RTCCTL_ALARM_NOT_SET -1
 
-    typedef struct {
-        bool enabled;
-        uint8_t hour;
-        uint8_t minute;
-        bool week_days[DAYS_IN_WEEK]; //starting from sunday to be aligned with tm
-    } rtcctl_alarm_t;
-
     /**
      * @brief setup rtc controller routine
      */
@@ -0,0 +1,48 @@
+/****************************************************************************
+ *   Copyright  2020  Jesper Ortlund
+ ****************************************************************************/
+/*
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+#include "rtcctl_config.h"
+
+#define VERSION_KEY "version"
+#define ENABLED_KEY "enabled"
+#define HOUR_KEY "hour"
+#define MINUTE_KEY "minute"
+#define WEEK_DAYS_KEY "week_days" 
+
+void rtcctl_alarm_from_json( rtcctl_alarm_t *alarm, JsonObjectConst json ) {
+    alarm->enabled = json[ENABLED_KEY].as<bool>();
+    alarm->hour = json[HOUR_KEY].as<uint8_t>();
+    alarm->minute =  json[MINUTE_KEY].as<uint8_t>();
+    uint8_t stored_week_days = json[WEEK_DAYS_KEY].as<uint8_t>();
+    for (int index = 0; index < DAYS_IN_WEEK; ++index){
+        alarm->week_days[index] = ((stored_week_days >> index) & 1) != 0;
+    }
+}
+
+void rtcctl_alarm_to_json( const rtcctl_alarm_t *alarm, JsonObject json ) {
+    json[VERSION_KEY] = 1;
+    json[ENABLED_KEY] = alarm->enabled;
+    json[HOUR_KEY] = alarm->hour;
+    json[MINUTE_KEY] = alarm->minute;
+
+    uint8_t week_days_to_store = 0;
+    for (int index = 0; index < DAYS_IN_WEEK; ++index){
+        week_days_to_store |= alarm->week_days[index] << index; 
+    }
+    json[WEEK_DAYS_KEY] = week_days_to_store;
+}
@@ -0,0 +1,57 @@
+/****************************************************************************
+ *   Copyright  2020  Jesper Ortlund
+ ****************************************************************************/
+/*
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+#ifndef _RTCCTL_CONFIG_H
+    #define _RTCCTL_CONFIG_H
+
+    /*
+     * no arduino or spiffs in here, the config and its json mapping build and run on the host
+     */
+    #include <stdint.h>
+    #include <ArduinoJson.h>
+
+
+    #define DAYS_IN_WEEK 7
+
+    /**
+     * @brief rtc alarm, stored as is in the config store. only append fields, never
+     * reorder or resize them
+     */
+    typedef struct {
+        bool enabled;
+        uint8_t hour;
+        uint8_t minute;
+        bool week_days[DAYS_IN_WEEK]; //starting from sunday to be aligned with tm
+    } rtcctl_alarm_t;
+
+    /**
+     * @brief fill the alarm from the legacy json, missing keys read as 0 and off
+     *
+     * @param   alarm       pointer to the alarm
+     * @param   json        root object of rtcctr.json
+     */
+    void rtcctl_alarm_from_json( rtcctl_alarm_t *alarm, JsonObjectConst json );
+    /**
+     * @brief write the alarm as legacy json
+     *
+     * @param   alarm       pointer to the alarm
+     * @param   json        root object to fill
+     */
+    void rtcctl_alarm_to_json( const rtcctl_alarm_t *alarm, JsonObject json );
+
+#endif // _RTCCTL_CONFIG_H
@@ -27,6 +27,7 @@
 #include "timesync.h"
 #include "powermgm.h"
 #include "blectl.h"
+#include "configstore.h"
 #include "json_psram_allocator.h"
 #include "callback.h"
 
@@ -143,6 +144,21 @@ bool timesync_blectl_event_cb( EventBits_t event, void *arg ) {
 }
 
 void timesync_save_config( void ) {
+    configstore_save( CONFIGSTORE_TIMESYNC );
+}
+
+void timesync_read_config( void ) {
+    if ( !configstore_register( CONFIGSTORE_TIMESYNC, &timesync_config, sizeof( timesync_config ), timesync_read_json_config, timesync_save_json_config ) ) {
+        timesync_read_json_config();
+        timesync_save_config();
+    }
+    else {
+        setenv("TZ", timesync_config.timezone_rule, 1);
+        tzset();
+    }
+}
+
+void timesync_save_json_config( void ) {
     fs::File file = SPIFFS.open( TIMESYNC_JSON_CONFIG_FILE, FILE_WRITE );
 
     if (!file) {
@@ -151,12 +167,7 @@ void timesync_save_config( void ) {
     else {
         SpiRamJsonDocument doc( 1000 );
 
-        doc["daylightsave"] = timesync_config.daylightsave;
-        doc["timesync"] = timesync_config.timesync;
-        doc["timezone"] = timesync_config.timezone;
-        doc["use_24hr_clock"] = timesync_config.use_24hr_clock;
-        doc["timezone_name"] = timesync_config.timezone_name;
-        doc["timezone_rule"] = timesync_config.timezone_rule;
+        timesync_config_to_json( &timesync_config, doc.to<JsonObject>() );
 
         if ( serializeJsonPretty( doc, file ) == 0) {
             log_e("Failed to write config file");
@@ -166,7 +177,7 @@ void timesync_save_config( void ) {
     file.close();
 }
 
-void timesync_read_config( void ) {    
+void timesync_read_json_config( void ) {    
     fs::File file = SPIFFS.open( TIMESYNC_JSON_CONFIG_FILE, FILE_READ );
 
     if (!file) {
@@ -181,15 +192,7 @@ void timesync_read_config( void ) {
             log_e("update check deserializeJson() failed: %s", error.c_str() );
         }
         else {
-            timesync_config.daylightsave = doc["daylightsave"] | false;
-            timesync_config.timesync = doc["timesync"] | true;
-            timesync_config.timezone = doc["timezone"] | 0;
-            timesync_config.use_24hr_clock = doc["use_24hr_clock"] | true;
-            // todo: for upgrade, default name = Etc\GMTxxx based on timezone & daylightsave
-            // todo: for upgrade, default rule = GMT0 or <-xx>xx based on timezone & daylightsave
-            // todo: upgrade rtc clock to be in utc? (First sync will fix it.)
-            strlcpy( timesync_config.timezone_name, doc["timezone_name"] | TIMEZONE_NAME_DEFAULT, sizeof( timesync_config.timezone_name ) );
-            strlcpy( timesync_config.timezone_rule, doc["timezone_rule"] | TIMEZONE_RULE_DEFAULT, sizeof( timesync_config.timezone_rule ) );
+            timesync_config_from_json( &timesync_config, doc.as<JsonObjectConst>() );
             setenv("TZ", timesync_config.timezone_rule, 1);
             tzset();
         }
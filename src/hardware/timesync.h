@@ -24,25 +24,12 @@
 
     #include <TTGO.h>
     #include "callback.h"
+    #include "timesync_config.h"
 
     #define TIME_SYNC_REQUEST       _BV(0)
     #define TIME_SYNC_OK            _BV(1)
 
     #define TIMESYNC_JSON_CONFIG_FILE   "/timesync.json"    /** @brief defines json config file name */
-    #define TIMEZONE_NAME_DEFAULT       "Etc/GMT"           /** @brief defines default time zone name */
-    #define TIMEZONE_RULE_DEFAULT       "GMT0"              /** @brief defines default time zone rule */
-
-    /**
-     * @brief time sync config structure
-     */
-    typedef struct {
-        bool timesync = true;               /** @brief time sync on/off */
-        bool daylightsave = false;          /** @brief day light save on/off */
-        int32_t timezone = 0;               /** @brief time zone from 0..24, 0 means -12 */
-        bool use_24hr_clock = true;         /** @brief 12h/24h time format */
-        char timezone_name[32] = TIMEZONE_NAME_DEFAULT; /** @brief name of the time zone to use */
-        char timezone_rule[48] = TIMEZONE_RULE_DEFAULT; /** @brief time zone rule to use */
-    } timesync_config_t;
 
     /**
      * @brief setup display
@@ -56,6 +43,14 @@
      * @brief read config for timesync from spiffs
      */
     void timesync_read_config( void );
+    /**
+     * @brief write the config as legacy json file to spiffs
+     */
+    void timesync_save_json_config( void );
+    /**
+     * @brief import the config from the legacy json file on spiffs
+     */
+    void timesync_read_json_config( void );
     /**
      * @brief get the status if timesync enable/disable
      * 
@@ -0,0 +1,42 @@
+/****************************************************************************
+ *   Copyright  2020  Jesper Ortlund
+ ****************************************************************************/
+/*
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+#include <stdio.h>
+
+#include "timesync_config.h"
+
+void timesync_config_from_json( timesync_config_t *config, JsonObjectConst json ) {
+    config->daylightsave = json["daylightsave"] | false;
+    config->timesync = json["timesync"] | true;
+    config->timezone = json["timezone"] | 0;
+    config->use_24hr_clock = json["use_24hr_clock"] | true;
+    // todo: for upgrade, default name = Etc\GMTxxx based on timezone & daylightsave
+    // todo: for upgrade, default rule = GMT0 or <-xx>xx based on timezone & daylightsave
+    // todo: upgrade rtc clock to be in utc? (First sync will fix it.)
+    snprintf( config->timezone_name, sizeof( config->timezone_name ), "%s", json["timezone_name"] | TIMEZONE_NAME_DEFAULT );
+    snprintf( config->timezone_rule, sizeof( config->timezone_rule ), "%s", json["timezone_rule"] | TIMEZONE_RULE_DEFAULT );
+}
+
+void timesync_config_to_json( const timesync_config_t *config, JsonObject json ) {
+    json["daylightsave"] = config->daylightsave;
+    json["timesync"] = config->timesync;
+    json["timezone"] = config->timezone;
+    json["use_24hr_clock"] = config->use_24hr_clock;
+    json["timezone_name"] = config->timezone_name;
+    json["timezone_rule"] = config->timezone_rule;
+}
@@ -0,0 +1,60 @@
+/****************************************************************************
+ *   Copyright  2020  Jesper Ortlund
+ ****************************************************************************/
+/*
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+#ifndef _TIMESYNC_CONFIG_H
+    #define _TIMESYNC_CONFIG_H
+
+    /*
+     * no arduino or spiffs in here, the config and its json mapping build and run on the host
+     */
+    #include <stdint.h>
+    #include <ArduinoJson.h>
+
+
+    #define TIMEZONE_NAME_DEFAULT       "Etc/GMT"           /** @brief defines default time zone name */
+    #define TIMEZONE_RULE_DEFAULT       "GMT0"              /** @brief defines default time zone rule */
+
+    /**
+     * @brief time sync config structure, stored as is in the config store. only append
+     * fields, never reorder or resize them
+     */
+    typedef struct {
+        bool timesync = true;               /** @brief time sync on/off */
+        bool daylightsave = false;          /** @brief day light save on/off */
+        int32_t timezone = 0;               /** @brief time zone from 0..24, 0 means -12 */
+        bool use_24hr_clock = true;         /** @brief 12h/24h time format */
+        char timezone_name[32] = TIMEZONE_NAME_DEFAULT; /** @brief name of the time zone to use */
+        char timezone_rule[48] = TIMEZONE_RULE_DEFAULT; /** @brief time zone rule to use */
+    } timesync_config_t;
+
+    /**
+     * @brief fill the time sync config from the legacy json, missing keys get their defaults
+     *
+     * @param   config      pointer to the config
+     * @param   json        root object of timesync.json
+     */
+    void timesync_config_from_json( timesync_config_t *config, JsonObjectConst json );
+    /**
+     * @brief write the time sync config as legacy json
+     *
+     * @param   config      pointer to the config
+     * @param   json        root object to fill
+     */
+    void timesync_config_to_json( const timesync_config_t *config, JsonObject json );
+
+#endif // _TIMESYNC_CONFIG_H
@@ -26,95 +26,139 @@
 
 lv_indev_t *touch_indev = NULL;
 
+volatile bool DRAM_ATTR touch_irq_flag = false;
+portMUX_TYPE DRAM_ATTR TOUCH_IRQ_Mux = portMUX_INITIALIZER_UNLOCKED;
+
+/*
+ * raw controller coordinates to screen coordinates, x = ( xx * px + xy * py + x0 ) >> TOUCH_TRANSFORM_SHIFT
+ */
+typedef struct
+{
+    int32_t xx, xy, x0;
+    int32_t yx, yy, y0;
+} touch_transform_t;
+
+static touch_transform_t touch_transform[4];
+static volatile bool touch_enabled = true;
+static bool touch_active = false;
+
 static bool touch_read(lv_indev_drv_t *drv, lv_indev_data_t *data);
 static bool touch_getXY(int16_t &x, int16_t &y);
+static void touch_setup_transform(touch_transform_t *transform, int xx, int xy, int x0, int yx, int yy, int y0);
+void IRAM_ATTR touch_irq(void);
 bool touch_powermgm_event_cb(EventBits_t event, void *arg);
 
 void touch_setup(void)
 {
+    /*
+     * one transform per display rotation, so a touch read is two multiply-adds per axis
+     */
+    touch_setup_transform(&touch_transform[0], -1, 0, TFT_WIDTH, 0, -1, TFT_HEIGHT);
+    touch_setup_transform(&touch_transform[1], 0, -1, TFT_WIDTH, 1, 0, 0);
+    touch_setup_transform(&touch_transform[2], 1, 0, 0, 0, 1, 0);
+    touch_setup_transform(&touch_transform[3], 0, 1, 0, -1, 0, TFT_HEIGHT);
+
     touch_indev = lv_indev_get_next(NULL);
     touch_indev->driver.read_cb = touch_read;
 
+    pinMode(TOUCH_INT, INPUT);
+    attachInterrupt(TOUCH_INT, &touch_irq, FALLING);
+
     powermgm_register_cb(POWERMGM_SILENCE_WAKEUP | POWERMGM_STANDBY | POWERMGM_WAKEUP, touch_powermgm_event_cb, "touch");
 }
 
+static void touch_setup_transform(touch_transform_t *transform, int xx, int xy, int x0, int yx, int yy, int y0)
+{
+    /*
+     * issue https://github.com/sharandac/My-TTGO-Watch/issues/18 fix, stretch x by TOUCH_SCALE_X around the
+     * screen center and fold it into the rotation
+     */
+    int32_t hor_center = lv_disp_get_hor_res(NULL) / 2;
+
+    transform->xx = xx * TOUCH_SCALE_X;
+    transform->xy = xy * TOUCH_SCALE_X;
+    transform->x0 = (x0 - hor_center) * TOUCH_SCALE_X + (hor_center << TOUCH_TRANSFORM_SHIFT);
+    transform->yx = yx << TOUCH_TRANSFORM_SHIFT;
+    transform->yy = yy << TOUCH_TRANSFORM_SHIFT;
+    transform->y0 = y0 << TOUCH_TRANSFORM_SHIFT;
+}
+
 bool touch_powermgm_event_cb(EventBits_t event, void *arg)
 {
-    TTGOClass *ttgo = TTGOClass::getWatch();
-    
     switch (event)
     {
     case POWERMGM_STANDBY:
         log_i("go standby");
-        //ttgo->touchToSleep(); //adjusted for compatibility to the focaltech driver
+        touch_enabled = false;
         break;
     case POWERMGM_WAKEUP:
         log_i("go wakeup");
-        //ttgo->touchToMonitor(); //adjusted for compatibility to the focaltech driver
+        /*
+         * drop touches latched while we were asleep
+         */
+        portENTER_CRITICAL(&TOUCH_IRQ_Mux);
+        touch_irq_flag = false;
+        portEXIT_CRITICAL(&TOUCH_IRQ_Mux);
+        touch_active = false;
+        touch_enabled = true;
         break;
     case POWERMGM_SILENCE_WAKEUP:
         log_i("go silence wakeup");
-        //ttgo->touchToSleep(); //adjusted for compatibility to the focaltech driver
+        touch_enabled = false;
         break;
     }
     return (true);
 }
 
-static bool touch_getXY(int16_t &x, int16_t &y)
+void IRAM_ATTR touch_irq(void)
 {
+    portENTER_CRITICAL_ISR(&TOUCH_IRQ_Mux);
+    touch_irq_flag = true;
+    portEXIT_CRITICAL_ISR(&TOUCH_IRQ_Mux);
+}
 
+static bool touch_getXY(int16_t &x, int16_t &y)
+{
     TTGOClass *ttgo = TTGOClass::getWatch();
     int16_t px = 0;
     int16_t py = 0;
-    static bool touch_press = false;
 
-    // disable touch when we are in standby or silence wakeup
-    if (powermgm_get_event(POWERMGM_STANDBY | POWERMGM_SILENCE_WAKEUP))
+    // touch is disabled when we are in standby or silence wakeup
+    if (!touch_enabled)
+    {
+        return (false);
+    }
+
+    portENTER_CRITICAL(&TOUCH_IRQ_Mux);
+    bool temp_touch_irq_flag = touch_irq_flag;
+    touch_irq_flag = false;
+    portEXIT_CRITICAL(&TOUCH_IRQ_Mux);
+
+    /*
+     * nobody touched the screen since the last release, skip the i2c transfer
+     */
+    if (!temp_touch_irq_flag && !touch_active)
     {
-        Serial.println("touch disabled");
         return (false);
     }
 
     if (!ttgo->touched()) //adjusted for compatibility to the focaltech driver
     {
-        touch_press = false;
+        touch_active = false;
         return (false);
     }
 
-    if (!touch_press)
+    if (!touch_active)
     {
-        touch_press = true;
+        touch_active = true;
         motor_vibe(1);
     }
 
     ttgo->getTouch(px, py); //adjusted for compatibility to the focaltech driver
 
-    uint8_t rotation = ttgo->tft->getRotation();
-    switch (rotation)
-    {
-    case 0:
-        x = TFT_WIDTH - px;
-        y = TFT_HEIGHT - py;
-        break;
-    case 1:
-        x = TFT_WIDTH - py;
-        y = px;
-        break;
-    case 3:
-        x = py;
-        y = TFT_HEIGHT - px;
-        break;
-    case 2:
-    default:
-        x = px;
-        y = py;
-    }
-
-    // issue https://github.com/sharandac/My-TTGO-Watch/issues/18 fix
-    float temp_x = (x - (lv_disp_get_hor_res(NULL) / 2)) * 1.15;
-    float temp_y = (y - (lv_disp_get_ver_res(NULL) / 2)) * 1.0;
-    x = temp_x + (lv_disp_get_hor_res(NULL) / 2);
-    y = temp_y + (lv_disp_get_ver_res(NULL) / 2);
+    touch_transform_t *transform = &touch_transform[ttgo->tft->getRotation() & 3];
+    x = (transform->xx * px + transform->xy * py + transform->x0) >> TOUCH_TRANSFORM_SHIFT;
+    y = (transform->yx * px + transform->yy * py + transform->y0) >> TOUCH_TRANSFORM_SHIFT;
 
     return (true);
 }
@@ -123,4 +167,4 @@ static bool touch_read(lv_indev_drv_t *drv, lv_indev_data_t *data)
 {
     data->state = touch_getXY(data->point.x, data->point.y) ? LV_INDEV_STATE_PR : LV_INDEV_STATE_REL;
     return (false);
-}
\ No newline at end of file
+}
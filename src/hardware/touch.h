@@ -24,6 +24,10 @@
     #define _TOUCH_H
 
     #include "TTGO.h"
+
+    #define TOUCH_TRANSFORM_SHIFT       8           /** @brief touch transform is kept in 24.8 fixed point */
+    #define TOUCH_SCALE_X               294         /** @brief 1.15 in 24.8 fixed point, horizontal stretch of the touch panel */
+
     /**
      * @brief setup touch
      */
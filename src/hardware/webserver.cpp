@@ -0,0 +1,662 @@
+/****************************************************************************
+ *   Copyright  2020  Jesper Ortlund
+ ****************************************************************************/
+/*
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+#include "config.h"
+#include <Arduino.h>
+#include <WiFi.h>
+#include <AsyncTCP.h>
+#include <SPIFFS.h>
+#include <mbedtls/sha1.h>
+#include <mbedtls/base64.h>
+
+#include "webserver.h"
+#include "webserver_proto.h"
+#include "wifictl.h"
+#include "wheelctl.h"
+#include "alloc.h"
+#include "arena.h"
+
+#define WEBSERVER_WS_GUID           "258EAFA5-E914-47DA-95CA-C5AB0DC85B11"
+#define WEBSERVER_FILES_PATH        "/files"
+#define WEBSERVER_CHUNK_OVERHEAD    8           /** @brief chunk size line and trailing crlf */
+
+enum {
+    WEBSERVER_CLIENT_FREE,
+    WEBSERVER_CLIENT_REQUEST,           /** @brief collecting request line and headers */
+    WEBSERVER_CLIENT_RESPONSE,          /** @brief sending a response body, closed when all is acked */
+    WEBSERVER_CLIENT_WEBSOCKET          /** @brief upgraded, gets the telemetry frames */
+};
+
+typedef struct {
+    AsyncClient *client;
+    uint8_t state;
+    char request[ WEBSERVER_REQUEST_SIZE ];
+    size_t request_len;
+    const char *body;                   /** @brief static response body */
+    size_t body_len;
+    size_t body_pos;
+    char *owned;                        /** @brief body allocated for this response, freed with the client */
+    fs::File file;                      /** @brief file response body, streamed from SPIFFS as the send buffer drains */
+    size_t file_left;                   /** @brief bytes left to send from file */
+    bool chunked;                       /** @brief file is sent with chunked transfer encoding */
+    size_t unacked;                     /** @brief bytes written and not yet acked */
+    uint32_t frame_seq;                 /** @brief last telemetry frame sent to this websocket client */
+} webserver_client_t;
+
+static const char webserver_index_html[] =
+"<!DOCTYPE html><html><head><meta name=\"viewport\" content=\"width=device-width\"><title>EUC Dash</title>"
+"<style>body{background:#000;color:#fff;font-family:sans-serif;text-align:center}td{padding:4px 12px;text-align:left}table{margin:auto}</style>"
+"</head><body><canvas id=\"g\" width=\"300\" height=\"260\"></canvas><table id=\"t\"></table><p id=\"st\">connecting</p><script>"
+"var c=document.getElementById('g').getContext('2d'),n={s:'speed km/h',v:'voltage V',c:'current A',p:'power W',t:'temp C',b:'battery %',o:'odo km'};"
+"function d(s,m){var f=Math.min(Math.max(s/m,0),1);c.clearRect(0,0,300,260);c.lineWidth=20;c.strokeStyle='#333';c.beginPath();"
+"c.arc(150,150,110,.75*Math.PI,2.25*Math.PI);c.stroke();c.strokeStyle=f>.9?'#f00':f>.75?'#fa0':'#0c0';c.beginPath();"
+"c.arc(150,150,110,.75*Math.PI,(.75+1.5*f)*Math.PI);c.stroke();c.fillStyle='#fff';c.font='64px sans-serif';c.textAlign='center';"
+"c.fillText(s.toFixed(1),150,170);}"
+"function o(){var w=new WebSocket('ws://'+location.host+'/ws');w.onopen=function(){document.getElementById('st').innerHTML='live';};"
+"w.onmessage=function(e){var m=JSON.parse(e.data),h='';d(m.s,m.x>0?m.x+5:50);for(var k in n)h+='<tr><td>'+n[k]+'</td><td>'+m[k]+'</td></tr>';"
+"document.getElementById('t').innerHTML=h;};w.onclose=function(){document.getElementById('st').innerHTML='reconnecting';setTimeout(o,1000);};}"
+"d(0,50);o();</script></body></html>";
+
+static webserver_client_t webserver_client[ WEBSERVER_MAX_CLIENTS ];
+static arena_pool_t webserver_list_pool;
+static AsyncServer *webserver_server = NULL;
+static webserver_stats_t webserver_stats;
+static uint32_t webserver_frame_seq = 0;
+
+/*
+ * the client table is used from the async_tcp task and the sender task,
+ * recursive because closing a client calls the disconnect handler right away
+ */
+static SemaphoreHandle_t webserver_mutex = NULL;
+portMUX_TYPE DRAM_ATTR webserverMux = portMUX_INITIALIZER_UNLOCKED;
+TaskHandle_t _webserver_Task = NULL;
+
+void webserver_Task( void * pvParameters );
+static void webserver_start( void );
+static void webserver_stop( void );
+static void webserver_send_frames( void );
+static void webserver_on_client( void *arg, AsyncClient *client );
+static void webserver_on_data( void *arg, AsyncClient *client, void *data, size_t len );
+static void webserver_on_ack( void *arg, AsyncClient *client, size_t len, uint32_t time );
+static void webserver_on_disconnect( void *arg, AsyncClient *client );
+static void webserver_handle_request( webserver_client_t *c );
+static void webserver_handle_websocket( webserver_client_t *c, uint8_t *data, size_t len );
+static void webserver_send_response( webserver_client_t *c, int code, const char *status, const char *type, const char *body, size_t len );
+static void webserver_pump( webserver_client_t *c );
+static void webserver_pump_file( webserver_client_t *c );
+static void webserver_release( webserver_client_t *c );
+static void webserver_handle_files( webserver_client_t *c, const char *method, const char *path );
+static void webserver_send_file( webserver_client_t *c, const char *filename );
+static void webserver_send_list( webserver_client_t *c );
+static bool webserver_served( const char *filename );
+static bool webserver_match_suffix( const char *filename, const char * const *suffix );
+
+void webserver_setup( void ) {
+    if ( _webserver_Task != NULL )
+        return;
+
+    webserver_mutex = xSemaphoreCreateRecursiveMutex();
+    if ( !arena_pool_init( &webserver_list_pool, ARENA_BULK, WEBSERVER_LIST_SIZE, WEBSERVER_MAX_CLIENTS, "webserver list" ) ) {
+        log_e("webserver list pool alloc failed");
+    }
+
+    xTaskCreatePinnedToCore(  webserver_Task,           /* Function to implement the task */
+                              "webserver Task",         /* Name of the task */
+                              WEBSERVER_TASK_STACK,     /* Stack size in words */
+                              NULL,                     /* Task input parameter */
+                              1,                        /* Priority of the task */
+                              &_webserver_Task,         /* Task handle. */
+                              0 );
+}
+
+void webserver_notify_frame( void ) {
+    portENTER_CRITICAL( &webserverMux );
+    webserver_frame_seq++;
+    webserver_stats.frames++;
+    bool listening = webserver_stats.clients != 0;
+    portEXIT_CRITICAL( &webserverMux );
+
+    if ( listening && _webserver_Task )
+        xTaskNotifyGive( _webserver_Task );
+}
+
+void webserver_get_stats( webserver_stats_t *stats ) {
+    portENTER_CRITICAL( &webserverMux );
+    *stats = webserver_stats;
+    portEXIT_CRITICAL( &webserverMux );
+}
+
+void webserver_Task( void * pvParameters ) {
+    log_i("start webserver task, heap: %d", ESP.getFreeHeap() );
+
+    while( true ) {
+        /*
+         * woken per decoded frame or on ack of a lagging client, the timeout
+         * follows the wifi and config state
+         */
+        ulTaskNotifyTake( pdTRUE, pdMS_TO_TICKS( 1000 ) );
+
+        bool run = wifictl_get_webserver() && WiFi.isConnected();
+        if ( run && webserver_server == NULL )
+            webserver_start();
+        else if ( !run && webserver_server != NULL )
+            webserver_stop();
+
+        if ( webserver_server )
+            webserver_send_frames();
+    }
+}
+
+static void webserver_start( void ) {
+    webserver_server = new AsyncServer( WEBSERVER_PORT );
+    webserver_server->onClient( webserver_on_client, NULL );
+    webserver_server->begin();
+    log_i("webserver listening on %s:%d", WiFi.localIP().toString().c_str(), WEBSERVER_PORT );
+}
+
+static void webserver_stop( void ) {
+    xSemaphoreTakeRecursive( webserver_mutex, portMAX_DELAY );
+    for ( int i = 0 ; i < WEBSERVER_MAX_CLIENTS ; i++ ) {
+        if ( webserver_client[ i ].state != WEBSERVER_CLIENT_FREE )
+            webserver_client[ i ].client->close( true );
+    }
+    xSemaphoreGiveRecursive( webserver_mutex );
+
+    webserver_server->end();
+    delete webserver_server;
+    webserver_server = NULL;
+    log_i("webserver stopped");
+}
+
+static void webserver_send_frames( void ) {
+    uint8_t buffer[ WEBSERVER_FRAME_SIZE ];
+    char *json = (char *)&buffer[ WEBSERVER_PROTO_WS_HEADER ];
+
+    portENTER_CRITICAL( &webserverMux );
+    uint32_t seq = webserver_frame_seq;
+    bool listening = webserver_stats.clients != 0;
+    portEXIT_CRITICAL( &webserverMux );
+
+    if ( !listening )
+        return;
+
+    /*
+     * build the frame once and hand it to every client that has room for it,
+     * a client that can't keep up skips frames and gets the latest one on its next ack
+     */
+    int payload = snprintf( json, sizeof( buffer ) - WEBSERVER_PROTO_WS_HEADER, "{\"q\":%u,\"s\":%.1f,\"v\":%.2f,\"c\":%.2f,\"p\":%.0f,\"t\":%.1f,\"b\":%.0f,\"o\":%.1f,\"x\":%.0f}",
+                                                                seq,
+                                                                wheelctl_get_data( WHEELCTL_SPEED ),
+                                                                wheelctl_get_data( WHEELCTL_VOLTAGE ),
+                                                                wheelctl_get_data( WHEELCTL_CURRENT ),
+                                                                wheelctl_get_data( WHEELCTL_POWER ),
+                                                                wheelctl_get_data( WHEELCTL_TEMP ),
+                                                                wheelctl_get_data( WHEELCTL_BATTPCT ),
+                                                                wheelctl_get_data( WHEELCTL_ODO ),
+                                                                wheelctl_get_data( WHEELCTL_TILTBACK ) );
+    payload = min( payload, (int)sizeof( buffer ) - WEBSERVER_PROTO_WS_HEADER - 1 );
+
+    uint8_t *frame;
+    size_t len = webserver_proto_ws_encode( buffer, WEBSERVER_PROTO_WS_TEXT, payload, &frame );
+    uint32_t sent = 0;
+    uint32_t dropped = 0;
+
+    xSemaphoreTakeRecursive( webserver_mutex, portMAX_DELAY );
+    for ( int i = 0 ; i < WEBSERVER_MAX_CLIENTS ; i++ ) {
+        webserver_client_t *c = &webserver_client[ i ];
+
+        if ( c->state != WEBSERVER_CLIENT_WEBSOCKET )
+            continue;
+        if ( !webserver_proto_take_latest( &c->frame_seq, seq, c->client->canSend() && c->client->space() >= len, &dropped ) )
+            continue;
+        c->client->write( (const char *)frame, len );
+        sent++;
+    }
+    xSemaphoreGiveRecursive( webserver_mutex );
+
+    portENTER_CRITICAL( &webserverMux );
+    webserver_stats.sent += sent;
+    webserver_stats.dropped += dropped;
+    portEXIT_CRITICAL( &webserverMux );
+}
+
+static void webserver_on_client( void *arg, AsyncClient *client ) {
+    webserver_client_t *c = NULL;
+
+    xSemaphoreTakeRecursive( webserver_mutex, portMAX_DELAY );
+    for ( int i = 0 ; i < WEBSERVER_MAX_CLIENTS ; i++ ) {
+        if ( webserver_client[ i ].state == WEBSERVER_CLIENT_FREE ) {
+            c = &webserver_client[ i ];
+            c->client = client;
+            c->state = WEBSERVER_CLIENT_REQUEST;
+            c->request_len = 0;
+            c->body = NULL;
+            c->body_len = 0;
+            c->body_pos = 0;
+            c->owned = NULL;
+            c->file_left = 0;
+            c->unacked = 0;
+            c->frame_seq = 0;
+            break;
+        }
+    }
+    xSemaphoreGiveRecursive( webserver_mutex );
+
+    if ( c == NULL ) {
+        log_w("no free client slot for %s", client->remoteIP().toString().c_str() );
+        client->close( true );
+        delete client;
+        return;
+    }
+
+    client->setNoDelay( true );
+    client->onData( webserver_on_data, c );
+    client->onAck( webserver_on_ack, c );
+    client->onDisconnect( webserver_on_disconnect, c );
+    client->onError( []( void *arg, AsyncClient *client, int8_t error ) {
+        log_w("client error %s", client->errorToString( error ) );
+    }, c );
+}
+
+static void webserver_on_disconnect( void *arg, AsyncClient *client ) {
+    webserver_client_t *c = (webserver_client_t *)arg;
+
+    xSemaphoreTakeRecursive( webserver_mutex, portMAX_DELAY );
+    if ( c->state == WEBSERVER_CLIENT_WEBSOCKET ) {
+        portENTER_CRITICAL( &webserverMux );
+        webserver_stats.clients--;
+        portEXIT_CRITICAL( &webserverMux );
+    }
+    webserver_release( c );
+    c->state = WEBSERVER_CLIENT_FREE;
+    c->client = NULL;
+    xSemaphoreGiveRecursive( webserver_mutex );
+
+    delete client;
+}
+
+static void webserver_on_data( void *arg, AsyncClient *client, void *data, size_t len ) {
+    webserver_client_t *c = (webserver_client_t *)arg;
+
+    xSemaphoreTakeRecursive( webserver_mutex, portMAX_DELAY );
+    switch( c->state ) {
+        case WEBSERVER_CLIENT_REQUEST:      if ( c->request_len + len >= WEBSERVER_REQUEST_SIZE ) {
+                                                webserver_send_response( c, 431, "Request Header Fields Too Large", "text/plain", "", 0 );
+                                                break;
+                                            }
+                                            memcpy( &c->request[ c->request_len ], data, len );
+                                            c->request_len += len;
+                                            c->request[ c->request_len ] = '\0';
+                                            if ( strstr( c->request, "\r\n\r\n" ) )
+                                                webserver_handle_request( c );
+                                            break;
+        case WEBSERVER_CLIENT_WEBSOCKET:    webserver_handle_websocket( c, (uint8_t *)data, len );
+                                            break;
+    }
+    xSemaphoreGiveRecursive( webserver_mutex );
+}
+
+static void webserver_on_ack( void *arg, AsyncClient *client, size_t len, uint32_t time ) {
+    webserver_client_t *c = (webserver_client_t *)arg;
+
+    xSemaphoreTakeRecursive( webserver_mutex, portMAX_DELAY );
+    switch( c->state ) {
+        case WEBSERVER_CLIENT_RESPONSE:     c->unacked = ( len < c->unacked ) ? c->unacked - len : 0;
+                                            webserver_pump( c );
+                                            break;
+        case WEBSERVER_CLIENT_WEBSOCKET:    if ( c->frame_seq != webserver_frame_seq && _webserver_Task )
+                                                xTaskNotifyGive( _webserver_Task );
+                                            break;
+    }
+    xSemaphoreGiveRecursive( webserver_mutex );
+}
+
+static void webserver_handle_request( webserver_client_t *c ) {
+    char method[ 8 ];
+    char path[ 128 ];
+    char key[ 32 ];
+
+    if ( sscanf( c->request, "%7s %127s", method, path ) != 2 ) {
+        webserver_send_response( c, 400, "Bad Request", "text/plain", "", 0 );
+        return;
+    }
+
+    size_t files_len = sizeof( WEBSERVER_FILES_PATH ) - 1;
+    if ( !strncmp( path, WEBSERVER_FILES_PATH, files_len ) && ( path[ files_len ] == '\0' || path[ files_len ] == '/' ) ) {
+        webserver_handle_files( c, method, &path[ sizeof( WEBSERVER_FILES_PATH ) - 1 ] );
+        return;
+    }
+
+    if ( strcmp( method, "GET" ) ) {
+        webserver_send_response( c, 405, "Method Not Allowed", "text/plain", "", 0 );
+        return;
+    }
+
+    if ( !strcmp( path, "/" ) || !strcmp( path, "/index.html" ) ) {
+        webserver_send_response( c, 200, "OK", "text/html", webserver_index_html, sizeof( webserver_index_html ) - 1 );
+        return;
+    }
+
+    if ( !strcmp( path, "/ws" ) && webserver_proto_get_header( c->request, "Sec-WebSocket-Key", key, sizeof( key ) ) ) {
+        char accept_src[ sizeof( key ) + sizeof( WEBSERVER_WS_GUID ) ];
+        unsigned char sha1[ 20 ];
+        unsigned char accept[ 32 ];
+        size_t accept_len = 0;
+        char response[ 160 ];
+
+        snprintf( accept_src, sizeof( accept_src ), "%s%s", key, WEBSERVER_WS_GUID );
+        mbedtls_sha1_ret( (const unsigned char *)accept_src, strlen( accept_src ), sha1 );
+        mbedtls_base64_encode( accept, sizeof( accept ) - 1, &accept_len, sha1, sizeof( sha1 ) );
+        accept[ accept_len ] = '\0';
+
+        int len = snprintf( response, sizeof( response ), "HTTP/1.1 101 Switching Protocols\r\nUpgrade: websocket\r\nConnection: Upgrade\r\nSec-WebSocket-Accept: %s\r\n\r\n", accept );
+        c->client->write( response, len );
+        c->state = WEBSERVER_CLIENT_WEBSOCKET;
+
+        portENTER_CRITICAL( &webserverMux );
+        webserver_stats.clients++;
+        portEXIT_CRITICAL( &webserverMux );
+        log_i("websocket client %s", c->client->remoteIP().toString().c_str() );
+        return;
+    }
+
+    webserver_send_response( c, 404, "Not Found", "text/plain", "not found", 9 );
+}
+
+static void webserver_handle_websocket( webserver_client_t *c, uint8_t *data, size_t len ) {
+    webserver_proto_ws_frame_t frame;
+    size_t pos = 0;
+    int used;
+
+    /*
+     * clients only send control frames here, text and binary frames are ignored
+     */
+    while ( ( used = webserver_proto_ws_decode( &data[ pos ], len - pos, &frame ) ) != 0 ) {
+        if ( used < 0 ) {
+            c->client->close( true );
+            return;
+        }
+
+        switch( frame.opcode ) {
+            case WEBSERVER_PROTO_WS_CLOSE:  {
+                                                uint8_t close_frame[ WEBSERVER_PROTO_WS_HEADER ];
+                                                uint8_t *start;
+                                                size_t close_len = webserver_proto_ws_encode( close_frame, WEBSERVER_PROTO_WS_CLOSE, 0, &start );
+                                                c->client->write( (const char *)start, close_len );
+                                                c->client->close( false );
+                                                return;
+                                            }
+            case WEBSERVER_PROTO_WS_PING:   if ( frame.len <= 125 ) {
+                                                uint8_t pong[ WEBSERVER_PROTO_WS_HEADER + 125 ];
+                                                uint8_t *start;
+                                                memcpy( &pong[ WEBSERVER_PROTO_WS_HEADER ], frame.payload, frame.len );
+                                                size_t pong_len = webserver_proto_ws_encode( pong, WEBSERVER_PROTO_WS_PONG, frame.len, &start );
+                                                c->client->write( (const char *)start, pong_len );
+                                            }
+                                            break;
+        }
+        pos += used;
+    }
+}
+
+static void webserver_send_response( webserver_client_t *c, int code, const char *status, const char *type, const char *body, size_t len ) {
+    char header[ 160 ];
+
+    int header_len = snprintf( header, sizeof( header ), "HTTP/1.1 %d %s\r\nContent-Type: %s\r\nContent-Length: %u\r\nConnection: close\r\n\r\n", code, status, type, (unsigned)len );
+    c->client->write( header, header_len );
+
+    c->state = WEBSERVER_CLIENT_RESPONSE;
+    c->body = body;
+    c->body_len = len;
+    c->body_pos = 0;
+    c->unacked = header_len;
+    webserver_pump( c );
+}
+
+static void webserver_pump( webserver_client_t *c ) {
+    if ( c->file ) {
+        webserver_pump_file( c );
+        return;
+    }
+
+    /*
+     * the body is static or owned by the client, hand it to lwip without a copy
+     * as far as the send buffer allows
+     */
+    while ( c->body_pos < c->body_len && c->client->canSend() && c->client->space() ) {
+        size_t len = min( c->client->space(), c->body_len - c->body_pos );
+        len = c->client->add( &c->body[ c->body_pos ], len, 0 );
+        if ( len == 0 )
+            break;
+        c->body_pos += len;
+        c->unacked += len;
+    }
+    c->client->send();
+
+    if ( c->body_pos >= c->body_len && c->unacked == 0 )
+        c->client->close( true );
+}
+
+static void webserver_pump_file( webserver_client_t *c ) {
+    char chunk[ 1024 ];
+    char size_line[ WEBSERVER_CHUNK_OVERHEAD ];
+
+    /*
+     * read only as much as lwip can take right now, the next ack continues.
+     * a multi megabyte log never needs more than this one chunk of memory
+     */
+    while ( c->file_left && c->client->canSend() && c->client->space() > WEBSERVER_CHUNK_OVERHEAD * 2 ) {
+        size_t len = min( c->client->space() - WEBSERVER_CHUNK_OVERHEAD * 2, sizeof( chunk ) );
+        len = c->file.read( (uint8_t *)chunk, min( len, c->file_left ) );
+        if ( len == 0 ) {
+            c->file_left = 0;
+            break;
+        }
+
+        if ( c->chunked ) {
+            int size_len = snprintf( size_line, sizeof( size_line ), "%x\r\n", (unsigned)len );
+            c->client->add( size_line, size_len );
+            c->unacked += size_len + 2;
+        }
+        c->client->add( chunk, len );
+        if ( c->chunked )
+            c->client->add( "\r\n", 2, 0 );
+        c->file_left -= len;
+        c->unacked += len;
+    }
+
+    if ( c->file_left == 0 ) {
+        if ( c->chunked && c->client->space() >= 5 ) {
+            c->client->add( "0\r\n\r\n", 5, 0 );
+            c->unacked += 5;
+            c->chunked = false;
+        }
+        if ( !c->chunked )
+            c->file.close();
+    }
+    c->client->send();
+
+    if ( !c->file && c->unacked == 0 )
+        c->client->close( true );
+}
+
+static void webserver_release( webserver_client_t *c ) {
+    if ( c->file )
+        c->file.close();
+    if ( c->owned ) {
+        arena_pool_put( &webserver_list_pool, c->owned );
+        c->owned = NULL;
+    }
+}
+
+static void webserver_handle_files( webserver_client_t *c, const char *method, const char *path ) {
+    char filename[ 64 ];
+
+    /*
+     * /files lists, /files/<name> downloads or deletes the SPIFFS file /<name>,
+     * files that are not served look like they don't exist, and can't be deleted
+     */
+    if ( path[ 0 ] == '\0' || !strcmp( path, "/" ) ) {
+        if ( strcmp( method, "GET" ) )
+            webserver_send_response( c, 405, "Method Not Allowed", "text/plain", "", 0 );
+        else
+            webserver_send_list( c );
+        return;
+    }
+
+    strlcpy( filename, path, sizeof( filename ) );
+    if ( strstr( filename, ".." ) || !webserver_served( filename ) || !SPIFFS.exists( filename ) ) {
+        webserver_send_response( c, 404, "Not Found", "text/plain", "not found", 9 );
+        return;
+    }
+
+    if ( !strcmp( method, "GET" ) ) {
+        webserver_send_file( c, filename );
+    }
+    else if ( !strcmp( method, "DELETE" ) ) {
+        if ( SPIFFS.remove( filename ) ) {
+            log_i("deleted %s", filename );
+            webserver_send_response( c, 200, "OK", "text/plain", "deleted", 7 );
+        }
+        else {
+            webserver_send_response( c, 500, "Internal Server Error", "text/plain", "delete failed", 13 );
+        }
+    }
+    else {
+        webserver_send_response( c, 405, "Method Not Allowed", "text/plain", "", 0 );
+    }
+}
+
+static void webserver_send_file( webserver_client_t *c, const char *filename ) {
+    char range[ 48 ];
+    char header[ 256 ];
+    int header_len;
+
+    c->file = SPIFFS.open( filename, FILE_READ );
+    if ( !c->file ) {
+        webserver_send_response( c, 500, "Internal Server Error", "text/plain", "open failed", 11 );
+        return;
+    }
+
+    size_t size = c->file.size();
+    const char *type = strstr( filename, ".csv" ) ? "text/csv" : strstr( filename, ".json" ) ? "application/json" : "application/octet-stream";
+
+    /*
+     * a single range resumes an interrupted download, the whole file goes out chunked
+     */
+    if ( webserver_proto_get_header( c->request, "Range", range, sizeof( range ) ) ) {
+        unsigned int first = 0;
+        unsigned int last = size ? size - 1 : 0;
+        bool valid;
+
+        if ( !strncmp( range, "bytes=-", 7 ) ) {
+            unsigned int suffix = atoi( &range[ 7 ] );
+            first = suffix < size ? size - suffix : 0;
+            valid = suffix > 0;
+        }
+        else {
+            valid = sscanf( range, "bytes=%u-%u", &first, &last ) >= 1;
+            last = min( last, (unsigned int)size - 1 );
+        }
+
+        if ( !valid || size == 0 || first > last ) {
+            c->file.close();
+            header_len = snprintf( header, sizeof( header ), "HTTP/1.1 416 Range Not Satisfiable\r\nContent-Range: bytes */%u\r\nContent-Length: 0\r\nConnection: close\r\n\r\n", (unsigned)size );
+            c->client->write( header, header_len );
+            c->state = WEBSERVER_CLIENT_RESPONSE;
+            c->unacked = header_len;
+            return;
+        }
+
+        c->file.seek( first );
+        c->file_left = last - first + 1;
+        c->chunked = false;
+        header_len = snprintf( header, sizeof( header ), "HTTP/1.1 206 Partial Content\r\nContent-Type: %s\r\nContent-Range: bytes %u-%u/%u\r\nContent-Length: %u\r\nAccept-Ranges: bytes\r\nConnection: close\r\n\r\n",
+                                                            type, first, last, (unsigned)size, (unsigned)c->file_left );
+    }
+    else {
+        c->file_left = size;
+        c->chunked = true;
+        header_len = snprintf( header, sizeof( header ), "HTTP/1.1 200 OK\r\nContent-Type: %s\r\nTransfer-Encoding: chunked\r\nAccept-Ranges: bytes\r\nConnection: close\r\n\r\n", type );
+    }
+
+    log_i("send %s, %u bytes", filename, (unsigned)c->file_left );
+    c->client->write( header, header_len );
+    c->state = WEBSERVER_CLIENT_RESPONSE;
+    c->unacked = header_len;
+    webserver_pump( c );
+}
+
+static void webserver_send_list( webserver_client_t *c ) {
+    size_t size = WEBSERVER_LIST_SIZE;
+    size_t len = 0;
+
+    c->owned = (char *)arena_pool_get( &webserver_list_pool );
+    if ( c->owned == NULL ) {
+        webserver_send_response( c, 500, "Internal Server Error", "text/plain", "out of memory", 13 );
+        return;
+    }
+
+    /*
+     * the closing "]}" and the '\0' of snprintf always stay free, an entry that doesn't fit
+     * in front of them ends the list, so a full listing is still valid json
+     */
+    size -= sizeof( "]}" ) - 1;
+    len += snprintf( &c->owned[ len ], size - len, "{\"total\":%u,\"used\":%u,\"files\":[", (unsigned)SPIFFS.totalBytes(), (unsigned)SPIFFS.usedBytes() );
+    fs::File root = SPIFFS.open( "/" );
+    fs::File file = root.openNextFile();
+    bool first = true;
+    while ( file ) {
+        if ( webserver_served( file.name() ) ) {
+            int entry = snprintf( &c->owned[ len ], size - len, "%s{\"name\":\"%s\",\"size\":%u}", first ? "" : ",", file.name(), (unsigned)file.size() );
+            if ( entry < 0 || (size_t)entry >= size - len ) {
+                log_w("file list full, %s and later files left out", file.name() );
+                break;
+            }
+            len += entry;
+            first = false;
+        }
+        file = root.openNextFile();
+    }
+    root.close();
+    memcpy( &c->owned[ len ], "]}", 2 );
+    len += 2;
+
+    webserver_send_response( c, 200, "OK", "application/json", c->owned, len );
+}
+
+/*
+ * only logs and screen captures leave the watch, the config files hold the
+ * wifi and broker passwords in plain text
+ */
+static const char *webserver_served_suffix[] = { ".csv", ".log", ".rle", NULL };
+
+static bool webserver_served( const char *filename ) {
+    return( webserver_match_suffix( filename, webserver_served_suffix ) );
+}
+
+static bool webserver_match_suffix( const char *filename, const char * const *suffix ) {
+    size_t len = strlen( filename );
+
+    for ( ; *suffix ; suffix++ ) {
+        size_t suffix_len = strlen( *suffix );
+        if ( len > suffix_len && !strcmp( &filename[ len - suffix_len ], *suffix ) )
+            return( true );
+    }
+    return( false );
+}
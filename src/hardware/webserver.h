@@ -0,0 +1,63 @@
+/****************************************************************************
+ *   Copyright  2020  Jesper Ortlund
+ ****************************************************************************/
+/*
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+#ifndef _WEBSERVER_H
+    #define _WEBSERVER_H
+
+    #include "TTGO.h"
+
+    #define WEBSERVER_PORT              80                  /** @brief http and websocket port */
+    #define WEBSERVER_MAX_CLIENTS       4                   /** @brief max concurrent http and websocket clients */
+    #define WEBSERVER_LIST_SIZE         2048                /** @brief size of a /files listing, one pool block per client */
+    #define WEBSERVER_REQUEST_SIZE      512                 /** @brief max size of a request line and headers */
+    #define WEBSERVER_FRAME_SIZE        192                 /** @brief max size of a websocket telemetry frame */
+    #define WEBSERVER_TASK_STACK        4096                /** @brief stack size of the websocket sender task in words */
+
+    /**
+     * @brief websocket statistics
+     */
+    typedef struct {
+        uint32_t frames;                                    /** @brief decoded wheel frames since boot */
+        uint32_t sent;                                      /** @brief frames sent to websocket clients */
+        uint32_t dropped;                                   /** @brief frames skipped for slow clients, they get the latest one instead */
+        uint8_t clients;                                    /** @brief connected websocket clients */
+    } webserver_stats_t;
+
+    /**
+     * @brief setup the webserver task, the server listens while wifi is connected
+     * and the webserver is enabled in the wifictl config
+     *
+     *  GET     /               live gauge page
+     *  GET     /ws             websocket with one json frame per decoded wheel frame
+     *  GET     /files          json list of the SPIFFS logs and captures, config files are never served
+     *  GET     /files/<name>   download a .csv, .log or .rle file, chunked or a single "Range: bytes=" range
+     *  DELETE  /files/<name>   delete a .csv, .log or .rle file
+     */
+    void webserver_setup( void );
+    /**
+     * @brief tell the webserver a new wheel frame was decoded, cheap enough for the ble notify callback
+     */
+    void webserver_notify_frame( void );
+    /**
+     * @brief get a copy of the websocket statistics
+     *
+     * @param   stats   pointer to the webserver_stats_t to fill
+     */
+    void webserver_get_stats( webserver_stats_t *stats );
+
+#endif // _WEBSERVER_H
@@ -0,0 +1,111 @@
+/****************************************************************************
+ *   Copyright  2020  Jesper Ortlund
+ ****************************************************************************/
+/*
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+#include <string.h>
+#include <strings.h>
+
+#include "webserver_proto.h"
+
+bool webserver_proto_get_header( const char *request, const char *name, char *value, size_t size ) {
+    size_t name_len = strlen( name );
+    const char *line = strstr( request, "\r\n" );
+
+    /*
+     * headers end with an empty line, nothing behind it is looked at
+     */
+    while ( line && line[ 2 ] != '\r' ) {
+        line += 2;
+        if ( !strncasecmp( line, name, name_len ) && line[ name_len ] == ':' ) {
+            const char *start = &line[ name_len + 1 ];
+            while ( *start == ' ' )
+                start++;
+            const char *end = strstr( start, "\r\n" );
+            size_t len = end ? end - start : strlen( start );
+            if ( len >= size )
+                return( false );
+            memcpy( value, start, len );
+            value[ len ] = '\0';
+            return( true );
+        }
+        line = strstr( line, "\r\n" );
+    }
+    return( false );
+}
+
+int webserver_proto_ws_decode( uint8_t *data, size_t len, webserver_proto_ws_frame_t *frame ) {
+    size_t payload;
+    size_t header = 2;
+
+    if ( len < 2 )
+        return( 0 );
+
+    bool masked = data[ 1 ] & 0x80;
+    payload = data[ 1 ] & 0x7f;
+    if ( payload == 126 ) {
+        if ( len < 4 )
+            return( 0 );
+        payload = ( data[ 2 ] << 8 ) | data[ 3 ];
+        header = 4;
+    }
+    else if ( payload == 127 ) {
+        return( -1 );
+    }
+
+    const uint8_t *mask = &data[ header ];
+    if ( masked )
+        header += 4;
+    if ( header + payload > len )
+        return( 0 );
+
+    frame->opcode = data[ 0 ] & 0x0f;
+    frame->payload = &data[ header ];
+    frame->len = payload;
+    if ( masked ) {
+        for ( size_t i = 0 ; i < payload ; i++ )
+            frame->payload[ i ] ^= mask[ i % 4 ];
+    }
+    return( header + payload );
+}
+
+size_t webserver_proto_ws_encode( uint8_t *buffer, uint8_t opcode, size_t len, uint8_t **frame ) {
+    if ( len < 126 ) {
+        buffer[ 2 ] = 0x80 | opcode;
+        buffer[ 3 ] = len;
+        *frame = &buffer[ 2 ];
+        return( len + 2 );
+    }
+    buffer[ 0 ] = 0x80 | opcode;
+    buffer[ 1 ] = 126;
+    buffer[ 2 ] = len >> 8;
+    buffer[ 3 ] = len & 0xff;
+    *frame = buffer;
+    return( len + 4 );
+}
+
+bool webserver_proto_take_latest( uint32_t *sent_seq, uint32_t seq, bool room, uint32_t *dropped ) {
+    if ( *sent_seq == seq || !room )
+        return( false );
+
+    /*
+     * a new client missed nothing, it just came in
+     */
+    if ( *sent_seq )
+        *dropped += seq - *sent_seq - 1;
+    *sent_seq = seq;
+    return( true );
+}
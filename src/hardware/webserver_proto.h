@@ -0,0 +1,90 @@
+/****************************************************************************
+ *   Copyright  2020  Jesper Ortlund
+ ****************************************************************************/
+/*
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+#ifndef _WEBSERVER_PROTO_H
+    #define _WEBSERVER_PROTO_H
+
+    /*
+     * no arduino and no AsyncTCP in here, the http and websocket parsing builds and runs on the host
+     */
+    #include <stdint.h>
+    #include <stddef.h>
+
+    #define WEBSERVER_PROTO_WS_HEADER       4           /** @brief max server frame header, payloads stay below 64k */
+
+    #define WEBSERVER_PROTO_WS_TEXT         0x01        /** @brief websocket text frame */
+    #define WEBSERVER_PROTO_WS_CLOSE        0x08        /** @brief websocket close frame */
+    #define WEBSERVER_PROTO_WS_PING         0x09        /** @brief websocket ping frame */
+    #define WEBSERVER_PROTO_WS_PONG         0x0a        /** @brief websocket pong frame */
+
+    /**
+     * @brief one decoded client websocket frame
+     */
+    typedef struct {
+        uint8_t opcode;                                 /** @brief WEBSERVER_PROTO_WS_CLOSE ... */
+        uint8_t *payload;                               /** @brief unmasked payload, points into the decoded data */
+        size_t len;                                     /** @brief payload length */
+    } webserver_proto_ws_frame_t;
+
+    /**
+     * @brief get a header value from a request
+     *
+     * @param   request     request line and headers, '\0' terminated
+     * @param   name        header name, compared without case
+     * @param   value       pointer to the buffer for the value, leading spaces are skipped
+     * @param   size        size of value
+     *
+     * @return  true if found and it fits into value
+     */
+    bool webserver_proto_get_header( const char *request, const char *name, char *value, size_t size );
+    /**
+     * @brief decode one websocket frame and unmask its payload in place
+     *
+     * @param   data        received data, starting at a frame header
+     * @param   len         bytes in data
+     * @param   frame       pointer to the webserver_proto_ws_frame_t to fill
+     *
+     * @return  bytes the frame takes in data, 0 if the frame is not complete yet,
+     *          -1 for a 64 bit length, no client sends that much to the watch
+     */
+    int webserver_proto_ws_decode( uint8_t *data, size_t len, webserver_proto_ws_frame_t *frame );
+    /**
+     * @brief put a server frame header in front of a payload, server frames are not masked
+     *
+     * @param   buffer      the payload starts at buffer + WEBSERVER_PROTO_WS_HEADER
+     * @param   opcode      WEBSERVER_PROTO_WS_TEXT ...
+     * @param   len         payload length, below 64k
+     * @param   frame       set to the start of the frame inside buffer
+     *
+     * @return  frame length with header
+     */
+    size_t webserver_proto_ws_encode( uint8_t *buffer, uint8_t opcode, size_t len, uint8_t **frame );
+    /**
+     * @brief drop to latest for one websocket client. a client with room gets the newest frame,
+     * the frames that came while it had no room are never sent and counted as dropped
+     *
+     * @param   sent_seq    pointer to the sequence last sent to the client, 0 for none, updated on send
+     * @param   seq         sequence of the newest frame
+     * @param   room        the client can take a frame now
+     * @param   dropped     pointer to the counter for skipped frames
+     *
+     * @return  true if the newest frame goes to the client now
+     */
+    bool webserver_proto_take_latest( uint32_t *sent_seq, uint32_t seq, bool room, uint32_t *dropped );
+
+#endif // _WEBSERVER_PROTO_H
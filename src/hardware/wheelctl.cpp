@@ -26,18 +26,6 @@
 #include "callback.h"
 #include "json_psram_allocator.h"
 #include "alloc.h"
-#include "powermgm.h"
-
-lv_task_t *speed_shake = nullptr;
-lv_task_t *current_shake = nullptr;
-lv_task_t *temp_shake = nullptr;
-
-static void lv_speed_shake(lv_task_t *speed_shake);
-static void lv_current_shake(lv_task_t *current_shake);
-static void lv_temp_shake(lv_task_t *temp_shake);
-void update_speed_shake(float value);
-void update_current_shake(float value);
-void update_temp_shake(float value);
 
 void wheelctl_update_max_min(int entry, float value, bool update_min);
 void wheelctl_update_regen_current(int entry, float value);
@@ -45,10 +33,9 @@ void wheelctl_update_battpct_max_min(int entry, float value);
 void update_calc_battery(float value);
 void wheelctl_calc_power(float value);
 
-bool shakeoff[3] = {true, true, true};
-
 wheelctl_data_t wheelctl_data[WHEELCTL_DATA_NUM];
 wheelctl_constants_t wheelctl_constants[WHEELCTL_CONST_NUM];
+portMUX_TYPE DRAM_ATTR wheelctlMux = portMUX_INITIALIZER_UNLOCKED;
 
 void wheelctl_setup( void ){
     wheelctl_data[WHEELCTL_SPEED].max_value = 0;
@@ -74,7 +61,11 @@ void wheelctl_set_data(int entry, float value)
 {
     if (entry < WHEELCTL_DATA_NUM)
     {
+        int64_t now = esp_timer_get_time();
+        portENTER_CRITICAL(&wheelctlMux);
         wheelctl_data[entry].value = value;
+        wheelctl_data[entry].timestamp = now;
+        portEXIT_CRITICAL(&wheelctlMux);
         /* debug
         Serial.print("Wheeldata entry: ");
         Serial.print(entry);
@@ -88,17 +79,14 @@ void wheelctl_set_data(int entry, float value)
             update_calc_battery(value);
             break;
         case WHEELCTL_SPEED:
-            update_speed_shake(value);
             wheelctl_update_max_min(entry, value, false);
             break;
         case WHEELCTL_CURRENT:
-            update_current_shake(value);
             wheelctl_update_max_min(entry, value, false);
             wheelctl_update_regen_current(entry, value);
             wheelctl_calc_power(value);
             break;
         case WHEELCTL_TEMP:
-            update_temp_shake(value);
             wheelctl_update_max_min(entry, value, true);
             break;
         case WHEELCTL_BATTPCT:
@@ -108,6 +96,19 @@ void wheelctl_set_data(int entry, float value)
     }
 }
 
+bool wheelctl_get_sample(int entry, float *value, int64_t *timestamp)
+{
+    if (entry < WHEELCTL_DATA_NUM)
+    {
+        portENTER_CRITICAL(&wheelctlMux);
+        *value = wheelctl_data[entry].value;
+        *timestamp = wheelctl_data[entry].timestamp;
+        portEXIT_CRITICAL(&wheelctlMux);
+        return (true);
+    }
+    return (false);
+}
+
 void wheelctl_update_max_min(int entry, float value, bool update_min)
 {
     if (wheelctl_data[entry].value > wheelctl_data[entry].max_value)
@@ -223,71 +224,3 @@ void wheelctl_set_constant(int entry, byte value)
         wheelctl_constants[entry].value = value;
     }
 }
-
-//Haptic feedback
-void update_speed_shake(float value)
-{
-    if (value >= wheelctl_data[WHEELCTL_ALARM3].value && shakeoff[0])
-    {
-        powermgm_set_event( POWERMGM_BMA_DOUBLECLICK );
-        speed_shake = lv_task_create(lv_speed_shake, 250, LV_TASK_PRIO_LOWEST, NULL);
-        lv_task_ready(speed_shake);
-        shakeoff[0] = false;
-        Serial.println("speedshake on");
-    }
-    else if (value < wheelctl_data[WHEELCTL_ALARM3].value && !shakeoff[0] && speed_shake != nullptr)
-    {
-        lv_task_del(speed_shake);
-        shakeoff[0] = true;
-        Serial.println("speedshake off");
-    }
-}
-
-void update_current_shake(float value)
-{
-    if (value >= (wheelctl_constants[WHEELCTL_CONST_MAXCURRENT].value * 0.75) && shakeoff[1] && current_shake != nullptr)
-    {
-        powermgm_set_event( POWERMGM_BMA_DOUBLECLICK );
-        current_shake = lv_task_create(lv_current_shake, 500, LV_TASK_PRIO_LOWEST, NULL);
-        lv_task_ready(current_shake);
-        shakeoff[1] = false;
-    }
-    else if (value < (wheelctl_constants[WHEELCTL_CONST_MAXCURRENT].value * 0.75) && !shakeoff[1])
-    {
-        lv_task_del(current_shake);
-        shakeoff[1] = true;
-    }
-}
-
-void update_temp_shake(float value)
-{
-    if (value > wheelctl_constants[WHEELCTL_CONST_CRITTEMP].value && shakeoff[2])
-    {
-        powermgm_set_event( POWERMGM_BMA_DOUBLECLICK );
-        temp_shake = lv_task_create(lv_temp_shake, 1000, LV_TASK_PRIO_LOWEST, NULL);
-        lv_task_ready(temp_shake);
-        shakeoff[2] = false;
-    }
-    else if (value <= wheelctl_constants[WHEELCTL_CONST_CRITTEMP].value && !shakeoff[2] && temp_shake != nullptr)
-    {
-        lv_task_del(temp_shake);
-        shakeoff[2] = true;
-    }
-}
-
-static void lv_current_shake(lv_task_t *current_shake)
-{
-    motor_vibe(50, true);
-}
-
-static void lv_temp_shake(lv_task_t *temp_shake)
-{
-    motor_vibe(10, true);
-    delay(150);
-    motor_vibe(10, true);
-}
-
-static void lv_speed_shake(lv_task_t *speed_shake)
-{
-    motor_vibe(10, true);
-} //End haptic feedback
\ No newline at end of file
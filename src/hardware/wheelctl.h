@@ -51,6 +51,7 @@
         WHEELCTL_CONST_WARNTEMP,    //internal temperature to trigger warning
         WHEELCTL_CONST_BATTVOLT,    //Voltage of the battery pack for the wheel model
         WHEELCTL_CONST_BATTWARN,    //Percentage of battery remaining when warning should be triggered for the specific wheel model        
+        WHEELCTL_CONST_MAXSPEED,    //Rated top speed in kmh for the wheel model
         WHEELCTL_CONST_NUM          //number of wheel constants
     };
 
@@ -62,6 +63,7 @@
         float value = 0;
         float max_value = 0;
         float min_value = 0;
+        int64_t timestamp = 0;  // esp_timer time of the last set, for the gauge animation
     } wheelctl_data_t;
 
     enum { 
@@ -111,6 +113,18 @@
      */
     void wheelctl_set_data( int entry, float value );
 
+    /**
+     * @brief get the value for a specific wheel data entry together with the time it was set,
+     * the pair is read consistently while the ble task decodes
+     * 
+     * @param   entry       configitem, see wheelctl_get_data
+     * @param   value       pointer to the value
+     * @param   timestamp   pointer to the esp_timer time in us the value was set, 0 if never
+     * 
+     * @return  true if entry is valid
+     */
+    bool wheelctl_get_sample( int entry, float *value, int64_t *timestamp );
+
     /**
      * @brief get the max value for a specific wheel data entry
      * 
@@ -152,7 +166,7 @@
     /**
      * @brief get the  value of the wheel constant
      * 
-     * @param   entry     configitem: WHEELCTL_CONST_MAXCURRENT,  WHEELCTL_CONST_CRITTEMP, WHEELCTL_CONST_WARNTEMP,   WHEELCTL_CONST_BATTVOLT, WHEELCTL_CONST_BATTWARN
+     * @param   entry     configitem: WHEELCTL_CONST_MAXCURRENT,  WHEELCTL_CONST_CRITTEMP, WHEELCTL_CONST_WARNTEMP,   WHEELCTL_CONST_BATTVOLT, WHEELCTL_CONST_BATTWARN, WHEELCTL_CONST_MAXSPEED
      * 
      * @return  uint8_t
      */
@@ -161,7 +175,7 @@
     /**
      * @brief set the min value for a specific wheel data entry
      * 
-     * @param   entry     configitem: WHEELCTL_CONST_MAXCURRENT,  WHEELCTL_CONST_CRITTEMP, WHEELCTL_CONST_WARNTEMP,   WHEELCTL_CONST_BATTVOLT, WHEELCTL_CONST_BATTWARN
+     * @param   entry     configitem: WHEELCTL_CONST_MAXCURRENT,  WHEELCTL_CONST_CRITTEMP, WHEELCTL_CONST_WARNTEMP,   WHEELCTL_CONST_BATTVOLT, WHEELCTL_CONST_BATTWARN, WHEELCTL_CONST_MAXSPEED
      * @param   value     the value of the constant
      */
     void wheelctl_set_constant( int entry, uint8_t value );
@@ -28,6 +28,7 @@
 #include "wifictl.h"
 #include "powermgm.h"
 #include "callback.h"
+#include "configstore.h"
 #include "json_psram_allocator.h"
 #include "alloc.h"
 
@@ -60,6 +61,8 @@ void wifictl_save_network( void );
 void wifictl_load_network( void );
 void wifictl_save_config( void );
 void wifictl_load_config( void );
+void wifictl_save_json_config( void );
+void wifictl_load_json_config( void );
 void wifictl_Task( void * pvParameters );
 
 void wifictl_setup( void ) {
@@ -199,6 +202,21 @@ bool wifictl_powermgm_event_cb( EventBits_t event, void *arg ) {
 }
 
 void wifictl_save_config( void ) {
+    configstore_save( CONFIGSTORE_WIFICTL );
+    configstore_save( CONFIGSTORE_NETWORKLIST );
+}
+
+void wifictl_load_config( void ) {
+    bool config_loaded = configstore_register( CONFIGSTORE_WIFICTL, &wifictl_config, sizeof( wifictl_config ), wifictl_load_json_config, wifictl_save_json_config );
+    bool networklist_loaded = configstore_register( CONFIGSTORE_NETWORKLIST, wifictl_networklist, sizeof( networklist ) * NETWORKLIST_ENTRYS, NULL, NULL );
+
+    if ( !config_loaded || !networklist_loaded ) {
+        wifictl_load_json_config();
+        wifictl_save_config();
+    }
+}
+
+void wifictl_save_json_config( void ) {
     fs::File file = SPIFFS.open( WIFICTL_JSON_CONFIG_FILE, FILE_WRITE );
 
     if (!file) {
@@ -207,12 +225,7 @@ void wifictl_save_config( void ) {
     else {
         SpiRamJsonDocument doc( 10000 );
 
-        doc["autoon"] = wifictl_config.autoon;
-        doc["enable_on_standby"] = wifictl_config.enable_on_standby;
-        for ( int i = 0 ; i < NETWORKLIST_ENTRYS ; i++ ) {
-            doc["networklist"][ i ]["ssid"] = wifictl_networklist[ i ].ssid;
-            doc["networklist"][ i ]["psk"] = wifictl_networklist[ i ].password;
-        }
+        wifictl_config_to_json( &wifictl_config, wifictl_networklist, doc.to<JsonObject>() );
 
         if ( serializeJsonPretty( doc, file ) == 0) {
             log_e("Failed to write config file");
@@ -222,7 +235,7 @@ void wifictl_save_config( void ) {
     file.close();
 }
 
-void wifictl_load_config( void ) {
+void wifictl_load_json_config( void ) {
     fs::File file = SPIFFS.open( WIFICTL_JSON_CONFIG_FILE, FILE_READ );
     if (!file) {
         log_e("Can't open file: %s!", WIFICTL_JSON_CONFIG_FILE );
@@ -236,14 +249,7 @@ void wifictl_load_config( void ) {
             log_e("update check deserializeJson() failed: %s", error.c_str() );
         }
         else {
-            wifictl_config.autoon = doc["autoon"] | true;
-            wifictl_config.enable_on_standby = doc["enable_on_standby"] | false;
-            for ( int i = 0 ; i < NETWORKLIST_ENTRYS ; i++ ) {
-                if ( doc["networklist"][ i ]["ssid"] && doc["networklist"][ i ]["psk"] ) {
-                    strlcpy( wifictl_networklist[ i ].ssid    , doc["networklist"][ i ]["ssid"], sizeof( wifictl_networklist[ i ].ssid ) );
-                    strlcpy( wifictl_networklist[ i ].password, doc["networklist"][ i ]["psk"], sizeof( wifictl_networklist[ i ].password ) );
-                }
-            }
+            wifictl_config_from_json( &wifictl_config, wifictl_networklist, doc.as<JsonObjectConst>() );
         }        
         doc.clear();
     }
@@ -254,6 +260,15 @@ bool wifictl_get_autoon( void ) {
   return( wifictl_config.autoon );
 }
 
+bool wifictl_get_webserver( void ) {
+  return( wifictl_config.webserver );
+}
+
+void wifictl_set_webserver( bool webserver ) {
+  wifictl_config.webserver = webserver;
+  wifictl_save_config();
+}
+
 bool wifictl_get_enable_on_standby( void ) {
   return( wifictl_config.enable_on_standby );
 }
@@ -24,9 +24,9 @@
 
     #include "TTGO.h"
     #include "callback.h"
+    #include "wifictl_config.h"
 
     #define WIFICTL_DELAY               10
-    #define NETWORKLIST_ENTRYS          20
     #define WIFICTL_JSON_CONFIG_FILE    "/wificfg.json"
 
     #define ESP_WPS_MODE                WPS_TYPE_PBC
@@ -35,23 +35,6 @@
     #define ESP_MODEL_NAME              "LILYGO T-WATCH2020 V1"
     #define ESP_DEVICE_NAME             "ESP STATION"
 
-    /**
-     * @brief network list structure
-     */
-    typedef struct {
-        char ssid[64]="";
-        char password[64]="";
-    } networklist;
-
-    /**
-     * @brief wifictl config structure
-     */
-    typedef struct {
-        bool autoon = false;             /** @brief enable on auto on/off an wakeup and standby */
-        bool webserver = false;         /** @brief enable on webserver */
-        bool enable_on_standby = false; /** @brief enable on standby */
-    } wifictl_config_t;
-
     enum wifictl_event_t {
         WIFICTL_CONNECT                = _BV(0),
         WIFICTL_CONNECT_IP             = _BV(1),
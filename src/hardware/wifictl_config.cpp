@@ -0,0 +1,49 @@
+/****************************************************************************
+ *   Copyright  2020  Jesper Ortlund
+ ****************************************************************************/
+/*
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+#include <stdio.h>
+
+#include "wifictl_config.h"
+
+void wifictl_config_from_json( wifictl_config_t *config, networklist *list, JsonObjectConst json ) {
+    config->autoon = json["autoon"] | true;
+    config->enable_on_standby = json["enable_on_standby"] | false;
+    config->webserver = json["webserver"] | false;
+    for ( int i = 0 ; i < NETWORKLIST_ENTRYS ; i++ ) {
+        JsonVariantConst entry = json["networklist"][ i ];
+
+        if ( entry["ssid"].is<const char *>() && entry["psk"].is<const char *>() ) {
+            snprintf( list[ i ].ssid, sizeof( list[ i ].ssid ), "%s", entry["ssid"].as<const char *>() );
+            snprintf( list[ i ].password, sizeof( list[ i ].password ), "%s", entry["psk"].as<const char *>() );
+        }
+    }
+}
+
+void wifictl_config_to_json( const wifictl_config_t *config, const networklist *list, JsonObject json ) {
+    json["autoon"] = config->autoon;
+    json["enable_on_standby"] = config->enable_on_standby;
+    json["webserver"] = config->webserver;
+
+    JsonArray networks = json.createNestedArray("networklist");
+    for ( int i = 0 ; i < NETWORKLIST_ENTRYS ; i++ ) {
+        JsonObject entry = networks.createNestedObject();
+
+        entry["ssid"] = list[ i ].ssid;
+        entry["psk"] = list[ i ].password;
+    }
+}
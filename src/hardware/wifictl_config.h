@@ -0,0 +1,67 @@
+/****************************************************************************
+ *   Copyright  2020  Jesper Ortlund
+ ****************************************************************************/
+/*
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+#ifndef _WIFICTL_CONFIG_H
+    #define _WIFICTL_CONFIG_H
+
+    /*
+     * no arduino or spiffs in here, the config and its json mapping build and run on the host
+     */
+    #include <ArduinoJson.h>
+
+
+    #define NETWORKLIST_ENTRYS          20
+
+    /**
+     * @brief network list structure, the list is stored as NETWORKLIST_ENTRYS of these.
+     * only append fields, never reorder or resize them
+     */
+    typedef struct {
+        char ssid[64]="";
+        char password[64]="";
+    } networklist;
+
+    /**
+     * @brief wifictl config structure, stored as is in the config store. only append
+     * fields, never reorder or resize them
+     */
+    typedef struct {
+        bool autoon = false;             /** @brief enable on auto on/off an wakeup and standby */
+        bool webserver = false;         /** @brief enable on webserver */
+        bool enable_on_standby = false; /** @brief enable on standby */
+    } wifictl_config_t;
+
+    /**
+     * @brief fill the wifictl config and network list from the legacy json, missing keys
+     * get their defaults, list entries without ssid or psk are left as they are
+     *
+     * @param   config      pointer to the config
+     * @param   list        pointer to NETWORKLIST_ENTRYS networks
+     * @param   json        root object of wificfg.json
+     */
+    void wifictl_config_from_json( wifictl_config_t *config, networklist *list, JsonObjectConst json );
+    /**
+     * @brief write the wifictl config and network list as legacy json
+     *
+     * @param   config      pointer to the config
+     * @param   list        pointer to NETWORKLIST_ENTRYS networks
+     * @param   json        root object to fill
+     */
+    void wifictl_config_to_json( const wifictl_config_t *config, const networklist *list, JsonObject json );
+
+#endif // _WIFICTL_CONFIG_H
@@ -0,0 +1,253 @@
+/****************************************************************************
+ *   Copyright  2020  Jesper Ortlund
+ ****************************************************************************/
+/*
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+#include <string.h>
+#include <unity.h>
+
+#include "hardware/alarm_rule.h"
+
+/*
+ * a small wheel, the rule engine only sees indices
+ */
+enum { SPEED, CURRENT, TEMP, TILTBACK, DATA_NUM };
+enum { MAXCURRENT, CRITTEMP, WARNTEMP, CONST_NUM };
+
+#define BAND_NORMAL     0
+#define BAND_WARN       1
+#define BAND_CRIT       2
+#define BAND_REGEN      3
+
+#define FRAME_MS        50          /** @brief wheel frames in the traces come every 50ms */
+
+static float data[ DATA_NUM ];
+static uint8_t constants[ CONST_NUM ];
+static uint8_t band[ DATA_NUM ];
+
+/**
+ * @brief a trace step, field holds value from time on
+ */
+typedef struct {
+    uint32_t time;
+    float value;
+} step_t;
+
+/**
+ * @brief replay a trace of one field in frames, went_active of every frame in fired[]
+ *
+ * @return  number of frames
+ */
+static int replay( const alarm_rule_t *rule, alarm_rule_state_t *state, int rules, int field, const step_t *trace, int steps, uint32_t end, uint32_t *fired ) {
+    int frames = 0;
+    int step = 0;
+
+    for ( uint32_t now = 0 ; now <= end ; now += FRAME_MS ) {
+        while ( step + 1 < steps && trace[ step + 1 ].time <= now )
+            step++;
+        data[ field ] = trace[ step ].value;
+        fired[ frames++ ] = alarm_rule_eval( rule, state, rules, data, DATA_NUM, constants, CONST_NUM, now, band );
+    }
+    return( frames );
+}
+
+static int first_fired( const uint32_t *fired, int frames, uint32_t mask ) {
+    for ( int frame = 0 ; frame < frames ; frame++ ) {
+        if ( fired[ frame ] & mask )
+            return( frame * FRAME_MS );
+    }
+    return( -1 );
+}
+
+static int count_fired( const uint32_t *fired, int frames, uint32_t mask ) {
+    int count = 0;
+
+    for ( int frame = 0 ; frame < frames ; frame++ ) {
+        if ( fired[ frame ] & mask )
+            count++;
+    }
+    return( count );
+}
+
+void setUp( void ) {
+    memset( data, 0, sizeof( data ) );
+    memset( band, 0, sizeof( band ) );
+    constants[ MAXCURRENT ] = 40;
+    constants[ CRITTEMP ] = 65;
+    constants[ WARNTEMP ] = 50;
+}
+
+void tearDown( void ) {
+}
+
+static void test_duration( void ) {
+    static const alarm_rule_t rule[] = {
+        { CURRENT, ALARM_RULE_GT, ALARM_RULE_REF_CONST, MAXCURRENT, 0.75, 2.0, 200, ALARM_RULE_HAPTIC, BAND_NORMAL, 1 },
+    };
+    /*
+     * a 150ms spike over 30A at 1s, then a real overload from 2s on
+     */
+    static const step_t trace[] = { { 0, 10 }, { 1000, 35 }, { 1150, 10 }, { 2000, 35 } };
+    alarm_rule_state_t state[ 1 ];
+    uint32_t fired[ 64 ];
+
+    alarm_rule_reset( state, 1 );
+    int frames = replay( rule, state, 1, CURRENT, trace, 4, 3000, fired );
+    TEST_ASSERT_EQUAL( 2200, first_fired( fired, frames, 1 ) );
+    TEST_ASSERT_EQUAL( 1, count_fired( fired, frames, 1 ) );
+    TEST_ASSERT_TRUE( state[ 0 ].active );
+}
+
+static void test_duration_restarts( void ) {
+    static const alarm_rule_t rule[] = {
+        { CURRENT, ALARM_RULE_GT, ALARM_RULE_REF_CONST, MAXCURRENT, 0.75, 2.0, 200, ALARM_RULE_HAPTIC, BAND_NORMAL, 1 },
+    };
+    /*
+     * 150ms over, one frame under, 150ms over again, the hold time starts again after the dip
+     */
+    static const step_t trace[] = { { 0, 35 }, { 150, 10 }, { 200, 35 } };
+    alarm_rule_state_t state[ 1 ];
+    uint32_t fired[ 64 ];
+
+    alarm_rule_reset( state, 1 );
+    int frames = replay( rule, state, 1, CURRENT, trace, 3, 1000, fired );
+    TEST_ASSERT_EQUAL( 400, first_fired( fired, frames, 1 ) );
+}
+
+static void test_hysteresis( void ) {
+    static const alarm_rule_t rule[] = {
+        { TEMP, ALARM_RULE_GT, ALARM_RULE_REF_CONST, CRITTEMP, 1.0, 1.0, 0, ALARM_RULE_BAND | ALARM_RULE_HAPTIC, BAND_CRIT, 2 },
+    };
+    /*
+     * wobbling around 65C fires once, only 63.9C clears it and 65.5C fires again
+     */
+    static const step_t trace[] = { { 0, 60 }, { 500, 65.5 }, { 600, 64.5 }, { 700, 65.2 }, { 800, 64.1 }, { 900, 65.1 },
+                                    { 1000, 63.9 }, { 1100, 64.8 }, { 1200, 65.5 } };
+    alarm_rule_state_t state[ 1 ];
+    uint32_t fired[ 64 ];
+
+    alarm_rule_reset( state, 1 );
+    int frames = replay( rule, state, 1, TEMP, trace, 9, 1300, fired );
+    TEST_ASSERT_EQUAL( 500, first_fired( fired, frames, 1 ) );
+    TEST_ASSERT_EQUAL( 2, count_fired( fired, frames, 1 ) );
+    TEST_ASSERT_EQUAL( 0, count_fired( &fired[ 600 / FRAME_MS ], ( 1000 - 600 ) / FRAME_MS, 1 ) );
+    TEST_ASSERT_TRUE( fired[ 1200 / FRAME_MS ] & 1 );
+}
+
+static void test_hysteresis_below( void ) {
+    static const alarm_rule_t rule[] = {
+        { CURRENT, ALARM_RULE_LT, ALARM_RULE_REF_NONE, 0, 0.0, 0.5, 0, ALARM_RULE_BAND, BAND_REGEN, 0 },
+    };
+    alarm_rule_state_t state[ 1 ];
+
+    /*
+     * regen is current below 0, it stays regen up to +0.5A
+     */
+    alarm_rule_reset( state, 1 );
+    data[ CURRENT ] = -1.0;
+    TEST_ASSERT_EQUAL( 1, alarm_rule_eval( rule, state, 1, data, DATA_NUM, constants, CONST_NUM, 0, band ) );
+    TEST_ASSERT_EQUAL( BAND_REGEN, band[ CURRENT ] );
+    data[ CURRENT ] = 0.4;
+    TEST_ASSERT_EQUAL( 0, alarm_rule_eval( rule, state, 1, data, DATA_NUM, constants, CONST_NUM, 50, band ) );
+    TEST_ASSERT_EQUAL( BAND_REGEN, band[ CURRENT ] );
+    data[ CURRENT ] = 0.6;
+    alarm_rule_eval( rule, state, 1, data, DATA_NUM, constants, CONST_NUM, 100, band );
+    TEST_ASSERT_EQUAL( BAND_NORMAL, band[ CURRENT ] );
+}
+
+static void test_crit_beats_warn( void ) {
+    /*
+     * same order as the default table, crit before warn within a field
+     */
+    static const alarm_rule_t rule[] = {
+        { TEMP, ALARM_RULE_GT, ALARM_RULE_REF_CONST, CRITTEMP, 1.0, 1.0, 0, ALARM_RULE_BAND, BAND_CRIT, 0 },
+        { TEMP, ALARM_RULE_GT, ALARM_RULE_REF_CONST, WARNTEMP, 1.0, 1.0, 0, ALARM_RULE_BAND, BAND_WARN, 0 },
+        { CURRENT, ALARM_RULE_GT, ALARM_RULE_REF_CONST, MAXCURRENT, 0.5, 2.0, 0, ALARM_RULE_BAND, BAND_WARN, 0 },
+    };
+    alarm_rule_state_t state[ 3 ];
+
+    alarm_rule_reset( state, 3 );
+    data[ TEMP ] = 55;
+    TEST_ASSERT_EQUAL( 1 << 1, alarm_rule_eval( rule, state, 3, data, DATA_NUM, constants, CONST_NUM, 0, band ) );
+    TEST_ASSERT_EQUAL( BAND_WARN, band[ TEMP ] );
+    TEST_ASSERT_EQUAL( BAND_NORMAL, band[ CURRENT ] );
+
+    data[ TEMP ] = 70;
+    data[ CURRENT ] = 25;
+    TEST_ASSERT_EQUAL( ( 1 << 0 ) | ( 1 << 2 ), alarm_rule_eval( rule, state, 3, data, DATA_NUM, constants, CONST_NUM, 50, band ) );
+    TEST_ASSERT_TRUE( state[ 1 ].active );
+    TEST_ASSERT_EQUAL( BAND_CRIT, band[ TEMP ] );
+    TEST_ASSERT_EQUAL( BAND_WARN, band[ CURRENT ] );
+
+    /*
+     * back under crit minus hysteresis, warn shows again
+     */
+    data[ TEMP ] = 60;
+    TEST_ASSERT_EQUAL( 0, alarm_rule_eval( rule, state, 3, data, DATA_NUM, constants, CONST_NUM, 100, band ) );
+    TEST_ASSERT_EQUAL( BAND_WARN, band[ TEMP ] );
+}
+
+static void test_unknown_reference( void ) {
+    static const alarm_rule_t rule[] = {
+        { SPEED, ALARM_RULE_GE, ALARM_RULE_REF_DATA, TILTBACK, 1.0, 1.0, 0, ALARM_RULE_BAND, BAND_CRIT, 0 },
+        { SPEED, ALARM_RULE_GE, ALARM_RULE_REF_DATA, DATA_NUM, 1.0, 1.0, 0, ALARM_RULE_BAND, BAND_WARN, 0 },
+        { SPEED, ALARM_RULE_GE, ALARM_RULE_REF_CONST, CONST_NUM, 1.0, 1.0, 0, ALARM_RULE_BAND, BAND_WARN, 0 },
+    };
+    alarm_rule_state_t state[ 3 ];
+
+    /*
+     * tiltback is 0 until its frame came in, speed >= 0 must not count as over it
+     */
+    alarm_rule_reset( state, 3 );
+    data[ SPEED ] = 30;
+    TEST_ASSERT_EQUAL( 0, alarm_rule_eval( rule, state, 3, data, DATA_NUM, constants, CONST_NUM, 0, band ) );
+    TEST_ASSERT_EQUAL( BAND_NORMAL, band[ SPEED ] );
+    TEST_ASSERT_EQUAL_FLOAT( 0, alarm_rule_threshold( &rule[ 1 ], data, DATA_NUM, constants, CONST_NUM ) );
+    TEST_ASSERT_EQUAL_FLOAT( 0, alarm_rule_threshold( &rule[ 2 ], data, DATA_NUM, constants, CONST_NUM ) );
+
+    data[ TILTBACK ] = 28;
+    TEST_ASSERT_EQUAL( 1, alarm_rule_eval( rule, state, 3, data, DATA_NUM, constants, CONST_NUM, 50, band ) );
+    TEST_ASSERT_EQUAL( BAND_CRIT, band[ SPEED ] );
+}
+
+static void test_reset( void ) {
+    static const alarm_rule_t rule[] = {
+        { TEMP, ALARM_RULE_GT, ALARM_RULE_REF_NONE, 0, 60.0, 1.0, 0, ALARM_RULE_HAPTIC, BAND_NORMAL, 2 },
+    };
+    alarm_rule_state_t state[ 1 ];
+
+    alarm_rule_reset( state, 1 );
+    data[ TEMP ] = 70;
+    TEST_ASSERT_EQUAL( 1, alarm_rule_eval( rule, state, 1, data, DATA_NUM, constants, CONST_NUM, 0, NULL ) );
+    TEST_ASSERT_EQUAL( 0, alarm_rule_eval( rule, state, 1, data, DATA_NUM, constants, CONST_NUM, 50, NULL ) );
+    /*
+     * a reset, e.g. a new table, reports a still active condition again
+     */
+    alarm_rule_reset( state, 1 );
+    TEST_ASSERT_EQUAL( 1, alarm_rule_eval( rule, state, 1, data, DATA_NUM, constants, CONST_NUM, 100, NULL ) );
+}
+
+int main( void ) {
+    UNITY_BEGIN();
+    RUN_TEST( test_duration );
+    RUN_TEST( test_duration_restarts );
+    RUN_TEST( test_hysteresis );
+    RUN_TEST( test_hysteresis_below );
+    RUN_TEST( test_crit_beats_warn );
+    RUN_TEST( test_unknown_reference );
+    RUN_TEST( test_reset );
+    return( UNITY_END() );
+}
@@ -0,0 +1,372 @@
+/****************************************************************************
+ *   Copyright  2020  Jesper Ortlund
+ ****************************************************************************/
+/*
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+#include <unity.h>
+#include <string.h>
+
+#include "hardware/configstore_image.h"
+#include "hardware/alarmctl_config.h"
+#include "hardware/blectl_config.h"
+#include "hardware/bma_config.h"
+#include "hardware/display_config.h"
+#include "hardware/mqttctl_config.h"
+#include "hardware/pmu_config.h"
+#include "hardware/rtcctl_config.h"
+#include "hardware/wifictl_config.h"
+
+#define SECTION_NUM     4
+
+/*
+ * a config as an older firmware stored it and the same config one field later
+ */
+typedef struct {
+    bool enable = true;
+    uint8_t level = 3;
+    char name[ 8 ] = "old";
+} v1_config_t;
+
+typedef struct {
+    bool enable = true;
+    uint8_t level = 3;
+    char name[ 8 ] = "old";
+    uint16_t interval = 500;
+} v2_config_t;
+
+static uint8_t payload[ 8192 ];
+
+static const char *field_name[] = { "voltage", "speed", "current", "temp" };
+static const char *cmp_name[] = { ">", ">=", "<", "<=" };
+static const char *const_name[] = { "maxcurrent", "crittemp" };
+static const char *band_name[] = { "normal", "warn", "crit", "regen" };
+static const char *haptic_name[] = { "none", "tick", "pulse", "double" };
+
+static const alarmctl_json_names_t names = {
+    field_name,     4,
+    cmp_name,       4,
+    const_name,     2,
+    band_name,      4,
+    haptic_name,    ALARMCTL_HAPTIC_NUM,
+};
+
+/*
+ * what the first boot of a configstore firmware does: legacy json into the struct, the
+ * struct into the image, and the next boot loads the struct back from the image
+ */
+static void migrate( void *config, size_t size, void *loaded ) {
+    configstore_image_section_t sections[ SECTION_NUM ];
+    size_t pos;
+
+    pos = configstore_image_put( payload, 0, 1, config, size );
+    TEST_ASSERT_EQUAL( 1, configstore_image_parse( payload, pos, 1, sections, SECTION_NUM ) );
+    TEST_ASSERT_EQUAL( size, configstore_image_load( loaded, size, sections[ 1 ].data, sections[ 1 ].size ) );
+}
+
+static JsonObjectConst parse( JsonDocument &doc, const char *json ) {
+    TEST_ASSERT_FALSE( deserializeJson( doc, json ) );
+    return( doc.as<JsonObjectConst>() );
+}
+
+void setUp( void ) {
+    memset( payload, 0, sizeof( payload ) );
+}
+
+void tearDown( void ) {
+}
+
+static void test_roundtrip( void ) {
+    configstore_image_section_t sections[ SECTION_NUM ];
+    uint32_t a = 0x11223344;
+    uint8_t b[ 3 ] = { 1, 2, 3 };
+    size_t pos = 0;
+
+    pos = configstore_image_put( payload, pos, 0, &a, sizeof( a ) );
+    pos = configstore_image_put( payload, pos, 2, b, sizeof( b ) );
+
+    TEST_ASSERT_EQUAL( 2, configstore_image_parse( payload, pos, 2, sections, SECTION_NUM ) );
+    TEST_ASSERT_EQUAL( sizeof( a ), sections[ 0 ].size );
+    TEST_ASSERT_EQUAL_MEMORY( &a, sections[ 0 ].data, sizeof( a ) );
+    TEST_ASSERT_NULL( sections[ 1 ].data );
+    TEST_ASSERT_EQUAL( sizeof( b ), sections[ 2 ].size );
+    TEST_ASSERT_EQUAL_MEMORY( b, sections[ 2 ].data, sizeof( b ) );
+    TEST_ASSERT_NULL( sections[ 3 ].data );
+}
+
+static void test_struct_grew( void ) {
+    configstore_image_section_t sections[ SECTION_NUM ];
+    v1_config_t stored;
+    v2_config_t config;
+    size_t pos;
+
+    stored.enable = false;
+    stored.level = 7;
+    strcpy( stored.name, "wheel" );
+    pos = configstore_image_put( payload, 0, 1, &stored, sizeof( stored ) );
+    configstore_image_parse( payload, pos, 1, sections, SECTION_NUM );
+
+    /*
+     * the stored fields survive, the new one keeps its default
+     */
+    TEST_ASSERT_EQUAL( sizeof( stored ), configstore_image_load( &config, sizeof( config ), sections[ 1 ].data, sections[ 1 ].size ) );
+    TEST_ASSERT_FALSE( config.enable );
+    TEST_ASSERT_EQUAL( 7, config.level );
+    TEST_ASSERT_EQUAL_STRING( "wheel", config.name );
+    TEST_ASSERT_EQUAL( 500, config.interval );
+}
+
+static void test_struct_shrank( void ) {
+    configstore_image_section_t sections[ SECTION_NUM ];
+    v2_config_t stored;
+    v1_config_t config;
+    size_t pos;
+
+    stored.level = 9;
+    stored.interval = 1234;
+    pos = configstore_image_put( payload, 0, 1, &stored, sizeof( stored ) );
+    configstore_image_parse( payload, pos, 1, sections, SECTION_NUM );
+
+    TEST_ASSERT_EQUAL( sizeof( config ), configstore_image_load( &config, sizeof( config ), sections[ 1 ].data, sections[ 1 ].size ) );
+    TEST_ASSERT_TRUE( config.enable );
+    TEST_ASSERT_EQUAL( 9, config.level );
+    TEST_ASSERT_EQUAL_STRING( "old", config.name );
+}
+
+static void test_array_grew( void ) {
+    configstore_image_section_t sections[ SECTION_NUM ];
+    bool stored[ 4 ] = { false, true, false, true };
+    bool config[ 5 ] = { true, true, true, true, false };
+    size_t pos;
+
+    /*
+     * bma config, one more entry behind the stored ones
+     */
+    pos = configstore_image_put( payload, 0, 3, stored, sizeof( stored ) );
+    configstore_image_parse( payload, pos, 1, sections, SECTION_NUM );
+    configstore_image_load( config, sizeof( config ), sections[ 3 ].data, sections[ 3 ].size );
+
+    TEST_ASSERT_EQUAL_MEMORY( stored, config, sizeof( stored ) );
+    TEST_ASSERT_FALSE( config[ 4 ] );
+}
+
+static void test_truncated_payload( void ) {
+    configstore_image_section_t sections[ SECTION_NUM ];
+    uint32_t a = 1, b = 2;
+    size_t pos = 0;
+
+    pos = configstore_image_put( payload, pos, 0, &a, sizeof( a ) );
+    pos = configstore_image_put( payload, pos, 1, &b, sizeof( b ) );
+
+    TEST_ASSERT_EQUAL( 1, configstore_image_parse( payload, pos - 1, 2, sections, SECTION_NUM ) );
+    TEST_ASSERT_NOT_NULL( sections[ 0 ].data );
+    TEST_ASSERT_NULL( sections[ 1 ].data );
+    /*
+     * a header that claims more sections than the payload holds
+     */
+    TEST_ASSERT_EQUAL( 2, configstore_image_parse( payload, pos, 5, sections, SECTION_NUM ) );
+}
+
+static void test_unknown_section( void ) {
+    configstore_image_section_t sections[ SECTION_NUM ];
+    uint32_t a = 1, b = 2;
+    size_t pos = 0;
+
+    /*
+     * a newer firmware wrote a section this one doesn't know
+     */
+    pos = configstore_image_put( payload, pos, SECTION_NUM + 2, &a, sizeof( a ) );
+    pos = configstore_image_put( payload, pos, 1, &b, sizeof( b ) );
+
+    TEST_ASSERT_EQUAL( 1, configstore_image_parse( payload, pos, 2, sections, SECTION_NUM ) );
+    TEST_ASSERT_EQUAL_MEMORY( &b, sections[ 1 ].data, sizeof( b ) );
+}
+
+static void test_json_display( void ) {
+    DynamicJsonDocument doc( 1024 );
+    display_config_t config, loaded;
+
+    display_config_from_json( &config, parse( doc, "{\"brightness\":200,\"rotation\":90,\"timeout\":60,\"block_return_maintile\":true,\"background_image\":1}" ) );
+    loaded.brightness = 0;
+    migrate( &config, sizeof( config ), &loaded );
+
+    TEST_ASSERT_EQUAL( 200, loaded.brightness );
+    TEST_ASSERT_EQUAL( 90, loaded.rotation );
+    TEST_ASSERT_EQUAL( 60, loaded.timeout );
+    TEST_ASSERT_TRUE( loaded.block_return_maintile );
+    TEST_ASSERT_EQUAL( 1, loaded.background_image );
+}
+
+static void test_json_missing_keys( void ) {
+    DynamicJsonDocument doc( 1024 );
+    display_config_t display, display_loaded;
+    blectl_config_t blectl, blectl_loaded;
+    pmu_config_t pmu, pmu_loaded;
+    bma_config_t bma[ BMA_CONFIG_NUM ], bma_loaded[ BMA_CONFIG_NUM ];
+
+    /*
+     * an older firmware wrote fewer keys, the missing ones get the legacy reader defaults,
+     * not the struct initializers
+     */
+    display_config_from_json( &display, parse( doc, "{\"brightness\":20}" ) );
+    migrate( &display, sizeof( display ), &display_loaded );
+    TEST_ASSERT_EQUAL( 20, display_loaded.brightness );
+    TEST_ASSERT_EQUAL( DISPLAY_MIN_ROTATE, display_loaded.rotation );
+    TEST_ASSERT_EQUAL( DISPLAY_MIN_TIMEOUT, display_loaded.timeout );
+    TEST_ASSERT_FALSE( display_loaded.block_return_maintile );
+    TEST_ASSERT_EQUAL( 2, display_loaded.background_image );
+
+    blectl_config_from_json( &blectl, parse( doc, "{\"wheel_mac\":\"aa:bb:cc:dd:ee:ff\"}" ) );
+    migrate( &blectl, sizeof( blectl ), &blectl_loaded );
+    TEST_ASSERT_TRUE( blectl_loaded.autoon );
+    TEST_ASSERT_FALSE( blectl_loaded.enable_on_standby );
+    TEST_ASSERT_EQUAL( 1, blectl_loaded.txpower );
+    TEST_ASSERT_EQUAL_STRING( "aa:bb:cc:dd:ee:ff", blectl_loaded.wheelmac );
+    TEST_ASSERT_FALSE( blectl_loaded.relay );
+
+    pmu_config_from_json( &pmu, parse( doc, "{\"silence_wakeup\":true,\"designed_battery_cap\":500}" ) );
+    migrate( &pmu, sizeof( pmu ), &pmu_loaded );
+    TEST_ASSERT_TRUE( pmu_loaded.silence_wakeup );
+    TEST_ASSERT_EQUAL( 500, pmu_loaded.designed_battery_cap );
+    TEST_ASSERT_EQUAL( SILENCEWAKEINTERVAL, pmu_loaded.silence_wakeup_interval );
+    TEST_ASSERT_EQUAL( SILENCEWAKEINTERVAL_PLUG, pmu_loaded.silence_wakeup_interval_vbplug );
+    TEST_ASSERT_EQUAL( NORMALVOLTAGE, pmu_loaded.normal_voltage );
+    TEST_ASSERT_EQUAL( EXPERIMENTALPOWERSAVEVOLTAGE, pmu_loaded.experimental_power_save_voltage );
+    TEST_ASSERT_FALSE( pmu_loaded.compute_percent );
+
+    /*
+     * ride_gestures came after the json files, it is never in a legacy bma.json
+     */
+    bma_config_from_json( bma, parse( doc, "{\"stepcounter\":false,\"doubleclick\":true,\"tilt\":true,\"daily_stepcounter\":false}" ) );
+    migrate( bma, sizeof( bma ), bma_loaded );
+    TEST_ASSERT_FALSE( bma_loaded[ BMA_STEPCOUNTER ].enable );
+    TEST_ASSERT_TRUE( bma_loaded[ BMA_DOUBLECLICK ].enable );
+    TEST_ASSERT_TRUE( bma_loaded[ BMA_TILT ].enable );
+    TEST_ASSERT_FALSE( bma_loaded[ BMA_RIDE_GESTURES ].enable );
+}
+
+static void test_json_wifictl( void ) {
+    DynamicJsonDocument doc( 4096 );
+    wifictl_config_t config, loaded;
+    networklist list[ NETWORKLIST_ENTRYS ], list_loaded[ NETWORKLIST_ENTRYS ];
+
+    /*
+     * entries without a psk are left alone
+     */
+    wifictl_config_from_json( &config, list, parse( doc, "{\"autoon\":false,\"webserver\":true,\"networklist\":["
+                                                         "{\"ssid\":\"home\",\"psk\":\"secret\"},{\"ssid\":\"open\"},{\"ssid\":\"work\",\"psk\":\"\"}]}" ) );
+    migrate( &config, sizeof( config ), &loaded );
+    migrate( list, sizeof( list ), list_loaded );
+
+    TEST_ASSERT_FALSE( loaded.autoon );
+    TEST_ASSERT_TRUE( loaded.webserver );
+    TEST_ASSERT_FALSE( loaded.enable_on_standby );
+    TEST_ASSERT_EQUAL_STRING( "home", list_loaded[ 0 ].ssid );
+    TEST_ASSERT_EQUAL_STRING( "secret", list_loaded[ 0 ].password );
+    TEST_ASSERT_EQUAL_STRING( "", list_loaded[ 1 ].ssid );
+    TEST_ASSERT_EQUAL_STRING( "work", list_loaded[ 2 ].ssid );
+    TEST_ASSERT_EQUAL_STRING( "", list_loaded[ NETWORKLIST_ENTRYS - 1 ].ssid );
+}
+
+static void test_json_mqttctl( void ) {
+    DynamicJsonDocument doc( 1024 );
+    mqttctl_config_t config, loaded, back;
+
+    mqttctl_config_from_json( &config, parse( doc, "{\"enable\":true,\"server\":\"10.0.0.2\",\"interval\":0,\"format\":\"binary\"}" ) );
+    migrate( &config, sizeof( config ), &loaded );
+
+    TEST_ASSERT_TRUE( loaded.enable );
+    TEST_ASSERT_EQUAL_STRING( "10.0.0.2", loaded.server );
+    TEST_ASSERT_EQUAL( 1883, loaded.port );
+    TEST_ASSERT_EQUAL_STRING( "eucdash/telemetry", loaded.topic );
+    TEST_ASSERT_EQUAL( 1, loaded.interval );
+    TEST_ASSERT_EQUAL( MQTTCTL_FORMAT_BINARY, loaded.format );
+
+    /*
+     * the json the config store writes next to the image reads back the same
+     */
+    doc.clear();
+    mqttctl_config_to_json( &loaded, doc.to<JsonObject>() );
+    mqttctl_config_from_json( &back, doc.as<JsonObjectConst>() );
+    TEST_ASSERT_EQUAL_MEMORY( &loaded, &back, sizeof( back ) );
+}
+
+static void test_json_rtcctl( void ) {
+    DynamicJsonDocument doc( 1024 );
+    rtcctl_alarm_t alarm, loaded;
+
+    rtcctl_alarm_from_json( &alarm, parse( doc, "{\"version\":1,\"enabled\":true,\"hour\":6,\"minute\":45,\"week_days\":65}" ) );
+    migrate( &alarm, sizeof( alarm ), &loaded );
+
+    TEST_ASSERT_TRUE( loaded.enabled );
+    TEST_ASSERT_EQUAL( 6, loaded.hour );
+    TEST_ASSERT_EQUAL( 45, loaded.minute );
+    TEST_ASSERT_TRUE( loaded.week_days[ 0 ] );
+    TEST_ASSERT_FALSE( loaded.week_days[ 1 ] );
+    TEST_ASSERT_TRUE( loaded.week_days[ 6 ] );
+}
+
+static void test_json_alarmctl( void ) {
+    DynamicJsonDocument doc( 4096 );
+    alarmctl_config_t config, loaded, back;
+    const char *json = "{\"rules\":["
+        "{\"field\":\"speed\",\"cmp\":\">=\",\"data\":\"temp\",\"threshold\":1.5,\"hysteresis\":1,\"band\":\"crit\",\"haptic\":\"tick\",\"jump\":true},"
+        "{\"field\":\"rpm\",\"cmp\":\">\",\"threshold\":1},"
+        "{\"field\":\"current\",\"cmp\":\"<\",\"const\":\"maxcurrent\",\"duration\":200,\"band\":\"normal\",\"haptic\":\"none\"}]}";
+
+    /*
+     * the second rule names an unknown field and is dropped, band normal and haptic
+     * none are no action
+     */
+    TEST_ASSERT_EQUAL( 1, alarmctl_config_from_json( &config, parse( doc, json ), &names ) );
+    migrate( &config, sizeof( config ), &loaded );
+
+    TEST_ASSERT_EQUAL( 2, loaded.rules );
+    TEST_ASSERT_EQUAL( 1, loaded.rule[ 0 ].field );
+    TEST_ASSERT_EQUAL( ALARM_RULE_GE, loaded.rule[ 0 ].cmp );
+    TEST_ASSERT_EQUAL( ALARM_RULE_REF_DATA, loaded.rule[ 0 ].ref );
+    TEST_ASSERT_EQUAL( 3, loaded.rule[ 0 ].ref_entry );
+    TEST_ASSERT_EQUAL_FLOAT( 1.5, loaded.rule[ 0 ].threshold );
+    TEST_ASSERT_EQUAL( ALARM_RULE_BAND | ALARM_RULE_HAPTIC | ALARM_RULE_JUMP, loaded.rule[ 0 ].actions );
+    TEST_ASSERT_EQUAL( 2, loaded.rule[ 0 ].band );
+    TEST_ASSERT_EQUAL( ALARMCTL_HAPTIC_TICK, loaded.rule[ 0 ].haptic );
+    TEST_ASSERT_EQUAL( 2, loaded.rule[ 1 ].field );
+    TEST_ASSERT_EQUAL( ALARM_RULE_REF_CONST, loaded.rule[ 1 ].ref );
+    TEST_ASSERT_EQUAL( 200, loaded.rule[ 1 ].duration );
+    TEST_ASSERT_EQUAL( 0, loaded.rule[ 1 ].actions );
+
+    doc.clear();
+    alarmctl_config_to_json( &loaded, doc.to<JsonObject>(), &names );
+    TEST_ASSERT_EQUAL( 0, alarmctl_config_from_json( &back, doc.as<JsonObjectConst>(), &names ) );
+    TEST_ASSERT_EQUAL( loaded.rules, back.rules );
+    TEST_ASSERT_EQUAL_MEMORY( loaded.rule, back.rule, sizeof( alarm_rule_t ) * loaded.rules );
+}
+
+int main( void ) {
+    UNITY_BEGIN();
+    RUN_TEST( test_roundtrip );
+    RUN_TEST( test_struct_grew );
+    RUN_TEST( test_struct_shrank );
+    RUN_TEST( test_array_grew );
+    RUN_TEST( test_truncated_payload );
+    RUN_TEST( test_unknown_section );
+    RUN_TEST( test_json_display );
+    RUN_TEST( test_json_missing_keys );
+    RUN_TEST( test_json_wifictl );
+    RUN_TEST( test_json_mqttctl );
+    RUN_TEST( test_json_rtcctl );
+    RUN_TEST( test_json_alarmctl );
+    return( UNITY_END() );
+}
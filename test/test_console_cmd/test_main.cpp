@@ -0,0 +1,175 @@
+/****************************************************************************
+ *   Copyright  2020  Jesper Ortlund
+ ****************************************************************************/
+/*
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+#include <string.h>
+#include <unity.h>
+
+#include "hardware/console_cmd.h"
+
+static int calls;
+static int last_argc;
+static char last_argv[ CONSOLE_CMD_MAX_ARGS ][ 16 ];
+
+static int record( int argc, char **argv ) {
+    calls++;
+    last_argc = argc;
+    for ( int i = 0 ; i < argc && i < CONSOLE_CMD_MAX_ARGS ; i++ ) {
+        strncpy( last_argv[ i ], argv[ i ], sizeof( last_argv[ i ] ) - 1 );
+        last_argv[ i ][ sizeof( last_argv[ i ] ) - 1 ] = '\0';
+    }
+    return( CONSOLE_CMD_OK );
+}
+
+static int fail( int argc, char **argv ) {
+    record( argc, argv );
+    return( CONSOLE_CMD_FAILED );
+}
+
+static const console_cmd_t table[] = {
+    { "help",       "",             "list commands",        0,  0, record },
+    { "inject",     "<hex> ...",    "feed a raw frame",     1, 20, record },
+    { "mqtt",       "[cmd ...]",    "uplink",               0,  3, record },
+    { "broken",     "",             "always fails",         0,  0, fail },
+};
+
+#define TABLE_LEN   (int)( sizeof( table ) / sizeof( table[ 0 ] ) )
+
+static int dispatch( const char *text ) {
+    char line[ 256 ];
+
+    strncpy( line, text, sizeof( line ) - 1 );
+    line[ sizeof( line ) - 1 ] = '\0';
+    return( console_cmd_dispatch( table, TABLE_LEN, line ) );
+}
+
+void setUp( void ) {
+    calls = 0;
+    last_argc = 0;
+    memset( last_argv, 0, sizeof( last_argv ) );
+}
+
+void tearDown( void ) {
+}
+
+static void test_split( void ) {
+    char line[] = "  mqtt\tserver  10.0.0.2 1883\r\n";
+    char *argv[ 8 ];
+
+    TEST_ASSERT_EQUAL( 4, console_cmd_split( line, argv, 8 ) );
+    TEST_ASSERT_EQUAL_STRING( "mqtt", argv[ 0 ] );
+    TEST_ASSERT_EQUAL_STRING( "server", argv[ 1 ] );
+    TEST_ASSERT_EQUAL_STRING( "10.0.0.2", argv[ 2 ] );
+    TEST_ASSERT_EQUAL_STRING( "1883", argv[ 3 ] );
+}
+
+static void test_split_limits( void ) {
+    char blank[] = " \t \r\n";
+    char full[] = "a b c";
+    char over[] = "a b c d";
+    char *argv[ 3 ];
+
+    TEST_ASSERT_EQUAL( 0, console_cmd_split( blank, argv, 3 ) );
+    TEST_ASSERT_EQUAL( 3, console_cmd_split( full, argv, 3 ) );
+    TEST_ASSERT_EQUAL( -1, console_cmd_split( over, argv, 3 ) );
+}
+
+static void test_dispatch( void ) {
+    TEST_ASSERT_EQUAL( CONSOLE_CMD_OK, dispatch( "mqtt login rider secret" ) );
+    TEST_ASSERT_EQUAL( 1, calls );
+    TEST_ASSERT_EQUAL( 4, last_argc );
+    TEST_ASSERT_EQUAL_STRING( "mqtt", last_argv[ 0 ] );
+    TEST_ASSERT_EQUAL_STRING( "secret", last_argv[ 3 ] );
+
+    TEST_ASSERT_EQUAL( CONSOLE_CMD_FAILED, dispatch( "broken" ) );
+    TEST_ASSERT_EQUAL( 2, calls );
+}
+
+static void test_dispatch_errors( void ) {
+    TEST_ASSERT_EQUAL( CONSOLE_CMD_EMPTY, dispatch( "" ) );
+    TEST_ASSERT_EQUAL( CONSOLE_CMD_EMPTY, dispatch( "   \r\n" ) );
+    TEST_ASSERT_EQUAL( CONSOLE_CMD_UNKNOWN, dispatch( "reboot" ) );
+    /*
+     * commands match the whole word only
+     */
+    TEST_ASSERT_EQUAL( CONSOLE_CMD_UNKNOWN, dispatch( "mqt" ) );
+    TEST_ASSERT_EQUAL( CONSOLE_CMD_UNKNOWN, dispatch( "helpme" ) );
+    /*
+     * argument counts are checked before the command runs
+     */
+    TEST_ASSERT_EQUAL( CONSOLE_CMD_USAGE, dispatch( "help me" ) );
+    TEST_ASSERT_EQUAL( CONSOLE_CMD_USAGE, dispatch( "inject" ) );
+    TEST_ASSERT_EQUAL( CONSOLE_CMD_USAGE, dispatch( "mqtt a b c d" ) );
+    TEST_ASSERT_EQUAL( 0, calls );
+}
+
+static void test_dispatch_frame( void ) {
+    /*
+     * a raw frame byte by byte is the longest line, command plus 20 words
+     */
+    TEST_ASSERT_EQUAL( CONSOLE_CMD_OK, dispatch( "inject aa 55 01 02 03 04 05 06 07 08 09 0a 0b 0c 0d 0e a9 14 5a 5a" ) );
+    TEST_ASSERT_EQUAL( 21, last_argc );
+    TEST_ASSERT_EQUAL( CONSOLE_CMD_USAGE, dispatch( "inject aa 55 01 02 03 04 05 06 07 08 09 0a 0b 0c 0d 0e a9 14 5a 5a 00" ) );
+    /*
+     * more words than CONSOLE_CMD_MAX_ARGS is refused by the splitter
+     */
+    TEST_ASSERT_EQUAL( CONSOLE_CMD_USAGE, dispatch( "inject 0 1 2 3 4 5 6 7 8 9 0 1 2 3 4 5 6 7 8 9 0 1 2 3 4" ) );
+    TEST_ASSERT_EQUAL( 1, calls );
+}
+
+static void test_parse_uint( void ) {
+    uint32_t value = 0;
+
+    TEST_ASSERT_TRUE( console_cmd_parse_uint( "1883", &value ) );
+    TEST_ASSERT_EQUAL_UINT32( 1883, value );
+    TEST_ASSERT_TRUE( console_cmd_parse_uint( "0x1F", &value ) );
+    TEST_ASSERT_EQUAL_UINT32( 31, value );
+    TEST_ASSERT_TRUE( console_cmd_parse_uint( "4294967295", &value ) );
+    TEST_ASSERT_EQUAL_UINT32( 4294967295u, value );
+
+    value = 7;
+    TEST_ASSERT_FALSE( console_cmd_parse_uint( "", &value ) );
+    TEST_ASSERT_FALSE( console_cmd_parse_uint( "0x", &value ) );
+    TEST_ASSERT_FALSE( console_cmd_parse_uint( "12a", &value ) );
+    TEST_ASSERT_FALSE( console_cmd_parse_uint( "-1", &value ) );
+    TEST_ASSERT_FALSE( console_cmd_parse_uint( "4294967296", &value ) );
+    TEST_ASSERT_EQUAL_UINT32( 7, value );
+}
+
+static void test_parse_hex( void ) {
+    uint8_t data[ 4 ];
+    const uint8_t expect[] = { 0xaa, 0x55, 0x0f, 0xA9 };
+
+    TEST_ASSERT_EQUAL( 4, console_cmd_parse_hex( "aa55:0F-A9", data, sizeof( data ) ) );
+    TEST_ASSERT_EQUAL_HEX8_ARRAY( expect, data, 4 );
+    TEST_ASSERT_EQUAL( 0, console_cmd_parse_hex( "", data, sizeof( data ) ) );
+    TEST_ASSERT_EQUAL( -1, console_cmd_parse_hex( "aa5", data, sizeof( data ) ) );
+    TEST_ASSERT_EQUAL( -1, console_cmd_parse_hex( "zz", data, sizeof( data ) ) );
+    TEST_ASSERT_EQUAL( -1, console_cmd_parse_hex( "0102030405", data, sizeof( data ) ) );
+}
+
+int main( void ) {
+    UNITY_BEGIN();
+    RUN_TEST( test_split );
+    RUN_TEST( test_split_limits );
+    RUN_TEST( test_dispatch );
+    RUN_TEST( test_dispatch_errors );
+    RUN_TEST( test_dispatch_frame );
+    RUN_TEST( test_parse_uint );
+    RUN_TEST( test_parse_hex );
+    return( UNITY_END() );
+}
@@ -0,0 +1,87 @@
+/*
+ * minimal streaming md5 after rfc 1321, the host has no MD5Builder
+ */
+#include <stdint.h>
+#include <string.h>
+
+typedef struct {
+    uint32_t state[ 4 ];
+    uint64_t len;
+    uint8_t block[ 64 ];
+} md5_t;
+
+static const uint32_t md5_k[ 64 ] = {
+    0xd76aa478, 0xe8c7b756, 0x242070db, 0xc1bdceee, 0xf57c0faf, 0x4787c62a, 0xa8304613, 0xfd469501,
+    0x698098d8, 0x8b44f7af, 0xffff5bb1, 0x895cd7be, 0x6b901122, 0xfd987193, 0xa679438e, 0x49b40821,
+    0xf61e2562, 0xc040b340, 0x265e5a51, 0xe9b6c7aa, 0xd62f105d, 0x02441453, 0xd8a1e681, 0xe7d3fbc8,
+    0x21e1cde6, 0xc33707d6, 0xf4d50d87, 0x455a14ed, 0xa9e3e905, 0xfcefa3f8, 0x676f02d9, 0x8d2a4c8a,
+    0xfffa3942, 0x8771f681, 0x6d9d6122, 0xfde5380c, 0xa4beea44, 0x4bdecfa9, 0xf6bb4b60, 0xbebfbc70,
+    0x289b7ec6, 0xeaa127fa, 0xd4ef3085, 0x04881d05, 0xd9d4d039, 0xe6db99e5, 0x1fa27cf8, 0xc4ac5665,
+    0xf4292244, 0x432aff97, 0xab9423a7, 0xfc93a039, 0x655b59c3, 0x8f0ccc92, 0xffeff47d, 0x85845dd1,
+    0x6fa87e4f, 0xfe2ce6e0, 0xa3014314, 0x4e0811a1, 0xf7537e82, 0xbd3af235, 0x2ad7d2bb, 0xeb86d391 };
+
+static const uint8_t md5_r[ 64 ] = {
+    7, 12, 17, 22, 7, 12, 17, 22, 7, 12, 17, 22, 7, 12, 17, 22,
+    5,  9, 14, 20, 5,  9, 14, 20, 5,  9, 14, 20, 5,  9, 14, 20,
+    4, 11, 16, 23, 4, 11, 16, 23, 4, 11, 16, 23, 4, 11, 16, 23,
+    6, 10, 15, 21, 6, 10, 15, 21, 6, 10, 15, 21, 6, 10, 15, 21 };
+
+static void md5_block( md5_t *md5 ) {
+    uint32_t w[ 16 ];
+    uint32_t a = md5->state[ 0 ], b = md5->state[ 1 ], c = md5->state[ 2 ], d = md5->state[ 3 ];
+
+    for ( int i = 0 ; i < 16 ; i++ )
+        w[ i ] = md5->block[ i * 4 ] | ( md5->block[ i * 4 + 1 ] << 8 ) | ( md5->block[ i * 4 + 2 ] << 16 ) | ( (uint32_t)md5->block[ i * 4 + 3 ] << 24 );
+
+    for ( int i = 0 ; i < 64 ; i++ ) {
+        uint32_t f;
+        int g;
+
+        if ( i < 16 )       { f = ( b & c ) | ( ~b & d );   g = i; }
+        else if ( i < 32 )  { f = ( d & b ) | ( ~d & c );   g = ( 5 * i + 1 ) & 15; }
+        else if ( i < 48 )  { f = b ^ c ^ d;                g = ( 3 * i + 5 ) & 15; }
+        else                { f = c ^ ( b | ~d );           g = ( 7 * i ) & 15; }
+
+        f += a + md5_k[ i ] + w[ g ];
+        a = d;
+        d = c;
+        c = b;
+        b += ( f << md5_r[ i ] ) | ( f >> ( 32 - md5_r[ i ] ) );
+    }
+    md5->state[ 0 ] += a;
+    md5->state[ 1 ] += b;
+    md5->state[ 2 ] += c;
+    md5->state[ 3 ] += d;
+}
+
+static void md5_begin( md5_t *md5 ) {
+    md5->state[ 0 ] = 0x67452301;
+    md5->state[ 1 ] = 0xefcdab89;
+    md5->state[ 2 ] = 0x98badcfe;
+    md5->state[ 3 ] = 0x10325476;
+    md5->len = 0;
+}
+
+static void md5_add( md5_t *md5, const uint8_t *data, size_t len ) {
+    while ( len-- ) {
+        md5->block[ md5->len++ & 63 ] = *data++;
+        if ( ( md5->len & 63 ) == 0 )
+            md5_block( md5 );
+    }
+}
+
+static void md5_end( md5_t *md5, uint8_t digest[ 16 ] ) {
+    uint64_t bits = md5->len * 8;
+    uint8_t pad = 0x80;
+
+    md5_add( md5, &pad, 1 );
+    pad = 0;
+    while ( ( md5->len & 63 ) != 56 )
+        md5_add( md5, &pad, 1 );
+    for ( int i = 0 ; i < 8 ; i++ ) {
+        uint8_t b = bits >> ( i * 8 );
+        md5_add( md5, &b, 1 );
+    }
+    for ( int i = 0 ; i < 16 ; i++ )
+        digest[ i ] = md5->state[ i / 4 ] >> ( ( i % 4 ) * 8 );
+}
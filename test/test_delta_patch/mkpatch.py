@@ -0,0 +1,71 @@
+#!/usr/bin/env python3
+"""Write patch.h, a tools/mkdelta.py patch for the delta patch decoder test.
+
+The source image is a xorshift32 byte stream the test regenerates itself,
+so only the patch and the md5 of both images end up in the header. The
+target is the source with the kind of changes a new build brings: a few
+changed bytes, an inserted and a removed block and code moved around.
+Rerun after changing the images or the patch format:
+
+    python3 test/test_delta_patch/mkpatch.py > test/test_delta_patch/patch.h
+"""
+
+import hashlib
+import os
+import sys
+
+sys.path.insert(0, os.path.join(os.path.dirname(os.path.abspath(__file__)), '..', '..', 'tools'))
+import mkdelta  # noqa: E402
+
+SOURCE_SEED = 0x2545F491
+SOURCE_SIZE = 20000
+
+
+def image(seed, size):
+    out = bytearray()
+    x = seed
+    for _ in range(size):
+        x ^= (x << 13) & 0xffffffff
+        x ^= x >> 17
+        x ^= (x << 5) & 0xffffffff
+        out.append(x & 0xff)
+    return bytes(out)
+
+
+def main():
+    source = image(SOURCE_SEED, SOURCE_SIZE)
+    noise = image(0x12345678, 600)
+
+    target = bytearray(source)
+    target[1000:1100] = noise[:100]                     # changed block
+    target[5000:5000] = noise[100:400]                  # inserted block
+    del target[9000:9200]                               # removed block
+    target[16000:16007] = b'v2020.1'                    # changed version string
+    target += source[12000:13000]                       # moved code
+    target = bytes(target)
+
+    patch = mkdelta.make_patch(source, target)
+    if mkdelta.apply_patch(source, patch) != target:
+        raise SystemExit('patch does not rebuild the target')
+
+    def md5(data):
+        return ', '.join('0x%02x' % b for b in hashlib.md5(data).digest())
+
+    print('/*')
+    print(' * generated by mkpatch.py, a mkdelta.py patch against a xorshift32 source image')
+    print(' */')
+    print('#define PATCH_SOURCE_SEED   0x%08X' % SOURCE_SEED)
+    print('#define PATCH_SOURCE_SIZE   %d' % len(source))
+    print('#define PATCH_TARGET_SIZE   %d' % len(target))
+    print()
+    print('static const uint8_t patch_source_md5[ 16 ] = { %s };' % md5(source))
+    print('static const uint8_t patch_target_md5[ 16 ] = { %s };' % md5(target))
+    print()
+    print('static const uint8_t patch[] = {')
+    for pos in range(0, len(patch), 16):
+        print('    ' + ' '.join('0x%02x,' % b for b in patch[pos:pos + 16]))
+    print('};')
+
+
+if __name__ == '__main__':
+    main()
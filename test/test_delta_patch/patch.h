@@ -0,0 +1,44 @@
+/*
+ * generated by mkpatch.py, a mkdelta.py patch against a xorshift32 source image
+ */
+#define PATCH_SOURCE_SEED   0x2545F491
+#define PATCH_SOURCE_SIZE   20000
+#define PATCH_TARGET_SIZE   21100
+
+static const uint8_t patch_source_md5[ 16 ] = { 0x87, 0x3e, 0xda, 0x02, 0xc6, 0xee, 0xff, 0x5b, 0x1a, 0x44, 0x2f, 0x45, 0x1e, 0xa5, 0x93, 0x11 };
+static const uint8_t patch_target_md5[ 16 ] = { 0x0f, 0x71, 0xa6, 0xe0, 0x4a, 0x1f, 0xa7, 0x7b, 0xb9, 0x8e, 0xab, 0xd6, 0x19, 0xac, 0x18, 0xfe };
+
+static const uint8_t patch[] = {
+    0x45, 0x44, 0x50, 0x31, 0x20, 0x4e, 0x00, 0x00, 0x6c, 0x52, 0x00, 0x00, 0x87, 0x3e, 0xda, 0x02,
+    0xc6, 0xee, 0xff, 0x5b, 0x1a, 0x44, 0x2f, 0x45, 0x1e, 0xa5, 0x93, 0x11, 0x01, 0x00, 0x00, 0x00,
+    0x00, 0xe8, 0x03, 0x00, 0x00, 0x02, 0x64, 0x00, 0x00, 0x00, 0xa5, 0xa3, 0xc4, 0x98, 0x88, 0x4d,
+    0x1d, 0x29, 0xa7, 0x11, 0xf8, 0xf8, 0xa0, 0x15, 0xc6, 0x69, 0x92, 0x9d, 0xc9, 0x94, 0xbf, 0x3e,
+    0x0c, 0x21, 0xd6, 0x51, 0x68, 0xf9, 0x84, 0x7b, 0xfa, 0xac, 0x47, 0x59, 0xac, 0x07, 0xac, 0x9a,
+    0x62, 0x0e, 0xee, 0xd2, 0x29, 0x0d, 0xf5, 0x14, 0xbe, 0x19, 0x5d, 0xc0, 0xa5, 0x00, 0xcd, 0xef,
+    0x04, 0x08, 0x0e, 0xca, 0x5f, 0xec, 0xb8, 0x79, 0x98, 0x87, 0x17, 0xb9, 0xfc, 0x65, 0x13, 0x73,
+    0xd3, 0x63, 0x24, 0x82, 0x82, 0x5c, 0xc4, 0x09, 0x0a, 0x3d, 0xcc, 0x2d, 0x5c, 0xc3, 0x17, 0x79,
+    0x40, 0x7a, 0x0e, 0xef, 0x2d, 0x70, 0x36, 0xdd, 0x66, 0xba, 0xad, 0x18, 0xf2, 0x08, 0x01, 0x4c,
+    0x04, 0x00, 0x00, 0x3c, 0x0f, 0x00, 0x00, 0x02, 0x2c, 0x01, 0x00, 0x00, 0xa5, 0x07, 0x82, 0x15,
+    0x60, 0x47, 0x2b, 0x3e, 0x08, 0x57, 0x79, 0x1b, 0xff, 0xb7, 0xaa, 0xa5, 0xaa, 0x59, 0x49, 0xb5,
+    0xea, 0xe1, 0xac, 0x63, 0xab, 0xe1, 0xd5, 0x1e, 0x41, 0x77, 0x4e, 0xbf, 0x78, 0x14, 0x13, 0xc2,
+    0x36, 0xf9, 0x98, 0xae, 0x28, 0xc0, 0xf5, 0x23, 0x76, 0x7f, 0x17, 0x5d, 0x1c, 0xae, 0xab, 0xc3,
+    0xbe, 0x6e, 0x0d, 0x45, 0xd8, 0x03, 0xe7, 0x56, 0xfa, 0x2b, 0x58, 0x62, 0x7c, 0xbb, 0xf1, 0x31,
+    0x29, 0xc4, 0x4c, 0x3e, 0xba, 0x93, 0x4c, 0x40, 0xd4, 0x11, 0x58, 0xb6, 0xbe, 0x73, 0x4c, 0x55,
+    0x2d, 0x6f, 0x63, 0x6b, 0x13, 0x85, 0xe8, 0x8e, 0xf1, 0xad, 0xe8, 0xac, 0x65, 0xf9, 0xd9, 0x10,
+    0x9c, 0xd2, 0xf7, 0x9c, 0x26, 0xc3, 0xa7, 0x0e, 0xe4, 0x59, 0xbb, 0x46, 0x62, 0x49, 0x78, 0x02,
+    0xfd, 0xac, 0xa0, 0x2e, 0xbe, 0xe5, 0x36, 0xad, 0xdc, 0x0e, 0x42, 0x16, 0xce, 0x6d, 0x07, 0x67,
+    0x61, 0x7b, 0xea, 0xb7, 0xf6, 0x66, 0xb7, 0x21, 0x52, 0x7a, 0x6f, 0xba, 0x64, 0x19, 0xe8, 0xe0,
+    0x13, 0x3f, 0xc1, 0x2b, 0x14, 0x64, 0xd3, 0xe9, 0xe4, 0xb0, 0x73, 0xe8, 0xaa, 0x56, 0x8b, 0x70,
+    0x01, 0x8f, 0x4f, 0xf9, 0x60, 0x16, 0x65, 0xf9, 0x68, 0xba, 0xec, 0x54, 0x79, 0x99, 0xa1, 0xe5,
+    0xc4, 0x71, 0x50, 0x73, 0xdf, 0x3c, 0xec, 0xde, 0x9e, 0xe7, 0xa9, 0x31, 0x23, 0x46, 0x81, 0x7f,
+    0x2b, 0x97, 0x64, 0x54, 0x41, 0xad, 0x25, 0xb6, 0x90, 0x33, 0x88, 0x04, 0x89, 0x32, 0x36, 0x4d,
+    0x7a, 0xab, 0x68, 0xab, 0x9d, 0x21, 0xc5, 0x9d, 0x1f, 0xdb, 0xb1, 0xe6, 0xfe, 0x78, 0x92, 0xc9,
+    0x92, 0x24, 0x6e, 0xd6, 0x85, 0x84, 0x53, 0x77, 0x5f, 0xd7, 0xa6, 0x17, 0x02, 0xc7, 0x77, 0x12,
+    0xa2, 0x36, 0xd4, 0xbe, 0xc4, 0x0c, 0xbd, 0x9b, 0x2e, 0x57, 0xca, 0x34, 0x93, 0xcd, 0x49, 0x98,
+    0xe7, 0x5a, 0xe2, 0x21, 0xdd, 0x0b, 0x97, 0xb7, 0xcf, 0x4d, 0x78, 0x10, 0x85, 0xed, 0x90, 0x17,
+    0xd6, 0x9a, 0xa4, 0xfb, 0xa9, 0x57, 0x3d, 0x42, 0x50, 0xc5, 0x71, 0xbf, 0x34, 0x81, 0x4f, 0x9b,
+    0x81, 0xc8, 0x0b, 0x06, 0xaa, 0x42, 0xe2, 0x89, 0x01, 0x88, 0x13, 0x00, 0x00, 0x74, 0x0e, 0x00,
+    0x00, 0x01, 0xc4, 0x22, 0x00, 0x00, 0x58, 0x1b, 0x00, 0x00, 0x02, 0x07, 0x00, 0x00, 0x00, 0x76,
+    0x32, 0x30, 0x32, 0x30, 0x2e, 0x31, 0x01, 0x23, 0x3e, 0x00, 0x00, 0xfd, 0x0f, 0x00, 0x00, 0x01,
+    0xe0, 0x2e, 0x00, 0x00, 0xe8, 0x03, 0x00, 0x00, 0x00,
+};
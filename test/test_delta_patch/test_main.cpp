@@ -0,0 +1,217 @@
+/****************************************************************************
+ *   Copyright  2020  Jesper Ortlund
+ ****************************************************************************/
+/*
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+#include <stdlib.h>
+#include <unity.h>
+
+#include "hardware/delta_patch.h"
+#include "md5.h"
+#include "patch.h"
+
+static uint8_t source[ PATCH_SOURCE_SIZE ];
+static md5_t target;                        /** @brief md5 over everything written to the target */
+static uint32_t target_len;
+static bool began;
+static uint32_t fail_write_at;              /** @brief target offset at which the write callback fails, 0 for never */
+
+static bool begin_cb( uint32_t source_size, const uint8_t *source_md5, uint32_t target_size ) {
+    began = true;
+    return( source_size == PATCH_SOURCE_SIZE && target_size == PATCH_TARGET_SIZE && !memcmp( source_md5, patch_source_md5, 16 ) );
+}
+
+static bool read_cb( uint32_t offset, uint8_t *data, size_t len ) {
+    if ( offset + len > sizeof( source ) )
+        return( false );
+    memcpy( data, &source[ offset ], len );
+    return( true );
+}
+
+static bool write_cb( const uint8_t *data, size_t len ) {
+    if ( fail_write_at && target_len + len > fail_write_at )
+        return( false );
+    md5_add( &target, data, len );
+    target_len += len;
+    return( true );
+}
+
+void setUp( void ) {
+    uint32_t x = PATCH_SOURCE_SEED;
+
+    for ( int i = 0 ; i < PATCH_SOURCE_SIZE ; i++ ) {
+        x ^= x << 13;
+        x ^= x >> 17;
+        x ^= x << 5;
+        source[ i ] = x;
+    }
+    md5_begin( &target );
+    target_len = 0;
+    began = false;
+    fail_write_at = 0;
+}
+
+void tearDown( void ) {
+}
+
+/**
+ * @brief feed a patch in chunks, from sizes[] round robin, or random sizes up to max if sizes is NULL
+ *
+ * @return  result of the last feed
+ */
+static int feed( delta_patch_t *delta, const uint8_t *data, size_t len, const size_t *sizes, size_t max ) {
+    int ret = DELTA_PATCH_MORE;
+    size_t pos = 0;
+    int n = 0;
+
+    srand( max );
+    while ( pos < len && ret == DELTA_PATCH_MORE ) {
+        size_t chunk = sizes ? sizes[ n++ ] : 1 + rand() % max;
+        if ( sizes && sizes[ n ] == 0 )
+            n = 0;
+        if ( chunk > len - pos )
+            chunk = len - pos;
+        ret = delta_patch_feed( delta, &data[ pos ], chunk );
+        pos += chunk;
+    }
+    return( ret );
+}
+
+static void expect_target( delta_patch_t *delta, int ret ) {
+    uint8_t digest[ 16 ];
+
+    TEST_ASSERT_EQUAL( DELTA_PATCH_DONE, ret );
+    TEST_ASSERT_NULL( delta->error );
+    TEST_ASSERT_TRUE( began );
+    TEST_ASSERT_EQUAL( PATCH_TARGET_SIZE, target_len );
+    md5_end( &target, digest );
+    TEST_ASSERT_EQUAL_HEX8_ARRAY( patch_target_md5, digest, 16 );
+}
+
+static void test_source_image( void ) {
+    uint8_t digest[ 16 ];
+    md5_t md5;
+
+    md5_begin( &md5 );
+    md5_add( &md5, source, sizeof( source ) );
+    md5_end( &md5, digest );
+    TEST_ASSERT_EQUAL_HEX8_ARRAY( patch_source_md5, digest, 16 );
+}
+
+static void test_whole( void ) {
+    static delta_patch_t delta;
+
+    delta_patch_init( &delta, begin_cb, read_cb, write_cb );
+    expect_target( &delta, delta_patch_feed( &delta, patch, sizeof( patch ) ) );
+}
+
+static void test_fixed_sizes( void ) {
+    /*
+     * single bytes, sizes that split the header and op arguments, and a download buffer
+     */
+    static const size_t sizes[][ 4 ] = { { 1, 0 }, { 3, 0 }, { 5, 7, 0 }, { 27, 1, 9, 0 }, { 4096, 0 } };
+    static delta_patch_t delta;
+
+    for ( unsigned int i = 0 ; i < sizeof( sizes ) / sizeof( sizes[ 0 ] ) ; i++ ) {
+        setUp();
+        delta_patch_init( &delta, begin_cb, read_cb, write_cb );
+        expect_target( &delta, feed( &delta, patch, sizeof( patch ), sizes[ i ], 0 ) );
+    }
+}
+
+static void test_random_sizes( void ) {
+    static delta_patch_t delta;
+
+    for ( size_t max = 2 ; max <= 512 ; max *= 2 ) {
+        setUp();
+        delta_patch_init( &delta, begin_cb, read_cb, write_cb );
+        expect_target( &delta, feed( &delta, patch, sizeof( patch ), NULL, max ) );
+    }
+}
+
+static void test_truncated( void ) {
+    static delta_patch_t delta;
+
+    delta_patch_init( &delta, begin_cb, read_cb, write_cb );
+    TEST_ASSERT_EQUAL( DELTA_PATCH_MORE, delta_patch_feed( &delta, patch, sizeof( patch ) - 1 ) );
+    TEST_ASSERT_EQUAL( DELTA_PATCH_DONE, delta_patch_feed( &delta, &patch[ sizeof( patch ) - 1 ], 1 ) );
+}
+
+static void test_bad_magic( void ) {
+    static delta_patch_t delta;
+    uint8_t bad[ sizeof( patch ) ];
+
+    memcpy( bad, patch, sizeof( patch ) );
+    bad[ 0 ] ^= 0xff;
+    delta_patch_init( &delta, begin_cb, read_cb, write_cb );
+    TEST_ASSERT_EQUAL( DELTA_PATCH_ERROR, delta_patch_feed( &delta, bad, sizeof( bad ) ) );
+    TEST_ASSERT_NOT_NULL( delta.error );
+    TEST_ASSERT_FALSE( began );
+}
+
+static void test_other_source( void ) {
+    static delta_patch_t delta;
+    uint8_t bad[ sizeof( patch ) ];
+
+    memcpy( bad, patch, sizeof( patch ) );
+    bad[ 12 ] ^= 0xff;
+    delta_patch_init( &delta, begin_cb, read_cb, write_cb );
+    TEST_ASSERT_EQUAL( DELTA_PATCH_ERROR, delta_patch_feed( &delta, bad, sizeof( bad ) ) );
+    TEST_ASSERT_EQUAL( 0, target_len );
+}
+
+static void test_copy_outside_source( void ) {
+    static delta_patch_t delta;
+    uint8_t bad[ DELTA_PATCH_HEADER_SIZE + 9 ];
+
+    /*
+     * the real header, then a copy reaching 8 bytes past the end of the source
+     */
+    memcpy( bad, patch, DELTA_PATCH_HEADER_SIZE );
+    bad[ DELTA_PATCH_HEADER_SIZE ] = DELTA_PATCH_OP_COPY;
+    uint32_t args[ 2 ] = { PATCH_SOURCE_SIZE - 8, 16 };
+    memcpy( &bad[ DELTA_PATCH_HEADER_SIZE + 1 ], args, sizeof( args ) );
+    delta_patch_init( &delta, begin_cb, read_cb, write_cb );
+    TEST_ASSERT_EQUAL( DELTA_PATCH_ERROR, delta_patch_feed( &delta, bad, sizeof( bad ) ) );
+    TEST_ASSERT_EQUAL( 0, target_len );
+}
+
+static void test_write_fails( void ) {
+    static delta_patch_t delta;
+
+    fail_write_at = PATCH_TARGET_SIZE / 2;
+    delta_patch_init( &delta, begin_cb, read_cb, write_cb );
+    TEST_ASSERT_EQUAL( DELTA_PATCH_ERROR, feed( &delta, patch, sizeof( patch ), NULL, 64 ) );
+    TEST_ASSERT_NOT_NULL( delta.error );
+    /*
+     * once failed, more data does not bring it back
+     */
+    TEST_ASSERT_EQUAL( DELTA_PATCH_ERROR, delta_patch_feed( &delta, patch, sizeof( patch ) ) );
+}
+
+int main( void ) {
+    UNITY_BEGIN();
+    RUN_TEST( test_source_image );
+    RUN_TEST( test_whole );
+    RUN_TEST( test_fixed_sizes );
+    RUN_TEST( test_random_sizes );
+    RUN_TEST( test_truncated );
+    RUN_TEST( test_bad_magic );
+    RUN_TEST( test_other_source );
+    RUN_TEST( test_copy_outside_source );
+    RUN_TEST( test_write_fails );
+    return( UNITY_END() );
+}
@@ -0,0 +1,138 @@
+/****************************************************************************
+ *   Copyright  2020  Jesper Ortlund
+ ****************************************************************************/
+/*
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+#include <string.h>
+#include <unity.h>
+
+#include "hardware/framequeue.h"
+
+#define QUEUE_LEN   4
+
+static framequeue_frame_t slots[ QUEUE_LEN ];
+static framequeue_t queue;
+
+void setUp( void ) {
+}
+
+void tearDown( void ) {
+}
+
+/**
+ * @brief push a 20 byte frame filled with its sequence number, like a wheel notification
+ */
+static bool push( uint8_t seq ) {
+    uint8_t frame[ FRAMEQUEUE_FRAME_SIZE ];
+
+    memset( frame, seq, sizeof( frame ) );
+    return( framequeue_push( &queue, frame, sizeof( frame ) ) );
+}
+
+static void expect_pop( uint8_t seq ) {
+    framequeue_frame_t frame;
+
+    TEST_ASSERT_TRUE( framequeue_pop( &queue, &frame ) );
+    TEST_ASSERT_EQUAL( FRAMEQUEUE_FRAME_SIZE, frame.len );
+    TEST_ASSERT_EQUAL( seq, frame.data[ 0 ] );
+    TEST_ASSERT_EQUAL( seq, frame.data[ FRAMEQUEUE_FRAME_SIZE - 1 ] );
+}
+
+static void expect_empty( void ) {
+    framequeue_frame_t frame;
+
+    TEST_ASSERT_FALSE( framequeue_pop( &queue, &frame ) );
+}
+
+static void test_fifo_order( void ) {
+    framequeue_init( &queue, slots, QUEUE_LEN, true );
+    expect_empty();
+    /*
+     * interleaved push and pop walks head around the slot array a few times
+     */
+    for ( int seq = 0 ; seq < 3 * QUEUE_LEN ; seq += 2 ) {
+        TEST_ASSERT_TRUE( push( seq ) );
+        TEST_ASSERT_TRUE( push( seq + 1 ) );
+        expect_pop( seq );
+        expect_pop( seq + 1 );
+    }
+    expect_empty();
+    TEST_ASSERT_EQUAL( 0, queue.dropped );
+}
+
+static void test_drop_oldest( void ) {
+    framequeue_init( &queue, slots, QUEUE_LEN, true );
+    /*
+     * telemetry, a stalled phone gets the latest frames
+     */
+    for ( int seq = 0 ; seq < QUEUE_LEN + 3 ; seq++ )
+        TEST_ASSERT_TRUE( push( seq ) );
+    TEST_ASSERT_EQUAL( 3, queue.dropped );
+    TEST_ASSERT_EQUAL( QUEUE_LEN, queue.count );
+    for ( int seq = 3 ; seq < QUEUE_LEN + 3 ; seq++ )
+        expect_pop( seq );
+    expect_empty();
+}
+
+static void test_drop_new( void ) {
+    framequeue_init( &queue, slots, QUEUE_LEN, false );
+    /*
+     * commands, a full queue refuses new ones and keeps the queued in order
+     */
+    for ( int seq = 0 ; seq < QUEUE_LEN ; seq++ )
+        TEST_ASSERT_TRUE( push( seq ) );
+    TEST_ASSERT_FALSE( push( 100 ) );
+    TEST_ASSERT_FALSE( push( 101 ) );
+    TEST_ASSERT_EQUAL( 2, queue.dropped );
+    expect_pop( 0 );
+    TEST_ASSERT_TRUE( push( QUEUE_LEN ) );
+    for ( int seq = 1 ; seq <= QUEUE_LEN ; seq++ )
+        expect_pop( seq );
+    expect_empty();
+}
+
+static void test_frame_len( void ) {
+    uint8_t frame[ FRAMEQUEUE_FRAME_SIZE + 1 ] = { 0xaa, 0x55, 0x01 };
+    framequeue_frame_t out;
+
+    framequeue_init( &queue, slots, QUEUE_LEN, false );
+    TEST_ASSERT_FALSE( framequeue_push( &queue, frame, sizeof( frame ) ) );
+    TEST_ASSERT_EQUAL( 0, queue.dropped );
+    TEST_ASSERT_TRUE( framequeue_push( &queue, frame, 3 ) );
+    TEST_ASSERT_TRUE( framequeue_pop( &queue, &out ) );
+    TEST_ASSERT_EQUAL( 3, out.len );
+    TEST_ASSERT_EQUAL_HEX8_ARRAY( frame, out.data, 3 );
+}
+
+static void test_clear( void ) {
+    framequeue_init( &queue, slots, QUEUE_LEN, true );
+    push( 1 );
+    push( 2 );
+    framequeue_clear( &queue );
+    expect_empty();
+    TEST_ASSERT_TRUE( push( 3 ) );
+    expect_pop( 3 );
+}
+
+int main( void ) {
+    UNITY_BEGIN();
+    RUN_TEST( test_fifo_order );
+    RUN_TEST( test_drop_oldest );
+    RUN_TEST( test_drop_new );
+    RUN_TEST( test_frame_len );
+    RUN_TEST( test_clear );
+    return( UNITY_END() );
+}
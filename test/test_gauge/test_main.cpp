@@ -0,0 +1,140 @@
+/****************************************************************************
+ *   Copyright  2020  Jesper Ortlund
+ ****************************************************************************/
+/*
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+#include <unity.h>
+
+#include "gui/gauge.h"
+
+static gauge_geometry_t gauge;
+
+void setUp( void ) {
+}
+
+void tearDown( void ) {
+}
+
+static void test_forward_arc( void ) {
+    gauge_init( &gauge, 90, 270, 0, 100, false );
+
+    TEST_ASSERT_EQUAL( 180, gauge.span );
+    TEST_ASSERT_EQUAL( 90, gauge_value2angle( &gauge, GAUGE_VALUE( 0 ) ) );
+    TEST_ASSERT_EQUAL( 180, gauge_value2angle( &gauge, GAUGE_VALUE( 50 ) ) );
+    TEST_ASSERT_EQUAL( 270, gauge_value2angle( &gauge, GAUGE_VALUE( 100 ) ) );
+}
+
+static void test_wraparound_arc( void ) {
+    /*
+     * speed arc style, 135 over 0 to 45
+     */
+    gauge_init( &gauge, 135, 45, 0, 60, false );
+
+    TEST_ASSERT_EQUAL( 270, gauge.span );
+    TEST_ASSERT_EQUAL( 135, gauge_value2angle( &gauge, GAUGE_VALUE( 0 ) ) );
+    TEST_ASSERT_EQUAL( 270, gauge_value2angle( &gauge, GAUGE_VALUE( 30 ) ) );
+    TEST_ASSERT_EQUAL( 0, gauge_value2angle( &gauge, GAUGE_VALUE( 50 ) ) );
+    TEST_ASSERT_EQUAL( 45, gauge_value2angle( &gauge, GAUGE_VALUE( 60 ) ) );
+}
+
+static void test_reversed_arc( void ) {
+    gauge_init( &gauge, 135, 45, 0, 60, true );
+
+    TEST_ASSERT_EQUAL( 45, gauge_value2angle( &gauge, GAUGE_VALUE( 0 ) ) );
+    TEST_ASSERT_EQUAL( 0, gauge_value2angle( &gauge, GAUGE_VALUE( 10 ) ) );
+    TEST_ASSERT_EQUAL( 270, gauge_value2angle( &gauge, GAUGE_VALUE( 30 ) ) );
+    TEST_ASSERT_EQUAL( 135, gauge_value2angle( &gauge, GAUGE_VALUE( 60 ) ) );
+}
+
+static void test_negative_start( void ) {
+    gauge_init( &gauge, -30, 30, 0, 60, false );
+
+    TEST_ASSERT_EQUAL( 330, gauge.start );
+    TEST_ASSERT_EQUAL( 60, gauge.span );
+    TEST_ASSERT_EQUAL( 330, gauge_value2angle( &gauge, GAUGE_VALUE( 0 ) ) );
+    TEST_ASSERT_EQUAL( 0, gauge_value2angle( &gauge, GAUGE_VALUE( 30 ) ) );
+    TEST_ASSERT_EQUAL( 30, gauge_value2angle( &gauge, GAUGE_VALUE( 60 ) ) );
+}
+
+static void test_clamp( void ) {
+    gauge_init( &gauge, 135, 45, 0, 60, false );
+
+    TEST_ASSERT_EQUAL( 135, gauge_value2angle( &gauge, GAUGE_VALUE( -20 ) ) );
+    TEST_ASSERT_EQUAL( 45, gauge_value2angle( &gauge, GAUGE_VALUE( 500 ) ) );
+
+    gauge_init( &gauge, 135, 45, 0, 60, true );
+    TEST_ASSERT_EQUAL( 45, gauge_value2angle( &gauge, GAUGE_VALUE( -20 ) ) );
+    TEST_ASSERT_EQUAL( 135, gauge_value2angle( &gauge, GAUGE_VALUE( 500 ) ) );
+}
+
+static void test_fixed_point_error( void ) {
+    /*
+     * every 1/16 step against the float mapping the tiles used before
+     */
+    for ( int max = 20 ; max <= 120 ; max += 7 ) {
+        gauge_init( &gauge, 135, 45, 0, max, false );
+        for ( int32_t value = 0 ; value <= max * GAUGE_VALUE_FRAC ; value++ ) {
+            float angle = 135 + 270.0f * value / ( max * GAUGE_VALUE_FRAC );
+            int32_t expected = (int32_t)angle % 360;
+            int32_t error = gauge_value2angle( &gauge, value ) - expected;
+            if ( error < -180 )
+                error += 360;
+            TEST_ASSERT_INT_WITHIN( 1, 0, error );
+        }
+    }
+}
+
+static void test_marker_wraps( void ) {
+    uint16_t start, end;
+
+    gauge_init( &gauge, 300, 60, 0, 120, false );
+
+    gauge_marker_angles( &gauge, GAUGE_VALUE( 58 ), &start, &end );
+    TEST_ASSERT_EQUAL( 358, start );
+    TEST_ASSERT_EQUAL( 358 + GAUGE_MARKER_WIDTH - 360, end );
+
+    gauge_marker_angles( &gauge, GAUGE_VALUE( 0 ), &start, &end );
+    TEST_ASSERT_EQUAL( 300, start );
+    TEST_ASSERT_EQUAL( 300 + GAUGE_MARKER_WIDTH, end );
+}
+
+static void test_set_range( void ) {
+    gauge_init( &gauge, 90, 270, 0, 100, false );
+
+    gauge_set_range( &gauge, 0, 50 );
+    TEST_ASSERT_EQUAL( 270, gauge_value2angle( &gauge, GAUGE_VALUE( 50 ) ) );
+    TEST_ASSERT_EQUAL( 180, gauge_value2angle( &gauge, GAUGE_VALUE( 25 ) ) );
+
+    /*
+     * an empty range pins everything to the arc start
+     */
+    gauge_set_range( &gauge, 10, 10 );
+    TEST_ASSERT_EQUAL( 0, gauge.scale );
+    TEST_ASSERT_EQUAL( 90, gauge_value2angle( &gauge, GAUGE_VALUE( 10 ) ) );
+}
+
+int main( void ) {
+    UNITY_BEGIN();
+    RUN_TEST( test_forward_arc );
+    RUN_TEST( test_wraparound_arc );
+    RUN_TEST( test_reversed_arc );
+    RUN_TEST( test_negative_start );
+    RUN_TEST( test_clamp );
+    RUN_TEST( test_fixed_point_error );
+    RUN_TEST( test_marker_wraps );
+    RUN_TEST( test_set_range );
+    return( UNITY_END() );
+}
@@ -0,0 +1,144 @@
+/****************************************************************************
+ *   Copyright  2020  Jesper Ortlund
+ ****************************************************************************/
+/*
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+#include <unity.h>
+
+#include "gui/gaugeanim.h"
+
+#define T0      1000000
+
+void setUp( void ) {
+}
+
+void tearDown( void ) {
+}
+
+static void test_first_sample( void ) {
+    gaugeanim_t anim;
+
+    gaugeanim_init( &anim, 0, 100, 1000 );
+    TEST_ASSERT_FLOAT_WITHIN( 0.01f, 0, gaugeanim_get_value( &anim, T0 ) );
+    /*
+     * one sample gives no slope, it is held
+     */
+    gaugeanim_add_sample( &anim, 10, T0 );
+    TEST_ASSERT_FLOAT_WITHIN( 0.01f, 10, gaugeanim_get_target( &anim, T0 + 100000 ) );
+}
+
+static void test_horizon( void ) {
+    gaugeanim_t anim;
+
+    /*
+     * 100 units per second, 0.1 per ms
+     */
+    gaugeanim_init( &anim, 0, 100, 1000 );
+    gaugeanim_add_sample( &anim, 10, T0 );
+    gaugeanim_add_sample( &anim, 20, T0 + 100000 );
+    /*
+     * the current wheel data is handed in every frame, the same sample time again changes nothing
+     */
+    gaugeanim_add_sample( &anim, 20, T0 + 100000 );
+    TEST_ASSERT_FLOAT_WITHIN( 0.01f, 25, gaugeanim_get_target( &anim, T0 + 150000 ) );
+    TEST_ASSERT_FLOAT_WITHIN( 0.01f, 20 + 0.1f * GAUGEANIM_HORIZON_US / 1000, gaugeanim_get_target( &anim, T0 + 100000 + GAUGEANIM_HORIZON_US ) );
+    TEST_ASSERT_FLOAT_WITHIN( 0.01f, 20 + 0.1f * GAUGEANIM_HORIZON_US / 1000, gaugeanim_get_target( &anim, T0 + 100000 + GAUGEANIM_HORIZON_US + 400000 ) );
+}
+
+static void test_max_rate( void ) {
+    gaugeanim_t anim;
+
+    /*
+     * 200 units per second sampled, 50 is plausible
+     */
+    gaugeanim_init( &anim, 0, 100, 50 );
+    gaugeanim_add_sample( &anim, 10, T0 );
+    gaugeanim_add_sample( &anim, 30, T0 + 100000 );
+    TEST_ASSERT_FLOAT_WITHIN( 0.01f, 35, gaugeanim_get_target( &anim, T0 + 200000 ) );
+    /*
+     * and the same going down
+     */
+    gaugeanim_add_sample( &anim, 10, T0 + 200000 );
+    TEST_ASSERT_FLOAT_WITHIN( 0.01f, 5, gaugeanim_get_target( &anim, T0 + 300000 ) );
+}
+
+static void test_stale( void ) {
+    gaugeanim_t anim;
+
+    gaugeanim_init( &anim, 0, 100, 1000 );
+    gaugeanim_add_sample( &anim, 10, T0 );
+    gaugeanim_add_sample( &anim, 20, T0 + 100000 );
+    /*
+     * the wheel went quiet, hold the newest sample
+     */
+    TEST_ASSERT_FLOAT_WITHIN( 0.01f, 20, gaugeanim_get_target( &anim, T0 + 100000 + GAUGEANIM_STALE_US + 1 ) );
+    /*
+     * samples further apart than GAUGEANIM_STALE_US give no slope
+     */
+    gaugeanim_add_sample( &anim, 40, T0 + 100000 + GAUGEANIM_STALE_US + 1 );
+    TEST_ASSERT_FLOAT_WITHIN( 0.01f, 40, gaugeanim_get_target( &anim, T0 + 100000 + GAUGEANIM_STALE_US + 100000 ) );
+}
+
+static void test_smoothing_and_pause( void ) {
+    gaugeanim_t anim;
+
+    gaugeanim_init( &anim, 0, 100, 1000 );
+    gaugeanim_add_sample( &anim, 10, T0 );
+    TEST_ASSERT_FLOAT_WITHIN( 0.01f, 10, gaugeanim_get_value( &anim, T0 ) );
+    /*
+     * a jump is followed over GAUGEANIM_TAU_US, not shown at once
+     */
+    gaugeanim_add_sample( &anim, 50, T0 + 100000 );
+    float target = gaugeanim_get_target( &anim, T0 + 100000 + GAUGEANIM_FRAME_MS * 1000 );
+    float shown = gaugeanim_get_value( &anim, T0 + 100000 + GAUGEANIM_FRAME_MS * 1000 );
+    TEST_ASSERT_GREATER_THAN( 10, shown );
+    TEST_ASSERT_LESS_THAN( target, shown );
+    /*
+     * after a pause, e.g. the tile was hidden, the value starts at the target again
+     */
+    int64_t later = T0 + 100000 + GAUGEANIM_FRAME_MS * 1000 + GAUGEANIM_STALE_US + 1;
+    TEST_ASSERT_FLOAT_WITHIN( 0.01f, gaugeanim_get_target( &anim, later ), gaugeanim_get_value( &anim, later ) );
+    TEST_ASSERT_FLOAT_WITHIN( 0.01f, 50, gaugeanim_get_value( &anim, later ) );
+}
+
+static void test_clamp( void ) {
+    gaugeanim_t anim;
+
+    gaugeanim_init( &anim, 0, 100, 1000 );
+    gaugeanim_add_sample( &anim, 150, T0 );
+    TEST_ASSERT_FLOAT_WITHIN( 0.01f, 100, gaugeanim_get_value( &anim, T0 ) );
+    gaugeanim_add_sample( &anim, -5, T0 + 100000 );
+    TEST_ASSERT_FLOAT_WITHIN( 0.01f, 0, gaugeanim_get_target( &anim, T0 + 100000 ) );
+    /*
+     * extrapolation doesn't run past the ends either
+     */
+    gaugeanim_add_sample( &anim, 90, T0 + 200000 );
+    gaugeanim_add_sample( &anim, 99, T0 + 210000 );
+    TEST_ASSERT_FLOAT_WITHIN( 0.01f, 100, gaugeanim_get_target( &anim, T0 + 310000 ) );
+    gaugeanim_add_sample( &anim, 1, T0 + 220000 );
+    TEST_ASSERT_FLOAT_WITHIN( 0.01f, 0, gaugeanim_get_target( &anim, T0 + 320000 ) );
+}
+
+int main( void ) {
+    UNITY_BEGIN();
+    RUN_TEST( test_first_sample );
+    RUN_TEST( test_horizon );
+    RUN_TEST( test_max_rate );
+    RUN_TEST( test_stale );
+    RUN_TEST( test_smoothing_and_pause );
+    RUN_TEST( test_clamp );
+    return( UNITY_END() );
+}
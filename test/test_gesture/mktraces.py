@@ -0,0 +1,120 @@
+#!/usr/bin/env python3
+"""Write traces.h, accelerometer traces for the gesture classifier test.
+
+The traces are synthesized, not recorded. Each one is built from the poses
+and motions seen on a wrist while riding: resting on the handlebar with the
+face pointing sideways, ride vibration, road bumps, a wrist raise and a
+deliberate shake. Values are in mg at the 25 Hz fifo rate bma.cpp sets up.
+A fixed seed keeps the output stable, rerun after changing a scene:
+
+    python3 test/test_gesture/mktraces.py > test/test_gesture/traces.h
+
+A trace dumped from a watch can replace any scene, the arrays only need
+x, y, z in mg per sample.
+"""
+
+import math
+import random
+
+RATE = 25
+
+BAR = (0, -950, 200)        # arm on the handlebar, face points sideways
+FACE_UP = (50, -100, 990)   # rider looks at the watch
+
+
+class Trace:
+    def __init__(self, seed):
+        self.rnd = random.Random(seed)
+        self.samples = []
+        self.pose = BAR
+
+    def ride(self, seconds, noise=60, pose=None):
+        pose = pose or self.pose
+        for _ in range(int(seconds * RATE)):
+            self.add(pose, noise)
+        self.pose = pose
+
+    def turn(self, seconds, pose, noise=60):
+        start = self.pose
+        num = int(seconds * RATE)
+        for n in range(1, num + 1):
+            t = n / num
+            p = [a + (b - a) * t for a, b in zip(start, pose)]
+            # the turn itself adds some fast motion
+            swing = 250 * math.sin(math.pi * t)
+            self.add((p[0] + swing, p[1], p[2]), noise)
+        self.pose = pose
+
+    def bump(self, height, rebound, noise=60):
+        x, y, z = self.pose
+        self.add((x, y, z + height), noise)
+        self.add((x, y, z - rebound), noise)
+
+    def shake(self, seconds, amplitude, freq, noise=60):
+        x, y, z = self.pose
+        for n in range(int(seconds * RATE)):
+            a = amplitude * math.sin(2 * math.pi * freq * n / RATE)
+            self.add((x + a, y, z), noise)
+
+    def add(self, pose, noise):
+        self.samples.append(tuple(
+            max(-4000, min(4000, int(round(v + self.rnd.gauss(0, noise))))) for v in pose))
+
+
+def scenes():
+    t = Trace(1)
+    t.ride(2.0)
+    t.turn(0.4, FACE_UP)
+    t.ride(1.5, noise=25)
+    yield "raise", t, "face sideways on the bar, quick turn up, hold"
+
+    t = Trace(2)
+    t.ride(1.0)
+    t.turn(4.0, FACE_UP)
+    t.ride(1.5, noise=25)
+    yield "slow_turn", t, "same turn as raise, too slow to be a look at the watch"
+
+    t = Trace(3)
+    t.ride(5.0, noise=120, pose=FACE_UP)
+    yield "face_up_ride", t, "face up the whole time, never turned"
+
+    t = Trace(4)
+    t.ride(1.0, noise=25, pose=FACE_UP)
+    t.shake(1.0, 2500, 3)
+    t.ride(2.0, noise=25)
+    yield "shake", t, "one second of hard back and forth shaking"
+
+    t = Trace(5)
+    for _ in range(7):
+        t.ride(0.6)
+        t.bump(1800, 600)
+    t.ride(0.6)
+    yield "bumps", t, "road bumps, one hard hit and a rebound each"
+
+    t = Trace(6)
+    t.ride(1.0, noise=25, pose=FACE_UP)
+    t.shake(1.0, 2500, 3)
+    t.ride(0.2, noise=25)
+    t.shake(0.6, 2500, 3)
+    t.ride(2.0, noise=25)
+    yield "double_shake", t, "two shakes, the second one inside the holdoff"
+
+
+def main():
+    print("/*")
+    print(" * generated by mktraces.py, accelerometer traces in mg at %d Hz" % RATE)
+    print(" */")
+    print("#define TRACE_RATE  %d" % RATE)
+    print()
+    for name, trace, text in scenes():
+        print("/* %s */" % text)
+        print("static const gesture_sample_t trace_%s[] = {" % name)
+        for n in range(0, len(trace.samples), 6):
+            row = trace.samples[n:n + 6]
+            print("    " + " ".join("{ %5d, %5d, %5d }," % s for s in row))
+        print("};")
+        print()
+
+
+if __name__ == "__main__":
+    main()
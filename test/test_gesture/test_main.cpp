@@ -0,0 +1,146 @@
+/****************************************************************************
+ *   Copyright  2020  Jesper Ortlund
+ ****************************************************************************/
+/*
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+#include <unity.h>
+
+#include "hardware/gesture.h"
+#include "traces.h"
+
+#define TRACE( name )   name, (int)( sizeof( name ) / sizeof( gesture_sample_t ) )
+
+/**
+ * @brief what a trace gave when fed in batches
+ */
+typedef struct {
+    int raises;                                 /** @brief batches that reported a wrist raise */
+    int shakes;                                 /** @brief batches that reported a shake */
+    int first_raise;                            /** @brief sample index behind the batch of the first raise, -1 if none */
+    int first_shake;                            /** @brief sample index behind the batch of the first shake, -1 if none */
+} trace_result_t;
+
+void setUp( void ) {
+}
+
+void tearDown( void ) {
+}
+
+static trace_result_t run_trace( const gesture_sample_t *trace, int num, int batch ) {
+    trace_result_t result = { 0, 0, -1, -1 };
+    gesture_t gesture;
+
+    gesture_init( &gesture, TRACE_RATE );
+    for ( int pos = 0 ; pos < num ; pos += batch ) {
+        int len = ( num - pos < batch ) ? num - pos : batch;
+        uint32_t detected = gesture_feed( &gesture, &trace[ pos ], len );
+
+        if ( detected & GESTURE_WRIST_RAISE ) {
+            if ( result.first_raise < 0 )
+                result.first_raise = pos + len;
+            result.raises++;
+        }
+        if ( detected & GESTURE_SHAKE ) {
+            if ( result.first_shake < 0 )
+                result.first_shake = pos + len;
+            result.shakes++;
+        }
+    }
+    return( result );
+}
+
+/*
+ * one sample at a time, a bit less than a 250ms fifo batch and a full fifo chunk
+ * all have to give the same gestures
+ */
+static const int batches[] = { 1, 6, 20 };
+
+static void expect_trace( const gesture_sample_t *trace, int num, int raises, int shakes ) {
+    for ( unsigned int i = 0 ; i < sizeof( batches ) / sizeof( int ) ; i++ ) {
+        trace_result_t result = run_trace( trace, num, batches[ i ] );
+        TEST_ASSERT_EQUAL( raises, result.raises );
+        TEST_ASSERT_EQUAL( shakes, result.shakes );
+    }
+}
+
+static void test_raise( void ) {
+    trace_result_t result = run_trace( TRACE( trace_raise ), 1 );
+
+    expect_trace( TRACE( trace_raise ), 1, 0 );
+    /*
+     * the turn ends at 2.4s, the raise comes after the hold time and well within a second
+     */
+    TEST_ASSERT_GREATER_OR_EQUAL( 60 + GESTURE_RAISE_HOLD * TRACE_RATE / 1000, result.first_raise );
+    TEST_ASSERT_LESS_THAN( 60 + TRACE_RATE, result.first_raise );
+}
+
+static void test_slow_turn( void ) {
+    expect_trace( TRACE( trace_slow_turn ), 0, 0 );
+}
+
+static void test_face_up_ride( void ) {
+    expect_trace( TRACE( trace_face_up_ride ), 0, 0 );
+}
+
+static void test_shake( void ) {
+    trace_result_t result = run_trace( TRACE( trace_shake ), 1 );
+
+    expect_trace( TRACE( trace_shake ), 0, 1 );
+    /*
+     * shaking runs from 1s to 2s
+     */
+    TEST_ASSERT_GREATER_THAN( TRACE_RATE, result.first_shake );
+    TEST_ASSERT_LESS_OR_EQUAL( 2 * TRACE_RATE, result.first_shake );
+}
+
+static void test_bumps( void ) {
+    expect_trace( TRACE( trace_bumps ), 0, 0 );
+}
+
+static void test_shake_holdoff( void ) {
+    expect_trace( TRACE( trace_double_shake ), 0, 1 );
+}
+
+static void test_reset_forgets_peaks( void ) {
+    gesture_t gesture;
+    int half = 36;
+
+    /*
+     * the shake completes right behind half when fed without a break ...
+     */
+    gesture_init( &gesture, TRACE_RATE );
+    TEST_ASSERT_EQUAL( 0, gesture_feed( &gesture, trace_shake, half ) );
+    TEST_ASSERT_EQUAL( GESTURE_SHAKE, gesture_feed( &gesture, &trace_shake[ half ], 8 ) );
+    /*
+     * ... but a gap in the fifo in the middle of it starts the count again
+     */
+    gesture_init( &gesture, TRACE_RATE );
+    TEST_ASSERT_EQUAL( 0, gesture_feed( &gesture, trace_shake, half ) );
+    gesture_reset( &gesture );
+    TEST_ASSERT_EQUAL( 0, gesture_feed( &gesture, &trace_shake[ half ], 8 ) );
+}
+
+int main( void ) {
+    UNITY_BEGIN();
+    RUN_TEST( test_raise );
+    RUN_TEST( test_slow_turn );
+    RUN_TEST( test_face_up_ride );
+    RUN_TEST( test_shake );
+    RUN_TEST( test_bumps );
+    RUN_TEST( test_shake_holdoff );
+    RUN_TEST( test_reset_forgets_peaks );
+    return( UNITY_END() );
+}
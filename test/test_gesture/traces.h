@@ -0,0 +1,154 @@
+/*
+ * generated by mktraces.py, accelerometer traces in mg at 25 Hz
+ */
+#define TRACE_RATE  25
+
+/* face sideways on the bar, quick turn up, hold */
+static const gesture_sample_t trace_raise[] = {
+    {    77,  -863,   204 }, {   -46, -1016,   202 }, {   -61, -1036,   212 }, {     8,  -917,   145 }, {     0,  -954,   110 }, {    32,  -931,   343 },
+    {    12,  -959,   274 }, {    12,  -895,   178 }, {    13,  -889,   242 }, {     8, -1015,   227 }, {     5,  -907,   213 }, {    65,  -953,   212 },
+    {    40, -1015,   176 }, {   -30,  -831,   194 }, {    39,  -913,   183 }, {   -93,  -892,   176 }, {    43, -1028,   174 }, {    75,  -864,   122 },
+    {   -80,  -953,   244 }, {    10,  -932,   141 }, {    35,  -883,   174 }, {   -86,  -996,   246 }, {  -104,  -956,   141 }, {    -8,  -965,   201 },
+    {    90,  -925,   280 }, {    -8,  -979,   223 }, {  -170,  -952,   210 }, {   -74,  -922,   166 }, {  -148,  -963,   141 }, {   -31,  -959,   275 },
+    {     6,  -952,   223 }, {  -109,  -876,   135 }, {    26, -1018,   141 }, {   -24,  -836,   242 }, {   -36,  -967,   131 }, {    -2,  -984,   243 },
+    {   -81,  -970,   149 }, {   -43,  -907,   208 }, {    35,  -879,   269 }, {   -82,  -918,    94 }, {    -4,  -835,   188 }, {   -22,  -940,   201 },
+    {     2,  -995,   265 }, {    53,  -963,   219 }, {    40,  -888,   224 }, {    42,  -966,   136 }, {   -30,  -889,   259 }, {     9,  -984,   218 },
+    {   100,  -869,   159 }, {    -3, -1037,   132 }, {    94,  -864,   337 }, {   233,  -730,   437 }, {   184,  -763,   467 }, {   418,  -589,   447 },
+    {   290,  -439,   533 }, {   316,  -477,   750 }, {   284,  -337,   873 }, {   162,  -311,   943 }, {    70,   -53,   909 }, {   -12,  -100,   998 },
+    {    55,  -105,  1017 }, {    -8,  -114,   983 }, {    95,  -150,   982 }, {    21,  -117,  1006 }, {    60,   -64,   975 }, {    57,   -71,  1013 },
+    {    42,   -72,   967 }, {    95,   -96,   987 }, {    57,   -79,  1034 }, {    46,  -109,  1005 }, {    28,  -142,  1011 }, {    41,   -72,   964 },
+    {   -22,   -93,   994 }, {    90,   -87,   998 }, {    65,  -109,   992 }, {    16,   -87,   970 }, {    39,   -83,  1013 }, {    25,   -50,   975 },
+    {    71,   -76,   996 }, {    54,   -55,  1012 }, {    61,  -146,   971 }, {    79,   -95,   966 }, {    34,  -108,  1007 }, {    60,   -75,   970 },
+    {    75,  -113,   983 }, {    93,   -98,   987 }, {    45,  -110,  1029 }, {    84,   -82,   995 }, {    76,  -102,  1001 }, {    60,   -98,  1031 },
+    {    94,   -67,   942 }, {    96,   -82,   979 }, {    49,   -72,  1019 }, {    71,   -96,   991 }, {    71,  -102,   968 }, {    34,  -103,   998 },
+    {   107,  -134,  1002 },
+};
+
+/* same turn as raise, too slow to be a look at the watch */
+static const gesture_sample_t trace_slow_turn[] = {
+    {   140,  -990,   224 }, {     9,  -900,   116 }, {   -25,  -995,   136 }, {   -51,  -981,   183 }, {   -54,  -925,   167 }, {  -192,  -879,   176 },
+    {   -45,  -934,   214 }, {     3, -1001,   211 }, {   -92,  -863,   124 }, {   -12,  -949,   213 }, {   -15,  -921,   -18 }, {   -14,  -967,   166 },
+    {    84, -1016,   187 }, {  -130,  -941,    94 }, {  -102,  -816,   235 }, {    -8,  -948,   105 }, {   -72,  -932,    64 }, {     9, -1063,   199 },
+    {   -75,  -851,   254 }, {   -39, -1073,   144 }, {   -11, -1018,   209 }, {    52,  -961,   166 }, {    40,  -976,   244 }, {   -27,  -859,   175 },
+    {   -72,  -952,   154 }, {   -57,  -957,   246 }, {  -123,  -943,   199 }, {     8,  -883,   136 }, {    66,  -937,   231 }, {    21,  -935,   200 },
+    {    68,  -778,   305 }, {   103,  -863,   220 }, {    97,  -762,   179 }, {   119,  -818,   282 }, {   125,  -786,   408 }, {   164,  -761,   302 },
+    {   144,  -842,   308 }, {    73,  -802,   387 }, {   100,  -819,   345 }, {   119,  -769,   331 }, {    54,  -879,   368 }, {   171,  -741,   347 },
+    {   153,  -895,   424 }, {    92,  -728,   279 }, {   115,  -773,   330 }, {   119,  -719,   405 }, {   192,  -785,   322 }, {   146,  -788,   379 },
+    {   228,  -758,   340 }, {   151,  -661,   406 }, {   208,  -713,   440 }, {   208,  -650,   462 }, {    35,  -721,   598 }, {   134,  -696,   494 },
+    {   217,  -615,   360 }, {   147,  -698,   400 }, {   162,  -644,   469 }, {   232,  -694,   477 }, {   229,  -705,   499 }, {   263,  -648,   518 },
+    {   178,  -653,   453 }, {   328,  -605,   619 }, {   346,  -649,   435 }, {   284,  -635,   499 }, {   194,  -574,   527 }, {   285,  -583,   470 },
+    {   129,  -609,   494 }, {   234,  -527,   534 }, {   358,  -565,   589 }, {   300,  -519,   480 }, {   336,  -553,   505 }, {   309,  -530,   649 },
+    {   317,  -520,   481 }, {   375,  -444,   634 }, {   303,  -452,   543 }, {   317,  -515,   543 }, {   298,  -487,   713 }, {   332,  -596,   501 },
+    {   270,  -504,   570 }, {   187,  -494,   565 }, {   232,  -422,   657 }, {   227,  -533,   639 }, {   375,  -487,   762 }, {   222,  -461,   708 },
+    {   221,  -437,   593 }, {   305,  -362,   643 }, {   275,  -448,   560 }, {   426,  -377,   747 }, {   281,  -396,   848 }, {   146,  -416,   688 },
+    {   240,  -347,   678 }, {   169,  -448,   757 }, {   302,  -324,   833 }, {   210,  -304,   786 }, {   227,  -400,   806 }, {   192,  -364,   702 },
+    {   333,  -341,   739 }, {   209,  -343,   782 }, {   117,  -391,   815 }, {   279,  -373,   799 }, {   174,  -441,   782 }, {   139,  -243,   796 },
+    {   196,  -375,   825 }, {    76,  -265,   907 }, {   114,  -219,   916 }, {   169,  -195,   845 }, {   145,  -374,   783 }, {    79,  -102,   871 },
+    {   152,  -317,   967 }, {    86,  -138,   937 }, {   154,  -259,   877 }, {    63,  -172,   988 }, {   190,  -139,   853 }, {   148,  -255,   876 },
+    {   166,   -35,   915 }, {   117,  -290,   929 }, {    53,  -252,   837 }, {   109,  -184,   975 }, {    80,  -151,  1031 }, {   135,   -96,  1039 },
+    {    92,  -194,   910 }, {   -22,  -104,   942 }, {    95,   -67,   925 }, {    68,   -32,   987 }, {   106,  -112,   933 }, {    44,  -147,  1008 },
+    {    37,   -66,   959 }, {    53,   -91,   985 }, {    60,  -119,   963 }, {    15,  -114,   969 }, {    56,  -109,   973 }, {    31,  -148,   981 },
+    {    60,  -134,   984 }, {    67,  -118,   995 }, {    39,   -38,  1025 }, {    80,  -117,  1006 }, {    46,   -91,   975 }, {    54,  -119,   997 },
+    {    94,  -135,   957 }, {    63,   -80,   980 }, {    65,   -89,  1004 }, {    85,  -116,  1007 }, {    55,  -117,  1003 }, {    17,  -138,  1017 },
+    {    22,   -57,  1016 }, {    37,  -122,   933 }, {    48,  -142,  1030 }, {     7,   -98,   920 }, {    41,   -66,   979 }, {    29,  -112,   999 },
+    {    73,  -106,   938 }, {    58,   -75,  1049 }, {    54,   -96,   976 }, {    69,   -55,   964 }, {    52,  -127,   972 }, {    45,   -88,   968 },
+    {    42,   -65,  1003 }, {    68,   -90,   985 }, {    61,   -87,   990 }, {    76,  -100,  1013 }, {    50,   -81,   973 }, {    36,  -130,  1021 },
+};
+
+/* face up the whole time, never turned */
+static const gesture_sample_t trace_face_up_ride[] = {
+    {    61,    50,   878 }, {   169,  -131,   959 }, {   278,   -81,   985 }, {   138,    35,   986 }, {   121,  -217,   946 }, {    -3,  -260,   809 },
+    {  -145,  -129,   969 }, {    12,   -92,   830 }, {    40,   -71,  1080 }, {   -52,  -148,   748 }, {   -10,  -364,   820 }, {   182,  -364,  1086 },
+    {    89,  -137,  1045 }, {   113,    25,   962 }, {   -21,  -173,   872 }, {    45,  -194,  1118 }, {  -174,  -231,   876 }, {  -201,   128,   701 },
+    {    16,  -163,  1189 }, {  -188,    29,   902 }, {    31,  -181,  1067 }, {   -87,  -109,  1032 }, {   271,  -389,  1173 }, {   164,  -158,  1027 },
+    {    -6,    98,  1015 }, {    24,  -127,   966 }, {    29,  -205,  1237 }, {  -179,  -533,   975 }, {    32,   -55,   965 }, {    32,   -60,  1106 },
+    {    -4,  -145,  1223 }, {   114,  -218,  1269 }, {   143,  -171,   849 }, {    86,  -200,   863 }, {  -106,  -161,  1123 }, {    -2,  -274,  1070 },
+    {    58,     1,  1134 }, {    30,  -117,   985 }, {   -86,   -20,  1155 }, {    71,  -128,   959 }, {   -44,  -196,   942 }, {   -51,  -152,   801 },
+    {    92,   -94,   852 }, {  -226,  -101,  1122 }, {   -38,  -158,   922 }, {   128,  -210,  1108 }, {    14,    11,   994 }, {    22,  -277,   908 },
+    {    19,   -21,  1019 }, {   -34,   -51,  1108 }, {    32,  -153,   943 }, {   147,   -35,   878 }, {    95,  -158,   900 }, {   199,    -1,   903 },
+    {    60,   -40,   913 }, {    36,   -20,   775 }, {    89,   -11,  1051 }, {  -111,   -62,   886 }, {   118,   -27,  1016 }, {   -42,  -171,  1092 },
+    {   -58,   -41,  1051 }, {    17,   187,   998 }, {   308,  -342,   721 }, {   168,   -24,   953 }, {    44,  -328,   915 }, {   -74,  -127,  1096 },
+    {    56,   -55,   906 }, {    -2,   -87,   956 }, {   202,  -205,  1217 }, {   -68,    27,   897 }, {   248,   -84,  1038 }, {   139,  -176,   865 },
+    {  -193,    46,   906 }, {   -21,  -104,  1229 }, {  -157,   -70,   942 }, {   114,  -316,   942 }, {   151,    87,  1182 }, {   -53,   -93,   977 },
+    {  -115,  -273,  1081 }, {    79,  -117,  1136 }, {   -70,   -37,   991 }, {    43,   -41,  1011 }, {    82,   -68,  1223 }, {    13,    21,  1063 },
+    {     8,    -5,   887 }, {   189,  -197,   931 }, {    89,     0,  1099 }, {   157,  -125,   875 }, {   116,   -64,   876 }, {   167,   -76,   875 },
+    {   103,  -259,   885 }, {    98,  -287,   995 }, {  -112,   -12,   903 }, {    72,  -280,   949 }, {   164,   -45,   769 }, {   161,     7,   945 },
+    {   220,  -227,   980 }, {   184,    57,  1144 }, {   -81,  -314,  1037 }, {  -122,  -116,   836 }, {   177,    -4,  1057 }, {    52,   -95,   954 },
+    {    96,   -70,  1045 }, {    -1,   128,  1024 }, {   217,    60,   885 }, {  -152,    51,   943 }, {    60,  -131,  1006 }, {   -93,  -112,   934 },
+    {    48,  -380,  1088 }, {    90,  -307,   902 }, {    54,   -25,   990 }, {   216,   -97,   870 }, {   -31,   -11,   916 }, {   151,    22,  1061 },
+    {   172,  -121,   989 }, {   -21,  -173,   802 }, {   -17,  -229,   819 }, {    68,   -45,   949 }, {   214,    13,  1115 }, {   -22,  -279,  1057 },
+    {    87,   -13,  1040 }, {   201,  -135,  1070 }, {   -57,  -377,   937 }, {   230,  -301,  1112 }, {   -32,  -148,   995 },
+};
+
+/* one second of hard back and forth shaking */
+static const gesture_sample_t trace_shake[] = {
+    {    51,   -88,   978 }, {    59,   -77,  1000 }, {    89,  -122,   992 }, {    32,  -120,   985 }, {    56,   -90,  1003 }, {   106,   -78,   950 },
+    {    55,  -116,   977 }, {    83,  -106,   941 }, {    58,  -107,   961 }, {    27,  -116,   989 }, {    39,   -98,  1036 }, {    30,  -120,   984 },
+    {    77,  -118,  1026 }, {    17,  -126,   989 }, {    28,  -115,  1001 }, {    68,   -97,   983 }, {    84,   -90,   984 }, {    80,  -123,   994 },
+    {    66,  -100,   976 }, {    59,  -114,   975 }, {    24,   -67,   976 }, {    79,   -90,   983 }, {    67,   -93,   993 }, {    16,   -98,  1012 },
+    {    62,   -75,  1027 }, {    75,    18,   899 }, {  1747,  -251,  1039 }, {  2551,     1,   968 }, {  1855,   -23,   910 }, {   287,  -111,  1028 },
+    { -1450,   -89,   877 }, { -2302,  -104,   997 }, { -2026,   -90,  1002 }, {  -627,  -107,  1016 }, {  1317,  -107,   995 }, {  2448,   -66,  1002 },
+    {  2297,  -131,  1057 }, {   988,   -99,  1199 }, {  -817,   -49,   999 }, { -2273,   -32,   985 }, { -2324,   -38,  1051 }, { -1140,   -99,  1116 },
+    {   706,  -162,  1035 }, {  2170,   -98,  1031 }, {  2520,    20,  1002 }, {  1535,   -30,   956 }, {  -203,  -104,  1061 }, { -1927,   -75,   894 },
+    { -2472,   -99,  1020 }, { -1543,    10,   910 }, {    31,   -69,  1001 }, {    16,   -88,   962 }, {    29,  -131,   984 }, {   106,   -91,   987 },
+    {   113,  -112,   986 }, {    43,   -89,   982 }, {    86,  -107,  1004 }, {    56,  -121,   966 }, {    49,  -157,   990 }, {    52,   -96,   988 },
+    {    59,  -109,  1006 }, {     9,   -77,   968 }, {    62,  -112,   979 }, {    30,   -66,   963 }, {    20,   -95,   997 }, {    51,  -124,   974 },
+    {    73,  -126,  1005 }, {    68,   -97,   960 }, {    98,   -97,   995 }, {    41,  -124,   983 }, {    55,  -121,   993 }, {    79,   -89,   988 },
+    {    76,   -77,  1013 }, {    30,  -145,  1010 }, {    52,  -109,  1002 }, {    39,  -115,  1035 }, {    10,   -79,  1015 }, {    94,   -94,  1003 },
+    {    27,   -99,   938 }, {    36,  -101,   987 }, {    38,   -71,   950 }, {    53,  -110,   991 }, {    51,   -52,   963 }, {    83,   -65,   987 },
+    {    35,  -131,   969 }, {   101,  -154,  1001 }, {    33,   -53,   998 }, {    16,  -113,   995 }, {    53,  -124,   983 }, {    39,   -88,   997 },
+    {    56,  -115,  1010 }, {    36,  -121,   979 }, {    42,  -108,   942 }, {    84,   -84,  1023 }, {    40,   -81,   995 }, {    51,   -55,   975 },
+    {    64,  -143,  1004 }, {    46,  -125,   975 }, {    -3,  -126,   994 }, {   -16,   -73,  1014 },
+};
+
+/* road bumps, one hard hit and a rebound each */
+static const gesture_sample_t trace_bumps[] = {
+    {   -71, -1019,   240 }, {  -138,  -959,    65 }, {    66,  -938,   281 }, {   -30,  -926,   183 }, {   -44,  -941,   125 }, {   -21,  -908,   203 },
+    {   -25,  -819,   203 }, {   -35,  -940,   169 }, {   -23,  -971,   322 }, {     1,  -939,   240 }, {   121,  -963,   163 }, {   148, -1038,   178 },
+    {    40,  -813,   143 }, {  -146,  -910,   169 }, {   -23,  -922,   213 }, {    17,  -976,  2077 }, {    90,  -948,  -427 }, {    44,  -921,   138 },
+    {   -28,  -887,   194 }, {   -20,  -937,   198 }, {     0, -1066,   305 }, {    12, -1003,   259 }, {    19,  -949,   263 }, {   136,  -917,   295 },
+    {   129, -1011,   169 }, {    47, -1052,   184 }, {    78,  -887,   235 }, {  -114,  -809,   233 }, {    46,  -920,    97 }, {   -86, -1023,   315 },
+    {   -50,  -965,   185 }, {    34,  -920,   216 }, {   -76, -1138,  2010 }, {    16,  -876,  -406 }, {   -37,  -925,   107 }, {   -62, -1010,   217 },
+    {   125,  -904,   269 }, {    14,  -933,   173 }, {   -17, -1096,   128 }, {   -77,  -900,   240 }, {    69,  -857,   182 }, {    63,  -833,   199 },
+    {    65,  -960,   103 }, {     7,  -999,   207 }, {   -28,  -931,    72 }, {   125,  -868,   179 }, {   -55,  -950,   241 }, {    25,  -926,    82 },
+    {   -68,  -869,   214 }, {   -91, -1002,  1913 }, {   -61,  -879,  -413 }, {    68,  -939,   109 }, {   -39,  -811,   153 }, {   -64,  -875,   205 },
+    {     0,  -860,    92 }, {    26, -1014,   114 }, {   -50,  -880,   191 }, {  -112, -1018,   293 }, {    63, -1017,   349 }, {   -22, -1023,   192 },
+    {    57,  -851,   263 }, {   -26,  -984,   111 }, {    -5,  -987,   215 }, {   -78,  -982,   146 }, {   -74, -1023,   137 }, {   -73,  -915,   206 },
+    {   -81,  -919,  2018 }, {    90,  -962,  -413 }, {   -42,  -942,   230 }, {    11,  -966,   235 }, {     6,  -935,   143 }, {    13, -1011,   148 },
+    {    10,  -821,   261 }, {     0,  -961,   261 }, {    85,  -875,   189 }, {    12,  -970,   182 }, {   -52,  -965,    68 }, {   -74,  -924,   143 },
+    {    33, -1029,   177 }, {    24, -1014,   156 }, {   152,  -992,   157 }, {   -35,  -948,   198 }, {    60,  -901,   175 }, {   -22, -1037,  1908 },
+    {   -45,  -905,  -393 }, {    49,  -892,   190 }, {   129,  -982,   162 }, {   -26,  -880,   192 }, {   -45,  -923,   269 }, {    -7,  -965,   267 },
+    {    60,  -892,   153 }, {    17,  -928,    90 }, {    74,  -944,   179 }, {   139,  -941,   156 }, {    -4,  -915,   250 }, {    -4, -1003,   157 },
+    {   -50, -1014,   199 }, {   -30,  -947,   149 }, {   -53,  -961,   179 }, {    71, -1005,   213 }, {    -3, -1030,  2045 }, {    10, -1079,  -363 },
+    {    57,  -999,   304 }, {    10, -1021,   234 }, {   -22, -1032,    69 }, {    15,  -995,   239 }, {    24,  -982,   168 }, {   108,  -846,   246 },
+    {   -22, -1010,   176 }, {   102,  -922,   182 }, {   -75,  -940,   146 }, {     1,  -905,   265 }, {     9,  -971,   214 }, {   110,  -927,   114 },
+    {    95,  -935,   413 }, {   -29,  -956,   182 }, {    23,  -985,   110 }, {  -117,  -958,  1969 }, {   -35,  -821,  -351 }, {    67,  -980,   218 },
+    {   -13,  -962,   246 }, {    37,  -931,   209 }, {   -88,  -995,   223 }, {   -22,  -997,   222 }, {   -56,  -991,   254 }, {   -22,  -863,   232 },
+    {    49,  -881,    68 }, {    -5, -1029,   172 }, {    -6,  -874,   197 }, {   100,  -982,   197 }, {     6,  -892,   197 }, {   -38,  -970,   115 },
+    {    77,  -905,   226 }, {    17,  -987,   175 },
+};
+
+/* two shakes, the second one inside the holdoff */
+static const gesture_sample_t trace_double_shake[] = {
+    {    62,  -145,   971 }, {    52,   -63,   990 }, {     9,   -92,   960 }, {    81,  -106,  1035 }, {    47,  -126,   953 }, {    41,   -89,  1020 },
+    {    57,  -118,  1003 }, {    14,   -87,   971 }, {    87,   -75,   999 }, {    24,   -86,   999 }, {    36,  -116,  1022 }, {    40,   -89,  1025 },
+    {    13,   -55,  1015 }, {    34,  -124,   959 }, {    73,  -164,  1013 }, {    54,  -117,   977 }, {    41,  -106,  1012 }, {    29,   -73,  1015 },
+    {    44,   -85,   976 }, {    51,   -88,  1038 }, {    49,  -104,   991 }, {    45,  -127,  1037 }, {    34,  -115,   972 }, {    67,   -26,  1066 },
+    {    75,   -91,   989 }, {   -10,   -55,   985 }, {  1887,  -116,   929 }, {  2435,  -207,  1027 }, {  1997,  -169,   898 }, {   380,  -121,  1004 },
+    { -1420,  -147,   885 }, { -2398,   -94,  1001 }, { -2004,   -44,   960 }, {  -536,  -231,  1031 }, {  1253,   -38,  1050 }, {  2371,  -108,  1058 },
+    {  2279,   -96,   953 }, {  1006,   -82,   940 }, {  -956,  -234,  1042 }, { -2239,  -142,   958 }, { -2383,   -59,  1028 }, { -1290,  -102,   996 },
+    {   652,   -94,  1092 }, {  2180,   -27,  1052 }, {  2414,     8,  1003 }, {  1502,   -49,  1126 }, {  -311,  -141,  1012 }, { -1984,  -167,   994 },
+    { -2399,   -67,  1042 }, { -1595,  -126,   969 }, {    42,  -108,  1018 }, {    72,  -152,  1002 }, {    23,  -128,  1023 }, {    84,   -70,  1007 },
+    {    96,  -129,  1011 }, {     9,  -137,   890 }, {  1855,     9,  1044 }, {  2510,   -88,   926 }, {  1961,    -7,  1089 }, {   405,   -51,   983 },
+    { -1396,  -109,  1021 }, { -2444,   -38,   977 }, { -2047,  -107,  1085 }, {  -515,  -148,   933 }, {  1291,   -92,   977 }, {  2442,     2,   986 },
+    {  2401,  -129,   977 }, {   990,  -103,   961 }, {  -934,  -120,   966 }, { -2211,   -35,  1023 }, {    80,   -94,  1002 }, {    66,   -81,  1016 },
+    {    36,   -89,   996 }, {    82,   -78,   976 }, {    61,   -81,   992 }, {    83,   -93,   958 }, {    58,   -79,   970 }, {    68,  -169,  1042 },
+    {    15,  -112,   982 }, {    15,   -92,   967 }, {    16,  -158,  1008 }, {    80,  -107,   996 }, {    91,   -90,  1020 }, {    76,   -81,  1004 },
+    {    81,   -94,   994 }, {    33,  -152,   967 }, {    42,   -73,   982 }, {     1,   -82,  1022 }, {    59,   -92,   998 }, {    49,   -64,   970 },
+    {    32,  -136,   978 }, {    33,  -116,   996 }, {    78,  -134,   994 }, {    33,  -116,   979 }, {    60,  -140,  1029 }, {    49,  -117,   950 },
+    {    78,   -81,  1013 }, {    55,   -55,  1031 }, {   106,   -90,  1015 }, {    41,   -96,   983 }, {    52,   -97,   992 }, {    51,   -95,   981 },
+    {    33,  -111,  1008 }, {    69,   -71,  1053 }, {    25,   -78,   958 }, {    36,  -120,   992 }, {    84,   -60,  1000 }, {    76,   -88,   959 },
+    {    93,  -115,   977 }, {    49,  -124,   974 }, {    70,  -123,   974 }, {     7,  -147,   999 }, {    62,  -109,  1034 }, {    25,   -86,   972 },
+    {    50,   -87,   956 }, {    86,  -102,   992 }, {    46,   -90,   959 }, {    20,   -90,   985 }, {    41,   -91,  1030 }, {    25,  -162,   982 },
+};
+
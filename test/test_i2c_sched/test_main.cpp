@@ -0,0 +1,271 @@
+/****************************************************************************
+ *   Copyright  2020  Jesper Ortlund
+ ****************************************************************************/
+/*
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+#include <string.h>
+#include <unity.h>
+
+#include "hardware/i2c_sched.h"
+
+#define PMU_ADDR        0x35
+#define BMA_ADDR        0x18
+
+/*
+ * mock bus, a register file per device and a clock that every transfer advances
+ * by the injected latency, so the tests see what a batch costs on the wire
+ */
+static uint8_t pmu_regs[ 256 ];
+static uint8_t bma_regs[ 256 ];
+static uint32_t bus_clock_us;
+static uint32_t bus_latency_us;
+static uint32_t bus_byte_us;
+static int bus_transfers;
+static int bus_fail_at;
+
+static uint8_t *regs( uint8_t addr ) {
+    return( addr == PMU_ADDR ? pmu_regs : bma_regs );
+}
+
+static int mock_read( uint8_t addr, uint8_t reg, uint8_t *data, uint16_t len, void * ) {
+    bus_clock_us += bus_latency_us + len * bus_byte_us;
+    if ( ++bus_transfers == bus_fail_at )
+        return( 1 << 13 );
+    memcpy( data, &regs( addr )[ reg ], len );
+    return( 0 );
+}
+
+static int mock_write( uint8_t addr, uint8_t reg, const uint8_t *data, uint16_t len, void * ) {
+    bus_clock_us += bus_latency_us + len * bus_byte_us;
+    if ( ++bus_transfers == bus_fail_at )
+        return( 1 << 12 );
+    memcpy( &regs( addr )[ reg ], data, len );
+    return( 0 );
+}
+
+static const i2c_sched_bus_t bus = { mock_read, mock_write, NULL };
+static i2c_sched_t sched;
+
+/*
+ * completions record their arg and result in the order they came in
+ */
+static int done_num;
+static int done_arg[ I2C_SCHED_QUEUE_LEN * 2 ];
+static int done_result[ I2C_SCHED_QUEUE_LEN * 2 ];
+
+static void done( int result, void *arg ) {
+    done_arg[ done_num ] = (int)(intptr_t)arg;
+    done_result[ done_num ] = result;
+    done_num++;
+}
+
+static int run_all( void ) {
+    i2c_sched_txn_t batch[ I2C_SCHED_QUEUE_LEN ];
+    int transfers = 0;
+    int num;
+
+    while ( ( num = i2c_sched_take( &sched, batch, I2C_SCHED_QUEUE_LEN ) ) > 0 )
+        transfers += i2c_sched_run( batch, num, &bus );
+    return( transfers );
+}
+
+void setUp( void ) {
+    for ( int i = 0 ; i < 256 ; i++ ) {
+        pmu_regs[ i ] = i;
+        bma_regs[ i ] = 0xff - i;
+    }
+    bus_clock_us = 0;
+    bus_latency_us = 0;
+    bus_byte_us = 0;
+    bus_transfers = 0;
+    bus_fail_at = 0;
+    done_num = 0;
+    i2c_sched_init( &sched );
+}
+
+void tearDown( void ) {
+}
+
+static void test_submit_is_deferred( void ) {
+    uint8_t data[ 2 ];
+
+    bus_latency_us = 5000;
+    TEST_ASSERT_TRUE( i2c_sched_read( &sched, PMU_ADDR, 0x78, data, 2, 0, done, (void *)1 ) );
+    TEST_ASSERT_TRUE( i2c_sched_write( &sched, PMU_ADDR, 0x84, data, 1, done, (void *)2 ) );
+    /*
+     * a slow bus costs the submitter nothing, the work happens in run
+     */
+    TEST_ASSERT_EQUAL( 0, bus_transfers );
+    TEST_ASSERT_EQUAL( 0, bus_clock_us );
+    TEST_ASSERT_EQUAL( 0, done_num );
+
+    TEST_ASSERT_EQUAL( 2, run_all() );
+    TEST_ASSERT_EQUAL( 10000, bus_clock_us );
+    TEST_ASSERT_EQUAL( 2, done_num );
+    TEST_ASSERT_EQUAL( 1, done_arg[ 0 ] );
+    TEST_ASSERT_EQUAL( 2, done_arg[ 1 ] );
+}
+
+static void test_burst_merge( void ) {
+    uint8_t voltage[ 2 ], charge[ 2 ], discharge[ 2 ];
+
+    bus_latency_us = 200;
+    bus_byte_us = 25;
+    /*
+     * the AXP202 adc registers, three reads but one transfer on the wire
+     */
+    i2c_sched_read( &sched, PMU_ADDR, 0x78, voltage, 2, 0, done, (void *)1 );
+    i2c_sched_read( &sched, PMU_ADDR, 0x7a, charge, 2, 0, done, (void *)2 );
+    i2c_sched_read( &sched, PMU_ADDR, 0x7c, discharge, 2, 0, done, (void *)3 );
+
+    TEST_ASSERT_EQUAL( 1, run_all() );
+    TEST_ASSERT_EQUAL( 200 + 6 * 25, bus_clock_us );
+    TEST_ASSERT_EQUAL_HEX8( 0x78, voltage[ 0 ] );
+    TEST_ASSERT_EQUAL_HEX8( 0x79, voltage[ 1 ] );
+    TEST_ASSERT_EQUAL_HEX8( 0x7a, charge[ 0 ] );
+    TEST_ASSERT_EQUAL_HEX8( 0x7d, discharge[ 1 ] );
+    TEST_ASSERT_EQUAL( 3, done_num );
+    for ( int i = 0 ; i < 3 ; i++ ) {
+        TEST_ASSERT_EQUAL( i + 1, done_arg[ i ] );
+        TEST_ASSERT_EQUAL( 0, done_result[ i ] );
+    }
+}
+
+static void test_no_merge( void ) {
+    uint8_t data[ 5 ];
+
+    /*
+     * a gap, another device, a fifo register and a write in between all split the burst
+     */
+    i2c_sched_read( &sched, PMU_ADDR, 0x00, &data[ 0 ], 1, 0, done, (void *)1 );
+    i2c_sched_read( &sched, PMU_ADDR, 0x02, &data[ 1 ], 1, 0, done, (void *)2 );
+    i2c_sched_read( &sched, BMA_ADDR, 0x03, &data[ 2 ], 1, 0, done, (void *)3 );
+    i2c_sched_read( &sched, BMA_ADDR, 0x04, &data[ 3 ], 1, I2C_SCHED_NO_BURST, done, (void *)4 );
+    i2c_sched_write( &sched, BMA_ADDR, 0x7e, &data[ 0 ], 1, done, (void *)5 );
+    i2c_sched_read( &sched, BMA_ADDR, 0x7f, &data[ 4 ], 1, 0, done, (void *)6 );
+
+    TEST_ASSERT_EQUAL( 6, run_all() );
+    TEST_ASSERT_EQUAL_HEX8( 0x00, data[ 0 ] );
+    TEST_ASSERT_EQUAL_HEX8( 0x02, data[ 1 ] );
+    TEST_ASSERT_EQUAL_HEX8( 0xfc, data[ 2 ] );
+    TEST_ASSERT_EQUAL_HEX8( 0xfb, data[ 3 ] );
+    TEST_ASSERT_EQUAL_HEX8( 0x80, data[ 4 ] );
+    TEST_ASSERT_EQUAL( 6, done_num );
+}
+
+static void test_burst_limit( void ) {
+    uint8_t data[ I2C_SCHED_BURST_MAX + 8 ];
+
+    i2c_sched_read( &sched, PMU_ADDR, 0x10, data, I2C_SCHED_BURST_MAX - 4, 0, done, (void *)1 );
+    i2c_sched_read( &sched, PMU_ADDR, 0x10 + I2C_SCHED_BURST_MAX - 4, &data[ I2C_SCHED_BURST_MAX - 4 ], 8, 0, done, (void *)2 );
+
+    TEST_ASSERT_EQUAL( 2, run_all() );
+    for ( int i = 0 ; i < I2C_SCHED_BURST_MAX + 4 ; i++ ) {
+        TEST_ASSERT_EQUAL_HEX8( 0x10 + i, data[ i ] );
+    }
+}
+
+static void test_error( void ) {
+    uint8_t data[ 4 ];
+
+    memset( data, 0xaa, sizeof( data ) );
+    bus_fail_at = 1;
+    i2c_sched_read( &sched, PMU_ADDR, 0xb0, &data[ 0 ], 2, 0, done, (void *)1 );
+    i2c_sched_read( &sched, PMU_ADDR, 0xb2, &data[ 2 ], 2, 0, done, (void *)2 );
+    i2c_sched_read( &sched, PMU_ADDR, 0x84, data, 1, 0, done, (void *)3 );
+
+    TEST_ASSERT_EQUAL( 2, run_all() );
+    /*
+     * every read of the failed burst hears about it, the buffers are left alone
+     */
+    TEST_ASSERT_EQUAL( 3, done_num );
+    TEST_ASSERT_EQUAL( 1 << 13, done_result[ 0 ] );
+    TEST_ASSERT_EQUAL( 1 << 13, done_result[ 1 ] );
+    TEST_ASSERT_EQUAL_HEX8( 0xaa, data[ 3 ] );
+    TEST_ASSERT_EQUAL( 0, done_result[ 2 ] );
+    TEST_ASSERT_EQUAL_HEX8( 0x84, data[ 0 ] );
+}
+
+static void test_queue_full( void ) {
+    uint8_t data;
+
+    for ( int i = 0 ; i < I2C_SCHED_QUEUE_LEN ; i++ ) {
+        TEST_ASSERT_TRUE( i2c_sched_read( &sched, PMU_ADDR, 0x00, &data, 1, 0, NULL, NULL ) );
+    }
+    TEST_ASSERT_FALSE( i2c_sched_read( &sched, PMU_ADDR, 0x00, &data, 1, 0, NULL, NULL ) );
+    TEST_ASSERT_FALSE( i2c_sched_write( &sched, PMU_ADDR, 0x00, &data, 1, NULL, NULL ) );
+    TEST_ASSERT_EQUAL( 2, sched.dropped );
+
+    TEST_ASSERT_EQUAL( I2C_SCHED_QUEUE_LEN, run_all() );
+    TEST_ASSERT_TRUE( i2c_sched_read( &sched, PMU_ADDR, 0x00, &data, 1, 0, NULL, NULL ) );
+}
+
+static void test_write_copy( void ) {
+    uint8_t small[ 2 ] = { 0x12, 0x34 };
+    uint8_t large[ I2C_SCHED_INLINE + 1 ];
+
+    memset( large, 0x55, sizeof( large ) );
+    i2c_sched_write( &sched, PMU_ADDR, 0x40, small, sizeof( small ), NULL, NULL );
+    i2c_sched_write( &sched, PMU_ADDR, 0x50, large, sizeof( large ), NULL, NULL );
+    /*
+     * the caller reuses its buffers before the batch runs
+     */
+    small[ 0 ] = 0;
+    large[ 0 ] = 0x66;
+
+    TEST_ASSERT_EQUAL( 2, run_all() );
+    TEST_ASSERT_EQUAL_HEX8( 0x12, pmu_regs[ 0x40 ] );
+    TEST_ASSERT_EQUAL_HEX8( 0x34, pmu_regs[ 0x41 ] );
+    TEST_ASSERT_EQUAL_HEX8( 0x66, pmu_regs[ 0x50 ] );
+}
+
+/*
+ * the bma fifo is read in two steps, the length read submits the data read from its callback
+ */
+static uint8_t fifo_length[ 2 ];
+static uint8_t fifo_data[ 64 ];
+
+static void fifo_length_done( int result, void *arg ) {
+    done( result, arg );
+    if ( result == 0 )
+        i2c_sched_read( &sched, BMA_ADDR, 0x26, fifo_data, fifo_length[ 0 ], I2C_SCHED_NO_BURST, done, (void *)2 );
+}
+
+static void test_callback_submits( void ) {
+    bma_regs[ 0x24 ] = 12;
+    bma_regs[ 0x25 ] = 0;
+
+    i2c_sched_read( &sched, BMA_ADDR, 0x24, fifo_length, 2, 0, fifo_length_done, (void *)1 );
+    TEST_ASSERT_EQUAL( 2, run_all() );
+    TEST_ASSERT_EQUAL( 2, done_num );
+    TEST_ASSERT_EQUAL( 1, done_arg[ 0 ] );
+    TEST_ASSERT_EQUAL( 2, done_arg[ 1 ] );
+    TEST_ASSERT_EQUAL_HEX8( 0xff - 0x26, fifo_data[ 0 ] );
+    TEST_ASSERT_EQUAL_HEX8( 0xff - 0x26 - 11, fifo_data[ 11 ] );
+}
+
+int main( void ) {
+    UNITY_BEGIN();
+    RUN_TEST( test_submit_is_deferred );
+    RUN_TEST( test_burst_merge );
+    RUN_TEST( test_no_merge );
+    RUN_TEST( test_burst_limit );
+    RUN_TEST( test_error );
+    RUN_TEST( test_queue_full );
+    RUN_TEST( test_write_copy );
+    RUN_TEST( test_callback_submits );
+    return( UNITY_END() );
+}
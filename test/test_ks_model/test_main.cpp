@@ -0,0 +1,161 @@
+/****************************************************************************
+ *   Copyright  2020  Jesper Ortlund
+ ****************************************************************************/
+/*
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+#include <string.h>
+#include <unity.h>
+
+#include "hardware/ks_model.h"
+
+static const char *models[] = { "KS-14D", "KS-14M", "KS-14S", "KS-16S", "KS-16X", "KS-18A", "KS-18L", "KS-18XL", "KS-S18" };
+
+void setUp( void ) {
+}
+
+void tearDown( void ) {
+}
+
+/**
+ * @brief build a frame like the wheel sends it, aa 55, payload from offset 2, type at 16, 5a 5a tail
+ */
+static void make_frame( uint8_t *frame, uint8_t type, const char *payload, size_t len ) {
+    memset( frame, 0, 20 );
+    frame[ 0 ] = 0xaa;
+    frame[ 1 ] = 0x55;
+    memcpy( &frame[ 2 ], payload, len );
+    frame[ 16 ] = type;
+    frame[ 17 ] = 0x14;
+    frame[ 18 ] = 0x5a;
+    frame[ 19 ] = 0x5a;
+}
+
+static void test_find_every_model( void ) {
+    for ( unsigned int i = 0 ; i < sizeof( models ) / sizeof( models[ 0 ] ) ; i++ ) {
+        const ks_model_t *model = ks_model_find( models[ i ] );
+        TEST_ASSERT_NOT_NULL( model );
+        TEST_ASSERT_EQUAL_STRING( models[ i ], model->name );
+        TEST_ASSERT_GREATER_THAN( 0, model->maxspeed );
+    }
+}
+
+static void test_find_limits( void ) {
+    const ks_model_t *model = ks_model_find( "KS-16X" );
+
+    TEST_ASSERT_NOT_NULL( model );
+    TEST_ASSERT_EQUAL( 45, model->maxcurrent );
+    TEST_ASSERT_EQUAL( 84, model->battvolt );
+    TEST_ASSERT_EQUAL( 50, model->maxspeed );
+    /*
+     * the 14D is the one every wheel got before the table, it has to stay as it was
+     */
+    model = ks_model_find( "KS-14D" );
+    TEST_ASSERT_NOT_NULL( model );
+    TEST_ASSERT_EQUAL( 35, model->maxcurrent );
+    TEST_ASSERT_EQUAL( 67, model->battvolt );
+    TEST_ASSERT_EQUAL( 40, model->battwarn );
+}
+
+static void test_find_unknown( void ) {
+    /*
+     * names that share a slot or a prefix with a known model must not match it
+     */
+    TEST_ASSERT_NULL( ks_model_find( "" ) );
+    TEST_ASSERT_NULL( ks_model_find( "KS" ) );
+    TEST_ASSERT_NULL( ks_model_find( "KS-16" ) );
+    TEST_ASSERT_NULL( ks_model_find( "KS-16XX" ) );
+    TEST_ASSERT_NULL( ks_model_find( "ks-16x" ) );
+    TEST_ASSERT_NULL( ks_model_find( "KS-22" ) );
+    TEST_ASSERT_NULL( ks_model_find( "GW-MSX" ) );
+}
+
+static void test_name_frame( void ) {
+    uint8_t frame[ 20 ];
+    char name[ KS_NAME_LEN + 1 ];
+
+    make_frame( frame, 0xbb, "KS-16X-0215", 11 );
+    const ks_model_t *model = ks_model_decode_name( frame, name );
+    TEST_ASSERT_EQUAL_STRING( "KS-16X-0215", name );
+    TEST_ASSERT_NOT_NULL( model );
+    TEST_ASSERT_EQUAL_STRING( "KS-16X", model->name );
+
+    /*
+     * a dash inside the model, only the last one splits off the firmware
+     */
+    make_frame( frame, 0xbb, "KS-18XL-1234", 12 );
+    model = ks_model_decode_name( frame, name );
+    TEST_ASSERT_NOT_NULL( model );
+    TEST_ASSERT_EQUAL_STRING( "KS-18XL", model->name );
+}
+
+static void test_name_frame_unknown( void ) {
+    uint8_t frame[ 20 ];
+    char name[ KS_NAME_LEN + 1 ];
+
+    make_frame( frame, 0xbb, "KS-22-0101", 10 );
+    TEST_ASSERT_NULL( ks_model_decode_name( frame, name ) );
+    TEST_ASSERT_EQUAL_STRING( "KS-22-0101", name );
+
+    /*
+     * no firmware part, the whole name is tried as model
+     */
+    make_frame( frame, 0xbb, "KS-18L", 6 );
+    TEST_ASSERT_NOT_NULL( ks_model_decode_name( frame, name ) );
+    make_frame( frame, 0xbb, "-0215", 5 );
+    TEST_ASSERT_NULL( ks_model_decode_name( frame, name ) );
+}
+
+static void test_name_frame_full( void ) {
+    uint8_t frame[ 20 ];
+    char name[ KS_NAME_LEN + 1 ];
+
+    /*
+     * a name filling all 14 bytes has no terminator, it must stop before the frame type
+     */
+    make_frame( frame, 0xbb, "KS-18XL-123456", KS_NAME_LEN );
+    const ks_model_t *model = ks_model_decode_name( frame, name );
+    TEST_ASSERT_EQUAL( KS_NAME_LEN, strlen( name ) );
+    TEST_ASSERT_EQUAL_STRING( "KS-18XL-123456", name );
+    TEST_ASSERT_NOT_NULL( model );
+    TEST_ASSERT_EQUAL_STRING( "KS-18XL", model->name );
+}
+
+static void test_serial_frame( void ) {
+    uint8_t frame[ 20 ];
+    char serial[ KS_SERIAL_LEN + 1 ];
+
+    /*
+     * the last 3 serial digits sit behind the frame type
+     */
+    make_frame( frame, 0xb3, "KS16X200601000", 14 );
+    frame[ 17 ] = '4';
+    frame[ 18 ] = '2';
+    frame[ 19 ] = '7';
+    ks_model_decode_serial( frame, serial );
+    TEST_ASSERT_EQUAL_STRING( "KS16X200601000427", serial );
+}
+
+int main( void ) {
+    UNITY_BEGIN();
+    RUN_TEST( test_find_every_model );
+    RUN_TEST( test_find_limits );
+    RUN_TEST( test_find_unknown );
+    RUN_TEST( test_name_frame );
+    RUN_TEST( test_name_frame_unknown );
+    RUN_TEST( test_name_frame_full );
+    RUN_TEST( test_serial_frame );
+    return( UNITY_END() );
+}
@@ -0,0 +1,189 @@
+/****************************************************************************
+ *   Copyright  2020  Jesper Ortlund
+ ****************************************************************************/
+/*
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+#include <string.h>
+#include <unity.h>
+
+#include "hardware/webserver_proto.h"
+
+static const char request[] =
+    "GET /files/ride.csv HTTP/1.1\r\n"
+    "Host: 192.168.4.1\r\n"
+    "range:   bytes=100-199\r\n"
+    "Sec-WebSocket-Key: dGhlIHNhbXBsZSBub25jZQ==\r\n"
+    "\r\n"
+    "X-Body: not a header\r\n";
+
+void setUp( void ) {
+}
+
+void tearDown( void ) {
+}
+
+static void test_get_header( void ) {
+    char value[ 32 ];
+
+    TEST_ASSERT_TRUE( webserver_proto_get_header( request, "Range", value, sizeof( value ) ) );
+    TEST_ASSERT_EQUAL_STRING( "bytes=100-199", value );
+    TEST_ASSERT_TRUE( webserver_proto_get_header( request, "Sec-WebSocket-Key", value, sizeof( value ) ) );
+    TEST_ASSERT_EQUAL_STRING( "dGhlIHNhbXBsZSBub25jZQ==", value );
+}
+
+static void test_get_header_missing( void ) {
+    char value[ 32 ];
+    char small[ 8 ];
+
+    TEST_ASSERT_FALSE( webserver_proto_get_header( request, "Cookie", value, sizeof( value ) ) );
+    /*
+     * the name has to match up to the colon, and the body is not searched
+     */
+    TEST_ASSERT_FALSE( webserver_proto_get_header( request, "Ho", value, sizeof( value ) ) );
+    TEST_ASSERT_FALSE( webserver_proto_get_header( request, "X-Body", value, sizeof( value ) ) );
+    TEST_ASSERT_FALSE( webserver_proto_get_header( "GET / HTTP/1.1", "Host", value, sizeof( value ) ) );
+    /*
+     * a value that doesn't fit is no value
+     */
+    TEST_ASSERT_FALSE( webserver_proto_get_header( request, "Range", small, sizeof( small ) ) );
+}
+
+static void test_ws_decode_masked( void ) {
+    /*
+     * the masked "Hello" ping from rfc 6455 5.7
+     */
+    uint8_t data[] = { 0x89, 0x85, 0x37, 0xfa, 0x21, 0x3d, 0x7f, 0x9f, 0x4d, 0x51, 0x58 };
+    webserver_proto_ws_frame_t frame;
+
+    TEST_ASSERT_EQUAL( sizeof( data ), webserver_proto_ws_decode( data, sizeof( data ), &frame ) );
+    TEST_ASSERT_EQUAL( WEBSERVER_PROTO_WS_PING, frame.opcode );
+    TEST_ASSERT_EQUAL( 5, frame.len );
+    TEST_ASSERT_EQUAL_MEMORY( "Hello", frame.payload, 5 );
+}
+
+static void test_ws_decode_partial( void ) {
+    uint8_t data[ 4 + 4 + 200 ];
+    webserver_proto_ws_frame_t frame;
+
+    memset( data, 0, sizeof( data ) );
+    data[ 0 ] = 0x81;
+    data[ 1 ] = 0x80 | 126;
+    data[ 2 ] = 0;
+    data[ 3 ] = 200;
+
+    /*
+     * a frame split over two tcp segments is left for later
+     */
+    TEST_ASSERT_EQUAL( 0, webserver_proto_ws_decode( data, 1, &frame ) );
+    TEST_ASSERT_EQUAL( 0, webserver_proto_ws_decode( data, 3, &frame ) );
+    TEST_ASSERT_EQUAL( 0, webserver_proto_ws_decode( data, sizeof( data ) - 1, &frame ) );
+    TEST_ASSERT_EQUAL( sizeof( data ), webserver_proto_ws_decode( data, sizeof( data ), &frame ) );
+    TEST_ASSERT_EQUAL( 200, frame.len );
+    TEST_ASSERT_EQUAL_PTR( &data[ 8 ], frame.payload );
+
+    data[ 1 ] = 0x80 | 127;
+    TEST_ASSERT_EQUAL( -1, webserver_proto_ws_decode( data, sizeof( data ), &frame ) );
+}
+
+static void test_ws_decode_sequence( void ) {
+    /*
+     * an unmasked pong and a masked close in one segment
+     */
+    uint8_t data[] = { 0x8a, 0x01, 'x', 0x88, 0x80, 0x01, 0x02, 0x03, 0x04 };
+    webserver_proto_ws_frame_t frame;
+    size_t pos = 0;
+    int used;
+
+    used = webserver_proto_ws_decode( &data[ pos ], sizeof( data ) - pos, &frame );
+    TEST_ASSERT_EQUAL( 3, used );
+    TEST_ASSERT_EQUAL( WEBSERVER_PROTO_WS_PONG, frame.opcode );
+    TEST_ASSERT_EQUAL( 'x', frame.payload[ 0 ] );
+    pos += used;
+
+    used = webserver_proto_ws_decode( &data[ pos ], sizeof( data ) - pos, &frame );
+    TEST_ASSERT_EQUAL( 6, used );
+    TEST_ASSERT_EQUAL( WEBSERVER_PROTO_WS_CLOSE, frame.opcode );
+    TEST_ASSERT_EQUAL( 0, frame.len );
+    pos += used;
+
+    TEST_ASSERT_EQUAL( 0, webserver_proto_ws_decode( &data[ pos ], sizeof( data ) - pos, &frame ) );
+}
+
+static void test_ws_encode( void ) {
+    uint8_t buffer[ WEBSERVER_PROTO_WS_HEADER + 300 ];
+    webserver_proto_ws_frame_t decoded;
+    uint8_t *frame;
+
+    memcpy( &buffer[ WEBSERVER_PROTO_WS_HEADER ], "{\"q\":1}", 7 );
+    TEST_ASSERT_EQUAL( 9, webserver_proto_ws_encode( buffer, WEBSERVER_PROTO_WS_TEXT, 7, &frame ) );
+    TEST_ASSERT_EQUAL_PTR( &buffer[ 2 ], frame );
+    TEST_ASSERT_EQUAL_HEX8( 0x81, frame[ 0 ] );
+    TEST_ASSERT_EQUAL_HEX8( 7, frame[ 1 ] );
+
+    /*
+     * 126 and up take the 16 bit length, the frame starts at the buffer
+     */
+    memset( &buffer[ WEBSERVER_PROTO_WS_HEADER ], 'a', 300 );
+    TEST_ASSERT_EQUAL( 304, webserver_proto_ws_encode( buffer, WEBSERVER_PROTO_WS_TEXT, 300, &frame ) );
+    TEST_ASSERT_EQUAL_PTR( buffer, frame );
+    TEST_ASSERT_EQUAL( 304, webserver_proto_ws_decode( frame, 304, &decoded ) );
+    TEST_ASSERT_EQUAL( 300, decoded.len );
+    TEST_ASSERT_EQUAL_PTR( &buffer[ WEBSERVER_PROTO_WS_HEADER ], decoded.payload );
+
+    TEST_ASSERT_EQUAL( 2, webserver_proto_ws_encode( buffer, WEBSERVER_PROTO_WS_CLOSE, 0, &frame ) );
+    TEST_ASSERT_EQUAL_HEX8( 0x88, frame[ 0 ] );
+    TEST_ASSERT_EQUAL_HEX8( 0x00, frame[ 1 ] );
+}
+
+static void test_take_latest( void ) {
+    uint32_t sent_seq = 0;
+    uint32_t dropped = 0;
+
+    /*
+     * a new client gets the current frame without counting the ones before it connected
+     */
+    TEST_ASSERT_TRUE( webserver_proto_take_latest( &sent_seq, 40, true, &dropped ) );
+    TEST_ASSERT_EQUAL( 40, sent_seq );
+    TEST_ASSERT_EQUAL( 0, dropped );
+    /*
+     * woken again without a new frame
+     */
+    TEST_ASSERT_FALSE( webserver_proto_take_latest( &sent_seq, 40, true, &dropped ) );
+    TEST_ASSERT_TRUE( webserver_proto_take_latest( &sent_seq, 41, true, &dropped ) );
+    /*
+     * a slow client misses 42 to 44 and gets 45 once it acked, a retry of the
+     * same frame without room counts nothing twice
+     */
+    TEST_ASSERT_FALSE( webserver_proto_take_latest( &sent_seq, 42, false, &dropped ) );
+    TEST_ASSERT_FALSE( webserver_proto_take_latest( &sent_seq, 44, false, &dropped ) );
+    TEST_ASSERT_FALSE( webserver_proto_take_latest( &sent_seq, 44, false, &dropped ) );
+    TEST_ASSERT_EQUAL( 41, sent_seq );
+    TEST_ASSERT_TRUE( webserver_proto_take_latest( &sent_seq, 45, true, &dropped ) );
+    TEST_ASSERT_EQUAL( 45, sent_seq );
+    TEST_ASSERT_EQUAL( 3, dropped );
+}
+
+int main( void ) {
+    UNITY_BEGIN();
+    RUN_TEST( test_get_header );
+    RUN_TEST( test_get_header_missing );
+    RUN_TEST( test_ws_decode_masked );
+    RUN_TEST( test_ws_decode_partial );
+    RUN_TEST( test_ws_decode_sequence );
+    RUN_TEST( test_ws_encode );
+    RUN_TEST( test_take_latest );
+    return( UNITY_END() );
+}
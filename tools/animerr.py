@@ -0,0 +1,160 @@
+#!/usr/bin/env python3
+#
+#   Copyright  2020  Jesper Ortlund
+#
+#   This program is free software; you can redistribute it and/or modify
+#   it under the terms of the GNU General Public License as published by
+#   the Free Software Foundation; either version 2 of the License, or
+#   (at your option) any later version.
+#
+"""
+replay a speed trace through the dash gauge update and report the displayed value error
+
+    animerr.py [trace.csv] [--time time_ms] [--value speed] [--period 200] [--jitter 80]
+               [--latency 30] [--drop 0.05] [--tick 250] [--seed 1]
+
+the trace is ground truth, a csv with a header, time in ms and value columns,
+points in between are linear. without a trace a ride is made up. wheel frames
+sample the truth every period ms, +-jitter/2, arrive latency ms later and get
+lost with the drop probability. the error of what the dash shows against the
+truth is taken every ms, for the old tick update that shows the newest sample
+every tick ms and for src/gui/gaugeanim.cpp at GAUGEANIM_FRAME_MS.
+
+gaugeanim.cpp itself runs the animation: it is built with animerr_host.cpp
+by $CXX (c++ if unset) into a temporary directory and fed the updates.
+"""
+import argparse
+import csv
+import os
+import random
+import re
+import shutil
+import subprocess
+import sys
+import tempfile
+
+ROOT = os.path.join(os.path.dirname(os.path.abspath(__file__)), '..')
+
+
+def gaugeanim_frame_ms():
+    with open(os.path.join(ROOT, 'src', 'gui', 'gaugeanim.h')) as f:
+        return int(re.search(r'#define\s+GAUGEANIM_FRAME_MS\s+(\d+)', f.read()).group(1))
+
+
+def build_host(tmpdir):
+    host = os.path.join(tmpdir, 'animerr_host')
+    cmd = [os.environ.get('CXX', 'c++'), '-O2', '-Wall', '-I' + os.path.join(ROOT, 'src'),
+           os.path.join(ROOT, 'tools', 'animerr_host.cpp'),
+           os.path.join(ROOT, 'src', 'gui', 'gaugeanim.cpp'), '-o', host]
+    if subprocess.call(cmd):
+        sys.exit('building %s failed' % host)
+    return host
+
+
+def made_up_ride():
+    # pull away, cruise with wobble, hard brake, crawl, sprint, stop
+    points = [(0, 0), (2000, 0), (8000, 25), (9000, 27), (10000, 24), (11000, 28),
+              (14000, 26), (15500, 5), (18000, 4), (21000, 38), (24000, 40), (28000, 0), (30000, 0)]
+    return points
+
+
+def read_trace(path, time_col, value_col):
+    with open(path, newline='') as f:
+        return [(float(row[time_col]), float(row[value_col])) for row in csv.DictReader(f)]
+
+
+def truth_at(points, t):
+    if t <= points[0][0]:
+        return points[0][1]
+    for (t0, v0), (t1, v1) in zip(points, points[1:]):
+        if t <= t1:
+            return v0 if t1 == t0 else v0 + (v1 - v0) * (t - t0) / (t1 - t0)
+    return points[-1][1]
+
+
+def wheel_frames(points, args, rng):
+    # (arrival ms, value) of the frames that made it
+    frames = []
+    t = points[0][0]
+    while t < points[-1][0]:
+        t += args.period + rng.uniform(-args.jitter / 2, args.jitter / 2)
+        if rng.random() >= args.drop:
+            frames.append((t + args.latency, truth_at(points, t)))
+    return frames
+
+
+def display_updates(frames, start, stop, tick):
+    # (now ms, newest frame or None) for every display update, one every tick ms
+    updates, frame, next_update = [], 0, start
+    for now in range(int(start), int(stop)):
+        while frame < len(frames) and frames[frame][0] <= now:
+            frame += 1
+        if now >= next_update:
+            updates.append((now, frames[frame - 1] if frame else None))
+            next_update += tick
+    return updates
+
+
+def shown_values(start, stop, updates, values):
+    # value on screen every ms, values[n] is shown from updates[n] on
+    shown, n, value = [], 0, 0.0
+    for now in range(int(start), int(stop)):
+        while n < len(updates) and updates[n][0] <= now:
+            value = values[n]
+            n += 1
+        shown.append(value)
+    return shown
+
+
+def run_gaugeanim(host, updates):
+    # same arguments as gaugeanim_init() in the dash tiles
+    lines = []
+    for now, frame in updates:
+        if frame:
+            lines.append('%d %d %f\n' % (now * 1000, int(frame[0] * 1000), frame[1]))
+        else:
+            lines.append('%d\n' % (now * 1000))
+    out = subprocess.run([host, '0', '100', '40'], input=''.join(lines), stdout=subprocess.PIPE,
+                         universal_newlines=True, check=True).stdout
+    return [float(value) for value in out.split()]
+
+
+def report(name, points, shown, start):
+    errors = sorted(abs(value - truth_at(points, start + ms)) for ms, value in enumerate(shown))
+    mean = sum(errors) / len(errors)
+    print('%-6s mean %.2f  p95 %.2f  max %.2f' % (name, mean, errors[int(len(errors) * 0.95)], errors[-1]))
+
+
+def main():
+    parser = argparse.ArgumentParser(usage=__doc__)
+    parser.add_argument('trace', nargs='?')
+    parser.add_argument('--time', default='time_ms')
+    parser.add_argument('--value', default='speed')
+    parser.add_argument('--period', type=float, default=200)
+    parser.add_argument('--jitter', type=float, default=80)
+    parser.add_argument('--latency', type=float, default=30)
+    parser.add_argument('--drop', type=float, default=0.05)
+    parser.add_argument('--tick', type=int, default=250)
+    parser.add_argument('--seed', type=int, default=1)
+    args = parser.parse_args()
+
+    points = read_trace(args.trace, args.time, args.value) if args.trace else made_up_ride()
+    frames = wheel_frames(points, args, random.Random(args.seed))
+    start, stop = points[0][0], points[-1][0]
+    print('%d frames over %.1f s' % (len(frames), (stop - start) / 1000))
+
+    tick_updates = display_updates(frames, start, stop, args.tick)
+    tick_values = [frame[1] if frame else 0.0 for now, frame in tick_updates]
+    report('tick', points, shown_values(start, stop, tick_updates, tick_values), start)
+
+    tmpdir = tempfile.mkdtemp(prefix='animerr')
+    try:
+        anim_updates = display_updates(frames, start, stop, gaugeanim_frame_ms())
+        anim_values = run_gaugeanim(build_host(tmpdir), anim_updates)
+    finally:
+        shutil.rmtree(tmpdir)
+    report('anim', points, shown_values(start, stop, anim_updates, anim_values), start)
+
+
+if __name__ == '__main__':
+    main()
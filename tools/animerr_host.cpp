@@ -0,0 +1,57 @@
+/****************************************************************************
+ *   Copyright  2020  Jesper Ortlund
+ ****************************************************************************/
+/*
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+/*
+ * host driver for src/gui/gaugeanim.cpp, animerr.py builds and runs it
+ *
+ *      animerr_host <min> <max> <max_rate> < updates > shown
+ *
+ * one line per display update, "<now us>" or "<now us> <sample us> <value>"
+ * with the newest wheel sample, answered by one line with the shown value
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <inttypes.h>
+
+#include "gui/gaugeanim.h"
+
+int main( int argc, char **argv ) {
+    gaugeanim_t anim;
+    char line[ 128 ];
+
+    if ( argc != 4 ) {
+        fprintf( stderr, "usage: %s <min> <max> <max_rate>\n", argv[ 0 ] );
+        return( 1 );
+    }
+    gaugeanim_init( &anim, atof( argv[ 1 ] ), atof( argv[ 2 ] ), atof( argv[ 3 ] ) );
+
+    while ( fgets( line, sizeof( line ), stdin ) ) {
+        int64_t now, time;
+        float value;
+
+        int fields = sscanf( line, "%" SCNd64 " %" SCNd64 " %f", &now, &time, &value );
+        if ( fields < 1 ) {
+            fprintf( stderr, "bad line: %s", line );
+            return( 1 );
+        }
+        if ( fields == 3 )
+            gaugeanim_add_sample( &anim, value, time );
+        printf( "%f\n", gaugeanim_get_value( &anim, now ) );
+    }
+    return( 0 );
+}
@@ -0,0 +1,75 @@
+#!/usr/bin/env python3
+#
+#   Copyright  2020  Jesper Ortlund
+#
+#   This program is free software; you can redistribute it and/or modify
+#   it under the terms of the GNU General Public License as published by
+#   the Free Software Foundation; either version 2 of the License, or
+#   (at your option) any later version.
+#
+"""
+print serial console lines that drive the dashboard into a wheel state, for
+checking the dash tiles on a bench watch without a wheel
+
+    ksframe.py <scene> [--shot]
+    ksframe.py --speed 25 --voltage 63.5 --current 12 --temp 40 [--shot]
+
+scenes are sized for the default 67V pack. the lines inject a KingSong 0xa9 live
+data frame, see decodeKS() in src/hardware/Kingsong.cpp. --shot adds a
+screenshot line, compare captures with rlediff.py. send them with e.g.
+
+    ksframe.py cruise --shot > /dev/ttyUSB0
+"""
+import argparse
+import struct
+import sys
+
+# speed km/h, voltage V, current A, temp C
+SCENES = {
+    'idle':     (0.0, 66.0, 0.5, 30.0),
+    'cruise':   (28.0, 63.0, 12.0, 40.0),
+    'current':  (35.0, 61.0, 34.0, 50.0),
+    'hot':      (20.0, 62.0, 15.0, 68.0),
+    'regen':    (22.0, 64.5, -18.0, 42.0),
+    'lowbatt':  (15.0, 54.2, 8.0, 38.0),
+}
+
+
+def live_frame(speed, voltage, current, temp, odo=1234.5, mode=0):
+    frame = bytearray(20)
+    frame[0:2] = b'\xaa\x55'
+    struct.pack_into('<H', frame, 2, round(voltage * 100))
+    struct.pack_into('<H', frame, 4, round(speed * 100))
+    odo = round(odo * 1000)
+    # the odometer is stored as two little endian words, high word first
+    struct.pack_into('<HH', frame, 6, odo >> 16, odo & 0xffff)
+    struct.pack_into('<h', frame, 10, round(current * 100))
+    struct.pack_into('<H', frame, 12, round(temp * 100))
+    frame[14] = mode
+    frame[16] = 0xa9
+    frame[17:20] = b'\x14\x5a\x5a'
+    return bytes(frame)
+
+
+def main():
+    parser = argparse.ArgumentParser(usage=__doc__)
+    parser.add_argument('scene', nargs='?', choices=sorted(SCENES))
+    parser.add_argument('--speed', type=float, default=0.0)
+    parser.add_argument('--voltage', type=float, default=66.0)
+    parser.add_argument('--current', type=float, default=0.0)
+    parser.add_argument('--temp', type=float, default=30.0)
+    parser.add_argument('--shot', action='store_true')
+    args = parser.parse_args()
+
+    if args.scene:
+        speed, voltage, current, temp = SCENES[args.scene]
+    else:
+        speed, voltage, current, temp = args.speed, args.voltage, args.current, args.temp
+
+    sys.stdout.write('inject %s\r\n' % live_frame(speed, voltage, current, temp).hex())
+    if args.shot:
+        sys.stdout.write('screenshot\r\n')
+
+
+if __name__ == '__main__':
+    main()
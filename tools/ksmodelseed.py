@@ -0,0 +1,46 @@
+#!/usr/bin/env python3
+#
+#   Copyright  2020  Jesper Ortlund
+#
+#   This program is free software; you can redistribute it and/or modify
+#   it under the terms of the GNU General Public License as published by
+#   the Free Software Foundation; either version 2 of the License, or
+#   (at your option) any later version.
+#
+"""
+find a KS_MODEL_SEED that gives every model in src/hardware/ks_model.cpp its own slot
+
+    ksmodelseed.py KS-14D KS-16X ...
+
+prints the seed and the slot for each model, the hash matches ks_model_hash()
+"""
+import sys
+
+SLOT_BITS = 4
+
+
+def model_hash(name, seed):
+    h = seed
+    for c in name.encode():
+        h = ((h ^ c) * 16777619) & 0xffffffff
+    return h
+
+
+def main():
+    models = sys.argv[1:]
+    if not models or len(models) > (1 << SLOT_BITS):
+        print(__doc__)
+        sys.exit(1)
+    for seed in range(1, 1 << 24):
+        slots = [model_hash(m, seed) >> (32 - SLOT_BITS) for m in models]
+        if len(set(slots)) == len(models):
+            print('#define KS_MODEL_SEED       %d' % seed)
+            for slot, model in sorted(zip(slots, models)):
+                print('    %2d %s' % (slot, model))
+            return
+    print('no seed found, raise SLOT_BITS')
+    sys.exit(1)
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,113 @@
+#!/usr/bin/env python3
+#
+#   Copyright  2020  Jesper Ortlund
+#
+#   This program is free software; you can redistribute it and/or modify
+#   it under the terms of the GNU General Public License as published by
+#   the Free Software Foundation; either version 2 of the License, or
+#   (at your option) any later version.
+#
+"""
+generate a delta patch for http_ota_start_delta(), see src/hardware/delta_patch.h
+
+    mkdelta.py <running firmware.bin> <new firmware.bin> <out.delta>
+
+the patch has to be served next to the full image as <file>.<running version>.delta,
+e.g. EUC-Dash-v0.bin.2020111001.delta. the patch is applied on the host after
+generation and checked against the md5 of the new image.
+"""
+import hashlib
+import struct
+import sys
+
+MAGIC = 0x31504445
+OP_END = 0
+OP_COPY = 1
+OP_ADD = 2
+BLOCK = 32          # source index granularity, also the shortest copy worth emitting
+
+
+def make_patch(source, target):
+    index = {}
+    for pos in range(0, len(source) - BLOCK + 1, BLOCK):
+        index.setdefault(source[pos:pos + BLOCK], pos)
+
+    ops = []
+    literal = 0     # start of pending literal bytes in target
+    pos = 0
+    while pos + BLOCK <= len(target):
+        src = index.get(target[pos:pos + BLOCK])
+        if src is None:
+            pos += 1
+            continue
+        # extend the match backwards into the pending literal and forwards
+        start = pos
+        while start > literal and src > 0 and source[src - 1] == target[start - 1]:
+            src -= 1
+            start -= 1
+        end = pos + BLOCK
+        src_end = src + ( end - start )
+        while end < len(target) and src_end < len(source) and source[src_end] == target[end]:
+            end += 1
+            src_end += 1
+        if start > literal:
+            ops.append((OP_ADD, target[literal:start]))
+        ops.append((OP_COPY, src, end - start))
+        literal = pos = end
+    if literal < len(target):
+        ops.append((OP_ADD, target[literal:]))
+
+    out = bytearray(struct.pack('<III', MAGIC, len(source), len(target)))
+    out += hashlib.md5(source).digest()
+    for op in ops:
+        if op[0] == OP_COPY:
+            out += struct.pack('<BII', OP_COPY, op[1], op[2])
+        else:
+            out += struct.pack('<BI', OP_ADD, len(op[1])) + op[1]
+    out += struct.pack('<B', OP_END)
+    return bytes(out)
+
+
+def apply_patch(source, patch):
+    magic, source_size, target_size = struct.unpack_from('<III', patch, 0)
+    if magic != MAGIC or source_size != len(source) or patch[12:28] != hashlib.md5(source).digest():
+        raise ValueError('patch does not match the source image')
+    target = bytearray()
+    pos = 28
+    while True:
+        op = patch[pos]
+        pos += 1
+        if op == OP_END:
+            break
+        if op == OP_COPY:
+            offset, length = struct.unpack_from('<II', patch, pos)
+            pos += 8
+            target += source[offset:offset + length]
+        elif op == OP_ADD:
+            length, = struct.unpack_from('<I', patch, pos)
+            pos += 4
+            target += patch[pos:pos + length]
+            pos += length
+        else:
+            raise ValueError('unknown op %d' % op)
+    if len(target) != target_size:
+        raise ValueError('patch produced %d of %d bytes' % (len(target), target_size))
+    return bytes(target)
+
+
+def main():
+    if len(sys.argv) != 4:
+        print(__doc__)
+        sys.exit(1)
+    source = open(sys.argv[1], 'rb').read()
+    target = open(sys.argv[2], 'rb').read()
+    patch = make_patch(source, target)
+    if hashlib.md5(apply_patch(source, patch)).digest() != hashlib.md5(target).digest():
+        print('patch check failed')
+        sys.exit(1)
+    open(sys.argv[3], 'wb').write(patch)
+    print('%s: %d bytes, %d%% of the full image, target md5 %s' % (sys.argv[3], len(patch), 100 * len(patch) // max(len(target), 1), hashlib.md5(target).hexdigest().upper()))
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,89 @@
+#!/usr/bin/env python3
+#
+#   Copyright  2020  Jesper Ortlund
+#
+#   This program is free software; you can redistribute it and/or modify
+#   it under the terms of the GNU General Public License as published by
+#   the Free Software Foundation; either version 2 of the License, or
+#   (at your option) any later version.
+#
+"""
+convert a screenshot capture to png, see src/gui/screenshot.h
+
+    rle2png.py <screenshot.rle> <out.png>
+
+fetch the capture with "screenshot" on the serial console and then
+http://<watch>/files/screenshot.rle
+"""
+import struct
+import sys
+import zlib
+
+MAGIC = 0x31535345
+FLAG_SWAP = 0x01
+HEADER = struct.Struct('<IHHBBH')
+
+
+def decode(data):
+    magic, width, height, depth, flags, _ = HEADER.unpack_from(data)
+    if magic != MAGIC:
+        raise ValueError('not a screenshot capture')
+    if depth != 16:
+        raise ValueError('unsupported depth %d' % depth)
+
+    pixels = []
+    pos = HEADER.size
+    while pos < len(data):
+        packet, = struct.unpack_from('<H', data, pos)
+        pos += 2
+        count = (packet & 0x7fff) + 1
+        if packet & 0x8000:
+            pixels.extend(struct.unpack_from('<H', data, pos) * count)
+            pos += 2
+        else:
+            pixels.extend(struct.unpack_from('<%dH' % count, data, pos))
+            pos += 2 * count
+
+    if len(pixels) != width * height:
+        raise ValueError('%d pixels, expected %d' % (len(pixels), width * height))
+    if flags & FLAG_SWAP:
+        pixels = [((p & 0xff) << 8) | (p >> 8) for p in pixels]
+    return width, height, pixels
+
+
+def rgb565_to_rgb(p):
+    r = (p >> 11) & 0x1f
+    g = (p >> 5) & 0x3f
+    b = p & 0x1f
+    return (r << 3) | (r >> 2), (g << 2) | (g >> 4), (b << 3) | (b >> 2)
+
+
+def png(width, height, pixels):
+    def chunk(kind, body):
+        return struct.pack('>I', len(body)) + kind + body + struct.pack('>I', zlib.crc32(kind + body) & 0xffffffff)
+
+    raw = bytearray()
+    for y in range(height):
+        raw.append(0)
+        for p in pixels[y * width:(y + 1) * width]:
+            raw.extend(rgb565_to_rgb(p))
+
+    return (b'\x89PNG\r\n\x1a\n'
+            + chunk(b'IHDR', struct.pack('>IIBBBBB', width, height, 8, 2, 0, 0, 0))
+            + chunk(b'IDAT', zlib.compress(bytes(raw), 9))
+            + chunk(b'IEND', b''))
+
+
+def main():
+    if len(sys.argv) != 3:
+        sys.exit(__doc__)
+    with open(sys.argv[1], 'rb') as f:
+        data = f.read()
+    width, height, pixels = decode(data)
+    with open(sys.argv[2], 'wb') as f:
+        f.write(png(width, height, pixels))
+    print('%dx%d, %d bytes compressed, %d raw' % (width, height, len(data), width * height * 2))
+
+
+if __name__ == '__main__':
+    main()
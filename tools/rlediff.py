@@ -0,0 +1,64 @@
+#!/usr/bin/env python3
+#
+#   Copyright  2020  Jesper Ortlund
+#
+#   This program is free software; you can redistribute it and/or modify
+#   it under the terms of the GNU General Public License as published by
+#   the Free Software Foundation; either version 2 of the License, or
+#   (at your option) any later version.
+#
+"""
+compare a screenshot capture against a reference capture taken earlier
+
+    rlediff.py <reference.rle> <capture.rle> [--tolerance 8] [--max-pixels 0] [--diff diff.png]
+
+pixels differ when any rgb channel is off by more than the tolerance. exits
+with 1 when more than max-pixels differ, and prints the bounding box of the
+change. --diff writes the capture with differing pixels in magenta.
+"""
+import argparse
+import sys
+
+from rle2png import decode, png, rgb565_to_rgb
+
+
+def main():
+    parser = argparse.ArgumentParser(usage=__doc__)
+    parser.add_argument('reference')
+    parser.add_argument('capture')
+    parser.add_argument('--tolerance', type=int, default=8)
+    parser.add_argument('--max-pixels', type=int, default=0)
+    parser.add_argument('--diff')
+    args = parser.parse_args()
+
+    with open(args.reference, 'rb') as f:
+        rw, rh, reference = decode(f.read())
+    with open(args.capture, 'rb') as f:
+        cw, ch, capture = decode(f.read())
+    if (rw, rh) != (cw, ch):
+        sys.exit('size %dx%d, reference is %dx%d' % (cw, ch, rw, rh))
+
+    differ = []
+    for i, (r, c) in enumerate(zip(reference, capture)):
+        if r != c and max(abs(a - b) for a, b in zip(rgb565_to_rgb(r), rgb565_to_rgb(c))) > args.tolerance:
+            differ.append(i)
+
+    if differ:
+        xs = [i % cw for i in differ]
+        ys = [i // cw for i in differ]
+        print('%d pixels differ in (%d,%d)-(%d,%d)' % (len(differ), min(xs), min(ys), max(xs), max(ys)))
+    else:
+        print('match')
+
+    if args.diff:
+        marked = list(capture)
+        for i in differ:
+            marked[i] = 0xf81f
+        with open(args.diff, 'wb') as f:
+            f.write(png(cw, ch, marked))
+
+    sys.exit(1 if len(differ) > args.max_pixels else 0)
+
+
+if __name__ == '__main__':
+    main()